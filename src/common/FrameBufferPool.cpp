@@ -0,0 +1,147 @@
+/**
+ * FrameBufferPool.cpp - Fixed-size pool of large, page-aligned frame buffers
+ */
+
+#include "common/FrameBufferPool.h"
+#include "common/Logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace ndi_bridge {
+
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+static size_t pageSize() {
+#ifdef _WIN32
+    return 4096;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : 4096;
+#endif
+}
+
+FrameBufferPool::FrameBufferPool(const FrameBufferPoolConfig& config)
+    : config_(config)
+    , state_(std::make_shared<State>()) {
+    Logger::instance().debugf("FrameBufferPool created: %zu buffers%s",
+                              config_.bufferCount, config_.hugePages ? ", huge pages" : "");
+}
+
+FrameBufferPool::~FrameBufferPool() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->closed = true;
+    for (auto& buffer : state_->free) {
+        release(buffer);
+        state_->allocated--;
+    }
+    state_->free.clear();
+}
+
+FrameBufferPool::Buffer FrameBufferPool::allocate(size_t size, bool hugePages) {
+    const size_t alignment = hugePages ? HUGE_PAGE_SIZE : pageSize();
+    Buffer buffer;
+    buffer.capacity = (size + alignment - 1) / alignment * alignment;
+
+#ifdef _WIN32
+    buffer.data = static_cast<uint8_t*>(_aligned_malloc(buffer.capacity, alignment));
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, buffer.capacity) == 0) {
+        buffer.data = static_cast<uint8_t*>(ptr);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // Transparent huge pages: fewer TLB misses and page faults per frame
+        if (hugePages) {
+            madvise(ptr, buffer.capacity, MADV_HUGEPAGE);
+        }
+#endif
+    }
+#endif
+
+    if (!buffer.data) {
+        buffer.capacity = 0;
+    }
+    return buffer;
+}
+
+void FrameBufferPool::release(Buffer& buffer) {
+#ifdef _WIN32
+    _aligned_free(buffer.data);
+#else
+    std::free(buffer.data);
+#endif
+    buffer.data = nullptr;
+    buffer.capacity = 0;
+}
+
+std::shared_ptr<uint8_t> FrameBufferPool::acquire(size_t size) {
+    Buffer buffer;
+    bool needAllocation = false;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        Stats& stats = state_->stats;
+        stats.acquires++;
+
+        if (!state_->free.empty()) {
+            buffer = state_->free.back();
+            state_->free.pop_back();
+            needAllocation = buffer.capacity < size;
+        } else if (state_->allocated < config_.bufferCount) {
+            state_->allocated++;
+            needAllocation = true;
+        } else {
+            stats.exhausted++;
+            return nullptr;
+        }
+
+        if (needAllocation) {
+            stats.allocations++;
+        } else {
+            stats.hits++;
+        }
+        stats.inUse++;
+        stats.peakInUse = std::max(stats.peakInUse, stats.inUse);
+    }
+
+    // Allocate outside the lock (first use of a slot, or the frame grew)
+    if (needAllocation) {
+        release(buffer);
+        buffer = allocate(size, config_.hugePages);
+        if (!buffer.data) {
+            Logger::instance().errorf("FrameBufferPool: failed to allocate %zu bytes", size);
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->allocated--;
+            state_->stats.inUse--;
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stats.bufferBytes = std::max(state_->stats.bufferBytes, buffer.capacity);
+    }
+
+    auto state = state_;
+    return std::shared_ptr<uint8_t>(buffer.data, [state, buffer](uint8_t*) {
+        Buffer returned = buffer;
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stats.inUse--;
+        if (state->closed) {
+            release(returned);
+            state->allocated--;
+        } else {
+            state->free.push_back(returned);
+        }
+    });
+}
+
+FrameBufferPool::Stats FrameBufferPool::getStats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->stats;
+}
+
+} // namespace ndi_bridge
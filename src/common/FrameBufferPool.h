@@ -0,0 +1,90 @@
+#pragma once
+
+/**
+ * FrameBufferPool.h - Fixed-size pool of large, page-aligned frame buffers
+ *
+ * Captured video frames are several MB each (4 MB at 1080p UYVY, 16 MB at
+ * 4K). Allocating one per frame means mmap/munmap and page faults at the
+ * frame rate. The pool keeps a fixed number of page-aligned buffers (huge
+ * pages on request, Linux only) and hands them out as shared_ptr handles
+ * that return the buffer to the pool when the last holder releases it.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ndi_bridge {
+
+/**
+ * Pool configuration
+ */
+struct FrameBufferPoolConfig {
+    size_t bufferCount = 6;         // Buffers in the pool (fixed)
+    bool hugePages = false;         // 2 MB aligned + MADV_HUGEPAGE (Linux)
+};
+
+/**
+ * FrameBufferPool - Recycles frame buffers between capture and encode
+ *
+ * acquire() is thread-safe and so is the release (any thread). Handles may
+ * outlive the pool: released buffers are then simply freed.
+ */
+class FrameBufferPool {
+public:
+    explicit FrameBufferPool(const FrameBufferPoolConfig& config = FrameBufferPoolConfig());
+    ~FrameBufferPool();
+
+    // Non-copyable
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+    /**
+     * Get a buffer of at least size bytes
+     * @return nullptr if every buffer is in use (caller falls back to the heap)
+     */
+    std::shared_ptr<uint8_t> acquire(size_t size);
+
+    /**
+     * Get statistics
+     */
+    struct Stats {
+        uint64_t acquires = 0;          // acquire() calls
+        uint64_t hits = 0;              // Served by a recycled buffer
+        uint64_t allocations = 0;       // New buffer (first use or larger frame)
+        uint64_t exhausted = 0;         // All buffers in use (nullptr returned)
+        size_t inUse = 0;
+        size_t peakInUse = 0;
+        size_t bufferBytes = 0;         // Current size of the largest buffer
+
+        double hitRate() const { return acquires ? static_cast<double>(hits) / acquires : 0.0; }
+    };
+    Stats getStats() const;
+
+    const FrameBufferPoolConfig& getConfig() const { return config_; }
+
+private:
+    struct Buffer {
+        uint8_t* data = nullptr;
+        size_t capacity = 0;
+    };
+
+    // Shared with outstanding handles so a release after ~FrameBufferPool is safe
+    struct State {
+        std::mutex mutex;
+        std::vector<Buffer> free;
+        size_t allocated = 0;           // Buffers that exist (free + in use)
+        bool closed = false;
+        Stats stats;
+    };
+
+    static Buffer allocate(size_t size, bool hugePages);
+    static void release(Buffer& buffer);
+
+    FrameBufferPoolConfig config_;
+    std::shared_ptr<State> state_;
+};
+
+} // namespace ndi_bridge
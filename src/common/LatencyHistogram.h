@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * LatencyHistogram.h - Fixed-bucket timing histogram with percentiles
+ *
+ * 0.1 ms buckets up to 100 ms (slower samples land in the last bucket).
+ * One writer records, any thread reads: counters are relaxed atomics, no
+ * lock and no allocation on the hot path. Percentiles are bucket upper
+ * edges, so they are at most 0.1 ms pessimistic.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace ndi_bridge {
+
+class LatencyHistogram {
+public:
+    static constexpr uint64_t BUCKET_US = 100;
+    static constexpr size_t BUCKETS = 1000;
+
+    /**
+     * Add one sample (single writer)
+     */
+    void record(uint64_t us) {
+        size_t bucket = static_cast<size_t>(us / BUCKET_US);
+        if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Sample time below which `fraction` (0-1) of the samples fall, in ms
+     * (0 when empty)
+     */
+    double percentileMs(double fraction) const {
+        const uint64_t total = count_.load(std::memory_order_relaxed);
+        if (total == 0) return 0.0;
+        uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5);
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; i++) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return static_cast<double>((i + 1) * BUCKET_US) / 1000.0;
+        }
+        return static_cast<double>(BUCKETS * BUCKET_US) / 1000.0;
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+    std::atomic<uint64_t> count_{0};
+};
+
+} // namespace ndi_bridge
@@ -59,6 +59,9 @@
     // SO_REUSEPORT doesn't exist on Windows
     #define PLATFORM_HAS_REUSEPORT 0
 
+    // IP_MULTICAST_TTL / IP_MULTICAST_LOOP take a DWORD on Windows
+    using platform_mcast_opt_t = DWORD;
+
 #else
     // POSIX (macOS, Linux)
     #include <sys/socket.h>
@@ -98,6 +101,9 @@
 
     #define PLATFORM_HAS_REUSEPORT 1
 
+    // IP_MULTICAST_TTL / IP_MULTICAST_LOOP take a u_char on macOS (Linux accepts both)
+    using platform_mcast_opt_t = unsigned char;
+
 #endif
 
 // ============================================================================
@@ -2,6 +2,8 @@
 #include "common/Logger.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cctype>
 
 namespace ndi_bridge {
 
@@ -19,7 +21,7 @@ PacketHeader Protocol::createVideoHeader(
     header.version = PROTOCOL_VERSION;
     header.mediaType = static_cast<uint8_t>(MediaType::Video);
     header.sourceId = 0;
-    header.flags = isKeyframe ? 0x01 : 0x00;
+    header.flags = isKeyframe ? FLAG_KEYFRAME : 0x00;
     header.sequenceNumber = sequenceNumber;
     header.timestamp = timestamp;
     header.totalSize = totalSize;
@@ -28,6 +30,7 @@ PacketHeader Protocol::createVideoHeader(
     header.payloadSize = payloadSize;
     header.sampleRate = 0;
     header.channels = 0;
+    header.codec = static_cast<uint8_t>(VideoCodec::H264);
     std::memset(header.reserved, 0, sizeof(header.reserved));
     header.sendTimestamp = 0;
     return header;
@@ -57,6 +60,7 @@ PacketHeader Protocol::createAudioHeader(
     header.payloadSize = payloadSize;
     header.sampleRate = sampleRate;
     header.channels = channels;
+    header.codec = 0;
     std::memset(header.reserved, 0, sizeof(header.reserved));
     header.sendTimestamp = 0;
     return header;
@@ -93,7 +97,8 @@ void Protocol::serializeInto(const PacketHeader& header, uint8_t* buffer) {
     std::memcpy(buffer + 28, &payloadSize, 2);// 28-29: payloadSize
     std::memcpy(buffer + 30, &sampleRate, 4); // 30-33: sampleRate
     buffer[34] = header.channels;             // 34: channels
-    std::memset(buffer + 35, 0, 3);           // 35-37: reserved
+    buffer[35] = header.codec;                // 35: codec
+    std::memset(buffer + 36, 0, 2);           // 36-37: reserved
     uint64_t sendTs = endian::hton64(header.sendTimestamp);
     std::memcpy(buffer + 38, &sendTs, 8);     // 38-45: sendTimestamp
 }
@@ -153,7 +158,8 @@ std::optional<PacketHeader> Protocol::deserialize(const uint8_t* data, size_t si
     header.sampleRate = endian::ntoh32(sampleRate);
 
     header.channels = data[34];
-    std::memset(header.reserved, 0, 3);
+    header.codec = data[35];
+    std::memset(header.reserved, 0, sizeof(header.reserved));
 
     // sendTimestamp: only present in 46-byte headers
     if (size >= HEADER_SIZE) {
@@ -167,6 +173,26 @@ std::optional<PacketHeader> Protocol::deserialize(const uint8_t* data, size_t si
     return header;
 }
 
+const char* Protocol::codecName(VideoCodec codec) {
+    switch (codec) {
+        case VideoCodec::H264: return "h264";
+        case VideoCodec::HEVC: return "hevc";
+        case VideoCodec::AV1:  return "av1";
+        case VideoCodec::Lossless: return "lossless";
+    }
+    return "unknown";
+}
+
+std::optional<VideoCodec> Protocol::parseCodec(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "h264" || lower == "avc") return VideoCodec::H264;
+    if (lower == "hevc" || lower == "h265") return VideoCodec::HEVC;
+    if (lower == "av1") return VideoCodec::AV1;
+    if (lower == "lossless") return VideoCodec::Lossless;
+    return std::nullopt;
+}
+
 bool Protocol::isValid(const PacketHeader& header) {
     return header.magic == PROTOCOL_MAGIC &&
            header.version == PROTOCOL_VERSION &&
@@ -183,6 +209,16 @@ std::string Protocol::describe(const PacketHeader& header) {
     if (header.mediaType == 0 && header.isKeyframe()) {
         ss << " [KEY]";
     }
+    if (header.mediaType == 0 && header.isSlice()) {
+        ss << ((header.flags & FLAG_END_OF_AU) ? " [SLICE END]" : " [SLICE]");
+    }
+    if (header.mediaType == 0 && header.isRepeat()) {
+        ss << " [REPEAT]";
+    }
+    if (header.mediaType == 0 && header.codec != static_cast<uint8_t>(VideoCodec::H264)) {
+        ss << ", codec=" << (header.codec < VIDEO_CODEC_COUNT
+                                 ? codecName(static_cast<VideoCodec>(header.codec)) : "?");
+    }
     ss << ", seq=" << header.sequenceNumber;
     ss << ", ts=" << header.timestamp;
     ss << ", size=" << header.totalSize;
@@ -196,8 +232,13 @@ std::string Protocol::describe(const PacketHeader& header) {
     return ss.str();
 }
 
-uint16_t Protocol::calculateFragmentCount(uint32_t totalSize) {
-    return static_cast<uint16_t>((totalSize + MAX_UDP_PAYLOAD - 1) / MAX_UDP_PAYLOAD);
+uint16_t Protocol::calculateFragmentCount(uint32_t totalSize, size_t maxPayload) {
+    return static_cast<uint16_t>((totalSize + maxPayload - 1) / maxPayload);
+}
+
+size_t Protocol::payloadSizeForMtu(size_t mtu) {
+    if (mtu <= HEADER_SIZE + MIN_UDP_PAYLOAD) return MIN_UDP_PAYLOAD;
+    return std::min(mtu - HEADER_SIZE, MAX_UDP_PAYLOAD);
 }
 
 uint64_t Protocol::nsToTimestamp(uint64_t nanoseconds) {
@@ -216,6 +257,92 @@ uint64_t Protocol::wallClockNs() {
     return platform::wallClockNs();
 }
 
+size_t Protocol::serializeRendezvous(RendezvousRole role, const std::string& sessionKey,
+                                     uint8_t* buffer) {
+    uint32_t magic = endian::hton32(RENDEZVOUS_MAGIC);
+    std::memcpy(buffer + 0, &magic, 4);       // 0-3: magic
+    buffer[4] = PROTOCOL_VERSION;             // 4: version
+    buffer[5] = static_cast<uint8_t>(role);   // 5: role
+    buffer[6] = 0;                            // 6-7: reserved
+    buffer[7] = 0;
+    std::memset(buffer + 8, 0, RENDEZVOUS_KEY_SIZE);
+    std::memcpy(buffer + 8, sessionKey.data(),
+                std::min(sessionKey.size(), RENDEZVOUS_KEY_SIZE));  // 8-39: sessionKey
+    return RENDEZVOUS_PACKET_SIZE;
+}
+
+std::optional<RendezvousPacket> Protocol::deserializeRendezvous(const uint8_t* data, size_t size) {
+    if (size < RENDEZVOUS_PACKET_SIZE || peekMagic(data, size) != RENDEZVOUS_MAGIC) {
+        return std::nullopt;
+    }
+    if (data[4] != PROTOCOL_VERSION || data[5] > static_cast<uint8_t>(RendezvousRole::Join)) {
+        return std::nullopt;
+    }
+
+    const char* key = reinterpret_cast<const char*>(data + 8);
+    size_t keyLen = 0;
+    while (keyLen < RENDEZVOUS_KEY_SIZE && key[keyLen] != '\0') keyLen++;
+    if (keyLen == 0) {
+        return std::nullopt;
+    }
+
+    RendezvousPacket packet;
+    packet.role = static_cast<RendezvousRole>(data[5]);
+    packet.sessionKey.assign(key, keyLen);
+    return packet;
+}
+
+static void putU32(uint8_t* buffer, uint32_t value) {
+    value = endian::hton32(value);
+    std::memcpy(buffer, &value, 4);
+}
+
+static uint32_t getU32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, 4);
+    return endian::ntoh32(value);
+}
+
+size_t Protocol::serializeReceiverReport(const ReceiverReport& report, uint8_t* buffer) {
+    putU32(buffer + 0, RECEIVER_REPORT_MAGIC);                          // 0-3: magic
+    buffer[4] = PROTOCOL_VERSION;                                       // 4: version
+    buffer[5] = report.sourceId;                                        // 5: rendition
+    buffer[6] = buffer[7] = 0;                                          // 6-7: reserved
+    putU32(buffer + 8, report.sequence);                                // 8-11
+    putU32(buffer + 12, report.intervalMs);                             // 12-15
+    putU32(buffer + 16, report.packetsReceived);                        // 16-19
+    putU32(buffer + 20, report.fragmentsLost);                          // 20-23
+    putU32(buffer + 24, report.framesDropped);                          // 24-27
+    putU32(buffer + 28, report.receiveRateKbps);                        // 28-31
+    putU32(buffer + 32, static_cast<uint32_t>(report.delayGradientUs)); // 32-35
+    return RECEIVER_REPORT_SIZE;
+}
+
+std::optional<ReceiverReport> Protocol::deserializeReceiverReport(const uint8_t* data, size_t size) {
+    if (size < RECEIVER_REPORT_SIZE || peekMagic(data, size) != RECEIVER_REPORT_MAGIC ||
+        data[4] != PROTOCOL_VERSION) {
+        return std::nullopt;
+    }
+
+    ReceiverReport report;
+    report.sourceId = data[5];
+    report.sequence = getU32(data + 8);
+    report.intervalMs = getU32(data + 12);
+    report.packetsReceived = getU32(data + 16);
+    report.fragmentsLost = getU32(data + 20);
+    report.framesDropped = getU32(data + 24);
+    report.receiveRateKbps = getU32(data + 28);
+    report.delayGradientUs = static_cast<int32_t>(getU32(data + 32));
+    return report;
+}
+
+uint32_t Protocol::peekMagic(const uint8_t* data, size_t size) {
+    if (size < 4) return 0;
+    uint32_t magic;
+    std::memcpy(&magic, data, 4);
+    return endian::ntoh32(magic);
+}
+
 // FrameReassembler implementation
 
 std::optional<FrameReassembler::Frame> FrameReassembler::addPacket(
@@ -235,6 +362,10 @@ std::optional<FrameReassembler::Frame> FrameReassembler::addPacket(
             Logger::instance().debugf("DROPPED frame seq=%u: got %u/%u fragments (%.0f%%)",
                 pending_->sequenceNumber, pending_->receivedCount, pending_->fragmentCount,
                 100.0 * pending_->receivedCount / pending_->fragmentCount);
+            partial_ = salvage(*pending_);
+        }
+        if (pending_.has_value()) {
+            recycle(std::move(pending_->data));
         }
 
         // Initialize new pending frame
@@ -247,8 +378,21 @@ std::optional<FrameReassembler::Frame> FrameReassembler::addPacket(
         pf.flags = header.flags;
         pf.sampleRate = header.sampleRate;
         pf.channels = header.channels;
+        pf.sourceId = header.sourceId;
+        pf.codec = header.codec;
+        pf.sendTimestamp = header.sendTimestamp;
         pf.received.resize(header.fragmentCount, false);
-        pf.data.resize(header.totalSize, 0);
+        if (!freeBuffers_.empty()) {
+            // Reused buffer: stale bytes are fine, a frame is only emitted once complete
+            pf.data = std::move(freeBuffers_.back());
+            freeBuffers_.pop_back();
+            pf.data.reserve(header.totalSize + FRAME_TAIL_PADDING);
+            pf.data.resize(header.totalSize);
+        } else {
+            // Padding as spare capacity: the decoder takes the buffer without a realloc
+            pf.data.reserve(header.totalSize + FRAME_TAIL_PADDING);
+            pf.data.resize(header.totalSize, 0);
+        }
         pf.receivedCount = 0;
         pending_ = std::move(pf);
     }
@@ -266,25 +410,33 @@ std::optional<FrameReassembler::Frame> FrameReassembler::addPacket(
         return std::nullopt;
     }
 
-    // Copy payload data
-    size_t offset = static_cast<size_t>(header.fragmentIndex) * MAX_UDP_PAYLOAD;
+    // Copy payload data. Every fragment but the last carries the sender's
+    // full per-fragment payload, so the offset follows from payloadSize
+    // whatever MTU the sender used; the last fragment ends at totalSize.
     size_t copySize = std::min(payloadSize, static_cast<size_t>(header.payloadSize));
+    size_t offset;
+    if (header.fragmentIndex + 1 == pf.fragmentCount) {
+        offset = header.payloadSize <= pf.totalSize ? pf.totalSize - header.payloadSize : pf.totalSize;
+    } else {
+        offset = static_cast<size_t>(header.fragmentIndex) * header.payloadSize;
+    }
+    if (pf.sendTimestamp == 0) {
+        pf.sendTimestamp = header.sendTimestamp;
+    }
     if (offset + copySize <= pf.data.size()) {
         std::memcpy(pf.data.data() + offset, payload, copySize);
         pf.received[header.fragmentIndex] = true;
         pf.receivedCount++;
+        if (header.fragmentIndex + 1 == pf.fragmentCount) {
+            pf.lastOffset = static_cast<uint32_t>(offset);
+        } else {
+            pf.fragmentSize = header.payloadSize;
+        }
     }
 
     // Check if frame is complete
     if (pf.receivedCount == pf.fragmentCount) {
-        Frame frame;
-        frame.type = pf.type;
-        frame.sequenceNumber = pf.sequenceNumber;
-        frame.timestamp = pf.timestamp;
-        frame.data = std::move(pf.data);
-        frame.isKeyframe = (pf.flags & 0x01) != 0;
-        frame.sampleRate = pf.sampleRate;
-        frame.channels = pf.channels;
+        Frame frame = makeFrame(pf);
 
         pending_.reset();
         stats_.framesCompleted++;
@@ -295,9 +447,112 @@ std::optional<FrameReassembler::Frame> FrameReassembler::addPacket(
     return std::nullopt;
 }
 
+std::optional<FrameReassembler::Frame> FrameReassembler::takePartial() {
+    std::optional<Frame> frame = std::move(partial_);
+    partial_.reset();
+    return frame;
+}
+
+FrameReassembler::Frame FrameReassembler::makeFrame(PendingFrame& pf) {
+    Frame frame;
+    frame.type = pf.type;
+    frame.sequenceNumber = pf.sequenceNumber;
+    frame.timestamp = pf.timestamp;
+    frame.data = std::move(pf.data);
+    frame.isKeyframe = (pf.flags & FLAG_KEYFRAME) != 0;
+    frame.sampleRate = pf.sampleRate;
+    frame.channels = pf.channels;
+    frame.sourceId = pf.sourceId;
+    frame.flags = pf.flags;
+    frame.codec = pf.codec;
+    frame.sendTimestamp = pf.sendTimestamp;
+    return frame;
+}
+
+std::optional<FrameReassembler::Frame> FrameReassembler::salvage(PendingFrame& pf) {
+    const bool annexB = pf.codec == static_cast<uint8_t>(VideoCodec::H264) ||
+                        pf.codec == static_cast<uint8_t>(VideoCodec::HEVC);
+    if (!partialFrames_ || pf.type != MediaType::Video || !annexB ||
+        (pf.flags & FLAG_REPEAT) || pf.receivedCount == 0) {
+        return std::nullopt;
+    }
+
+    // Byte range of a received fragment (the non-last ones share one size)
+    auto range = [&pf](uint16_t index) -> std::pair<size_t, size_t> {
+        if (index + 1 == pf.fragmentCount) return {pf.lastOffset, pf.totalSize};
+        const size_t start = static_cast<size_t>(index) * pf.fragmentSize;
+        return {start, std::min(start + pf.fragmentSize, static_cast<size_t>(pf.totalSize))};
+    };
+
+    // A NAL unit survives if it lies entirely in one run of contiguous
+    // received bytes: it starts at a start code in the run and ends at the
+    // next start code in the same run, or at the end of the frame. The
+    // survivors are compacted to the front of the buffer in place.
+    uint8_t* data = pf.data.data();
+    size_t write = 0;
+    bool haveSlice = false;
+    auto keep = [&](size_t start, size_t end) {
+        while (end > start + 3 && data[end - 1] == 0) end--;   // Zero byte of a 4-byte start code
+        if (end <= start + 3) return;
+        const uint8_t header = data[start + 3];
+        if (pf.codec == static_cast<uint8_t>(VideoCodec::H264)) {
+            const uint8_t type = header & 0x1F;
+            haveSlice |= type >= 1 && type <= 5;
+        } else {
+            haveSlice |= ((header >> 1) & 0x3F) < 32;
+        }
+        std::memmove(data + write, data + start, end - start);
+        write += end - start;
+    };
+
+    uint16_t i = 0;
+    while (i < pf.fragmentCount) {
+        if (!pf.received[i]) {
+            i++;
+            continue;
+        }
+        auto [runStart, runEnd] = range(i);
+        while (i + 1 < pf.fragmentCount && pf.received[i + 1] && range(i + 1).first == runEnd) {
+            runEnd = range(++i).second;
+        }
+        i++;
+
+        size_t nalStart = SIZE_MAX;
+        for (size_t p = runStart; p + 3 <= runEnd; p++) {
+            if (data[p + 2] > 1) {
+                p += 2;     // No start code can begin at p, p+1 or p+2
+                continue;
+            }
+            if (data[p] != 0 || data[p + 1] != 0 || data[p + 2] != 1) continue;
+            if (nalStart != SIZE_MAX) keep(nalStart, p);
+            nalStart = p;
+            p += 2;
+        }
+        if (nalStart != SIZE_MAX && runEnd == pf.totalSize) keep(nalStart, runEnd);
+    }
+
+    if (!haveSlice) return std::nullopt;
+
+    pf.data.resize(write);
+    Frame frame = makeFrame(pf);
+    frame.partial = true;
+    stats_.framesSalvaged++;
+    Logger::instance().debugf("SALVAGED frame seq=%u: %zu/%u bytes of complete NAL units",
+        frame.sequenceNumber, write, pf.totalSize);
+    return frame;
+}
+
 void FrameReassembler::reset() {
     pending_.reset();
+    partial_.reset();
     stats_ = Stats{};
 }
 
+void FrameReassembler::recycle(std::vector<uint8_t>&& buffer) {
+    if (buffer.capacity() == 0 || freeBuffers_.size() >= MAX_FREE_BUFFERS) {
+        return;
+    }
+    freeBuffers_.push_back(std::move(buffer));
+}
+
 } // namespace ndi_bridge
@@ -12,8 +12,9 @@
  *   0-3    | magic          | U32    | 0x4E444942 ("NDIB")
  *   4      | version        | U8     | Protocol version (2)
  *   5      | mediaType      | U8     | 0=video, 1=audio
- *   6      | sourceId       | U8     | Source ID (multi-source future)
- *   7      | flags          | U8     | Bit 0 = keyframe (video)
+ *   6      | sourceId       | U8     | Video: simulcast rendition (0 = primary)
+ *   7      | flags          | U8     | Video: bit 0 = keyframe, bit 1 = slice,
+ *          |                |        |        bit 2 = last slice of the picture
  *   8-11   | sequenceNumber | U32    | Frame sequence number
  *   12-19  | timestamp      | U64    | PTS (10,000,000 ticks/sec)
  *   20-23  | totalSize      | U32    | Total frame size in bytes
@@ -22,7 +23,8 @@
  *   28-29  | payloadSize    | U16    | Payload size in this packet
  *   30-33  | sampleRate     | U32    | Audio: sample rate (48000)
  *   34     | channels       | U8     | Audio: channel count (2)
- *   35-37  | reserved       | U8[3]  | Reserved
+ *   35     | codec          | U8     | Video: VideoCodec (0 = H.264)
+ *   36-37  | reserved       | U8[2]  | Reserved
  *   38-45  | sendTimestamp   | U64    | Wall clock at send time (ns since epoch)
  */
 
@@ -38,11 +40,21 @@ namespace ndi_bridge {
 // Protocol constants
 constexpr uint32_t PROTOCOL_MAGIC = 0x4E444942;  // "NDIB"
 constexpr uint8_t  PROTOCOL_VERSION = 2;
+
+// Video header flags (byte 7)
+constexpr uint8_t FLAG_KEYFRAME = 0x01;     // IDR access unit (or its first slice)
+constexpr uint8_t FLAG_SLICE = 0x02;        // Payload is one slice of an access unit
+constexpr uint8_t FLAG_END_OF_AU = 0x04;    // Last slice of the access unit
+constexpr uint8_t FLAG_REPEAT = 0x08;       // No new picture: show the previous frame again
+constexpr size_t  REPEAT_PAYLOAD_SIZE = 1;  // Repeat marker payload (one zero byte)
+constexpr size_t  FRAME_TAIL_PADDING = 64;  // Spare capacity after reassembled frames (decoder input padding)
 constexpr size_t   HEADER_SIZE = 46;
 constexpr size_t   LEGACY_HEADER_SIZE = 38;      // Pre-sendTimestamp header size
 constexpr size_t   DEFAULT_MTU = 1400;
 constexpr size_t   MAX_UDP_PAYLOAD = DEFAULT_MTU - HEADER_SIZE;  // 1354 bytes
 constexpr size_t   MAX_PACKET_SIZE = DEFAULT_MTU;
+constexpr size_t   MIN_UDP_PAYLOAD = 256;        // Floor for very small --mtu values
+constexpr size_t   MAX_SOURCE_IDS = 16;          // Simulcast renditions per stream (sourceId)
 
 // Timestamp resolution: 10,000,000 ticks per second (same as NDI)
 constexpr uint64_t TIMESTAMP_RESOLUTION = 10000000;
@@ -52,6 +64,93 @@ enum class MediaType : uint8_t {
     Audio = 1
 };
 
+/**
+ * Video bitstream carried in a stream (header byte 35)
+ *
+ * H.264 and HEVC are Annex-B (start codes), AV1 is a low-overhead OBU
+ * temporal unit. Keyframes carry their parameter sets / sequence header
+ * in-band, so a join can start on any keyframe. Lossless is one
+ * LosslessCodec UYVY frame (every frame a keyframe, LAN links only).
+ */
+enum class VideoCodec : uint8_t {
+    H264 = 0,
+    HEVC = 1,
+    AV1 = 2,
+    Lossless = 3
+};
+constexpr uint8_t VIDEO_CODEC_COUNT = 4;
+
+/**
+ * Rendezvous registration packet (relay mode, phase 2)
+ *
+ * Sent by host and join to the relay so it can learn their public
+ * address (recvfrom source) and pair them by session key. Re-sent
+ * periodically as a NAT keepalive. Never forwarded by the relay.
+ *
+ *   Offset | Field      | Type     | Description
+ *   -------|------------|----------|---------------------------
+ *   0-3    | magic      | U32      | 0x4E444252 ("NDBR")
+ *   4      | version    | U8       | Protocol version (2)
+ *   5      | role       | U8       | 0=host (sender), 1=join (receiver)
+ *   6-7    | reserved   | U8[2]    | Reserved
+ *   8-39   | sessionKey | char[32] | Session key, NUL-padded
+ */
+constexpr uint32_t RENDEZVOUS_MAGIC = 0x4E444252;  // "NDBR"
+constexpr size_t   RENDEZVOUS_PACKET_SIZE = 40;
+constexpr size_t   RENDEZVOUS_KEY_SIZE = 32;
+constexpr int      RENDEZVOUS_KEEPALIVE_MS = 2000;    // Re-register interval (NAT keepalive)
+
+enum class RendezvousRole : uint8_t {
+    Host = 0,
+    Join = 1
+};
+
+struct RendezvousPacket {
+    RendezvousRole role;
+    std::string sessionKey;
+};
+
+/**
+ * Receiver report (join → host, adaptive bitrate)
+ *
+ * Sent periodically from the join's listening socket to the address the
+ * stream comes from (the host, or the relay, which forwards it to the
+ * session's host). Counters cover the interval since the previous report.
+ *
+ *   Offset | Field          | Type | Description
+ *   -------|----------------|------|---------------------------
+ *   0-3    | magic          | U32  | 0x4E445252 ("NDRR")
+ *   4      | version        | U8   | Protocol version (2)
+ *   5      | sourceId       | U8   | Rendition the join receives (simulcast)
+ *   6-7    | reserved       | U8[2]| Reserved
+ *   8-11   | sequence       | U32  | Report counter
+ *   12-15  | intervalMs     | U32  | Time covered by this report
+ *   16-19  | packetsReceived| U32  | Datagrams received
+ *   20-23  | fragmentsLost  | U32  | Fragments of dropped/missing frames
+ *   24-27  | framesDropped  | U32  | Incomplete + never-seen frames
+ *   28-31  | receiveRateKbps| U32  | Receive rate
+ *   32-35  | delayGradientUs| I32  | Change of mean one-way delay since the previous report
+ */
+constexpr uint32_t RECEIVER_REPORT_MAGIC = 0x4E445252;  // "NDRR"
+constexpr size_t   RECEIVER_REPORT_SIZE = 36;
+constexpr int      RECEIVER_REPORT_INTERVAL_MS = 500;
+
+struct ReceiverReport {
+    uint8_t  sourceId = 0;
+    uint32_t sequence = 0;
+    uint32_t intervalMs = 0;
+    uint32_t packetsReceived = 0;
+    uint32_t fragmentsLost = 0;
+    uint32_t framesDropped = 0;
+    uint32_t receiveRateKbps = 0;
+    int32_t  delayGradientUs = 0;
+
+    double lossFraction() const {
+        uint64_t expected = static_cast<uint64_t>(packetsReceived) + fragmentsLost;
+        return expected ? static_cast<double>(fragmentsLost) / expected : 0.0;
+    }
+};
+
 /**
  * PacketHeader - 46-byte protocol header
  *
@@ -62,8 +161,8 @@ struct PacketHeader {
     uint32_t magic;           // 0-3:   "NDIB" (0x4E444942)
     uint8_t  version;         // 4:     Protocol version
     uint8_t  mediaType;       // 5:     0=video, 1=audio
-    uint8_t  sourceId;        // 6:     Source ID (for multi-source)
-    uint8_t  flags;           // 7:     Bit 0 = keyframe (video)
+    uint8_t  sourceId;        // 6:     Simulcast rendition (video)
+    uint8_t  flags;           // 7:     FLAG_KEYFRAME / FLAG_SLICE / FLAG_END_OF_AU / FLAG_REPEAT
     uint32_t sequenceNumber;  // 8-11:  Frame sequence
     uint64_t timestamp;       // 12-19: PTS (10M ticks/sec)
     uint32_t totalSize;       // 20-23: Total frame size
@@ -72,11 +171,14 @@ struct PacketHeader {
     uint16_t payloadSize;     // 28-29: This packet's payload size
     uint32_t sampleRate;      // 30-33: Audio sample rate
     uint8_t  channels;        // 34:    Audio channels
-    uint8_t  reserved[3];     // 35-37: Reserved
+    uint8_t  codec;           // 35:    VideoCodec (video)
+    uint8_t  reserved[2];     // 36-37: Reserved
     uint64_t sendTimestamp;    // 38-45: Wall clock at send time (ns since epoch)
 
     // Helper methods
-    bool isKeyframe() const { return (flags & 0x01) != 0; }
+    bool isKeyframe() const { return (flags & FLAG_KEYFRAME) != 0; }
+    bool isSlice() const { return (flags & FLAG_SLICE) != 0; }
+    bool isRepeat() const { return (flags & FLAG_REPEAT) != 0; }
     bool isVideo() const { return mediaType == static_cast<uint8_t>(MediaType::Video); }
     bool isAudio() const { return mediaType == static_cast<uint8_t>(MediaType::Audio); }
 };
@@ -169,10 +271,29 @@ public:
      */
     static std::string describe(const PacketHeader& header);
 
+    /**
+     * Codec name ("h264", "hevc", "av1", "lossless"), also the --codec spelling
+     */
+    static const char* codecName(VideoCodec codec);
+
+    /**
+     * Parse a --codec value (h264, hevc / h265, av1, lossless)
+     * @return Codec if known, nullopt otherwise
+     */
+    static std::optional<VideoCodec> parseCodec(const std::string& name);
+
     /**
      * Calculate number of fragments needed for a frame
+     * @param maxPayload Payload bytes per fragment (see payloadSizeForMtu)
+     */
+    static uint16_t calculateFragmentCount(uint32_t totalSize,
+                                           size_t maxPayload = MAX_UDP_PAYLOAD);
+
+    /**
+     * Payload bytes per fragment for a given MTU (header included in MTU)
+     * Clamped to [MIN_UDP_PAYLOAD, MAX_UDP_PAYLOAD].
      */
-    static uint16_t calculateFragmentCount(uint32_t totalSize);
+    static size_t payloadSizeForMtu(size_t mtu);
 
     /**
      * Convert nanoseconds to protocol timestamp (10M ticks/sec)
@@ -188,12 +309,52 @@ public:
      * Get current wall clock time in nanoseconds (CLOCK_REALTIME)
      */
     static uint64_t wallClockNs();
+
+    /**
+     * Serialize a rendezvous registration packet
+     * @param buffer Destination buffer (must be at least RENDEZVOUS_PACKET_SIZE bytes)
+     * @return Number of bytes written (RENDEZVOUS_PACKET_SIZE)
+     */
+    static size_t serializeRendezvous(RendezvousRole role, const std::string& sessionKey,
+                                      uint8_t* buffer);
+
+    /**
+     * Parse a rendezvous registration packet
+     * @return Packet if valid, nullopt otherwise (wrong magic/version/size, empty key)
+     */
+    static std::optional<RendezvousPacket> deserializeRendezvous(const uint8_t* data, size_t size);
+
+    /**
+     * Serialize a receiver report
+     * @param buffer Destination buffer (must be at least RECEIVER_REPORT_SIZE bytes)
+     * @return Number of bytes written (RECEIVER_REPORT_SIZE)
+     */
+    static size_t serializeReceiverReport(const ReceiverReport& report, uint8_t* buffer);
+
+    /**
+     * Parse a receiver report
+     * @return Report if valid, nullopt otherwise (wrong magic/version/size)
+     */
+    static std::optional<ReceiverReport> deserializeReceiverReport(const uint8_t* data, size_t size);
+
+    /**
+     * Read the 4-byte magic of a datagram (0 if too short)
+     */
+    static uint32_t peekMagic(const uint8_t* data, size_t size);
 };
 
 /**
  * FrameReassembler - Reassemble fragmented frames
  *
  * Handles out-of-order packets and detects missing fragments.
+ * MTU-agnostic: fragment offsets are derived from each header's payloadSize
+ * (all fragments but the last carry the same payload size), so streams
+ * fragmented at any MTU up to DEFAULT_MTU reassemble correctly.
+ *
+ * With partial frames enabled, an H.264 / HEVC frame abandoned with
+ * fragments missing is not thrown away whole: the NAL units (slices) that
+ * arrived complete are recovered from their Annex-B start codes and handed
+ * out by takePartial(), for the decoder to conceal the missing regions.
  */
 class FrameReassembler {
 public:
@@ -205,6 +366,11 @@ public:
         bool isKeyframe;      // Video only
         uint32_t sampleRate;  // Audio only
         uint8_t channels;     // Audio only
+        uint8_t sourceId;
+        uint8_t flags;            // Raw header flags (FLAG_*)
+        uint8_t codec;            // VideoCodec (video)
+        uint64_t sendTimestamp;   // Sender wall clock (ns), 0 if absent
+        bool partial = false;     // Complete NAL units of an incomplete frame only
     };
 
     /**
@@ -215,17 +381,37 @@ public:
                                    const uint8_t* payload,
                                    size_t payloadSize);
 
+    /**
+     * Recover the complete slices of incomplete video frames (default off)
+     */
+    void setPartialFrames(bool enabled) { partialFrames_ = enabled; }
+
+    /**
+     * Frame salvaged by the last addPacket() when it abandoned an incomplete
+     * one (nullopt if none). It precedes any frame addPacket() returned, so
+     * call this right after addPacket() and deliver it first.
+     */
+    std::optional<Frame> takePartial();
+
     /**
      * Reset reassembler state
      */
     void reset();
 
+    /**
+     * Return a completed frame's buffer for reuse by a later frame.
+     * Lets hot paths (relay) hand buffers by move from reassembly to the
+     * send path and back without a large allocation per frame.
+     */
+    void recycle(std::vector<uint8_t>&& buffer);
+
     /**
      * Get statistics
      */
     struct Stats {
         uint64_t framesCompleted = 0;
         uint64_t framesDropped = 0;
+        uint64_t framesSalvaged = 0;    // Dropped frames whose complete slices were kept
         uint64_t packetsReceived = 0;
         uint64_t packetsDuplicate = 0;
         uint64_t totalFragmentsReceivedBeforeDrop = 0;
@@ -243,12 +429,25 @@ private:
         uint8_t flags;
         uint32_t sampleRate;
         uint8_t channels;
+        uint8_t sourceId;
+        uint8_t codec;
+        uint64_t sendTimestamp;
         std::vector<bool> received;
         std::vector<uint8_t> data;
         uint16_t receivedCount = 0;
+        uint32_t fragmentSize = 0;      // Payload of the non-last fragments (0 until one arrives)
+        uint32_t lastOffset = 0;        // Where the last fragment starts (once it arrives)
     };
 
+    static Frame makeFrame(PendingFrame& pf);
+    std::optional<Frame> salvage(PendingFrame& pf);
+
+    static constexpr size_t MAX_FREE_BUFFERS = 4;
+
     std::optional<PendingFrame> pending_;
+    std::optional<Frame> partial_;
+    bool partialFrames_ = false;
+    std::vector<std::vector<uint8_t>> freeBuffers_;
     Stats stats_;
 };
 
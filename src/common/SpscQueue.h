@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * SpscQueue.h - Bounded lock-free single-producer / single-consumer queue
+ *
+ * Ring buffer with acquire/release indices: push and pop never take a lock.
+ * A consumer that finds the queue empty can block in pop(); the producer
+ * only touches the mutex when a consumer is actually sleeping (event count),
+ * so the steady-state hand-off between pipeline stages stays lock-free.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace ndi_bridge {
+
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : slots_(capacity + 1) {}
+
+    // Non-copyable
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * Producer: append an item
+     * @return false if the queue is full (item left untouched)
+     */
+    bool tryPush(T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t next = increment(tail);
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots_[tail] = std::move(item);
+        tail_.store(next, std::memory_order_seq_cst);  // Pairs with sleeping_ (event count)
+        wakeConsumer();
+        return true;
+    }
+
+    bool tryPush(T&& item) { return tryPush(item); }
+
+    /**
+     * Consumer: take the oldest item without blocking
+     */
+    bool tryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = std::move(slots_[head]);
+        slots_[head] = T();     // Drop whatever the moved-from slot still holds
+        head_.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer: take the oldest item, waiting up to timeoutMs
+     * @return false on timeout or after wake()
+     */
+    bool pop(T& out, int timeoutMs) {
+        if (tryPop(out)) return true;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        const uint64_t wakeups = wakeups_;
+        cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] {
+            return tail_.load(std::memory_order_seq_cst) != head_.load(std::memory_order_relaxed) ||
+                   wakeups_ != wakeups;
+        });
+        sleeping_.store(false, std::memory_order_relaxed);
+        lock.unlock();
+
+        return tryPop(out);
+    }
+
+    /**
+     * Wake a blocked consumer (shutdown)
+     */
+    void wake() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeups_++;
+        cv_.notify_all();
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t size() const {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : tail + slots_.size() - head;
+    }
+
+    size_t capacity() const { return slots_.size() - 1; }
+
+private:
+    size_t increment(size_t index) const {
+        return index + 1 == slots_.size() ? 0 : index + 1;
+    }
+
+    void wakeConsumer() {
+        if (sleeping_.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+    }
+
+    std::vector<T> slots_;
+    alignas(64) std::atomic<size_t> head_{0};   // Consumer index
+    alignas(64) std::atomic<size_t> tail_{0};   // Producer index
+
+    // Consumer sleep / wake-up (slow path only)
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> sleeping_{false};
+    uint64_t wakeups_ = 0;
+};
+
+} // namespace ndi_bridge
@@ -1,11 +1,13 @@
 /**
  * HostMode.cpp - NDI Bridge Host Mode Implementation
  *
- * Orchestrates: NDIReceiver → VideoEncoder → NetworkSender
+ * Orchestrates: NDIReceiver → convert → VideoEncoder → NetworkSender
+ * (one thread per stage, see HostMode.h)
  */
 
 #include "HostMode.h"
 #include "../common/Logger.h"
+#include "../common/Protocol.h"
 
 #include <iostream>
 #include <algorithm>
@@ -20,6 +22,8 @@ namespace ndi_bridge {
 
 HostMode::HostMode(const HostModeConfig& config)
     : config_(config)
+    , sendQueue_(SEND_QUEUE_SIZE * static_cast<size_t>(std::max(1, config.slices)))
+    , bitrateKbps_(config.bitrateMbps * 1000)
 {
     LOG_DEBUG("HostMode created");
 }
@@ -39,8 +43,40 @@ int HostMode::start(std::atomic<bool>& running) {
 
     log.info("═══════════════════════════════════════════════════════");
     log.info("Starting HOST MODE (Sender)");
-    log.successf("Target: %s:%u", config_.targetHost.c_str(), config_.targetPort);
-    log.successf("Bitrate: %d Mbps, MTU: %zu", config_.bitrateMbps, config_.mtu);
+    log.successf("Target: %s", describeTargets().c_str());
+    const bool lossless = config_.codec == VideoCodec::Lossless;
+    if (lossless) {
+        log.successf("Codec: lossless UYVY (LAN, roughly 1 Gbps at 1080p60), MTU: %zu", config_.mtu);
+        if (!config_.simulcast.empty() || config_.adaptiveBitrate || config_.adaptivePreset ||
+            config_.slices > 0) {
+            log.info("Lossless: simulcast / adaptive bitrate / adaptive preset / slice options ignored");
+        }
+        // No encoder to retune, and a paced sender would throttle the raw rate
+        config_.adaptiveBitrate = false;
+        config_.adaptivePreset = false;
+    } else {
+        log.successf("Codec: %s, bitrate: %d Mbps, MTU: %zu", Protocol::codecName(config_.codec),
+                     config_.bitrateMbps, config_.mtu);
+    }
+    if (config_.adaptiveBitrate) {
+        int maxMbps = config_.maxBitrateMbps > 0 ? config_.maxBitrateMbps : config_.bitrateMbps;
+        log.successf("Adaptive bitrate: %d-%d Mbps (receiver reports)", config_.minBitrateMbps, maxMbps);
+        if (config_.codec != VideoCodec::H264) {
+            log.info("Adaptive bitrate: only the pacing rate adapts (live bitrate change is x264 only)");
+        }
+    }
+    if (config_.adaptivePreset) {
+        log.successf("Adaptive preset: up to %s%s", config_.maxPreset.c_str(),
+                     config_.adaptiveFrameRate ? ", half frame rate allowed" : "");
+    }
+    if (!config_.rendezvousKey.empty()) {
+        log.successf("Rendezvous: session '%s' via relay", config_.rendezvousKey.c_str());
+    }
+    for (size_t i = 0; i < config_.simulcast.size(); i++) {
+        const auto& r = config_.simulcast[i];
+        log.successf("Simulcast rendition %zu: %dx%d @ %.1f Mbps",
+                     i + 1, r.width, r.height, r.bitrateKbps / 1000.0);
+    }
     log.info("═══════════════════════════════════════════════════════");
 
     // Step 1: Initialize NDI Receiver
@@ -49,6 +85,11 @@ int HostMode::start(std::atomic<bool>& running) {
     {
         NDIReceiverConfig recvConfig;
         recvConfig.preferBGRA = false;  // UYVY = half the bandwidth (4.1 MB/frame vs 8.3 MB)
+        recvConfig.zeroCopy = config_.zeroCopyCapture;
+        // Queued frames + the one being encoded + the one being delivered
+        recvConfig.maxFramesInFlight = static_cast<int>(MAX_QUEUE_SIZE) + 2;
+        recvConfig.poolBuffers = MAX_QUEUE_SIZE + 2;
+        recvConfig.hugePages = config_.hugePages;
         ndiReceiver_->configure(recvConfig);
     }
 
@@ -94,22 +135,66 @@ int HostMode::start(std::atomic<bool>& running) {
     ndiReceiver_->prepareConnect(selectedSource_);
 
     // Step 4: Initialize encoder (will be configured on first frame)
-    log.info("Step 4/5: Preparing H.264 encoder...");
-    encoder_ = std::make_unique<VideoEncoder>();
+    log.infof("Step 4/5: Preparing %s encoder...", Protocol::codecName(config_.codec));
+    if (lossless) {
+        lossless_ = std::make_unique<LosslessCodec>();
+        log.successf("Lossless codec: %d slice thread(s)", lossless_->threadCount());
+    } else {
+        encoder_ = std::make_unique<VideoEncoder>();
+    }
 
-    encoder_->setOnEncodedFrame([this](const EncodedFrame& frame) {
-        onEncodedFrame(frame);
-    });
-    encoder_->setOnError([](const std::string& error) {
-        Logger::instance().errorf("Encoder error: %s", error.c_str());
+    if (encoder_) {
+        encoder_->setOnEncodedFrame([this](EncodedFrame& frame) {
+            onEncodedFrame(frame);
+        });
+        encoder_->setOnError([](const std::string& error) {
+            Logger::instance().errorf("Encoder error: %s", error.c_str());
+        });
+    }
+
+    // Lower renditions: sourceId follows the configured order, resize runs
+    // largest first so each can cascade from the previous one
+    if (config_.simulcast.size() >= MAX_SOURCE_IDS) {
+        Logger::instance().errorf("At most %zu simulcast renditions", MAX_SOURCE_IDS - 1);
+        return 1;
+    }
+    renditions_.clear();
+    for (size_t i = 0; i < config_.simulcast.size() && !lossless; i++) {
+        auto rendition = std::make_unique<Rendition>(static_cast<uint8_t>(i + 1), config_.simulcast[i]);
+        rendition->encoder = std::make_unique<VideoEncoder>();
+        Rendition* r = rendition.get();
+        rendition->encoder->setOnEncodedFrame([r](EncodedFrame& frame) {
+            // Rendition encode thread → its send thread (pacing / socket
+            // back-pressure never blocks the encoder)
+            r->framesEncoded++;
+            if (!r->sendQueue.tryPush(frame)) {
+                r->sendStage.dropped++;
+                r->encoder->forceKeyframe();
+            }
+        });
+        rendition->encoder->setOnError([r](const std::string& error) {
+            Logger::instance().errorf("Rendition %d encoder error: %s", r->sourceId, error.c_str());
+        });
+        renditions_.push_back(std::move(rendition));
+    }
+    std::stable_sort(renditions_.begin(), renditions_.end(), [](const auto& a, const auto& b) {
+        return a->settings.width * a->settings.height > b->settings.width * b->settings.height;
     });
+    if (!renditions_.empty()) {
+        scaler_ = std::make_unique<PixelConverter>();
+    }
 
     // Step 5: Initialize network sender
     log.info("Step 5/5: Connecting to network...");
     NetworkSenderConfig senderConfig;
     senderConfig.host = config_.targetHost;
     senderConfig.port = config_.targetPort;
+    senderConfig.targets = config_.targets;
     senderConfig.mtu = config_.mtu;
+    senderConfig.videoCodec = config_.codec;
+    senderConfig.multicastTtl = config_.multicastTtl;
+    senderConfig.multicastInterface = config_.multicastInterface;
+    senderConfig.multicastLoopback = config_.multicastLoopback;
 
     networkSender_ = std::make_unique<NetworkSender>(senderConfig);
 
@@ -118,27 +203,67 @@ int HostMode::start(std::atomic<bool>& running) {
         return 1;
     }
 
+    if (config_.adaptiveBitrate) {
+        CongestionControllerConfig ccConfig;
+        ccConfig.minBitrate = config_.minBitrateMbps * 1000000;
+        ccConfig.maxBitrate = (config_.maxBitrateMbps > 0 ? config_.maxBitrateMbps
+                                                         : config_.bitrateMbps) * 1000000;
+        ccConfig.startBitrate = bitrateKbps_ * 1000;
+        congestion_ = CongestionController(ccConfig);
+        applyPacing();
+    }
+
+    // Register with the relay before the first media packet goes out
+    if (!config_.rendezvousKey.empty()) {
+        sendRendezvousKeepalive();
+    }
+
+    if (config_.adaptivePreset) {
+        EncoderLoadControllerConfig loadConfig;
+        loadConfig.startPreset = preset_.load();
+        loadConfig.maxPreset = config_.maxPreset;
+        loadConfig.allowHalfFrameRate = config_.adaptiveFrameRate;
+        loadController_ = EncoderLoadController(loadConfig);
+    }
+
+    if (config_.skipStatic) {
+        log.infof("Static content: unchanged frames sent as repeat markers (%s block hash)",
+                  FrameChangeDetector::hashName());
+    }
+
     // Start receiving in background thread
     running_ = true;
     startTime_ = std::chrono::steady_clock::now();
 
-    // Start async encode thread (must be before startReceiving)
-    encodeThread_ = std::thread(&HostMode::encodeLoop, this);
+    // Start pipeline stage threads (must be before startReceiving)
+    encodeStageDone_ = false;
+    sendThread_ = std::thread(&HostMode::sendLoop, this, std::ref(sendQueue_), std::ref(sendStage_), 0);
+    if (lossless) {
+        convertThread_ = std::thread(&HostMode::losslessLoop, this);
+    } else {
+        encodeThread_ = std::thread(&HostMode::encodeLoop, this);
+        convertThread_ = std::thread(&HostMode::convertLoop, this);
+    }
+    for (auto& rendition : renditions_) {
+        rendition->thread = std::thread(&HostMode::renditionLoop, this, std::ref(*rendition));
+        rendition->sendThread = std::thread(&HostMode::sendLoop, this, std::ref(rendition->sendQueue),
+                                            std::ref(rendition->sendStage), rendition->sourceId);
+    }
 
     ndiReceiver_->startReceiving();
 
     log.success("═══════════════════════════════════════════════════════");
     log.success("HOST MODE STARTED");
-    log.successf("Streaming: %s → %s:%u",
+    log.successf("Streaming: %s → %s",
                  selectedSource_.name.c_str(),
-                 config_.targetHost.c_str(),
-                 config_.targetPort);
+                 describeTargets().c_str());
     log.success("═══════════════════════════════════════════════════════");
     log.info("Press Ctrl+C to stop...");
 
     // Main loop — on macOS, pump CFRunLoop so NDI's internal CoreFoundation
     // networking callbacks fire. Without this, recv_capture never gets video.
     auto lastStats = std::chrono::steady_clock::now();
+    auto lastKeepalive = lastStats;
     while (running && running_) {
 #ifdef __APPLE__
         // Run the CFRunLoop for 100ms to process NDI's internal callbacks
@@ -147,8 +272,18 @@ int HostMode::start(std::atomic<bool>& running) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
 #endif
 
-        // Periodic stats (every 5 seconds in verbose mode)
         auto now = std::chrono::steady_clock::now();
+
+        // Keep the relay registration (and our NAT mapping) alive
+        if (!config_.rendezvousKey.empty() &&
+            now - lastKeepalive >= std::chrono::milliseconds(RENDEZVOUS_KEEPALIVE_MS)) {
+            lastKeepalive = now;
+            sendRendezvousKeepalive();
+        }
+
+        pollReceiverReports();
+
+        // Periodic stats (every 5 seconds in verbose mode)
         if (Logger::instance().isVerbose() &&
             std::chrono::duration_cast<std::chrono::seconds>(now - lastStats).count() >= 5) {
             lastStats = now;
@@ -163,6 +298,42 @@ int HostMode::start(std::atomic<bool>& running) {
                       senderStats.packetsDroppedEagain,
                       stats.bytesSent / (1024.0 * 1024.0),
                       stats.runTimeSeconds);
+            if (config_.adaptivePreset) {
+                log.debugf("  encoder: preset=%s%s load=%d%%", stats.preset.c_str(),
+                           stats.frameDecimation > 1 ? " @ half rate" : "", stats.encoderLoadPercent);
+            }
+            log.debugf("  stages: convert %.2f/%.2fms drop=%lu q=%zu | encode %.2f/%.2fms q=%zu | send %.2f/%.2fms drop=%lu q=%zu",
+                       stats.convert.avgMs, stats.convert.maxMs, stats.convert.dropped, stats.convert.queueDepth,
+                       stats.encode.avgMs, stats.encode.maxMs, stats.encode.queueDepth,
+                       stats.send.avgMs, stats.send.maxMs, stats.send.dropped, stats.send.queueDepth);
+            if (config_.skipStatic) {
+                log.debugf("  static: repeated=%lu dirty=%.1f%% last=%dx%d@%d,%d hash %.2f/%.2fms",
+                           stats.videoFramesRepeated, stats.dirtyPercent,
+                           stats.dirtyWidth, stats.dirtyHeight, stats.dirtyX, stats.dirtyY,
+                           stats.detect.avgMs, stats.detect.maxMs);
+            }
+            if (!stats.renditions.empty()) {
+                log.debugf("  simulcast: resize %.2f/%.2fms", stats.scale.avgMs, stats.scale.maxMs);
+                for (const auto& r : stats.renditions) {
+                    log.debugf("    [%d] %dx%d: encoded=%lu encode %.2f/%.2fms drop=%lu q=%zu | send %.2f/%.2fms drop=%lu q=%zu",
+                               r.sourceId, r.width, r.height, r.framesEncoded,
+                               r.encode.avgMs, r.encode.maxMs, r.encode.dropped, r.encode.queueDepth,
+                               r.send.avgMs, r.send.maxMs, r.send.dropped, r.send.queueDepth);
+                }
+            }
+            auto pool = ndiReceiver_->getPoolStats();
+            if (pool.acquires > 0) {
+                log.debugf("  pool: hit=%.1f%% alloc=%lu exhausted=%lu in_use=%zu peak=%zu/%zu",
+                           pool.hitRate() * 100.0, pool.allocations, pool.exhausted,
+                           pool.inUse, pool.peakInUse, MAX_QUEUE_SIZE + 2);
+            }
+            if (config_.targets.size() > 1) {
+                for (const auto& t : networkSender_->getTargetStats()) {
+                    log.debugf("  -> %s: pkts_sent=%lu eagain_drops=%lu errors=%lu sent=%.2fMB pacing=%dus",
+                               t.endpoint.c_str(), t.packetsSent, t.packetsDroppedEagain,
+                               t.sendErrors, t.bytesSent / (1024.0 * 1024.0), t.pacingDelayUs);
+                }
+            }
         }
     }
 
@@ -177,9 +348,46 @@ int HostMode::start(std::atomic<bool>& running) {
     log.successf("Video: %lu received, %lu encoded, %lu qdrop",
                  finalStats.videoFramesReceived, finalStats.videoFramesEncoded,
                  finalStats.videoFramesDropped);
+    log.successf("Stages (avg/max ms): convert %.2f/%.2f, encode %.2f/%.2f, send %.2f/%.2f",
+                 finalStats.convert.avgMs, finalStats.convert.maxMs,
+                 finalStats.encode.avgMs, finalStats.encode.maxMs,
+                 finalStats.send.avgMs, finalStats.send.maxMs);
+    for (const auto& r : finalStats.renditions) {
+        log.successf("Simulcast [%d] %dx%d: %lu encoded, %lu dropped, encode %.2f/%.2f ms, send %.2f/%.2f ms (%lu dropped)",
+                     r.sourceId, r.width, r.height, r.framesEncoded, r.encode.dropped,
+                     r.encode.avgMs, r.encode.maxMs, r.send.avgMs, r.send.maxMs, r.send.dropped);
+    }
+    if (config_.skipStatic) {
+        log.successf("Static: %lu frames repeated, %.1f%% of blocks dirty, hash %.2f/%.2f ms (%s)",
+                     finalStats.videoFramesRepeated, finalStats.dirtyPercent,
+                     finalStats.detect.avgMs, finalStats.detect.maxMs,
+                     FrameChangeDetector::hashName());
+    }
+    if (config_.adaptivePreset) {
+        log.successf("Encoder: preset %s%s at exit, last load %d%%", finalStats.preset.c_str(),
+                     finalStats.frameDecimation > 1 ? " @ half rate" : "", finalStats.encoderLoadPercent);
+    }
+    if (config_.zeroCopyCapture && ndiReceiver_) {
+        auto recvStats = ndiReceiver_->getStats();
+        log.successf("Zero-copy: %lu frames, %lu copied (in-flight limit)",
+                     recvStats.zeroCopyFrames, recvStats.zeroCopyFallbacks);
+    }
+    if (ndiReceiver_ && ndiReceiver_->getPoolStats().acquires > 0) {
+        auto pool = ndiReceiver_->getPoolStats();
+        log.successf("Frame pool: %.1f%% hits, %lu allocations, %lu exhausted, peak %zu buffers (%.1f MB each)",
+                     pool.hitRate() * 100.0, pool.allocations, pool.exhausted,
+                     pool.peakInUse, pool.bufferBytes / (1024.0 * 1024.0));
+    }
     log.successf("Network: %lu packets sent, %lu EAGAIN drops, %.2f MB",
                  finalSenderStats.packetsSent, finalSenderStats.packetsDroppedEagain,
                  finalStats.bytesSent / (1024.0 * 1024.0));
+    if (networkSender_ && config_.targets.size() > 1) {
+        for (const auto& t : networkSender_->getTargetStats()) {
+            log.successf("  -> %s: %lu packets, %lu EAGAIN drops, %lu errors, %.2f MB",
+                         t.endpoint.c_str(), t.packetsSent, t.packetsDroppedEagain,
+                         t.sendErrors, t.bytesSent / (1024.0 * 1024.0));
+        }
+    }
     log.successf("Audio: %lu frames", finalStats.audioFramesReceived);
     log.success("═══════════════════════════════════════════════════════");
 
@@ -193,20 +401,57 @@ void HostMode::stop() {
 
     LOG_INFO("Stopping Host Mode...");
 
-    // Wake up encode thread so it can exit
-    queueCv_.notify_all();
+    // Stop the producer first, then drain the pipeline front to back
+    if (ndiReceiver_) {
+        ndiReceiver_->stopReceiving();
+    }
+
+    captureQueue_.wake();
+    if (convertThread_.joinable()) {
+        convertThread_.join();
+    }
+    encodeQueue_.wake();
     if (encodeThread_.joinable()) {
         encodeThread_.join();
     }
+    for (auto& rendition : renditions_) {
+        rendition->encodeQueue.wake();
+        if (rendition->thread.joinable()) {
+            rendition->thread.join();
+        }
+    }
+
+    // Release queued frames (zero-copy frames must go back before disconnect)
+    {
+        NDIVideoFrame pending;
+        while (captureQueue_.tryPop(pending)) {}
+    }
 
     if (ndiReceiver_) {
-        ndiReceiver_->stopReceiving();
         ndiReceiver_->disconnect();
     }
 
     if (encoder_) {
         encoder_->flush();
     }
+    for (auto& rendition : renditions_) {
+        if (rendition->configured) {
+            rendition->encoder->flush();
+        }
+    }
+
+    // Send stage exits once everything queued (including the flush) is out
+    encodeStageDone_ = true;
+    sendQueue_.wake();
+    if (sendThread_.joinable()) {
+        sendThread_.join();
+    }
+    for (auto& rendition : renditions_) {
+        rendition->sendQueue.wake();
+        if (rendition->sendThread.joinable()) {
+            rendition->sendThread.join();
+        }
+    }
 
     if (networkSender_) {
         networkSender_->disconnect();
@@ -221,12 +466,55 @@ std::vector<NDISource> HostMode::listSources() {
     return ndiReceiver_->discoverSources(config_.sourceDiscoveryTimeoutMs);
 }
 
+std::string HostMode::describeTargets() const {
+    if (config_.targets.empty()) {
+        return config_.targetHost + ":" + std::to_string(config_.targetPort);
+    }
+    std::string result;
+    for (const auto& t : config_.targets) {
+        if (!result.empty()) result += ", ";
+        result += t.host + ":" + std::to_string(t.port);
+        if (t.pacingDelayUs >= 0) result += "@" + std::to_string(t.pacingDelayUs) + "us";
+    }
+    return result;
+}
+
 HostMode::Stats HostMode::getStats() const {
     Stats stats;
     stats.videoFramesReceived = videoFramesReceived_;
     stats.audioFramesReceived = audioFramesReceived_;
     stats.videoFramesEncoded = videoFramesEncoded_;
     stats.videoFramesDropped = videoFramesDropped_;
+    stats.bitrateKbps = bitrateKbps_;
+    stats.adaptiveBitrate = config_.adaptiveBitrate;
+    stats.receiverReports = receiverReports_;
+    stats.preset = preset_.load();
+    stats.frameDecimation = frameDecimation_;
+    stats.encoderLoadPercent = encoderLoadPercent_;
+    stats.keyframeInterval = keyframeInterval_;
+    stats.convert = convertStage_.snapshot(captureQueue_.size());
+    stats.encode = encodeStage_.snapshot(encodeQueue_.size());
+    stats.send = sendStage_.snapshot(sendQueue_.size());
+    stats.scale = scaleStage_.snapshot(0);
+    stats.videoFramesRepeated = videoFramesRepeated_;
+    const uint64_t compared = comparedBlocks_;
+    stats.dirtyPercent = compared ? 100.0 * dirtyBlocks_ / compared : 0.0;
+    stats.dirtyX = dirtyX_;
+    stats.dirtyY = dirtyY_;
+    stats.dirtyWidth = dirtyWidth_;
+    stats.dirtyHeight = dirtyHeight_;
+    stats.detect = detectStage_.snapshot(0);
+    for (const auto& rendition : renditions_) {
+        Stats::Rendition r;
+        r.sourceId = rendition->sourceId;
+        r.width = rendition->settings.width;
+        r.height = rendition->settings.height;
+        r.bitrateKbps = rendition->settings.bitrateKbps;
+        r.framesEncoded = rendition->framesEncoded;
+        r.encode = rendition->encodeStage.snapshot(rendition->encodeQueue.size());
+        r.send = rendition->sendStage.snapshot(rendition->sendQueue.size());
+        stats.renditions.push_back(r);
+    }
 
     if (networkSender_) {
         stats.bytesSent = networkSender_->getStats().bytesSent;
@@ -240,6 +528,59 @@ HostMode::Stats HostMode::getStats() const {
     return stats;
 }
 
+void HostMode::reconfigureEncoder(int bitrateMbps, int keyframeInterval) {
+    if (bitrateMbps > 0) {
+        bitrateKbps_ = bitrateMbps * 1000;
+        bitrateOverridden_ = true;
+    }
+    if (keyframeInterval > 0) {
+        keyframeInterval_ = keyframeInterval;
+    }
+    reconfigurePending_ = true;
+    Logger::instance().infof("Encoder reconfigure requested: %.1f Mbps, keyframe interval %d (0 = 1s)",
+                              bitrateKbps_ / 1000.0, keyframeInterval_.load());
+}
+
+void HostMode::applyPacing() {
+    // Only the adapted stream (rendition 0) is paced; lower renditions keep
+    // their fixed bitrates and are not held behind its keyframes
+    networkSender_->setPacingRate(congestion_.pacingRate(), congestion_.pacingBurstBytes(), 0);
+}
+
+void HostMode::pollReceiverReports() {
+    if (!networkSender_) return;
+
+    if (bitrateOverridden_.exchange(false) && config_.adaptiveBitrate) {
+        congestion_.reset(bitrateKbps_ * 1000);
+        applyPacing();
+    }
+
+    uint8_t buffer[2048];
+    size_t size;
+    while ((size = networkSender_->receive(buffer, sizeof(buffer))) > 0) {
+        auto report = Protocol::deserializeReceiverReport(buffer, size);
+        if (!report) continue;
+        receiverReports_++;
+
+        // Lower renditions have fixed bitrates: only rendition 0 is adapted
+        if (report->sourceId != 0) continue;
+
+        if (!config_.adaptiveBitrate || !congestion_.onReport(*report)) continue;
+
+        int kbps = congestion_.targetBitrate() / 1000;
+        int previousKbps = bitrateKbps_.exchange(kbps);
+        reconfigurePending_ = true;
+        applyPacing();
+
+        auto cc = congestion_.getStats();
+        Logger::instance().infof("Adaptive bitrate: %.2f -> %.2f Mbps (%s, loss %.1f%%, delay %+.1fms, recv %.2f Mbps)",
+                                  previousKbps / 1000.0, kbps / 1000.0,
+                                  CongestionController::signalName(cc.lastSignal),
+                                  cc.lastLossFraction * 100.0, cc.lastDelayGradientMs,
+                                  cc.lastReceiveRateKbps / 1000.0);
+    }
+}
+
 // ============================================================================
 // Callbacks
 // ============================================================================
@@ -247,79 +588,475 @@ HostMode::Stats HostMode::getStats() const {
 void HostMode::onVideoFrame(NDIVideoFrame frame) {
     videoFramesReceived_++;
 
-    // Push frame into async encode queue (drop-oldest if full)
-    {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        if (frameQueue_.size() >= MAX_QUEUE_SIZE) {
-            frameQueue_.pop();
-            videoFramesDropped_++;
+    // Capture stage: hand off to the convert thread (drop if it is behind)
+    if (!captureQueue_.tryPush(frame)) {
+        videoFramesDropped_++;
+    }
+}
+
+bool HostMode::configureEncoder(const NDIVideoFrame& frame) {
+    VideoEncoderConfig encConfig;
+    encConfig.width = frame.width;
+    encConfig.height = frame.height;
+    encConfig.bitrate = bitrateKbps_ * 1000;
+    encConfig.codec = config_.codec;
+    encConfig.chroma422 = config_.chroma422;
+    encConfig.pipelinePictures = PIPELINE_PICTURES;
+    encConfig.slices = config_.slices;
+    encConfig.sliceOutput = config_.slices > 0;
+    encConfig.intraRefresh = config_.intraRefresh;
+    encConfig.preset = preset_.load();
+
+    // Determine framerate
+    if (frame.frameRateD > 0 && frame.frameRateN > 0) {
+        encConfig.fps = frame.frameRateN / frame.frameRateD;
+        encConfig.keyframeInterval = encConfig.fps; // Keyframe every second
+    }
+    if (keyframeInterval_ > 0) {
+        encConfig.keyframeInterval = keyframeInterval_;
+    }
+    loadController_.setFrameRate(encConfig.fps);
+
+    // Determine input format from FourCC
+    // NDI uses UYVY (0x59565955) or BGRA (0x41524742)
+    if (frame.fourcc == 0x59565955 || frame.fourcc == 0x56595559) {  // UYVY or YUYV
+        encConfig.inputFormat = PixelFormat::UYVY;
+    } else {
+        encConfig.inputFormat = PixelFormat::BGRA;
+    }
+
+    Logger::instance().infof("Video: %dx%d @ %d fps, format=0x%08X",
+                              frame.width, frame.height, encConfig.fps, frame.fourcc);
+    Logger::instance().infof("Encoder: %s, %s preset, %d Mbps%s%s%s",
+                              Protocol::codecName(encConfig.codec),
+                              encConfig.preset.c_str(), encConfig.bitrate / 1000000,
+                              encConfig.chroma422 ? ", 4:2:2" : "",
+                              encConfig.sliceOutput ? ", slice streaming" : "",
+                              encConfig.intraRefresh ? ", intra refresh" : "");
+
+    if (!encoder_->configure(encConfig)) {
+        LOG_ERROR("Failed to configure encoder");
+        return false;
+    }
+
+    // Every picture starts on the free list
+    for (int i = 0; i < encoder_->pictureCount(); i++) {
+        freePictures_.tryPush(i);
+    }
+
+    LOG_SUCCESS("Encoder configured");
+
+    if (!renditions_.empty()) {
+        configureRenditions(encConfig);
+    }
+    return true;
+}
+
+void HostMode::configureRenditions(const VideoEncoderConfig& primary) {
+    // Renditions take the primary's converted pictures, resized in place format
+    pictureFormat_ = encoder_->pictureFormat();
+    if (!PixelConverter::supportsScale(pictureFormat_)) {
+        LOG_ERROR("Simulcast: no resize kernel for the encoder picture format");
+        return;
+    }
+
+    for (auto& rendition : renditions_) {
+        auto& r = *rendition;
+        // Even dimensions for 4:2:0 / 4:2:2 chroma
+        int width = r.settings.width & ~1;
+        int height = r.settings.height & ~1;
+        if (width <= 0 || height <= 0 || width > primary.width || height > primary.height ||
+            (width == primary.width && height == primary.height)) {
+            Logger::instance().infof("Simulcast rendition %d (%dx%d) skipped: must be smaller than %dx%d",
+                                      r.sourceId, r.settings.width, r.settings.height,
+                                      primary.width, primary.height);
+            continue;
         }
-        frameQueue_.push(std::move(frame));
+
+        VideoEncoderConfig encConfig = primary;
+        encConfig.width = width;
+        encConfig.height = height;
+        encConfig.bitrate = r.settings.bitrateKbps * 1000;
+        encConfig.inputFormat = pictureFormat_;
+        encConfig.pipelinePictures = RENDITION_PICTURES;
+        encConfig.slices = 0;
+        encConfig.sliceOutput = false;
+        encConfig.useHardwareAccel = encoder_->isHardwareAccelerated();
+
+        if (!r.encoder->configure(encConfig) || r.encoder->pictureFormat() != pictureFormat_) {
+            Logger::instance().errorf("Simulcast rendition %d: failed to configure encoder", r.sourceId);
+            continue;
+        }
+        for (int i = 0; i < r.encoder->pictureCount(); i++) {
+            r.freePictures.tryPush(i);
+        }
+        r.settings.width = width;
+        r.settings.height = height;
+        r.configured = true;
+        Logger::instance().successf("Simulcast rendition %d: %dx%d @ %.1f Mbps",
+                                     r.sourceId, width, height, r.settings.bitrateKbps / 1000.0);
     }
-    queueCv_.notify_one();
 }
 
-void HostMode::encodeLoop() {
-    LOG_DEBUG("Encode thread started");
+void HostMode::scaleRenditions(int picture, uint64_t timestamp, bool keyframe) {
+    uint8_t* primaryPlanes[3];
+    int primaryStride[3];
+    if (!encoder_->picturePlanes(picture, primaryPlanes, primaryStride)) return;
+
+    const auto& primary = encoder_->getConfig();
+    const uint8_t* src[3] = {primaryPlanes[0], primaryPlanes[1], primaryPlanes[2]};
+    int srcStride[3] = {primaryStride[0], primaryStride[1], primaryStride[2]};
+    int srcWidth = primary.width;
+    int srcHeight = primary.height;
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto& rendition : renditions_) {
+        auto& r = *rendition;
+        if (!r.configured) continue;
+
+        // Its encoder is behind: drop this rendition's frame only
+        int target = -1;
+        if (!r.freePictures.tryPop(target)) {
+            r.encodeStage.dropped++;
+            continue;
+        }
 
-    while (running_) {
-        NDIVideoFrame frame;
+        // Cascade from the previous (larger) rendition when it covers this one
+        const int width = r.settings.width;
+        const int height = r.settings.height;
+        if (width > srcWidth || height > srcHeight) {
+            for (int p = 0; p < 3; p++) {
+                src[p] = primaryPlanes[p];
+                srcStride[p] = primaryStride[p];
+            }
+            srcWidth = primary.width;
+            srcHeight = primary.height;
+        }
+
+        uint8_t* dst[3];
+        int dstStride[3];
+        if (!r.encoder->picturePlanes(target, dst, dstStride) ||
+            !scaler_->scale(pictureFormat_, src, srcStride, srcWidth, srcHeight,
+                            dst, dstStride, width, height)) {
+            r.freePictures.tryPush(target);
+            continue;
+        }
+
+        // Only this thread writes the picture; the encoder only reads it
+        r.encodeQueue.tryPush(ConvertedPicture{target, timestamp, keyframe});
+        for (int p = 0; p < 3; p++) {
+            src[p] = dst[p];
+            srcStride[p] = dstStride[p];
+        }
+        srcWidth = width;
+        srcHeight = height;
+    }
+    scaleStage_.record(start);
+}
 
-        // Wait for a frame
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            queueCv_.wait(lock, [this] {
-                return !frameQueue_.empty() || !running_;
-            });
+HostMode::FrameContent HostMode::classifyFrame(const NDIVideoFrame& frame) {
+    if (changeResync_.exchange(false)) {
+        changeDetector_.reset();
+    }
 
-            if (!running_ && frameQueue_.empty()) break;
+    auto start = std::chrono::steady_clock::now();
+    const int bytesPerPixel = frame.fourcc == 0x41524742 || frame.fourcc == 0x41424752 ? 4 : 2;
+    FrameChange change = changeDetector_.compare(frame.pixels(), frame.stride,
+                                                 frame.width, frame.height, bytesPerPixel);
+    detectStage_.record(start);
+
+    dirtyBlocks_ += static_cast<uint64_t>(change.dirtyBlocks);
+    comparedBlocks_ += static_cast<uint64_t>(change.totalBlocks);
+    if (change.changed()) {
+        dirtyX_ = change.x;
+        dirtyY_ = change.y;
+        dirtyWidth_ = change.width;
+        dirtyHeight_ = change.height;
+        staticRun_ = 0;
+        return FrameContent::Changed;
+    }
 
-            frame = std::move(frameQueue_.front());
-            frameQueue_.pop();
+    // Keyframe interval in frames (0 = one second)
+    int refresh = keyframeInterval_;
+    if (refresh <= 0) {
+        refresh = frame.frameRateD > 0 && frame.frameRateN > 0
+            ? frame.frameRateN / frame.frameRateD : 30;
+    }
+    if (++staticRun_ >= std::max(refresh, 1)) {
+        staticRun_ = 0;
+        return FrameContent::Refresh;
+    }
+    return FrameContent::Static;
+}
+
+void HostMode::queueRepeat(uint64_t timestamp) {
+    // Only into an empty queue: a marker never takes a picture's slot
+    // (the queues have one spare), and a busy encoder skips the marker
+    if (encodeQueue_.empty()) {
+        encodeQueue_.tryPush(ConvertedPicture{REPEAT_PICTURE, timestamp, false});
+    }
+    for (auto& rendition : renditions_) {
+        if (rendition->configured && rendition->encodeQueue.empty()) {
+            rendition->encodeQueue.tryPush(ConvertedPicture{REPEAT_PICTURE, timestamp, false});
         }
+    }
+}
+
+void HostMode::convertLoop() {
+    LOG_DEBUG("Convert thread started");
+
+    int picture = -1;   // Held across iterations if a conversion fails
+    uint64_t captured = 0;
+    while (running_) {
+        NDIVideoFrame frame;
+        if (!captureQueue_.pop(frame, 100)) continue;
+
+        // Reduced frame rate (adaptive preset's last resort): skip before converting
+        const int decimation = frameDecimation_.load(std::memory_order_relaxed);
+        if (captured++ % static_cast<uint64_t>(decimation) != 0) continue;
 
         // Configure encoder on first frame (auto-detect resolution/fps)
         if (!encoderConfigured_) {
-            VideoEncoderConfig encConfig;
-            encConfig.width = frame.width;
-            encConfig.height = frame.height;
-            encConfig.bitrate = config_.bitrateMbps * 1000000;
-
-            // Determine framerate
-            if (frame.frameRateD > 0 && frame.frameRateN > 0) {
-                encConfig.fps = frame.frameRateN / frame.frameRateD;
-                encConfig.keyframeInterval = encConfig.fps; // Keyframe every second
-            }
+            if (!configureEncoder(frame)) continue;
+            encoderConfigured_ = true;
+        }
 
-            // Determine input format from FourCC
-            // NDI uses UYVY (0x59565955) or BGRA (0x41524742)
-            if (frame.fourcc == 0x59565955 || frame.fourcc == 0x56595559) {  // UYVY or YUYV
-                encConfig.inputFormat = PixelFormat::UYVY;
-            } else {
-                encConfig.inputFormat = PixelFormat::BGRA;
+        // Static content: no conversion, no encode
+        bool keyframe = false;
+        if (config_.skipStatic) {
+            FrameContent content = classifyFrame(frame);
+            if (content == FrameContent::Static) {
+                queueRepeat(static_cast<uint64_t>(frame.timestamp));
+                continue;
             }
+            keyframe = content == FrameContent::Refresh;
+        }
 
-            Logger::instance().infof("Video: %dx%d @ %d fps, format=0x%08X",
-                                      frame.width, frame.height, encConfig.fps, frame.fourcc);
-            Logger::instance().infof("Encoder: %s preset, %d Mbps",
-                                      encConfig.preset.c_str(), config_.bitrateMbps);
+        // No free picture: the encoder is behind, drop rather than queue
+        if (picture < 0 && !freePictures_.tryPop(picture)) {
+            convertStage_.dropped++;
+            videoFramesDropped_++;
+            changeDetector_.reset();    // The next frame must not become a repeat of this one
+            continue;
+        }
 
-            if (!encoder_->configure(encConfig)) {
-                LOG_ERROR("Failed to configure encoder");
-                continue;
+        auto start = std::chrono::steady_clock::now();
+        if (!encoder_->convertToPicture(frame.pixels(), frame.stride, picture)) {
+            LOG_ERROR("Pixel format conversion failed");
+            changeDetector_.reset();
+            continue;
+        }
+        convertStage_.record(start);
+
+        if (!renditions_.empty()) {
+            scaleRenditions(picture, static_cast<uint64_t>(frame.timestamp), keyframe);
+        }
+
+        // Cannot fail: the queue holds every picture (and at most one repeat marker)
+        encodeQueue_.tryPush(ConvertedPicture{picture, static_cast<uint64_t>(frame.timestamp), keyframe});
+        picture = -1;
+    }
+
+    LOG_DEBUG("Convert thread stopped");
+}
+
+void HostMode::losslessLoop() {
+    LOG_DEBUG("Lossless compress thread started");
+
+    while (running_) {
+        NDIVideoFrame frame;
+        if (!captureQueue_.pop(frame, 100)) continue;
+
+        // The join hands the decoded frame to NDI as UYVY: nothing else is sent
+        if (frame.fourcc != 0x59565955) {
+            if (convertStage_.dropped++ == 0) {
+                Logger::instance().errorf("Lossless: source format 0x%08X is not UYVY, frames dropped",
+                                          frame.fourcc);
             }
+            videoFramesDropped_++;
+            continue;
+        }
+
+        if (!encoderConfigured_) {
+            Logger::instance().infof("Video: %dx%d @ %d/%d fps, lossless UYVY (%.1f MB/frame raw)",
+                                      frame.width, frame.height, frame.frameRateN, frame.frameRateD,
+                                      frame.width * 2.0 * frame.height / (1024.0 * 1024.0));
             encoderConfigured_ = true;
-            LOG_SUCCESS("Encoder configured");
         }
 
-        // Encode the frame
-        encoder_->encodeWithStride(frame.data.data(), frame.stride,
-                                   static_cast<uint64_t>(frame.timestamp));
+        // Static content: a repeat marker instead of a compressed frame
+        if (config_.skipStatic && classifyFrame(frame) == FrameContent::Static) {
+            EncodedFrame repeat;
+            repeat.isKeyframe = false;
+            repeat.isRepeat = true;
+            repeat.timestamp = static_cast<uint64_t>(frame.timestamp);
+            repeat.duration = 0;
+            if (sendQueue_.tryPush(repeat)) {
+                videoFramesRepeated_++;
+            }
+            continue;
+        }
+
+        // Every frame is intra: a keyframe on its own, nothing to resync
+        auto start = std::chrono::steady_clock::now();
+        EncodedFrame coded;
+        if (!lossless_->encode(frame.pixels(), frame.stride, frame.width, frame.height, coded.data)) {
+            LOG_ERROR("Lossless compression failed");
+            continue;
+        }
+        encodeStage_.record(start);
+
+        coded.isKeyframe = true;
+        coded.timestamp = static_cast<uint64_t>(frame.timestamp);
+        coded.duration = 0;
+        videoFramesEncoded_++;
+        if (!sendQueue_.tryPush(coded)) {
+            sendStage_.dropped++;
+            changeDetector_.reset();
+        }
+    }
+
+    LOG_DEBUG("Lossless compress thread stopped");
+}
+
+void HostMode::encodeLoop() {
+    LOG_DEBUG("Encode thread started");
+
+    while (running_) {
+        ConvertedPicture item;
+        if (!encodeQueue_.pop(item, 100)) continue;
+
+        // Static frame: nothing to encode, the send stage emits the marker
+        if (item.picture == REPEAT_PICTURE) {
+            EncodedFrame repeat;
+            repeat.isKeyframe = false;
+            repeat.isRepeat = true;
+            repeat.timestamp = item.timestamp;
+            repeat.duration = 0;
+            if (sendQueue_.tryPush(repeat)) {
+                videoFramesRepeated_++;
+            }
+            continue;
+        }
+
+        // A picture in the queue means the encoder is configured
+        if (reconfigurePending_.exchange(false)) {
+            encoder_->reconfigure(bitrateKbps_ * 1000, keyframeInterval_);
+        }
+        if (item.keyframe) {
+            encoder_->forceKeyframe();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        encoder_->encodePicture(item.picture, item.timestamp);
+        encodeStage_.record(start);
+
+        if (config_.adaptivePreset && !encoder_->isHardwareAccelerated()) {
+            adaptPreset(start);
+        }
+
+        freePictures_.tryPush(item.picture);
     }
 
     LOG_DEBUG("Encode thread stopped");
 }
 
+void HostMode::renditionLoop(Rendition& rendition) {
+    Logger::instance().debugf("Rendition %d thread started", rendition.sourceId);
+
+    while (running_) {
+        ConvertedPicture item;
+        if (!rendition.encodeQueue.pop(item, 100)) continue;
+
+        if (item.picture == REPEAT_PICTURE) {
+            // Through the send queue, in order with the encoded pictures
+            EncodedFrame repeat;
+            repeat.isKeyframe = false;
+            repeat.isRepeat = true;
+            repeat.timestamp = item.timestamp;
+            repeat.duration = 0;
+            rendition.sendQueue.tryPush(repeat);
+            continue;
+        }
+        if (item.keyframe) {
+            rendition.encoder->forceKeyframe();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        rendition.encoder->encodePicture(item.picture, item.timestamp);
+        rendition.encodeStage.record(start);
+
+        rendition.freePictures.tryPush(item.picture);
+    }
+
+    Logger::instance().debugf("Rendition %d thread stopped", rendition.sourceId);
+}
+
+void HostMode::adaptPreset(std::chrono::steady_clock::time_point encodeStart) {
+    double encodeMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - encodeStart).count();
+
+    // Convert-stage drops: no free picture because the encoder was behind
+    if (loadController_.onFrame(encodeMs, convertStage_.dropped)) {
+        if (encoder_->setPreset(loadController_.preset())) {
+            preset_ = loadController_.preset();
+        }
+        frameDecimation_ = loadController_.frameDecimation();
+    }
+    encoderLoadPercent_ = static_cast<int>(loadController_.lastLoad() * 100.0);
+}
+
+void HostMode::sendLoop(SpscQueue<EncodedFrame>& queue, StageCounters& stage, uint8_t sourceId) {
+    Logger::instance().debugf("Send thread %d started", sourceId);
+
+    while (true) {
+        EncodedFrame frame;
+        if (!queue.pop(frame, 100)) {
+            if (encodeStageDone_ && queue.empty()) break;
+            continue;
+        }
+
+        if (!networkSender_ || !networkSender_->isConnected()) {
+            continue;
+        }
+
+        if (frame.isRepeat) {
+            networkSender_->sendRepeat(frame.timestamp, sourceId);
+            continue;
+        }
+
+        // Send encoded video over network (slice units carry their boundary flags)
+        uint8_t sliceFlags = 0;
+        if (frame.isSlice) {
+            sliceFlags = FLAG_SLICE | (frame.endOfAccessUnit ? FLAG_END_OF_AU : 0);
+        }
+        auto start = std::chrono::steady_clock::now();
+        networkSender_->sendVideo(frame.data.data(), frame.data.size(),
+                                  frame.isKeyframe, frame.timestamp, sliceFlags, sourceId);
+        stage.record(start);
+    }
+
+    Logger::instance().debugf("Send thread %d stopped", sourceId);
+}
+
+void HostMode::StageCounters::record(std::chrono::steady_clock::time_point start) {
+    auto us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    frames++;
+    busyUs += us;
+    if (us > maxUs) maxUs = us;   // Single writer per stage
+}
+
+HostMode::StageStats HostMode::StageCounters::snapshot(size_t queueDepth) const {
+    StageStats stats;
+    stats.frames = frames;
+    stats.dropped = dropped;
+    stats.avgMs = stats.frames ? busyUs / 1000.0 / stats.frames : 0.0;
+    stats.maxMs = maxUs / 1000.0;
+    stats.queueDepth = queueDepth;
+    return stats;
+}
+
 void HostMode::onAudioFrame(const NDIAudioFrame& frame) {
     audioFramesReceived_++;
 
@@ -337,16 +1074,29 @@ void HostMode::onAudioFrame(const NDIAudioFrame& frame) {
                               static_cast<uint8_t>(frame.channels));
 }
 
-void HostMode::onEncodedFrame(const EncodedFrame& frame) {
-    videoFramesEncoded_++;
+void HostMode::onEncodedFrame(EncodedFrame& frame) {
+    if (frame.endOfAccessUnit) {
+        videoFramesEncoded_++;
+    }
+
+    // Encode stage → send stage: the encoder's buffer moves into the queue
+    // (no copy). A dropped frame breaks the reference chain, so ask for a
+    // keyframe to resynchronise the receiver.
+    if (!sendQueue_.tryPush(frame)) {
+        sendStage_.dropped++;
+        encoder_->forceKeyframe();
+        changeResync_ = true;   // Joins miss this picture: do not repeat it
+    }
+}
 
+void HostMode::sendRendezvousKeepalive() {
     if (!networkSender_ || !networkSender_->isConnected()) {
         return;
     }
 
-    // Send encoded video over network
-    networkSender_->sendVideo(frame.data.data(), frame.data.size(),
-                              frame.isKeyframe, frame.timestamp);
+    uint8_t packet[RENDEZVOUS_PACKET_SIZE];
+    size_t size = Protocol::serializeRendezvous(RendezvousRole::Host, config_.rendezvousKey, packet);
+    networkSender_->sendRaw(packet, size);
 }
 
 void HostMode::onNDIError(const std::string& error) {
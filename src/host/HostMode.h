@@ -11,40 +11,112 @@
 
 #include <string>
 #include <vector>
-#include <queue>
 #include <memory>
 #include <atomic>
 #include <chrono>
-#include <mutex>
-#include <condition_variable>
 #include <thread>
 
+#include "../common/SpscQueue.h"
 #include "../ndi/NDIReceiver.h"
 #include "../video/VideoEncoder.h"
+#include "../video/PixelConverter.h"
+#include "../video/LosslessCodec.h"
+#include "../video/FrameChangeDetector.h"
+#include "../video/EncoderLoadController.h"
 #include "../network/NetworkSender.h"
+#include "../network/CongestionController.h"
 
 namespace ndi_bridge {
 
+/**
+ * One lower simulcast rendition (the capture resolution is rendition 0)
+ */
+struct SimulcastRendition {
+    int width = 1280;
+    int height = 720;
+    int bitrateKbps = 3000;
+};
+
 /**
  * Host mode configuration
  */
 struct HostModeConfig {
     std::string targetHost = "127.0.0.1";
     uint16_t targetPort = 5990;
+    std::vector<NetworkTarget> targets;     // Non-empty = replaces targetHost/targetPort
     int bitrateMbps = 8;                    // Video bitrate in Mbps
+    VideoCodec codec = VideoCodec::H264;    // HEVC / AV1: software, fewer bits per quality
+                                            // Lossless: UYVY frames, no encoder (10 GbE LAN)
     size_t mtu = 1400;                      // UDP MTU (reduce for VPN tunnels)
+    bool chroma422 = false;                 // Encode 4:2:2 (x264 High 4:2:2, no chroma decimation)
+    bool zeroCopyCapture = false;           // Encode straight from the NDI SDK buffer (no copy)
+    bool hugePages = false;                 // Capture buffer pool on transparent huge pages
+    int slices = 0;                         // > 0: N slices per picture, each sent as its own unit
+                                            // (joins decode per slice, partial loss stays local).
+                                            // x264 returns a picture's slices together, so this
+                                            // does not start sending before the picture is encoded
+    bool intraRefresh = false;              // Rolling intra refresh instead of a periodic IDR
+    bool adaptiveBitrate = false;           // Follow the joins' receiver reports (bitrateMbps = start)
+    int minBitrateMbps = 1;                 // Adaptive floor
+    int maxBitrateMbps = 0;                 // Adaptive ceiling (0 = bitrateMbps)
+    bool adaptivePreset = false;            // Step x264 presets with measured encode headroom
+    std::string maxPreset = "medium";       // Slowest preset adaptivePreset may reach
+    bool adaptiveFrameRate = false;         // Allow half frame rate below ultrafast
+    std::vector<SimulcastRendition> simulcast;  // Lower renditions, sourceId 1..N
+    bool skipStatic = false;                // Unchanged frames (block hash) sent as repeat markers
     bool autoSelectFirstSource = false;     // Auto-select first source
     std::string sourceName;                 // Specific source name (empty = interactive)
     std::vector<std::string> excludePatterns = {"Bridge"};  // Patterns to exclude
     int sourceDiscoveryTimeoutMs = 5000;    // Discovery timeout
+    std::string rendezvousKey;              // Non-empty = target is a rendezvous relay
+
+    // Multicast (when a target is a 224.0.0.0/4 group)
+    int multicastTtl = 1;
+    std::string multicastInterface;         // Local IPv4 of the outgoing interface
+    bool multicastLoopback = true;
 };
 
 /**
  * HostMode - Main orchestrator for sender mode
  *
- * Pipeline:
- *   NDIReceiver (video) → VideoEncoder → NetworkSender
+ * Pipeline (one thread per stage, bounded lock-free SPSC queues between them):
+ *   capture (NDI thread) → convert (PixelConverter) → encode (x264) → send
  *   NDIReceiver (audio) → NetworkSender (passthrough)
+ *
+ * Conversion of frame N+1 overlaps with the encode of frame N. Converted
+ * pictures cycle between the convert and encode stages through a free list,
+ * so a slow encoder makes the convert stage drop frames instead of queueing.
+ *
+ * With several targets, one capture + one encode feed every destination;
+ * NetworkSender fans each fragmented frame out (per-target pacing/stats).
+ *
+ * With adaptiveBitrate, the main loop drains the receiver reports joins send
+ * back on the media socket and lets CongestionController retune the encoder
+ * bitrate and the sender's pacing rate (a token bucket on rendition 0 that
+ * lets a keyframe out at once).
+ *
+ * With adaptivePreset, the encode thread times every picture against the
+ * frame budget and EncoderLoadController steps the x264 preset (and, as a
+ * last resort, halves the frame rate in the convert stage).
+ *
+ * With simulcast renditions, the convert stage also resizes each converted
+ * picture into every lower rendition (largest first, each from the smallest
+ * picture already made that covers it). Each rendition has its own encoder
+ * and send threads (bounded queue between them, so network back-pressure
+ * never blocks an encoder) and sends on the shared socket under its own
+ * sourceId. Adaptive bitrate / preset and slice streaming apply to
+ * rendition 0 only.
+ *
+ * With the lossless codec there is no convert / encode split: the convert
+ * thread compresses each captured UYVY frame (LosslessCodec, slices on its
+ * own worker pool) and hands it straight to the send stage. Simulcast and
+ * the adaptive encoder controls do not apply.
+ *
+ * With skipStatic, the convert thread hashes each captured frame in blocks
+ * (FrameChangeDetector) before any conversion. An unchanged frame is not
+ * converted or encoded: a repeat marker goes through the encode queue in
+ * its place and joins present their previous frame again. A static run is
+ * broken by one keyframe per keyframe interval so late joiners still sync.
  */
 class HostMode {
 public:
@@ -77,6 +149,28 @@ public:
      */
     std::vector<NDISource> listSources();
 
+    /**
+     * Change the encoder bitrate / keyframe interval live (any thread)
+     *
+     * Applied by the encode thread before its next picture, and kept if the
+     * encoder is reopened. An explicit bitrate also restarts the adaptive
+     * controller from that value.
+     * @param bitrateMbps New bitrate in Mbps (0 = keep)
+     * @param keyframeInterval Frames between keyframes (0 = keep; default one second)
+     */
+    void reconfigureEncoder(int bitrateMbps, int keyframeInterval);
+
+    /**
+     * Per-stage pipeline statistics
+     */
+    struct StageStats {
+        uint64_t frames = 0;            // Frames processed by the stage
+        uint64_t dropped = 0;           // Frames the stage had to drop
+        double avgMs = 0.0;             // Mean busy time per frame
+        double maxMs = 0.0;
+        size_t queueDepth = 0;          // Items waiting in front of the stage
+    };
+
     /**
      * Get statistics
      */
@@ -87,6 +181,37 @@ public:
         uint64_t videoFramesDropped = 0;
         uint64_t bytesSent = 0;
         double runTimeSeconds = 0.0;
+        int bitrateKbps = 0;            // Current encoder bitrate
+        bool adaptiveBitrate = false;
+        uint64_t receiverReports = 0;
+        std::string preset;             // Current x264 preset
+        int frameDecimation = 1;        // Encoding 1 frame in N
+        int encoderLoadPercent = 0;     // Encode time / frame budget (adaptivePreset)
+        int keyframeInterval = 0;       // Frames (0 = one second)
+        StageStats convert;
+        StageStats encode;
+        StageStats send;
+        StageStats scale;               // Simulcast resize (all renditions, per frame)
+
+        // Static content (skipStatic)
+        uint64_t videoFramesRepeated = 0;   // Sent as repeat markers (not converted / encoded)
+        double dirtyPercent = 0.0;      // Mean share of changed blocks per compared frame
+        int dirtyX = 0;                 // Changed region of the last changed frame
+        int dirtyY = 0;
+        int dirtyWidth = 0;
+        int dirtyHeight = 0;
+        StageStats detect;              // Block-hash comparison
+
+        struct Rendition {
+            int sourceId = 0;
+            int width = 0;
+            int height = 0;
+            int bitrateKbps = 0;
+            uint64_t framesEncoded = 0;
+            StageStats encode;          // dropped = no free picture at resize time
+            StageStats send;            // dropped = send queue full (keyframe forced)
+        };
+        std::vector<Rendition> renditions;
     };
     Stats getStats() const;
 
@@ -94,11 +219,36 @@ private:
     // Callbacks wired to components
     void onVideoFrame(NDIVideoFrame frame);
     void onAudioFrame(const NDIAudioFrame& frame);
-    void onEncodedFrame(const EncodedFrame& frame);
+    void onEncodedFrame(EncodedFrame& frame);
     void onNDIError(const std::string& error);
 
-    // Async encode thread
+    // Pipeline stage threads
+    void convertLoop();
+    void losslessLoop();
     void encodeLoop();
+    bool configureEncoder(const NDIVideoFrame& frame);
+    void configureRenditions(const VideoEncoderConfig& primary);
+    void scaleRenditions(int picture, uint64_t timestamp, bool keyframe);
+
+    // Static content (skipStatic, convert thread)
+    enum class FrameContent {
+        Changed,
+        Static,         // Send a repeat marker instead
+        Refresh         // Static, but due for a keyframe (late joiners)
+    };
+    FrameContent classifyFrame(const NDIVideoFrame& frame);
+    void queueRepeat(uint64_t timestamp);
+    void adaptPreset(std::chrono::steady_clock::time_point encodeStart);
+
+    // Receiver reports → congestion controller (main loop)
+    void pollReceiverReports();
+    void applyPacing();
+
+    // Rendezvous registration / NAT keepalive (relay mode)
+    void sendRendezvousKeepalive();
+
+    // "host:port, host:port" for logs
+    std::string describeTargets() const;
 
     // Source selection helpers
     NDISource selectSource(const std::vector<NDISource>& sources);
@@ -111,6 +261,7 @@ private:
     // Components
     std::unique_ptr<NDIReceiver> ndiReceiver_;
     std::unique_ptr<VideoEncoder> encoder_;
+    std::unique_ptr<LosslessCodec> lossless_;       // codec == Lossless (replaces encoder_)
     std::unique_ptr<NetworkSender> networkSender_;
 
     // State
@@ -118,12 +269,101 @@ private:
     NDISource selectedSource_;
     bool encoderConfigured_ = false;
 
-    // Async encode queue (bounded, drop-oldest policy)
-    static constexpr size_t MAX_QUEUE_SIZE = 3;
-    std::queue<NDIVideoFrame> frameQueue_;
-    std::mutex queueMutex_;
-    std::condition_variable queueCv_;
+    // Pipeline queues (capture → convert → encode → send)
+    static constexpr size_t MAX_QUEUE_SIZE = 3;         // Captured frames waiting for convert
+    static constexpr int PIPELINE_PICTURES = 3;         // Converted pictures (convert ⇄ encode)
+    static constexpr size_t SEND_QUEUE_SIZE = 16;       // Encoded frames waiting for send (x slices)
+
+    static constexpr int REPEAT_PICTURE = -1;           // Repeat marker (skipStatic)
+
+    struct ConvertedPicture {
+        int picture = REPEAT_PICTURE;
+        uint64_t timestamp = 0;
+        bool keyframe = false;                          // Force a keyframe (static refresh)
+    };
+
+    SpscQueue<NDIVideoFrame> captureQueue_{MAX_QUEUE_SIZE};
+    // One extra slot: at most one repeat marker, queued only when the queue is empty
+    SpscQueue<ConvertedPicture> encodeQueue_{PIPELINE_PICTURES + 1};
+    SpscQueue<int> freePictures_{PIPELINE_PICTURES};
+    SpscQueue<EncodedFrame> sendQueue_;
+
+    std::thread convertThread_;
     std::thread encodeThread_;
+    std::thread sendThread_;
+    std::atomic<bool> encodeStageDone_{false};          // Nothing more will reach sendQueue_
+
+    // Busy time per stage
+    struct StageCounters {
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> busyUs{0};
+        std::atomic<uint64_t> maxUs{0};
+
+        void record(std::chrono::steady_clock::time_point start);
+        StageStats snapshot(size_t queueDepth) const;
+    };
+    StageCounters convertStage_;
+    StageCounters encodeStage_;
+    StageCounters sendStage_;
+
+    // Send stage of one stream (rendition 0: sendQueue_, lower renditions: their own)
+    void sendLoop(SpscQueue<EncodedFrame>& queue, StageCounters& stage, uint8_t sourceId);
+
+    // Simulcast: lower renditions, each with its own encoder and thread
+    static constexpr int RENDITION_PICTURES = 2;        // Resized pictures (convert ⇄ rendition)
+
+    struct Rendition {
+        Rendition(uint8_t id, const SimulcastRendition& s) : sourceId(id), settings(s) {}
+
+        uint8_t sourceId;
+        SimulcastRendition settings;
+        std::unique_ptr<VideoEncoder> encoder;
+        bool configured = false;                        // Convert thread only
+        SpscQueue<ConvertedPicture> encodeQueue{RENDITION_PICTURES + 1};
+        SpscQueue<int> freePictures{RENDITION_PICTURES};
+        SpscQueue<EncodedFrame> sendQueue{SEND_QUEUE_SIZE};  // Own send thread: never behind rendition 0
+        std::thread thread;
+        std::thread sendThread;
+        StageCounters encodeStage;
+        StageCounters sendStage;
+        std::atomic<uint64_t> framesEncoded{0};
+    };
+    void renditionLoop(Rendition& rendition);
+
+    std::vector<std::unique_ptr<Rendition>> renditions_; // Largest first
+    std::unique_ptr<PixelConverter> scaler_;
+    PixelFormat pictureFormat_ = PixelFormat::I420;
+    StageCounters scaleStage_;
+
+    // Live encoder settings (reconfigureEncoder / controller → encode thread)
+    std::atomic<int> bitrateKbps_{0};
+    std::atomic<int> keyframeInterval_{0};
+    std::atomic<bool> reconfigurePending_{false};
+    std::atomic<bool> bitrateOverridden_{false};        // Manual change: restart the controller
+
+    // Adaptive bitrate (main loop only)
+    CongestionController congestion_;
+    std::atomic<uint64_t> receiverReports_{0};
+
+    // Adaptive preset (encode thread; operating point published for stats / convert)
+    EncoderLoadController loadController_;
+    std::atomic<const char*> preset_{"ultrafast"};
+    std::atomic<int> frameDecimation_{1};
+    std::atomic<int> encoderLoadPercent_{0};
+
+    // Static content detection (convert thread; counters published for stats)
+    FrameChangeDetector changeDetector_;
+    int staticRun_ = 0;                                 // Frames since the last encoded one
+    std::atomic<bool> changeResync_{false};             // A frame was lost downstream: re-encode
+    StageCounters detectStage_;
+    std::atomic<uint64_t> videoFramesRepeated_{0};
+    std::atomic<uint64_t> dirtyBlocks_{0};
+    std::atomic<uint64_t> comparedBlocks_{0};
+    std::atomic<int> dirtyX_{0};
+    std::atomic<int> dirtyY_{0};
+    std::atomic<int> dirtyWidth_{0};
+    std::atomic<int> dirtyHeight_{0};
 
     // Statistics
     std::chrono::steady_clock::time_point startTime_;
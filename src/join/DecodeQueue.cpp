@@ -0,0 +1,84 @@
+/**
+ * DecodeQueue.cpp - Join decode queue with a keyframe-aware overload policy
+ */
+
+#include "DecodeQueue.h"
+#include "../common/Logger.h"
+
+#include <utility>
+
+namespace ndi_bridge {
+
+bool DecodeQueue::startsIndependentPicture(const ReceivedVideoFrame& frame) {
+    if (frame.isRepeat) return false;
+    // FLAG_KEYFRAME: the IDR access unit, or its first slice; lossless frames are all intra
+    return frame.isKeyframe || frame.codec == static_cast<uint8_t>(VideoCodec::Lossless);
+}
+
+bool DecodeQueue::push(const ReceivedVideoFrame& frame) {
+    const bool independent = startsIndependentPicture(frame);
+    const bool pictureEnd = frame.endOfAccessUnit && !frame.isRepeat;
+
+    // After a chain was cut, everything up to the next keyframe references a lost picture
+    if (awaitingKeyframe_) {
+        if (!independent) {
+            if (pictureEnd) skippedResync_++;
+            return false;
+        }
+        awaitingKeyframe_ = false;
+    }
+
+    if (frames_.size() >= capacity_) {
+        // A repeat marker carries no picture: losing it only holds the last frame
+        if (frame.isRepeat) {
+            droppedOverload_++;
+            return false;
+        }
+
+        if (independent) {
+            // A new keyframe makes everything still queued obsolete
+            skipFront(frames_.size());
+            LOG_DEBUG("Decode queue full: skipped to incoming keyframe");
+        } else {
+            // Otherwise skip ahead to the newest queued keyframe, if there is one past the head
+            size_t keyframe = 0;
+            for (size_t i = frames_.size() - 1; i > 0 && keyframe == 0; i--) {
+                if (startsIndependentPicture(frames_[i])) keyframe = i;
+            }
+            if (keyframe == 0) {
+                // No keyframe to resume from: drop this picture (and its queued
+                // slices), then its dependants. What is queued still decodes.
+                while (!frames_.empty() && !frames_.back().endOfAccessUnit) {
+                    frames_.pop_back();
+                }
+                droppedOverload_++;
+                awaitingKeyframe_ = true;
+                LOG_DEBUG("Decode queue full: waiting for the next keyframe");
+                return false;
+            }
+            skipFront(keyframe);
+            Logger::instance().debugf("Decode queue full: skipped %zu queued entries to a keyframe", keyframe);
+        }
+    }
+
+    frames_.push_back(frame);
+    return true;
+}
+
+ReceivedVideoFrame DecodeQueue::pop() {
+    ReceivedVideoFrame frame = std::move(frames_.front());
+    frames_.pop_front();
+    return frame;
+}
+
+void DecodeQueue::skipFront(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const auto& queued = frames_[i];
+        if (queued.endOfAccessUnit && !queued.isRepeat) {
+            skippedResync_++;
+        }
+    }
+    frames_.erase(frames_.begin(), frames_.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+} // namespace ndi_bridge
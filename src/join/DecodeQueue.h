@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * DecodeQueue.h - Join decode queue with a keyframe-aware overload policy
+ *
+ * Received video waits here for the decode thread. When the queue is full,
+ * whole dependency chains go, never a picture a later one references:
+ *   1. an incoming keyframe replaces everything queued;
+ *   2. otherwise the queue skips ahead to its newest queued keyframe;
+ *   3. otherwise the incoming picture is dropped, with its slices already
+ *      queued, and so is every picture after it until the next keyframe.
+ * Cuts land on access unit boundaries: the slice units of one picture are
+ * kept or dropped together.
+ *
+ * Not thread-safe (JoinMode holds its queue mutex); the counters can be
+ * read from any thread.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "../network/NetworkReceiver.h"
+
+namespace ndi_bridge {
+
+class DecodeQueue {
+public:
+    explicit DecodeQueue(size_t capacity) : capacity_(capacity) {}
+
+    // Non-copyable
+    DecodeQueue(const DecodeQueue&) = delete;
+    DecodeQueue& operator=(const DecodeQueue&) = delete;
+
+    /**
+     * Queue a received unit, applying the overload policy
+     * @return false if the unit was dropped
+     */
+    bool push(const ReceivedVideoFrame& frame);
+
+    /**
+     * Take the oldest unit (queue must not be empty)
+     */
+    ReceivedVideoFrame pop();
+
+    bool empty() const { return frames_.empty(); }
+    size_t size() const { return frames_.size(); }
+    const ReceivedVideoFrame& operator[](size_t index) const { return frames_[index]; }
+
+    /**
+     * A chain was cut: pictures are refused until the next keyframe
+     */
+    bool awaitingKeyframe() const { return awaitingKeyframe_; }
+
+    /**
+     * First (or only) unit of a picture that needs no earlier picture
+     */
+    static bool startsIndependentPicture(const ReceivedVideoFrame& frame);
+
+    /**
+     * Counters, in pictures (repeat markers included in droppedOverload only)
+     */
+    struct Stats {
+        uint64_t droppedOverload = 0;   // Refused with the queue full
+        uint64_t skippedResync = 0;     // Discarded to resume at a keyframe
+    };
+    Stats getStats() const {
+        return Stats{droppedOverload_.load(), skippedResync_.load()};
+    }
+
+private:
+    void skipFront(size_t count);
+
+    size_t capacity_;
+    std::deque<ReceivedVideoFrame> frames_;
+    bool awaitingKeyframe_ = false;
+    std::atomic<uint64_t> droppedOverload_{0};
+    std::atomic<uint64_t> skippedResync_{0};
+};
+
+} // namespace ndi_bridge
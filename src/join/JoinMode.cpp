@@ -8,6 +8,7 @@
 #include "../common/Logger.h"
 #include "../common/Protocol.h"
 
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 
@@ -35,21 +36,36 @@ int JoinMode::start(std::atomic<bool>& running) {
     log.info("═══════════════════════════════════════════════════════");
     log.info("Starting JOIN MODE (Receiver)");
     log.successf("Listen port: %u", config_.listenPort);
-    log.successf("NDI output: '%s'", config_.ndiOutputName.c_str());
+    if (!config_.multicastGroup.empty()) {
+        log.successf("Multicast group: %s%s%s", config_.multicastGroup.c_str(),
+                     config_.multicastSource.empty() ? "" : " from ",
+                     config_.multicastSource.c_str());
+    }
+    log.successf("NDI output: '%s' (%s)", config_.ndiOutputName.c_str(),
+                 config_.outputFormat == OutputPixelFormat::I420 ? "I420" :
+                 config_.outputFormat == OutputPixelFormat::NV12 ? "NV12" : "UYVY");
+    if (config_.rendition > 0) {
+        log.successf("Simulcast rendition: %d", config_.rendition);
+    }
     if (config_.bufferMs > 0) {
         log.successf("Buffer: %d ms delay", config_.bufferMs);
     } else {
         log.info("Buffer: disabled (real-time)");
     }
+    if (!config_.rendezvousKey.empty()) {
+        log.successf("Rendezvous: session '%s' via relay %s:%u",
+                     config_.rendezvousKey.c_str(), config_.relayHost.c_str(), config_.relayPort);
+    }
     log.info("═══════════════════════════════════════════════════════");
 
     // Step 1: Initialize decoder
-    log.info("Step 1/3: Initializing H.264 decoder...");
+    log.info("Step 1/3: Initializing video decoder (H.264 until the stream says otherwise)...");
     decoder_ = std::make_unique<VideoDecoder>();
 
     VideoDecoderConfig decoderConfig;
-    decoderConfig.outputFormat = OutputPixelFormat::UYVY;
+    decoderConfig.outputFormat = config_.outputFormat;
     decoderConfig.useHardwareAccel = true;
+    decoderConfig.threads = config_.decodeThreads;
     if (!decoder_->configure(decoderConfig)) {
         LOG_ERROR("Failed to configure video decoder");
         return 1;
@@ -62,6 +78,16 @@ int JoinMode::start(std::atomic<bool>& running) {
         Logger::instance().errorf("Decoder error: %s", error.c_str());
     });
 
+    // Frames in flight: one decoding, one in NDI, one spare, plus the playback
+    // buffer (sized for 60 fps; past that, frames fall back to a copy)
+    FrameBufferPoolConfig poolConfig;
+    poolConfig.bufferCount = 3 + static_cast<size_t>(std::max(config_.bufferMs, 0)) * 60 / 1000;
+    framePool_ = std::make_unique<FrameBufferPool>(poolConfig);
+    decoder_->setOutputBuffer([this](size_t size) {
+        return framePool_->acquire(size);
+    });
+
+    decodeThreads_ = decoder_->threadCount();
     LOG_SUCCESS("Decoder ready (waiting for SPS/PPS)");
 
     // Start async decode thread
@@ -88,6 +114,12 @@ int JoinMode::start(std::atomic<bool>& running) {
     log.info("Step 3/3: Starting network listener...");
     NetworkReceiverConfig recvConfig;
     recvConfig.port = config_.listenPort;
+    recvConfig.multicastGroup = config_.multicastGroup;
+    recvConfig.multicastSource = config_.multicastSource;
+    recvConfig.multicastInterface = config_.multicastInterface;
+    recvConfig.reportIntervalMs = config_.reportIntervalMs;
+    recvConfig.sourceId = static_cast<uint8_t>(config_.rendition);
+    recvConfig.partialFrames = config_.partialFrames;
 
     networkReceiver_ = std::make_unique<NetworkReceiver>(recvConfig);
 
@@ -107,6 +139,11 @@ int JoinMode::start(std::atomic<bool>& running) {
         return 1;
     }
 
+    // Register with the relay from the listening socket (relay learns our NAT mapping)
+    if (!config_.rendezvousKey.empty()) {
+        sendRendezvousKeepalive();
+    }
+
     // Start buffer thread if buffering enabled
     if (config_.bufferMs > 0) {
         bufferRunning_ = true;
@@ -125,9 +162,19 @@ int JoinMode::start(std::atomic<bool>& running) {
     log.info("Press Ctrl+C to stop...");
 
     // Main loop - just wait for shutdown signal
+    auto lastKeepalive = std::chrono::steady_clock::now();
     while (running && running_) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
+        // Keep the relay registration (and our NAT mapping) alive
+        if (!config_.rendezvousKey.empty()) {
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastKeepalive >= std::chrono::milliseconds(RENDEZVOUS_KEEPALIVE_MS)) {
+                lastKeepalive = now;
+                sendRendezvousKeepalive();
+            }
+        }
+
         // Periodic stats (every 5 seconds in verbose mode)
         static int counter = 0;
         if (++counter >= 50 && Logger::instance().isVerbose()) {
@@ -140,18 +187,19 @@ int JoinMode::start(std::atomic<bool>& running) {
             uint64_t avgExpect = videoReasmStats.framesDropped > 0 ? videoReasmStats.totalFragmentsExpectedBeforeDrop / videoReasmStats.framesDropped : 0;
             double avgCompletion = videoReasmStats.totalFragmentsExpectedBeforeDrop > 0
                 ? 100.0 * videoReasmStats.totalFragmentsReceivedBeforeDrop / videoReasmStats.totalFragmentsExpectedBeforeDrop : 0.0;
-            double decAvgMs = decodeCount_ > 0 ? (totalDecodeTimeUs_.load() / (double)decodeCount_.load()) / 1000.0 : 0.0;
-            double decMaxMs = maxDecodeTimeUs_.load() / 1000.0;
             int64_t latencyAvgMs = netStats.latencyCount > 0 ? netStats.latencySumMs / static_cast<int64_t>(netStats.latencyCount) : 0;
-            log.debugf("Stats: pkts=%lu recv=%lu dropped=%lu(avg %lu/%lu frags %.0f%%) decoded=%lu output=%lu qdrop=%lu decode_ms=%.1f/%.1f latency_ms=%ld audio=%lu time=%.1fs",
+            log.debugf("Stats: pkts=%lu recv=%lu dropped=%lu(avg %lu/%lu frags %.0f%%) partial=%lu concealed=%lu decoded=%lu output=%lu qdrop=%lu resync=%lu decode_ms=%.1f/%.1f/%.1f/%.1f latency_ms=%ld audio=%lu time=%.1fs",
                       netStats.packetsReceived,
                       stats.videoFramesReceived,
                       netStats.framesDropped,
                       avgRecv, avgExpect, avgCompletion,
+                      netStats.videoFramesPartial,
+                      stats.videoFramesConcealed,
                       stats.videoFramesDecoded,
                       stats.videoFramesOutput,
-                      videoFramesDroppedQueue_.load(),
-                      decAvgMs, decMaxMs,
+                      stats.videoFramesDroppedQueue,
+                      stats.videoFramesSkippedResync,
+                      stats.decodeAvgMs, stats.decodeP95Ms, stats.decodeP99Ms, stats.decodeMaxMs,
                       latencyAvgMs,
                       stats.audioFramesOutput,
                       stats.runTimeSeconds);
@@ -166,25 +214,36 @@ int JoinMode::start(std::atomic<bool>& running) {
     auto finalReasmStats = networkReceiver_ ? networkReceiver_->getVideoReassemblerStats() : FrameReassembler::Stats{};
     double finalAvgCompletion = finalReasmStats.totalFragmentsExpectedBeforeDrop > 0
         ? 100.0 * finalReasmStats.totalFragmentsReceivedBeforeDrop / finalReasmStats.totalFragmentsExpectedBeforeDrop : 0.0;
-    double finalDecAvgMs = decodeCount_ > 0 ? (totalDecodeTimeUs_.load() / (double)decodeCount_.load()) / 1000.0 : 0.0;
-    double finalDecMaxMs = maxDecodeTimeUs_.load() / 1000.0;
     int64_t finalLatencyAvgMs = finalNetStats.latencyCount > 0 ? finalNetStats.latencySumMs / static_cast<int64_t>(finalNetStats.latencyCount) : 0;
     log.success("═══════════════════════════════════════════════════════");
     log.success("JOIN MODE STOPPED");
     log.successf("Duration: %.1f seconds", finalStats.runTimeSeconds);
     log.successf("Packets: %lu received, %lu invalid",
                  finalNetStats.packetsReceived, finalNetStats.invalidPackets);
-    log.successf("Video: %lu received, %lu decoded, %lu output",
+    log.successf("Video: %lu received, %lu decoded, %lu output (%lu repeated)",
                  finalStats.videoFramesReceived,
                  finalStats.videoFramesDecoded,
-                 finalStats.videoFramesOutput);
-    log.successf("Dropped: %lu frames (avg completion %.0f%%, frags %lu/%lu) qdrop=%lu",
+                 finalStats.videoFramesOutput,
+                 finalStats.videoFramesRepeated);
+    log.successf("Dropped: %lu frames (avg completion %.0f%%, frags %lu/%lu) qdrop=%lu, %lu skipped to resync",
                  finalNetStats.framesDropped, finalAvgCompletion,
                  finalReasmStats.totalFragmentsReceivedBeforeDrop,
                  finalReasmStats.totalFragmentsExpectedBeforeDrop,
-                 videoFramesDroppedQueue_.load());
-    log.successf("Decode: avg=%.1fms max=%.1fms (%lu frames)",
-                 finalDecAvgMs, finalDecMaxMs, decodeCount_.load());
+                 finalStats.videoFramesDroppedQueue,
+                 finalStats.videoFramesSkippedResync);
+    if (config_.partialFrames) {
+        log.successf("Partial: %lu frames decoded from their complete slices, %lu concealed",
+                     finalNetStats.videoFramesPartial, finalStats.videoFramesConcealed);
+    }
+    if (framePool_) {
+        auto pool = framePool_->getStats();
+        log.successf("Frame pool: %.1f%% hits, %lu allocations, %lu exhausted (copied), peak %zu buffers",
+                     pool.hitRate() * 100.0, pool.allocations, pool.exhausted, pool.peakInUse);
+    }
+    log.successf("Decode: avg=%.1fms p50=%.1fms p95=%.1fms p99=%.1fms max=%.1fms (%lu frames, %d thread%s)",
+                 finalStats.decodeAvgMs, finalStats.decodeP50Ms, finalStats.decodeP95Ms,
+                 finalStats.decodeP99Ms, finalStats.decodeMaxMs, finalStats.decodedFrames,
+                 finalStats.decodeThreads, finalStats.decodeThreads > 1 ? "s" : "");
     if (finalNetStats.latencyCount > 0) {
         log.successf("Latency: avg=%ldms (%lu samples)",
                      finalLatencyAvgMs, finalNetStats.latencyCount);
@@ -246,7 +305,19 @@ JoinMode::Stats JoinMode::getStats() const {
     stats.audioFramesReceived = audioFramesReceived_;
     stats.videoFramesDecoded = videoFramesDecoded_;
     stats.videoFramesOutput = videoFramesOutput_;
+    stats.videoFramesRepeated = videoFramesRepeated_;
+    auto queueStats = decodeQueue_.getStats();
+    stats.videoFramesDroppedQueue = queueStats.droppedOverload;
+    stats.videoFramesSkippedResync = queueStats.skippedResync;
+    stats.videoFramesConcealed = videoFramesConcealed_;
     stats.audioFramesOutput = audioFramesOutput_;
+    stats.decodedFrames = decodeCount_;
+    stats.decodeAvgMs = stats.decodedFrames ? totalDecodeTimeUs_ / 1000.0 / stats.decodedFrames : 0.0;
+    stats.decodeP50Ms = decodeTimes_.percentileMs(0.50);
+    stats.decodeP95Ms = decodeTimes_.percentileMs(0.95);
+    stats.decodeP99Ms = decodeTimes_.percentileMs(0.99);
+    stats.decodeMaxMs = maxDecodeTimeUs_ / 1000.0;
+    stats.decodeThreads = decodeThreads_;
 
     if (running_) {
         auto now = std::chrono::steady_clock::now();
@@ -261,16 +332,16 @@ JoinMode::Stats JoinMode::getStats() const {
 // ============================================================================
 
 void JoinMode::onVideoFrame(const ReceivedVideoFrame& frame) {
-    videoFramesReceived_++;
+    if (frame.endOfAccessUnit) {
+        videoFramesReceived_++;
+    }
 
     // Push to async decode queue (non-blocking, ~1ms)
     {
         std::lock_guard<std::mutex> lock(decodeQueueMutex_);
-        if (decodeQueue_.size() >= MAX_DECODE_QUEUE) {
-            decodeQueue_.pop();
-            videoFramesDroppedQueue_++;
+        if (!decodeQueue_.push(frame)) {
+            return;
         }
-        decodeQueue_.push(frame);
     }
     decodeQueueCv_.notify_one();
 }
@@ -285,23 +356,153 @@ void JoinMode::decodeLoop() {
                 return !decodeQueue_.empty() || !decodeRunning_;
             });
             if (!decodeRunning_ && decodeQueue_.empty()) break;
-            frame = std::move(decodeQueue_.front());
-            decodeQueue_.pop();
+            frame = decodeQueue_.pop();
+        }
+        // A picture whose last slice never came still counts once
+        if (sliceDecodeUs_ > 0 && (!frame.isSlice || frame.timestamp != sliceTimestamp_)) {
+            recordDecodeTimeUs(sliceDecodeUs_);
+            sliceDecodeUs_ = 0;
+        }
+        if (frame.isRepeat) {
+            repeatFrame(frame);
+            continue;
+        }
+        if (frame.codec == static_cast<uint8_t>(VideoCodec::Lossless)) {
+            decodeLossless(frame);
+            continue;
+        }
+        // The header names the codec: reopen the decoder when the host's differs
+        if (decoder_ && frame.codec != static_cast<uint8_t>(decoder_->getConfig().codec)) {
+            if (frame.codec >= VIDEO_CODEC_COUNT) {
+                Logger::instance().debugf("Dropping video with unknown codec id %u", frame.codec);
+                continue;
+            }
+            VideoDecoderConfig decoderConfig = decoder_->getConfig();
+            decoderConfig.codec = static_cast<VideoCodec>(frame.codec);
+            Logger::instance().infof("Stream codec: %s", Protocol::codecName(decoderConfig.codec));
+            if (!decoder_->configure(decoderConfig)) {
+                LOG_ERROR("Failed to configure video decoder");
+            }
+            decodeThreads_ = decoder_->threadCount();
         }
         if (decoder_) {
             auto t0 = std::chrono::steady_clock::now();
-            decoder_->decode(frame.data.data(), frame.data.size(), frame.timestamp);
-            auto t1 = std::chrono::steady_clock::now();
-            uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
-            totalDecodeTimeUs_ += us;
-            decodeCount_++;
-            uint64_t prevMax = maxDecodeTimeUs_.load();
-            while (us > prevMax && !maxDecodeTimeUs_.compare_exchange_weak(prevMax, us)) {}
+            // The decoder takes the reassembled buffer (no copy into the packet)
+            if (frame.isSlice) {
+                decoder_->decodeSlice(std::move(frame.data), frame.timestamp);
+                // Timing is per picture: add up its slices until the end of the access unit
+                sliceDecodeUs_ += elapsedUs(t0);
+                sliceTimestamp_ = frame.timestamp;
+                if (frame.endOfAccessUnit) {
+                    recordDecodeTimeUs(sliceDecodeUs_);
+                    sliceDecodeUs_ = 0;
+                }
+            } else {
+                recordDecodeTime(t0);
+            }
         }
     }
     LOG_DEBUG("Decode thread stopped");
 }
 
+void JoinMode::decodeLossless(const ReceivedVideoFrame& frame) {
+    auto info = LosslessCodec::parseHeader(frame.data.data(), frame.data.size());
+    if (!info) {
+        LOG_DEBUG("Dropping malformed lossless frame");
+        return;
+    }
+    if (!lossless_) {
+        LosslessCodecConfig codecConfig;
+        codecConfig.threads = config_.decodeThreads;
+        lossless_ = std::make_unique<LosslessCodec>(codecConfig);
+        decodeThreads_ = lossless_->threadCount();
+        Logger::instance().infof("Stream codec: lossless UYVY %dx%d (%d slice thread(s))",
+                                  info->width, info->height, lossless_->threadCount());
+    }
+
+    const int stride = info->width * 2;
+    const size_t size = static_cast<size_t>(stride) * info->height;
+    auto t0 = std::chrono::steady_clock::now();
+    bool ok;
+    if (config_.bufferMs > 0 || !ndiSender_ || !ndiSender_->isRunning()) {
+        // Delayed playback: decompress into a pool buffer the playback queue keeps
+        std::shared_ptr<uint8_t> buffer = framePool_->acquire(size);
+        uint8_t* out = buffer.get();
+        if (!out) {
+            losslessFrame_.data.resize(size);
+            out = losslessFrame_.data.data();
+        }
+        ok = lossless_->decode(frame.data.data(), frame.data.size(), out, stride);
+        if (ok) {
+            losslessFrame_.width = info->width;
+            losslessFrame_.height = info->height;
+            losslessFrame_.stride = stride;
+            losslessFrame_.timestamp = frame.timestamp;
+            losslessFrame_.format = OutputPixelFormat::UYVY;
+            losslessFrame_.buffer = std::move(buffer);
+            onDecodedFrame(losslessFrame_);
+            losslessFrame_.buffer.reset();
+        }
+    } else {
+        // Real time: decompress into the buffer NDI sends from (no copy)
+        uint8_t* out = ndiSender_->acquireVideoBuffer(size);
+        ok = lossless_->decode(frame.data.data(), frame.data.size(), out, stride);
+        if (ok) {
+            videoFramesDecoded_++;
+            ndiSender_->sendAcquiredVideo(info->width, info->height, stride,
+                                          NDIVideoFormat::UYVY, frame.timestamp);
+            videoFramesOutput_++;
+        }
+    }
+    if (!ok) {
+        LOG_DEBUG("Dropping corrupt lossless frame");
+        return;
+    }
+
+    recordDecodeTime(t0);
+}
+
+uint64_t JoinMode::elapsedUs(std::chrono::steady_clock::time_point start) {
+    // Never 0: a zero total marks "no slice pending" in decodeLoop()
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return us > 0 ? us : 1;
+}
+
+void JoinMode::recordDecodeTime(std::chrono::steady_clock::time_point start) {
+    recordDecodeTimeUs(elapsedUs(start));
+}
+
+void JoinMode::recordDecodeTimeUs(uint64_t us) {
+    totalDecodeTimeUs_ += us;
+    decodeCount_++;
+    decodeTimes_.record(us);
+    uint64_t prevMax = maxDecodeTimeUs_.load();
+    while (us > prevMax && !maxDecodeTimeUs_.compare_exchange_weak(prevMax, us)) {}
+}
+
+void JoinMode::repeatFrame(const ReceivedVideoFrame& frame) {
+    if (!ndiSender_ || !ndiSender_->isRunning()) {
+        return;
+    }
+
+    if (config_.bufferMs > 0) {
+        // Buffered mode: an empty entry keeps its slot in the playout order
+        std::lock_guard<std::mutex> lock(videoBufferMutex_);
+
+        BufferedVideoFrame buffered;
+        buffered.width = 0;
+        buffered.height = 0;
+        buffered.stride = 0;
+        buffered.timestamp = frame.timestamp;
+        buffered.playTime = bufferPlayTime(frame.timestamp);
+        videoBuffer_.push(std::move(buffered));
+    } else if (ndiSender_->repeatLastVideo(frame.timestamp)) {
+        videoFramesRepeated_++;
+        videoFramesOutput_++;
+    }
+}
+
 void JoinMode::onAudioFrame(const ReceivedAudioFrame& frame) {
     audioFramesReceived_++;
 
@@ -324,20 +525,7 @@ void JoinMode::onAudioFrame(const ReceivedAudioFrame& frame) {
         buffered.numSamples = numSamples;
         buffered.timestamp = frame.timestamp;
 
-        // Calculate play time
-        if (!bufferSynced_ && firstFrameTimestamp_ == 0) {
-            firstFrameTimestamp_ = frame.timestamp;
-            bufferStartTime_ = static_cast<uint64_t>(
-                std::chrono::duration_cast<std::chrono::microseconds>(
-                    std::chrono::steady_clock::now().time_since_epoch()
-                ).count()
-            );
-            bufferSynced_ = true;
-        }
-
-        // Play time = buffer start + (frame timestamp - first frame timestamp) + buffer delay
-        uint64_t relativeTime = (frame.timestamp - firstFrameTimestamp_) / 10; // 100ns to us
-        buffered.playTime = bufferStartTime_ + relativeTime + (config_.bufferMs * 1000);
+        buffered.playTime = bufferPlayTime(frame.timestamp);
 
         audioBuffer_.push(buffered);
     } else {
@@ -351,6 +539,9 @@ void JoinMode::onAudioFrame(const ReceivedAudioFrame& frame) {
 
 void JoinMode::onDecodedFrame(const DecodedFrame& frame) {
     videoFramesDecoded_++;
+    if (frame.concealed) {
+        videoFramesConcealed_++;
+    }
 
     if (!ndiSender_ || !ndiSender_->isRunning()) {
         return;
@@ -359,21 +550,23 @@ void JoinMode::onDecodedFrame(const DecodedFrame& frame) {
     // Debug: log first frame data to verify content
     if (videoFramesDecoded_.load() <= 3) {
         // Check if data is all zeros
+        const uint8_t* px = frame.pixels();
+        const size_t size = static_cast<size_t>(frame.stride) * frame.height;
         bool allZero = true;
-        for (size_t i = 0; i < std::min(frame.data.size(), (size_t)100); i++) {
-            if (frame.data[i] != 0) { allZero = false; break; }
+        for (size_t i = 0; i < std::min(size, (size_t)100); i++) {
+            if (px[i] != 0) { allZero = false; break; }
         }
-        Logger::instance().debugf("Frame %lu: %dx%d stride=%d size=%zu fmt=%d first_bytes=[%02x %02x %02x %02x %02x %02x %02x %02x] allZero=%s",
+        Logger::instance().debugf("Frame %lu: %dx%d stride=%d size=%zu fmt=%d%s first_bytes=[%02x %02x %02x %02x %02x %02x %02x %02x] allZero=%s",
             videoFramesDecoded_.load(), frame.width, frame.height, frame.stride,
-            frame.data.size(), (int)frame.format,
-            frame.data.size() > 0 ? frame.data[0] : 0,
-            frame.data.size() > 1 ? frame.data[1] : 0,
-            frame.data.size() > 2 ? frame.data[2] : 0,
-            frame.data.size() > 3 ? frame.data[3] : 0,
-            frame.data.size() > 4 ? frame.data[4] : 0,
-            frame.data.size() > 5 ? frame.data[5] : 0,
-            frame.data.size() > 6 ? frame.data[6] : 0,
-            frame.data.size() > 7 ? frame.data[7] : 0,
+            size, (int)frame.format, frame.buffer ? " (pool buffer)" : "",
+            size > 0 ? px[0] : 0,
+            size > 1 ? px[1] : 0,
+            size > 2 ? px[2] : 0,
+            size > 3 ? px[3] : 0,
+            size > 4 ? px[4] : 0,
+            size > 5 ? px[5] : 0,
+            size > 6 ? px[6] : 0,
+            size > 7 ? px[7] : 0,
             allZero ? "YES" : "no");
     }
 
@@ -386,6 +579,9 @@ void JoinMode::onDecodedFrame(const DecodedFrame& frame) {
         case OutputPixelFormat::I420:
             ndiFormat = NDIVideoFormat::I420;
             break;
+        case OutputPixelFormat::NV12:
+            ndiFormat = NDIVideoFormat::NV12;
+            break;
         default:
             ndiFormat = NDIVideoFormat::BGRA;
             break;
@@ -396,37 +592,42 @@ void JoinMode::onDecodedFrame(const DecodedFrame& frame) {
         std::lock_guard<std::mutex> lock(videoBufferMutex_);
 
         BufferedVideoFrame buffered;
-        buffered.data = frame.data;
+        buffered.buffer = frame.buffer;     // Shared, not copied
+        if (!buffered.buffer) {
+            buffered.data = frame.data;
+        }
         buffered.width = frame.width;
         buffered.height = frame.height;
         buffered.stride = frame.stride;
         buffered.ndiFormat = ndiFormat;
         buffered.timestamp = frame.timestamp;
 
-        // Calculate play time
-        if (!bufferSynced_ && firstFrameTimestamp_ == 0) {
-            firstFrameTimestamp_ = frame.timestamp;
-            bufferStartTime_ = static_cast<uint64_t>(
-                std::chrono::duration_cast<std::chrono::microseconds>(
-                    std::chrono::steady_clock::now().time_since_epoch()
-                ).count()
-            );
-            bufferSynced_ = true;
-        }
-
-        // Play time = buffer start + (frame timestamp - first frame timestamp) + buffer delay
-        uint64_t relativeTime = (frame.timestamp - firstFrameTimestamp_) / 10; // 100ns to us
-        buffered.playTime = bufferStartTime_ + relativeTime + (config_.bufferMs * 1000);
+        buffered.playTime = bufferPlayTime(frame.timestamp);
 
-        videoBuffer_.push(buffered);
+        videoBuffer_.push(std::move(buffered));
     } else {
-        // Real-time mode: send directly to NDI
-        ndiSender_->sendVideo(frame.data.data(), frame.width, frame.height,
-                              frame.stride, ndiFormat, frame.timestamp);
+        // Real-time mode: send directly to NDI (pool buffers without a copy)
+        if (frame.buffer) {
+            ndiSender_->sendVideo(frame.buffer, frame.width, frame.height,
+                                  frame.stride, ndiFormat, frame.timestamp);
+        } else {
+            ndiSender_->sendVideo(frame.data.data(), frame.width, frame.height,
+                                  frame.stride, ndiFormat, frame.timestamp);
+        }
         videoFramesOutput_++;
     }
 }
 
+void JoinMode::sendRendezvousKeepalive() {
+    if (!networkReceiver_ || !networkReceiver_->isListening()) {
+        return;
+    }
+
+    uint8_t packet[RENDEZVOUS_PACKET_SIZE];
+    size_t size = Protocol::serializeRendezvous(RendezvousRole::Join, config_.rendezvousKey, packet);
+    networkReceiver_->sendTo(config_.relayHost, config_.relayPort, packet, size);
+}
+
 void JoinMode::onNetworkError(const std::string& error) {
     Logger::instance().errorf("Network error: %s", error.c_str());
 }
@@ -446,6 +647,23 @@ void JoinMode::bufferOutputLoop() {
     LOG_DEBUG("Buffer output thread stopped");
 }
 
+uint64_t JoinMode::bufferPlayTime(uint64_t timestamp) {
+    // The first frame (audio or video) anchors the timeline
+    if (!bufferSynced_ && firstFrameTimestamp_ == 0) {
+        firstFrameTimestamp_ = timestamp;
+        bufferStartTime_ = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()
+            ).count()
+        );
+        bufferSynced_ = true;
+    }
+
+    // Play time = buffer start + (frame timestamp - first frame timestamp) + buffer delay
+    uint64_t relativeTime = (timestamp - firstFrameTimestamp_) / 10; // 100ns to us
+    return bufferStartTime_ + relativeTime + (config_.bufferMs * 1000);
+}
+
 void JoinMode::processBufferedFrames() {
     uint64_t now = static_cast<uint64_t>(
         std::chrono::duration_cast<std::chrono::microseconds>(
@@ -461,9 +679,20 @@ void JoinMode::processBufferedFrames() {
             if (frame.playTime <= now) {
                 // Time to play this frame
                 if (ndiSender_ && ndiSender_->isRunning()) {
-                    ndiSender_->sendVideo(frame.data.data(), frame.width, frame.height,
-                                          frame.stride, frame.ndiFormat, frame.timestamp);
-                    videoFramesOutput_++;
+                    if (frame.isRepeat()) {
+                        if (ndiSender_->repeatLastVideo(frame.timestamp)) {
+                            videoFramesRepeated_++;
+                            videoFramesOutput_++;
+                        }
+                    } else if (frame.buffer) {
+                        ndiSender_->sendVideo(std::move(frame.buffer), frame.width, frame.height,
+                                              frame.stride, frame.ndiFormat, frame.timestamp);
+                        videoFramesOutput_++;
+                    } else {
+                        ndiSender_->sendVideo(frame.data.data(), frame.width, frame.height,
+                                              frame.stride, frame.ndiFormat, frame.timestamp);
+                        videoFramesOutput_++;
+                    }
                 }
                 videoBuffer_.pop();
             } else {
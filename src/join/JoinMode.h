@@ -19,8 +19,12 @@
 #include <queue>
 #include <thread>
 
+#include "../common/FrameBufferPool.h"
+#include "../common/LatencyHistogram.h"
 #include "../network/NetworkReceiver.h"
+#include "DecodeQueue.h"
 #include "../video/VideoDecoder.h"
+#include "../video/LosslessCodec.h"
 #include "../ndi/NDISender.h"
 
 namespace ndi_bridge {
@@ -34,19 +38,49 @@ struct JoinModeConfig {
     int outputWidth = 1920;
     int outputHeight = 1080;
     int bufferMs = 0;       // 0 = real-time, >0 = delay in ms
+
+    // Rendezvous relay (empty key = receive directly on listenPort)
+    std::string relayHost;
+    uint16_t relayPort = 5990;
+    std::string rendezvousKey;
+
+    // Multicast (empty group = unicast on listenPort)
+    std::string multicastGroup;
+    std::string multicastSource;    // Source-specific join when set
+    std::string multicastInterface;
+
+    // Receiver reports back to the host (adaptive bitrate), 0 = off
+    int reportIntervalMs = RECEIVER_REPORT_INTERVAL_MS;
+
+    // Simulcast rendition to decode (host sourceId, 0 = full resolution)
+    int rendition = 0;
+
+    // Software decode slice threads (0 = one per core, 1 = single-threaded)
+    int decodeThreads = 0;
+
+    // NDI pixel format (I420 / NV12: decoder planes as they are, no conversion;
+    // UYVY: SIMD re-interleave). 4:2:2 streams always go out as UYVY.
+    OutputPixelFormat outputFormat = OutputPixelFormat::UYVY;
+
+    // Decode the complete slices of frames that lost fragments (concealing
+    // the rest) instead of dropping them whole
+    bool partialFrames = true;
 };
 
 /**
  * Buffered video frame for delayed playback
  */
 struct BufferedVideoFrame {
-    std::vector<uint8_t> data;
+    std::vector<uint8_t> data;  // Copy when the frame pool ran dry (empty with no buffer = repeat)
+    std::shared_ptr<const uint8_t> buffer;  // Decoded frame, handed to NDI as is
     int width;
     int height;
     int stride;
     NDIVideoFormat ndiFormat = NDIVideoFormat::I420;
     uint64_t timestamp;
     uint64_t playTime;      // When to play (system clock)
+
+    bool isRepeat() const { return !buffer && data.empty(); }
 };
 
 /**
@@ -67,6 +101,20 @@ struct BufferedAudioFrame {
  * Pipeline:
  *   NetworkReceiver (video) → VideoDecoder → NDISender
  *   NetworkReceiver (audio) → NDISender (passthrough)
+ *
+ * Lossless streams skip VideoDecoder: LosslessCodec decompresses each
+ * frame straight into the NDI sender's output buffer.
+ *
+ * Decoded frames live in ref-counted pool buffers: the same buffer goes
+ * from the decoder through the playback buffer into NDI's async send and
+ * returns to the pool once NDI has released it (no per-frame copy).
+ *
+ * Repeat markers (host skipStatic) carry no picture: the NDI sender
+ * presents its last frame again under the marker's timestamp.
+ *
+ * When decoding falls behind, the decode queue drops whole dependency
+ * chains, never a lone P-frame: it skips ahead to the newest queued
+ * keyframe or, failing that, discards input until the next one.
  */
 class JoinMode {
 public:
@@ -107,8 +155,21 @@ public:
         uint64_t audioFramesReceived = 0;
         uint64_t videoFramesDecoded = 0;
         uint64_t videoFramesOutput = 0;
+        uint64_t videoFramesRepeated = 0;   // Repeat markers presented (static source)
+        uint64_t videoFramesDroppedQueue = 0;   // Decode queue full (overload)
+        uint64_t videoFramesSkippedResync = 0;  // Discarded until the next keyframe (references lost)
+        uint64_t videoFramesConcealed = 0;      // Decoded with missing slices concealed
         uint64_t audioFramesOutput = 0;
         double runTimeSeconds = 0.0;
+
+        // Decode time per frame (video decoder or lossless)
+        uint64_t decodedFrames = 0;
+        double decodeAvgMs = 0.0;
+        double decodeP50Ms = 0.0;
+        double decodeP95Ms = 0.0;
+        double decodeP99Ms = 0.0;
+        double decodeMaxMs = 0.0;
+        int decodeThreads = 1;
     };
     Stats getStats() const;
 
@@ -119,13 +180,22 @@ private:
     void onDecodedFrame(const DecodedFrame& frame);
     void onNetworkError(const std::string& error);
 
+    // Rendezvous registration / NAT keepalive (relay mode)
+    void sendRendezvousKeepalive();
+
     // Async decode
     void decodeLoop();
+    void decodeLossless(const ReceivedVideoFrame& frame);
+    void repeatFrame(const ReceivedVideoFrame& frame);
+    void recordDecodeTime(std::chrono::steady_clock::time_point start);
+    void recordDecodeTimeUs(uint64_t us);           // One picture (all of its slices)
+    static uint64_t elapsedUs(std::chrono::steady_clock::time_point start);
     static constexpr size_t MAX_DECODE_QUEUE = 90; // 3 seconds at 30fps
 
     // Buffer management
     void bufferOutputLoop();
     void processBufferedFrames();
+    uint64_t bufferPlayTime(uint64_t timestamp);
 
     // Configuration
     JoinModeConfig config_;
@@ -133,14 +203,17 @@ private:
     // Components
     std::unique_ptr<NetworkReceiver> networkReceiver_;
     std::unique_ptr<VideoDecoder> decoder_;
+    std::unique_ptr<LosslessCodec> lossless_;       // Created on the first lossless frame
+    DecodedFrame losslessFrame_;                    // Buffered mode only (decode thread)
+    std::unique_ptr<FrameBufferPool> framePool_;    // Decoded frames (decoder → buffer → NDI)
     std::unique_ptr<NDISender> ndiSender_;
 
     // State
     std::atomic<bool> running_{false};
     bool decoderConfigured_ = false;
 
-    // Async decode queue
-    std::queue<ReceivedVideoFrame> decodeQueue_;
+    // Async decode queue (overload drops cut it at access unit boundaries)
+    DecodeQueue decodeQueue_{MAX_DECODE_QUEUE};     // Under decodeQueueMutex_
     std::mutex decodeQueueMutex_;
     std::condition_variable decodeQueueCv_;
     std::thread decodeThread_;
@@ -163,13 +236,18 @@ private:
     std::atomic<uint64_t> audioFramesReceived_{0};
     std::atomic<uint64_t> videoFramesDecoded_{0};
     std::atomic<uint64_t> videoFramesOutput_{0};
+    std::atomic<uint64_t> videoFramesRepeated_{0};
     std::atomic<uint64_t> audioFramesOutput_{0};
 
     // Decode timing
     std::atomic<uint64_t> totalDecodeTimeUs_{0};
     std::atomic<uint64_t> maxDecodeTimeUs_{0};
     std::atomic<uint64_t> decodeCount_{0};
-    std::atomic<uint64_t> videoFramesDroppedQueue_{0};
+    LatencyHistogram decodeTimes_;                  // Percentiles (decode thread writes)
+    uint64_t sliceDecodeUs_ = 0;                    // Decode thread: current picture's slices so far
+    uint64_t sliceTimestamp_ = 0;                   // Decode thread: timestamp of that picture
+    std::atomic<int> decodeThreads_{1};
+    std::atomic<uint64_t> videoFramesConcealed_{0};
 };
 
 } // namespace ndi_bridge
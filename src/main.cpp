@@ -1,21 +1,25 @@
 /**
  * NDI Bridge Linux - Main Entry Point
  *
- * CLI interface for NDI Bridge with three modes:
+ * CLI interface for NDI Bridge with four modes:
  *   - discover: Find NDI sources on the network
  *   - host:     Capture NDI, encode, and stream over UDP
  *   - join:     Receive UDP stream, decode, and output as NDI
+ *   - relay:    Rendezvous relay pairing hosts and joins by session key
  *
  * Usage:
  *   ndi-bridge discover
- *   ndi-bridge host --auto [--target IP:PORT] [--bitrate MBPS]
- *   ndi-bridge join --name "Source Name" [--port PORT] [--buffer MS]
+ *   ndi-bridge host --auto [--target IP:PORT] [--bitrate MBPS] [--rendezvous KEY] [--simulcast WxH@MBPS]
+ *   ndi-bridge join --name "Source Name" [--port PORT] [--buffer MS] [--relay IP:PORT --rendezvous KEY]
+ *                   [--multicast GROUP [--multicast-source IP]] [--rendition N]
+ *   ndi-bridge relay [--port PORT] [--frame-level] [--mtu BYTES] [--fanout] [--rendition N]
  */
 
 #include <iostream>
 #include <string>
 #include <vector>
 #include <cstring>
+#include <cstdio>
 #include <csignal>
 #include <atomic>
 
@@ -30,6 +34,7 @@
 #include "common/Protocol.h"
 #include "host/HostMode.h"
 #include "join/JoinMode.h"
+#include "relay/RelayMode.h"
 #include "web/BridgeManager.h"
 #include "web/BridgeWebControl.h"
 
@@ -65,7 +70,7 @@ BOOL WINAPI consoleCtrlHandler(DWORD ctrlType) {
 
 // Command-line argument parser
 struct Config {
-    enum class Mode { None, Discover, Host, Join, WebUI };
+    enum class Mode { None, Discover, Host, Join, Relay, WebUI };
 
     Mode mode = Mode::None;
 
@@ -74,13 +79,50 @@ struct Config {
     bool autoSelect = false;    // Auto-select first source
     std::string targetHost = "127.0.0.1";
     uint16_t targetPort = 5990;
+    std::vector<NetworkTarget> targets;  // Every --target (multi-target when > 1)
     int bitrate = 8;            // Mbps
+    std::string codec = "h264"; // h264, hevc, av1, lossless
     size_t mtu = 1400;          // UDP MTU
+    bool chroma422 = false;     // Native 4:2:2 encode (x264 High 4:2:2)
+    bool zeroCopy = false;      // Encode from the NDI SDK buffer
+    bool hugePages = false;     // Capture pool on huge pages
+    int slices = 0;             // Slice streaming (0 = whole frames)
+    bool intraRefresh = false;  // Periodic intra refresh instead of IDR
+    bool adaptive = false;      // Bitrate follows receiver reports
+    int minBitrate = 1;         // Mbps (adaptive floor)
+    int maxBitrate = 0;         // Mbps (adaptive ceiling, 0 = --bitrate)
+    bool adaptivePreset = false;    // Step x264 presets with encode headroom
+    std::string maxPreset = "medium";
+    bool adaptiveFps = false;   // Allow half frame rate when ultrafast is not enough
+    bool skipStatic = false;    // Repeat markers for unchanged frames
+    std::vector<SimulcastRendition> simulcast;  // Every --simulcast (lower renditions)
 
     // Join mode options
     std::string outputName = "NDI Bridge";
     uint16_t listenPort = 5990;
     int bufferMs = 0;           // Buffer delay in ms
+    int decodeThreads = 0;      // Slice decode threads (0 = one per core)
+    std::string ndiFormat = "uyvy"; // NDI output pixel format (uyvy, i420, nv12)
+    bool partialFrames = true;  // Decode the complete slices of frames that lost fragments
+    std::string relayHost;      // Rendezvous relay (join side)
+    uint16_t relayPort = 5990;
+
+    // Rendezvous (host + join)
+    std::string rendezvousKey;  // Session key shared by host and join
+
+    // Simulcast rendition to receive (join: 0 by default, relay: all by default)
+    int rendition = -1;
+
+    // Multicast (host: TTL/interface/loopback, join: group/source/interface)
+    int multicastTtl = 1;
+    bool multicastLoopback = true;
+    std::string multicastGroup;
+    std::string multicastSource;
+    std::string multicastInterface;
+
+    // Relay mode options
+    bool frameLevel = false;    // Reassemble + re-fragment at --mtu
+    bool fanout = false;        // One host → many joins per session key
 
     // Web UI options
     int webPort = 8080;
@@ -102,19 +144,68 @@ void printUsage(const char* programName) {
         "  discover              Discover NDI sources on the network\n"
         "  host                  Capture NDI source and stream over UDP\n"
         "  join                  Receive UDP stream and output as NDI\n"
+        "  relay                 Rendezvous relay: pair host/join by session key\n"
         "  --web-ui              Launch web control interface\n"
         "\n"
         "Host mode options:\n"
         "  --source <name>       NDI source name to capture\n"
         "  --auto                Auto-select first available source\n"
         "  --target <ip:port>    Target address (default: 127.0.0.1:5990)\n"
+        "                        Repeat to send one encode to several sites;\n"
+        "                        append @<us> for per-target fragment pacing\n"
         "  --bitrate <mbps>      Video bitrate in Mbps (default: 8)\n"
-        "  --mtu <bytes>         UDP MTU size (default: 1400, use 1200 for VPN)\n"
+        "  --codec <name>        h264 (default), hevc (libx265) or av1 (SVT-AV1): software,\n"
+        "                        fewer bits for the same quality on limited WAN links;\n"
+        "                        lossless: UYVY frames, no encoder (~1 Gbps at 1080p60, 10 GbE LAN)\n"
+        "  --mtu <bytes>         UDP MTU size (default: 1400, use 1200 for VPN);\n"
+        "                        other than 1400 needs up-to-date joins / relays (older ones\n"
+        "                        assume 1400-byte fragments and corrupt the frames)\n"
+        "  --422                 Encode 4:2:2 (High 4:2:2, software x264, no chroma loss)\n"
+        "  --zero-copy           Encode straight from the NDI frame buffer (no capture copy)\n"
+        "  --huge-pages          Back the capture buffer pool with huge pages (Linux)\n"
+        "  --slices <n>          Encode n slices per frame, each sent and decoded as its own unit\n"
+        "                        (loss stays local; no earlier send: x264 returns them together)\n"
+        "  --intra-refresh       Rolling intra refresh instead of a keyframe every second (x264)\n"
+        "  --adaptive            Adapt bitrate to loss/delay reported by the join (starts at --bitrate)\n"
+        "  --min-bitrate <mbps>  Adaptive bitrate floor (default: 1)\n"
+        "  --max-bitrate <mbps>  Adaptive bitrate ceiling (default: --bitrate)\n"
+        "  --adaptive-preset     Step the x264 preset up/down with measured encode headroom\n"
+        "  --max-preset <name>   Slowest preset --adaptive-preset may use (default: medium)\n"
+        "  --adaptive-fps        With --adaptive-preset, halve the frame rate if ultrafast is too slow\n"
+        "  --skip-static         Do not convert / encode unchanged frames (slides, dashboards):\n"
+        "                        send a repeat marker, the join shows its last frame again\n"
+        "  --simulcast <WxH@mbps>  Also encode a lower rendition from the same capture\n"
+        "                        (repeatable; sourceId 1, 2, ... in order)\n"
+        "  --rendezvous <key>    Register with the relay at --target under this session key\n"
+        "  --multicast-ttl <n>   TTL when a target is a multicast group (default: 1)\n"
+        "  --multicast-if <ip>   Local interface address for multicast\n"
+        "  --no-multicast-loop   Do not loop multicast back to this host\n"
         "\n"
         "Join mode options:\n"
         "  --name <name>         NDI output source name (default: NDI Bridge)\n"
         "  --port <port>         UDP listen port (default: 5990)\n"
         "  --buffer <ms>         Playback buffer delay in ms (default: 0)\n"
+        "  --decode-threads <n>  Slice threads for software decode (default: 0 = one per core,\n"
+        "                        1 = single-threaded); no added latency\n"
+        "  --ndi-format <fmt>    NDI pixel format: uyvy (default), i420 or nv12 (4:2:0 decoder\n"
+        "                        output handed to NDI without conversion)\n"
+        "  --no-partial-frames   Drop frames that lost fragments instead of decoding their\n"
+        "                        complete slices and concealing the rest\n"
+        "  --relay <ip:port>     Rendezvous relay address (with --rendezvous)\n"
+        "  --rendezvous <key>    Session key to join on the relay\n"
+        "  --multicast <group>   Join an IPv4 multicast group on --port\n"
+        "  --multicast-source <ip>  Source-specific join (SSM)\n"
+        "  --multicast-if <ip>   Local interface address to join on\n"
+        "  --rendition <n>       Simulcast rendition to decode (default: 0 = full resolution)\n"
+        "\n"
+        "Relay mode options:\n"
+        "  --port <port>         UDP listen port (default: 5990)\n"
+        "  --frame-level         Reassemble frames, re-fragment, per-frame stats\n"
+        "  --mtu <bytes>         Outbound MTU (implies --frame-level if not 1400;\n"
+        "                        joins must be up to date, as with host --mtu)\n"
+        "  --fanout              Serve one host to many joins per session key\n"
+        "  --rendition <n>       Forward only this simulcast rendition\n"
+        "                        (default: all, or 0 with --frame-level / --fanout)\n"
         "\n"
         "Web UI options:\n"
         "  --web-port <port>     HTTP port for web UI (default: 8080)\n"
@@ -128,7 +219,19 @@ void printUsage(const char* programName) {
         "  " << programName << " discover\n"
         "  " << programName << " host --auto\n"
         "  " << programName << " host --source 'OBS (Camera)' --target 192.168.1.100:5990\n"
+        "  " << programName << " host --auto --target 10.0.0.2:5990 --target 10.0.1.2:5990@200\n"
         "  " << programName << " join --name 'Remote Camera' --port 5990\n"
+        "  " << programName << " host --auto --target 239.10.0.1:5990 --multicast-ttl 4\n"
+        "  " << programName << " join --name 'Plateau' --port 5990 --multicast 239.10.0.1\n"
+        "  " << programName << " relay --port 5990\n"
+        "  " << programName << " relay --port 5990 --mtu 1200\n"
+        "  " << programName << " relay --port 5990 --fanout\n"
+        "  " << programName << " host --auto --target 54.93.225.67:5990 --rendezvous studio-a\n"
+        "  " << programName << " join --name 'Studio A' --relay 54.93.225.67:5990 --rendezvous studio-a\n"
+        "  " << programName << " host --auto --target 54.93.225.67:5990 --codec hevc --bitrate 4\n"
+        "  " << programName << " host --auto --target 10.0.0.2:5990 --codec lossless\n"
+        "  " << programName << " host --auto --bitrate 8 --simulcast 1280x720@3 --simulcast 640x360@0.8\n"
+        "  " << programName << " join --name 'Preview' --port 5990 --rendition 2\n"
         "  " << programName << " --web-ui\n"
         "  " << programName << " --web-ui --web-port 9090\n"
         "\n";
@@ -147,6 +250,8 @@ Config parseArgs(int argc, char* argv[]) {
             config.mode = Config::Mode::Host;
         } else if (arg == "join") {
             config.mode = Config::Mode::Join;
+        } else if (arg == "relay") {
+            config.mode = Config::Mode::Relay;
         } else if (arg == "--web-ui") {
             config.mode = Config::Mode::WebUI;
         } else if (arg == "--web-port" && i + 1 < argc) {
@@ -158,7 +263,14 @@ Config parseArgs(int argc, char* argv[]) {
         } else if (arg == "--auto") {
             config.autoSelect = true;
         } else if (arg == "--target" && i + 1 < argc) {
+            // ip[:port][@pacingUs], repeatable
             std::string target = argv[++i];
+            NetworkTarget t;
+            size_t atPos = target.find('@');
+            if (atPos != std::string::npos) {
+                t.pacingDelayUs = std::stoi(target.substr(atPos + 1));
+                target = target.substr(0, atPos);
+            }
             size_t colonPos = target.rfind(':');
             if (colonPos != std::string::npos) {
                 config.targetHost = target.substr(0, colonPos);
@@ -166,10 +278,52 @@ Config parseArgs(int argc, char* argv[]) {
             } else {
                 config.targetHost = target;
             }
+            t.host = config.targetHost;
+            t.port = config.targetPort;
+            config.targets.push_back(t);
         } else if (arg == "--bitrate" && i + 1 < argc) {
             config.bitrate = std::stoi(argv[++i]);
+        } else if (arg == "--codec" && i + 1 < argc) {
+            config.codec = argv[++i];
         } else if (arg == "--mtu" && i + 1 < argc) {
             config.mtu = static_cast<size_t>(std::stoi(argv[++i]));
+        } else if (arg == "--422") {
+            config.chroma422 = true;
+        } else if (arg == "--zero-copy") {
+            config.zeroCopy = true;
+        } else if (arg == "--huge-pages") {
+            config.hugePages = true;
+        } else if (arg == "--slices" && i + 1 < argc) {
+            config.slices = std::stoi(argv[++i]);
+        } else if (arg == "--intra-refresh") {
+            config.intraRefresh = true;
+        } else if (arg == "--adaptive") {
+            config.adaptive = true;
+        } else if (arg == "--min-bitrate" && i + 1 < argc) {
+            config.minBitrate = std::stoi(argv[++i]);
+        } else if (arg == "--max-bitrate" && i + 1 < argc) {
+            config.maxBitrate = std::stoi(argv[++i]);
+        } else if (arg == "--adaptive-preset") {
+            config.adaptivePreset = true;
+        } else if (arg == "--max-preset" && i + 1 < argc) {
+            config.maxPreset = argv[++i];
+        } else if (arg == "--adaptive-fps") {
+            config.adaptiveFps = true;
+        } else if (arg == "--skip-static") {
+            config.skipStatic = true;
+        } else if (arg == "--simulcast" && i + 1 < argc) {
+            // WxH@mbps, repeatable (malformed → zero size, rejected in runHost)
+            SimulcastRendition rendition;
+            int width = 0, height = 0;
+            double mbps = 0.0;
+            if (std::sscanf(argv[++i], "%dx%d@%lf", &width, &height, &mbps) == 3 && mbps > 0.0) {
+                rendition.width = width;
+                rendition.height = height;
+                rendition.bitrateKbps = static_cast<int>(mbps * 1000.0);
+            } else {
+                rendition.width = rendition.height = 0;
+            }
+            config.simulcast.push_back(rendition);
         }
         // Join options
         else if (arg == "--name" && i + 1 < argc) {
@@ -178,6 +332,47 @@ Config parseArgs(int argc, char* argv[]) {
             config.listenPort = static_cast<uint16_t>(std::stoi(argv[++i]));
         } else if (arg == "--buffer" && i + 1 < argc) {
             config.bufferMs = std::stoi(argv[++i]);
+        } else if (arg == "--decode-threads" && i + 1 < argc) {
+            config.decodeThreads = std::stoi(argv[++i]);
+        } else if (arg == "--ndi-format" && i + 1 < argc) {
+            config.ndiFormat = argv[++i];
+        } else if (arg == "--no-partial-frames") {
+            config.partialFrames = false;
+        } else if (arg == "--relay" && i + 1 < argc) {
+            std::string relay = argv[++i];
+            size_t colonPos = relay.rfind(':');
+            if (colonPos != std::string::npos) {
+                config.relayHost = relay.substr(0, colonPos);
+                config.relayPort = static_cast<uint16_t>(std::stoi(relay.substr(colonPos + 1)));
+            } else {
+                config.relayHost = relay;
+            }
+        }
+        // Rendezvous options
+        else if (arg == "--rendezvous" && i + 1 < argc) {
+            config.rendezvousKey = argv[++i];
+        }
+        // Simulcast options (join + relay)
+        else if (arg == "--rendition" && i + 1 < argc) {
+            config.rendition = std::stoi(argv[++i]);
+        }
+        // Multicast options
+        else if (arg == "--multicast" && i + 1 < argc) {
+            config.multicastGroup = argv[++i];
+        } else if (arg == "--multicast-source" && i + 1 < argc) {
+            config.multicastSource = argv[++i];
+        } else if (arg == "--multicast-if" && i + 1 < argc) {
+            config.multicastInterface = argv[++i];
+        } else if (arg == "--multicast-ttl" && i + 1 < argc) {
+            config.multicastTtl = std::stoi(argv[++i]);
+        } else if (arg == "--no-multicast-loop") {
+            config.multicastLoopback = false;
+        }
+        // Relay options
+        else if (arg == "--frame-level") {
+            config.frameLevel = true;
+        } else if (arg == "--fanout") {
+            config.fanout = true;
         }
         // Global options
         else if (arg == "--clean") {
@@ -254,10 +449,54 @@ int runHost(const Config& config) {
     HostModeConfig hostConfig;
     hostConfig.targetHost = config.targetHost;
     hostConfig.targetPort = config.targetPort;
+    hostConfig.targets = config.targets;
     hostConfig.bitrateMbps = config.bitrate;
+    auto codec = Protocol::parseCodec(config.codec);
+    if (!codec) {
+        Logger::instance().errorf("Unknown codec: %s (h264, hevc, av1, lossless)", config.codec.c_str());
+        return 1;
+    }
+    hostConfig.codec = *codec;
     hostConfig.mtu = config.mtu;
+    if (config.mtu != DEFAULT_MTU) {
+        // Receivers before payloadSize-based offsets place fragments at fixed 1400-MTU offsets
+        Logger::instance().infof("[WARNING] --mtu %zu: joins and relays must be up to date "
+                                 "(older ones only reassemble %zu-byte MTU streams)",
+                                 config.mtu, DEFAULT_MTU);
+    }
+    hostConfig.chroma422 = config.chroma422;
+    hostConfig.zeroCopyCapture = config.zeroCopy;
+    hostConfig.hugePages = config.hugePages;
+    hostConfig.slices = config.slices;
+    hostConfig.intraRefresh = config.intraRefresh;
+    hostConfig.adaptiveBitrate = config.adaptive;
+    hostConfig.minBitrateMbps = config.minBitrate;
+    hostConfig.maxBitrateMbps = config.maxBitrate;
+    hostConfig.adaptivePreset = config.adaptivePreset;
+    hostConfig.maxPreset = config.maxPreset;
+    hostConfig.adaptiveFrameRate = config.adaptiveFps;
+    hostConfig.skipStatic = config.skipStatic;
+    if (!EncoderLoadController::isPreset(config.maxPreset)) {
+        Logger::instance().errorf("Unknown x264 preset: %s", config.maxPreset.c_str());
+        return 1;
+    }
+    for (const auto& rendition : config.simulcast) {
+        if (rendition.width <= 0 || rendition.height <= 0) {
+            LOG_ERROR("--simulcast expects WxH@mbps (e.g. 1280x720@3)");
+            return 1;
+        }
+    }
+    if (config.simulcast.size() >= MAX_SOURCE_IDS) {
+        Logger::instance().errorf("At most %zu --simulcast renditions", MAX_SOURCE_IDS - 1);
+        return 1;
+    }
+    hostConfig.simulcast = config.simulcast;
     hostConfig.autoSelectFirstSource = config.autoSelect;
     hostConfig.sourceName = config.source;
+    hostConfig.rendezvousKey = config.rendezvousKey;
+    hostConfig.multicastTtl = config.multicastTtl;
+    hostConfig.multicastInterface = config.multicastInterface;
+    hostConfig.multicastLoopback = config.multicastLoopback;
 
     // Create and start host mode
     HostMode host(hostConfig);
@@ -349,12 +588,53 @@ int runJoin(const Config& config) {
     joinConfig.listenPort = config.listenPort;
     joinConfig.ndiOutputName = config.outputName;
     joinConfig.bufferMs = config.bufferMs;
+    joinConfig.decodeThreads = config.decodeThreads;
+    joinConfig.partialFrames = config.partialFrames;
+    joinConfig.relayHost = config.relayHost;
+    joinConfig.relayPort = config.relayPort;
+    joinConfig.rendezvousKey = config.rendezvousKey;
+    joinConfig.multicastGroup = config.multicastGroup;
+    joinConfig.multicastSource = config.multicastSource;
+    joinConfig.multicastInterface = config.multicastInterface;
+    joinConfig.rendition = config.rendition < 0 ? 0 : config.rendition;
+
+    if (!joinConfig.rendezvousKey.empty() && joinConfig.relayHost.empty()) {
+        LOG_ERROR("--rendezvous requires --relay <ip:port> in join mode");
+        return 1;
+    }
+    if (config.ndiFormat == "i420") {
+        joinConfig.outputFormat = OutputPixelFormat::I420;
+    } else if (config.ndiFormat == "nv12") {
+        joinConfig.outputFormat = OutputPixelFormat::NV12;
+    } else if (config.ndiFormat != "uyvy") {
+        Logger::instance().errorf("Unknown NDI format: %s (uyvy, i420, nv12)", config.ndiFormat.c_str());
+        return 1;
+    }
 
     // Create and start join mode
     JoinMode join(joinConfig);
     return join.start(g_running);
 }
 
+// Relay mode: rendezvous forwarding between hosts and joins (no NDI, no codec)
+int runRelay(const Config& config) {
+    RelayModeConfig relayConfig;
+    relayConfig.listenPort = config.listenPort;
+    relayConfig.outputMtu = config.mtu;
+    // Packet forwarding cannot change the MTU: re-fragmenting needs whole frames
+    relayConfig.frameLevel = config.frameLevel || config.mtu != DEFAULT_MTU;
+    if (config.mtu != DEFAULT_MTU) {
+        Logger::instance().infof("[WARNING] --mtu %zu: joins must be up to date "
+                                 "(older ones only reassemble %zu-byte MTU streams)",
+                                 config.mtu, DEFAULT_MTU);
+    }
+    relayConfig.fanout = config.fanout;
+    relayConfig.rendition = config.rendition;
+
+    RelayMode relay(relayConfig);
+    return relay.start(g_running);
+}
+
 int main(int argc, char* argv[]) {
     // Setup signal handlers
     std::signal(SIGINT, signalHandler);
@@ -389,6 +669,15 @@ int main(int argc, char* argv[]) {
         cleanOrphans();
     }
 
+    // Relay mode needs neither NDI nor FFmpeg
+    if (config.mode == Config::Mode::Relay) {
+        int result = runRelay(config);
+#ifdef _WIN32
+        ndi_bridge::WinSockInit::cleanup();
+#endif
+        return result;
+    }
+
     // Initialize NDI
     if (!initNDI()) {
         return 1;
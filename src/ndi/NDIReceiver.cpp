@@ -3,6 +3,7 @@
 
 #include <Processing.NDI.Lib.h>
 #include <cstring>
+#include <chrono>
 
 #ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
@@ -47,9 +48,18 @@ void NDIReceiver::destroyNDI() {
 
 void NDIReceiver::configure(const NDIReceiverConfig& config) {
     config_ = config;
-    Logger::instance().debugf("NDIReceiver configured: name=%s, BGRA=%s",
+
+    pool_.reset();
+    if (config_.poolBuffers > 0) {
+        FrameBufferPoolConfig poolConfig;
+        poolConfig.bufferCount = config_.poolBuffers;
+        poolConfig.hugePages = config_.hugePages;
+        pool_ = std::make_unique<FrameBufferPool>(poolConfig);
+    }
+    Logger::instance().debugf("NDIReceiver configured: name=%s, BGRA=%s, zero-copy=%s",
                               config.receiverName.c_str(),
-                              config.preferBGRA ? "yes" : "no");
+                              config.preferBGRA ? "yes" : "no",
+                              config.zeroCopy ? "yes" : "no");
 }
 
 std::vector<NDISource> NDIReceiver::discoverSources(int timeoutMs) {
@@ -178,7 +188,13 @@ void NDIReceiver::disconnect() {
     stopReceiving();
 
     if (receiver_) {
-        NDIlib_recv_destroy(static_cast<NDIlib_recv_instance_t>(receiver_));
+        // Zero-copy frames still held downstream point into this receiver
+        if (!waitFramesReleased(2000)) {
+            Logger::instance().errorf("%d zero-copy NDI frame(s) still held, leaking receiver",
+                                      framesInFlight());
+        } else {
+            NDIlib_recv_destroy(static_cast<NDIlib_recv_instance_t>(receiver_));
+        }
         receiver_ = nullptr;
     }
 
@@ -218,6 +234,21 @@ void NDIReceiver::startReceiving() {
     LOG_INFO("Started receiving NDI frames");
 }
 
+int NDIReceiver::framesInFlight() const {
+    std::lock_guard<std::mutex> lock(inFlight_->mutex);
+    return inFlight_->count;
+}
+
+FrameBufferPool::Stats NDIReceiver::getPoolStats() const {
+    return pool_ ? pool_->getStats() : FrameBufferPool::Stats{};
+}
+
+bool NDIReceiver::waitFramesReleased(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(inFlight_->mutex);
+    return inFlight_->released.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                        [this] { return inFlight_->count == 0; });
+}
+
 void NDIReceiver::stopReceiving() {
     if (!receiving_) {
         return;
@@ -375,19 +406,56 @@ void NDIReceiver::receiveLoop() {
                     frame.frameRateD = videoFrame.frame_rate_D;
                     frame.timestamp = videoFrame.timestamp;
 
-                    size_t dataSize = static_cast<size_t>(videoFrame.line_stride_in_bytes) *
-                                      static_cast<size_t>(videoFrame.yres);
-                    frame.data.resize(dataSize);
-                    std::memcpy(frame.data.data(), videoFrame.p_data, dataSize);
+                    // Zero-copy: reference the SDK buffer, freed by the last holder
+                    bool handedOff = false;
+                    if (config_.zeroCopy) {
+                        std::lock_guard<std::mutex> lock(inFlight_->mutex);
+                        if (inFlight_->count < config_.maxFramesInFlight) {
+                            inFlight_->count++;
+                            handedOff = true;
+                        }
+                    }
+
+                    if (handedOff) {
+                        auto state = inFlight_;
+                        void* recv = receiver_;
+                        NDIlib_video_frame_v2_t held = videoFrame;
+                        frame.buffer = std::shared_ptr<const uint8_t>(
+                            videoFrame.p_data,
+                            [state, recv, held](const uint8_t*) {
+                                NDIlib_recv_free_video_v2(
+                                    static_cast<NDIlib_recv_instance_t>(recv), &held);
+                                std::lock_guard<std::mutex> lock(state->mutex);
+                                state->count--;
+                                state->released.notify_all();
+                            });
+                        stats_.zeroCopyFrames++;
+                    } else {
+                        if (config_.zeroCopy) stats_.zeroCopyFallbacks++;
+                        size_t dataSize = static_cast<size_t>(videoFrame.line_stride_in_bytes) *
+                                          static_cast<size_t>(videoFrame.yres);
+                        std::shared_ptr<uint8_t> pooled = pool_ ? pool_->acquire(dataSize) : nullptr;
+                        if (pooled) {
+                            std::memcpy(pooled.get(), videoFrame.p_data, dataSize);
+                            frame.buffer = std::move(pooled);
+                        } else {
+                            frame.data.resize(dataSize);
+                            std::memcpy(frame.data.data(), videoFrame.p_data, dataSize);
+                        }
+                        NDIlib_recv_free_video_v2(
+                            static_cast<NDIlib_recv_instance_t>(receiver_),
+                            &videoFrame
+                        );
+                    }
 
                     onVideoFrame_(std::move(frame));
                     stats_.videoFramesReceived++;
+                } else {
+                    NDIlib_recv_free_video_v2(
+                        static_cast<NDIlib_recv_instance_t>(receiver_),
+                        &videoFrame
+                    );
                 }
-
-                NDIlib_recv_free_video_v2(
-                    static_cast<NDIlib_recv_instance_t>(receiver_),
-                    &videoFrame
-                );
                 break;
 
             case NDIlib_frame_type_audio:
@@ -15,6 +15,10 @@
 #include <memory>
 #include <atomic>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "../common/FrameBufferPool.h"
 
 namespace ndi_bridge {
 
@@ -28,6 +32,10 @@ struct NDISource {
 
 /**
  * NDI Video frame data
+ *
+ * Either owns a copy of the pixels (data) or holds a ref-counted buffer:
+ * the NDI SDK frame itself (zero-copy mode) or a FrameBufferPool buffer.
+ * The buffer goes back to the SDK / pool when the last handle goes away.
  */
 struct NDIVideoFrame {
     int width;
@@ -37,7 +45,10 @@ struct NDIVideoFrame {
     int frameRateN;         // Frame rate numerator
     int frameRateD;         // Frame rate denominator
     int64_t timestamp;      // Timestamp in 100ns intervals
-    std::vector<uint8_t> data;
+    std::vector<uint8_t> data;                  // Owned copy (empty when buffer is set)
+    std::shared_ptr<const uint8_t> buffer;      // NDI SDK frame or pool buffer
+
+    const uint8_t* pixels() const { return buffer ? buffer.get() : data.data(); }
 };
 
 /**
@@ -66,6 +77,15 @@ struct NDIReceiverConfig {
     std::string receiverName = "NDI Bridge Receiver";
     bool preferBGRA = true;     // true = BGRA, false = UYVY
     bool lowBandwidth = false;  // Use low bandwidth mode
+
+    // Zero-copy capture: hand out the SDK buffer instead of a copy. Frames
+    // beyond maxFramesInFlight (still held downstream) are copied as usual.
+    bool zeroCopy = false;
+    int maxFramesInFlight = 4;
+
+    // Copied frames go into a fixed pool of page-aligned buffers (0 = heap vectors)
+    size_t poolBuffers = 0;
+    bool hugePages = false;     // Back pool buffers with transparent huge pages (Linux)
 };
 
 /**
@@ -174,11 +194,31 @@ public:
         uint64_t videoFramesReceived = 0;
         uint64_t audioFramesReceived = 0;
         uint64_t droppedFrames = 0;
+        uint64_t zeroCopyFrames = 0;        // Delivered as SDK buffer references
+        uint64_t zeroCopyFallbacks = 0;     // Copied because maxFramesInFlight was reached
     };
     Stats getStats() const { return stats_; }
 
+    /**
+     * Zero-copy frames currently held downstream
+     */
+    int framesInFlight() const;
+
+    /**
+     * Frame buffer pool statistics (all zero when the pool is disabled)
+     */
+    FrameBufferPool::Stats getPoolStats() const;
+
 private:
+    // SDK frames handed out in zero-copy mode (shared with their release hooks)
+    struct InFlight {
+        std::mutex mutex;
+        std::condition_variable released;
+        int count = 0;
+    };
+
     void receiveLoop();
+    bool waitFramesReleased(int timeoutMs);
 
     NDIReceiverConfig config_;
     void* finder_ = nullptr;
@@ -199,6 +239,9 @@ private:
     // Statistics
     Stats stats_;
 
+    std::shared_ptr<InFlight> inFlight_ = std::make_shared<InFlight>();
+    std::unique_ptr<FrameBufferPool> pool_;
+
     // For source lookup
     void* currentSources_ = nullptr;
     int numSources_ = 0;
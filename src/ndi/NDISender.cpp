@@ -129,6 +129,8 @@ void NDISender::stop() {
         NDIlib_send_destroy(static_cast<NDIlib_send_instance_t>(sender_));
         sender_ = nullptr;
     }
+    heldVideo_.reset();     // Flushed: NDI no longer reads it
+    haveLastVideo_ = false;
 
     Logger::instance().successf("NDI sender stopped. Video: %lu, Audio: %lu",
                                  stats_.videoFramesSent, stats_.audioFramesSent);
@@ -140,6 +142,66 @@ bool NDISender::sendVideo(const uint8_t* data, int width, int height, int stride
         return false;
     }
 
+    // Copy data to our owned buffer (NDI async keeps reference until next call)
+    size_t dataSize;
+    if (format == NDIVideoFormat::I420 || format == NDIVideoFormat::NV12) {
+        // 4:2:0: luma plane + half as many bytes of chroma
+        dataSize = static_cast<size_t>(stride) * (height + (height + 1) / 2);
+    } else {
+        dataSize = static_cast<size_t>(stride) * height;
+    }
+    auto& buf = asyncVideoBuf_[currentBuf_];
+    buf.resize(dataSize);
+    std::memcpy(buf.data(), data, dataSize);
+
+    sendAsync(buf.data(), width, height, stride, format, timestamp);
+    currentBuf_ = 1 - currentBuf_;  // swap buffer
+    return true;
+}
+
+bool NDISender::sendVideo(std::shared_ptr<const uint8_t> buffer, int width, int height, int stride,
+                          NDIVideoFormat format, uint64_t timestamp) {
+    if (!running_ || !sender_ || !buffer) {
+        return false;
+    }
+
+    // NDI reads the caller's buffer; both owned buffers stay free
+    const uint8_t* data = buffer.get();
+    sendAsync(data, width, height, stride, format, timestamp, std::move(buffer));
+    return true;
+}
+
+uint8_t* NDISender::acquireVideoBuffer(size_t size) {
+    // The other buffer may still be in flight: only the current one is free
+    auto& buf = asyncVideoBuf_[currentBuf_];
+    buf.resize(size);
+    return buf.data();
+}
+
+bool NDISender::sendAcquiredVideo(int width, int height, int stride,
+                                  NDIVideoFormat format, uint64_t timestamp) {
+    if (!running_ || !sender_) {
+        return false;
+    }
+    sendAsync(asyncVideoBuf_[currentBuf_].data(), width, height, stride, format, timestamp);
+    currentBuf_ = 1 - currentBuf_;  // swap buffer
+    return true;
+}
+
+bool NDISender::repeatLastVideo(uint64_t timestamp) {
+    if (!running_ || !sender_ || !haveLastVideo_) {
+        return false;
+    }
+
+    // NDI still holds the last frame: resend it (and keep holding its reference)
+    sendAsync(lastVideo_.data, lastVideo_.width, lastVideo_.height,
+              lastVideo_.stride, lastVideo_.format, timestamp, heldVideo_);
+    return true;
+}
+
+void NDISender::sendAsync(const uint8_t* data, int width, int height, int stride,
+                          NDIVideoFormat format, uint64_t timestamp,
+                          std::shared_ptr<const uint8_t> hold) {
     // Detect frame rate from timestamps
     detectFrameRate(timestamp);
 
@@ -152,7 +214,7 @@ bool NDISender::sendVideo(const uint8_t* data, int width, int height, int stride
     videoFrame.picture_aspect_ratio = static_cast<float>(width) / static_cast<float>(height);
     videoFrame.frame_format_type = NDIlib_frame_format_type_progressive;
     videoFrame.timecode = NDIlib_send_timecode_synthesize;
-    videoFrame.p_data = const_cast<uint8_t*>(data);
+    videoFrame.p_data = const_cast<uint8_t*>(data);    // Read only
     videoFrame.line_stride_in_bytes = stride;
     videoFrame.p_metadata = nullptr;
     videoFrame.timestamp = static_cast<int64_t>(timestamp);
@@ -168,29 +230,18 @@ bool NDISender::sendVideo(const uint8_t* data, int width, int height, int stride
         case NDIVideoFormat::I420:
             videoFrame.FourCC = NDIlib_FourCC_video_type_I420;
             break;
+        case NDIVideoFormat::NV12:
+            videoFrame.FourCC = NDIlib_FourCC_video_type_NV12;
+            break;
     }
 
-    // Copy data to our owned buffer (NDI async keeps reference until next call)
-    auto& buf = asyncVideoBuf_[currentBuf_];
-    size_t dataSize;
-    if (videoFrame.FourCC == NDIlib_FourCC_video_type_BGRA) {
-        dataSize = static_cast<size_t>(stride) * height;
-    } else if (videoFrame.FourCC == NDIlib_FourCC_video_type_UYVY) {
-        dataSize = static_cast<size_t>(stride) * height;
-    } else {
-        // I420: Y + U + V
-        dataSize = static_cast<size_t>(width) * height * 3 / 2;
-    }
-    buf.resize(dataSize);
-    std::memcpy(buf.data(), data, dataSize);
-    videoFrame.p_data = buf.data();
-
     // Async send — non-blocking, NDI releases previous buffer
     NDIlib_send_send_video_async_v2(static_cast<NDIlib_send_instance_t>(sender_), &videoFrame);
-    currentBuf_ = 1 - currentBuf_;  // swap buffer
+    heldVideo_ = std::move(hold);   // NDI released the previous frame
 
+    lastVideo_ = LastVideo{data, width, height, stride, format};
+    haveLastVideo_ = true;
     stats_.videoFramesSent++;
-    return true;
 }
 
 bool NDISender::sendAudio(const uint8_t* data, size_t size, uint32_t sampleRate,
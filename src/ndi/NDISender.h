@@ -33,7 +33,8 @@ struct NDISenderConfig {
 enum class NDIVideoFormat {
     BGRA,       // 32-bit BGRA
     UYVY,       // 16-bit packed YUV 4:2:2
-    I420        // Planar YUV 4:2:0 (3 planes: Y, U, V)
+    I420,       // Planar YUV 4:2:0 (3 planes: Y, U, V; chroma stride = stride / 2)
+    NV12        // Semi-planar YUV 4:2:0 (Y, then interleaved UV at the same stride)
 };
 
 /**
@@ -103,6 +104,36 @@ public:
     bool sendVideo(const uint8_t* data, int width, int height, int stride,
                    NDIVideoFormat format, uint64_t timestamp);
 
+    /**
+     * Send a ref-counted frame without copying it
+     *
+     * The sender holds the reference while NDI reads the frame and drops it
+     * on the next async send (or stop()), when NDI releases the buffer.
+     */
+    bool sendVideo(std::shared_ptr<const uint8_t> buffer, int width, int height, int stride,
+                   NDIVideoFormat format, uint64_t timestamp);
+
+    /**
+     * Borrow the next async video buffer to render a frame into
+     *
+     * Lets a decoder write straight into the buffer NDI sends from, instead
+     * of sendVideo()'s copy. Valid until the next send on this sender.
+     * @param size Bytes the frame needs (stride * height for packed formats)
+     */
+    uint8_t* acquireVideoBuffer(size_t size);
+
+    /**
+     * Send the frame rendered into acquireVideoBuffer() (no copy)
+     */
+    bool sendAcquiredVideo(int width, int height, int stride,
+                           NDIVideoFormat format, uint64_t timestamp);
+
+    /**
+     * Send the last video frame again with a new timestamp (static content)
+     * @return false if nothing was sent yet
+     */
+    bool repeatLastVideo(uint64_t timestamp);
+
     /**
      * Send an audio frame
      * @param data PCM 32-bit float planar audio data
@@ -143,6 +174,9 @@ public:
 
 private:
     void detectFrameRate(uint64_t timestamp);
+    void sendAsync(const uint8_t* data, int width, int height, int stride,
+                   NDIVideoFormat format, uint64_t timestamp,
+                   std::shared_ptr<const uint8_t> hold = nullptr);
 
     std::string sourceName_;
     NDISenderConfig config_;
@@ -155,6 +189,20 @@ private:
     std::vector<uint8_t> asyncVideoBuf_[2];
     int currentBuf_ = 0;
 
+    // Ref-counted frame NDI is reading (sendVideo(buffer)), released on the next send
+    std::shared_ptr<const uint8_t> heldVideo_;
+
+    // Last frame sent (asyncVideoBuf_[1 - currentBuf_] or heldVideo_), for repeatLastVideo()
+    struct LastVideo {
+        const uint8_t* data = nullptr;
+        int width = 0;
+        int height = 0;
+        int stride = 0;
+        NDIVideoFormat format = NDIVideoFormat::UYVY;
+    };
+    LastVideo lastVideo_;
+    bool haveLastVideo_ = false;
+
     // Frame rate detection
     uint64_t lastTimestamp_ = 0;
     std::vector<double> frameIntervals_;
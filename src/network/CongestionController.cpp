@@ -0,0 +1,91 @@
+/**
+ * CongestionController.cpp - Receiver-report driven bitrate controller
+ */
+
+#include "network/CongestionController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ndi_bridge {
+
+CongestionController::CongestionController(const CongestionControllerConfig& config)
+    : config_(config)
+    , target_(0.0)
+    , applied_(0.0) {
+    config_.maxBitrate = std::max(config_.maxBitrate, config_.minBitrate);
+    reset(config_.startBitrate);
+}
+
+void CongestionController::reset(int bitrate) {
+    target_ = clamp(bitrate);
+    applied_ = target_;
+    holdReports_ = 0;
+}
+
+double CongestionController::clamp(double bitrate) const {
+    return std::min(std::max(bitrate, static_cast<double>(config_.minBitrate)),
+                    static_cast<double>(config_.maxBitrate));
+}
+
+bool CongestionController::onReport(const ReceiverReport& report) {
+    const double loss = report.lossFraction();
+    const double receiveRate = report.receiveRateKbps * 1000.0;
+    const double seconds = std::max(report.intervalMs, 1u) / 1000.0;
+
+    stats_.reports++;
+    stats_.lastLossFraction = loss;
+    stats_.lastDelayGradientMs = report.delayGradientUs / 1000.0;
+    stats_.lastReceiveRateKbps = report.receiveRateKbps;
+
+    if (loss > LOSS_BACKOFF) {
+        stats_.lastSignal = Signal::Loss;
+        stats_.lossBackoffs++;
+        target_ = clamp(target_ * (1.0 - 0.5 * loss));
+        holdReports_ = HOLD_REPORTS;
+    } else if (report.delayGradientUs > OVERUSE_GRADIENT_US) {
+        stats_.lastSignal = Signal::Overuse;
+        // Back off below what actually gets through, never above the current target
+        double backoff = receiveRate > 0.0 ? DELAY_BACKOFF * receiveRate : DELAY_BACKOFF * target_;
+        if (backoff < target_) {
+            stats_.delayBackoffs++;
+            target_ = clamp(backoff);
+        }
+        holdReports_ = HOLD_REPORTS;
+    } else {
+        stats_.lastSignal = report.delayGradientUs < -OVERUSE_GRADIENT_US ? Signal::Underuse
+                                                                          : Signal::Normal;
+        if (holdReports_ > 0) {
+            // Let the queue drain; underuse means it is draining already
+            holdReports_ = stats_.lastSignal == Signal::Underuse ? 0 : holdReports_ - 1;
+        } else if (loss < LOSS_CLEAN) {
+            double next = target_ * std::pow(1.0 + INCREASE_PER_SECOND, seconds);
+            if (receiveRate > 0.0) {
+                next = std::min(next, std::max(target_, MAX_OVER_RECEIVE * receiveRate));
+            }
+            next = clamp(next);
+            if (next > target_) {
+                stats_.increases++;
+                target_ = next;
+            }
+        }
+    }
+
+    if (std::fabs(target_ - applied_) >= RETUNE_THRESHOLD * applied_) {
+        applied_ = target_;
+        return true;
+    }
+    return false;
+}
+
+const char* CongestionController::signalName(Signal signal) {
+    switch (signal) {
+        case Signal::Normal: return "normal";
+        case Signal::Overuse: return "overuse";
+        case Signal::Underuse: return "underuse";
+        case Signal::Loss: return "loss";
+    }
+    return "?";
+}
+
+} // namespace ndi_bridge
@@ -0,0 +1,115 @@
+#pragma once
+
+/**
+ * CongestionController.h - Receiver-report driven bitrate controller
+ *
+ * Combines the two signals the join reports every RECEIVER_REPORT_INTERVAL_MS:
+ *
+ *   - delay gradient: a growing one-way delay means a queue is building on
+ *     the path (overuse) before anything is lost; back off to 85% of what
+ *     the receiver actually gets,
+ *   - loss: above 10% cut proportionally (rate * (1 - loss/2)), between 2%
+ *     and 10% hold, below 2% the path is clean.
+ *
+ * With neither signal the target grows 8% per second (multiplicative probe,
+ * capped at 1.5x the receive rate so an idle encoder cannot inflate it).
+ * After a back-off the target holds for a few reports to let queues drain.
+ * Same shape as WebRTC's GCC delay + loss controllers, without the
+ * Kalman/trendline filtering (reports are already interval averages).
+ */
+
+#include <cstdint>
+#include "../common/Protocol.h"
+
+namespace ndi_bridge {
+
+/**
+ * Controller bounds (bits per second)
+ */
+struct CongestionControllerConfig {
+    int minBitrate = 1000000;       // 1 Mbps
+    int maxBitrate = 20000000;      // 20 Mbps
+    int startBitrate = 8000000;     // Initial target
+};
+
+/**
+ * CongestionController - Turns receiver reports into a target bitrate
+ *
+ * Not thread-safe: feed it from one thread (HostMode's main loop).
+ */
+class CongestionController {
+public:
+    explicit CongestionController(const CongestionControllerConfig& config = CongestionControllerConfig());
+
+    /**
+     * Process one receiver report
+     * @return true if the target moved enough (>= 5%) to re-tune the encoder
+     */
+    bool onReport(const ReceiverReport& report);
+
+    /**
+     * Restart from a new target (manual bitrate change)
+     */
+    void reset(int bitrate);
+
+    /**
+     * Target encoder bitrate (bits/s)
+     */
+    int targetBitrate() const { return static_cast<int>(target_); }
+
+    /**
+     * Pacing rate for the sender: target with headroom for keyframe bursts
+     */
+    uint64_t pacingRate() const { return static_cast<uint64_t>(target_ * PACING_FACTOR); }
+
+    /**
+     * Pacing burst for the sender (bytes): about one keyframe, sent unpaced
+     */
+    size_t pacingBurstBytes() const { return static_cast<size_t>(target_ * PACING_BURST_SECONDS / 8.0); }
+
+    enum class Signal {
+        Normal,
+        Overuse,        // Delay growing: queue building on the path
+        Underuse,       // Delay shrinking: queue draining
+        Loss            // Loss above the back-off threshold
+    };
+
+    /**
+     * Get statistics
+     */
+    struct Stats {
+        uint64_t reports = 0;
+        uint64_t increases = 0;
+        uint64_t delayBackoffs = 0;
+        uint64_t lossBackoffs = 0;
+        double lastLossFraction = 0.0;
+        double lastDelayGradientMs = 0.0;
+        uint32_t lastReceiveRateKbps = 0;
+        Signal lastSignal = Signal::Normal;
+    };
+    Stats getStats() const { return stats_; }
+
+    static const char* signalName(Signal signal);
+
+private:
+    static constexpr double LOSS_BACKOFF = 0.10;        // Cut above 10% loss
+    static constexpr double LOSS_CLEAN = 0.02;          // Probe below 2% loss
+    static constexpr int32_t OVERUSE_GRADIENT_US = 4000;
+    static constexpr double DELAY_BACKOFF = 0.85;       // x receive rate
+    static constexpr double INCREASE_PER_SECOND = 0.08;
+    static constexpr double MAX_OVER_RECEIVE = 1.5;
+    static constexpr int HOLD_REPORTS = 3;              // After a back-off
+    static constexpr double PACING_FACTOR = 2.5;
+    static constexpr double PACING_BURST_SECONDS = 0.25;    // x target: a 1 s GOP's IDR
+    static constexpr double RETUNE_THRESHOLD = 0.05;
+
+    double clamp(double bitrate) const;
+
+    CongestionControllerConfig config_;
+    double target_;
+    double applied_;                // Last target reported as a change
+    int holdReports_ = 0;
+    Stats stats_;
+};
+
+} // namespace ndi_bridge
@@ -8,6 +8,7 @@ namespace ndi_bridge {
 NetworkReceiver::NetworkReceiver(const NetworkReceiverConfig& config)
     : config_(config)
 {
+    videoReassembler_.setPartialFrames(config_.partialFrames);
     LOG_DEBUG("NetworkReceiver initialized");
 }
 
@@ -27,6 +28,7 @@ bool NetworkReceiver::startListening(uint16_t port) {
     }
 
     config_.port = port;
+    report_ = ReportState{};
 
     Logger::instance().infof("Starting UDP listener on port %u...", port);
 
@@ -64,11 +66,17 @@ bool NetworkReceiver::startListening(uint16_t port) {
     Logger::instance().debugf("UDP recv buffer: requested=%dMB actual=%dMB",
         recvbuf / (1024*1024), actualBuf / (1024*1024));
 
-    // Bind to port
+    // Bind to port (POSIX: bind the group address so only that group's
+    // traffic reaches this socket; Windows only accepts INADDR_ANY)
     struct sockaddr_in addr{};
     addr.sin_family = AF_INET;
     addr.sin_port = htons(port);
     addr.sin_addr.s_addr = INADDR_ANY;
+#ifndef _WIN32
+    if (!config_.multicastGroup.empty()) {
+        inet_pton(AF_INET, config_.multicastGroup.c_str(), &addr.sin_addr);
+    }
+#endif
 
     if (bind(socket_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
         int err = platform_socket_errno();
@@ -81,6 +89,15 @@ bool NetworkReceiver::startListening(uint16_t port) {
         return false;
     }
 
+    if (!config_.multicastGroup.empty() && !joinMulticastGroup()) {
+        platform_close_socket(socket_);
+        socket_ = INVALID_SOCKET_VAL;
+        if (onError_) {
+            onError_("Failed to join multicast group " + config_.multicastGroup);
+        }
+        return false;
+    }
+
     // Start receive thread
     shouldStop_ = false;
     listening_ = true;
@@ -90,6 +107,68 @@ bool NetworkReceiver::startListening(uint16_t port) {
     return true;
 }
 
+bool NetworkReceiver::joinMulticastGroup() {
+    struct in_addr group{};
+    if (inet_pton(AF_INET, config_.multicastGroup.c_str(), &group) <= 0 ||
+        !IN_MULTICAST(ntohl(group.s_addr))) {
+        Logger::instance().errorf("Invalid multicast group: %s", config_.multicastGroup.c_str());
+        return false;
+    }
+
+    struct in_addr iface{};
+    iface.s_addr = INADDR_ANY;
+    if (!config_.multicastInterface.empty() &&
+        inet_pton(AF_INET, config_.multicastInterface.c_str(), &iface) <= 0) {
+        Logger::instance().errorf("Invalid multicast interface: %s",
+                                  config_.multicastInterface.c_str());
+        return false;
+    }
+
+    // Source-specific join: only packets from the expected sender reach us
+    if (!config_.multicastSource.empty()) {
+#ifdef IP_ADD_SOURCE_MEMBERSHIP
+        struct ip_mreq_source mreq{};
+        mreq.imr_multiaddr = group;
+        mreq.imr_interface = iface;
+        if (inet_pton(AF_INET, config_.multicastSource.c_str(), &mreq.imr_sourceaddr) <= 0) {
+            Logger::instance().errorf("Invalid multicast source: %s",
+                                      config_.multicastSource.c_str());
+            return false;
+        }
+        if (setsockopt(socket_, IPPROTO_IP, IP_ADD_SOURCE_MEMBERSHIP,
+                       reinterpret_cast<const char*>(&mreq), sizeof(mreq)) < 0) {
+            int err = platform_socket_errno();
+            Logger::instance().errorf("Failed to join %s from source %s: %s",
+                                      config_.multicastGroup.c_str(),
+                                      config_.multicastSource.c_str(),
+                                      platform_socket_strerror(err));
+            return false;
+        }
+        Logger::instance().successf("Joined multicast group %s (source %s)",
+                                    config_.multicastGroup.c_str(),
+                                    config_.multicastSource.c_str());
+        return true;
+#else
+        Logger::instance().infof("Source-specific multicast not supported here, joining %s for any source",
+                                 config_.multicastGroup.c_str());
+#endif
+    }
+
+    struct ip_mreq mreq{};
+    mreq.imr_multiaddr = group;
+    mreq.imr_interface = iface;
+    if (setsockopt(socket_, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+                   reinterpret_cast<const char*>(&mreq), sizeof(mreq)) < 0) {
+        int err = platform_socket_errno();
+        Logger::instance().errorf("Failed to join multicast group %s: %s",
+                                  config_.multicastGroup.c_str(), platform_socket_strerror(err));
+        return false;
+    }
+
+    Logger::instance().successf("Joined multicast group %s", config_.multicastGroup.c_str());
+    return true;
+}
+
 void NetworkReceiver::stop() {
     if (!listening_) {
         return;
@@ -150,6 +229,14 @@ void NetworkReceiver::receiveLoop() {
             break;
         }
 
+        // Receiver report due? (checked on timeouts too, the stream may have stalled)
+        if (config_.reportIntervalMs > 0 && report_.haveSource) {
+            auto now = std::chrono::steady_clock::now();
+            if (now - report_.lastSent >= std::chrono::milliseconds(config_.reportIntervalMs)) {
+                sendReport(now);
+            }
+        }
+
         if (ret == 0) {
             // Timeout, check shouldStop and continue
             continue;
@@ -179,6 +266,13 @@ void NetworkReceiver::receiveLoop() {
 
         if (received > 0) {
             uint64_t recvNs = Protocol::wallClockNs();
+            if (config_.reportIntervalMs > 0 && !report_.haveSource &&
+                Protocol::peekMagic(buffer.data(), static_cast<size_t>(received)) == PROTOCOL_MAGIC) {
+                // Reports go back to the stream's source (host, or the relay)
+                report_.source = senderAddr;
+                report_.haveSource = true;
+                report_.lastSent = std::chrono::steady_clock::now();
+            }
             processPacket(buffer.data(), static_cast<size_t>(received), recvNs);
         }
     }
@@ -222,6 +316,35 @@ void NetworkReceiver::processPacket(const uint8_t* data, size_t size, uint64_t r
         return;
     }
 
+    // Simulcast: other renditions share the port, drop them before any accounting
+    if (header.isVideo() && header.sourceId != config_.sourceId) {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.filteredPackets++;
+        return;
+    }
+
+    if (config_.reportIntervalMs > 0) {
+        report_.packets++;
+        report_.bytes += size;
+        if (header.sendTimestamp > 0 && header.fragmentIndex == 0) {
+            report_.delaySumUs += static_cast<int64_t>(recvTimestampNs - header.sendTimestamp) / 1000;
+            report_.delayCount++;
+        }
+
+        // Frames never seen at all. Audio shares rendition 0's sequence
+        // counter, so it only counts when rendition 0 is the one received.
+        if (header.sourceId == config_.sourceId) {
+            int32_t delta = static_cast<int32_t>(header.sequenceNumber - report_.highestSequence);
+            if (!report_.haveSequence || delta > 1000 || delta < -1000) {
+                report_.highestSequence = header.sequenceNumber;    // First packet or sender restart
+                report_.haveSequence = true;
+            } else if (delta > 0) {
+                report_.framesMissing += static_cast<uint64_t>(delta - 1);
+                report_.highestSequence = header.sequenceNumber;
+            }
+        }
+    }
+
     // Get payload
     const uint8_t* payload = data + HEADER_SIZE;
     size_t payloadSize = size - HEADER_SIZE;
@@ -231,39 +354,12 @@ void NetworkReceiver::processPacket(const uint8_t* data, size_t size, uint64_t r
 
     auto frameOpt = reassembler.addPacket(header, payload, payloadSize);
 
+    // A frame abandoned with fragments missing is older: its slices go first
+    if (auto partial = reassembler.takePartial()) {
+        deliverFrame(*partial);
+    }
     if (frameOpt) {
-        const auto& frame = *frameOpt;
-
-        if (frame.type == MediaType::Video) {
-            {
-                std::lock_guard<std::mutex> lock(statsMutex_);
-                stats_.videoFramesReceived++;
-            }
-
-            if (onVideoFrame_) {
-                ReceivedVideoFrame vf;
-                vf.data = std::move(frame.data);
-                vf.timestamp = frame.timestamp;
-                vf.isKeyframe = frame.isKeyframe;
-                vf.sequenceNumber = frame.sequenceNumber;
-                onVideoFrame_(vf);
-            }
-        } else {
-            {
-                std::lock_guard<std::mutex> lock(statsMutex_);
-                stats_.audioFramesReceived++;
-            }
-
-            if (onAudioFrame_) {
-                ReceivedAudioFrame af;
-                af.data = std::move(frame.data);
-                af.timestamp = frame.timestamp;
-                af.sampleRate = frame.sampleRate;
-                af.channels = frame.channels;
-                af.sequenceNumber = frame.sequenceNumber;
-                onAudioFrame_(af);
-            }
-        }
+        deliverFrame(*frameOpt);
     }
 
     // Update dropped frames count from reassembler stats
@@ -275,6 +371,131 @@ void NetworkReceiver::processPacket(const uint8_t* data, size_t size, uint64_t r
     }
 }
 
+void NetworkReceiver::deliverFrame(FrameReassembler::Frame& frame) {
+    if (frame.type == MediaType::Video) {
+        {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.videoFramesReceived++;
+            if (frame.partial) stats_.videoFramesPartial++;
+        }
+
+        if (onVideoFrame_) {
+            ReceivedVideoFrame vf;
+            vf.data = std::move(frame.data);
+            vf.timestamp = frame.timestamp;
+            vf.isKeyframe = frame.isKeyframe;
+            vf.sequenceNumber = frame.sequenceNumber;
+            vf.isSlice = (frame.flags & FLAG_SLICE) != 0;
+            vf.endOfAccessUnit = !vf.isSlice || (frame.flags & FLAG_END_OF_AU) != 0;
+            vf.isRepeat = (frame.flags & FLAG_REPEAT) != 0;
+            vf.codec = frame.codec;
+            vf.isPartial = frame.partial;
+            onVideoFrame_(vf);
+        }
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            stats_.audioFramesReceived++;
+        }
+
+        if (onAudioFrame_) {
+            ReceivedAudioFrame af;
+            af.data = std::move(frame.data);
+            af.timestamp = frame.timestamp;
+            af.sampleRate = frame.sampleRate;
+            af.channels = frame.channels;
+            af.sequenceNumber = frame.sequenceNumber;
+            onAudioFrame_(af);
+        }
+    }
+}
+
+void NetworkReceiver::sendReport(std::chrono::steady_clock::time_point now) {
+    ReportState& r = report_;
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - r.lastSent).count();
+    if (elapsedMs <= 0) return;
+
+    // Incomplete frames (reassembler) + frames with no fragment received
+    auto video = videoReassembler_.getStats();
+    auto audio = audioReassembler_.getStats();
+    uint64_t dropped = video.framesDropped + audio.framesDropped;
+    uint64_t fragmentsLost =
+        (video.totalFragmentsExpectedBeforeDrop - video.totalFragmentsReceivedBeforeDrop) +
+        (audio.totalFragmentsExpectedBeforeDrop - audio.totalFragmentsReceivedBeforeDrop);
+
+    ReceiverReport report;
+    report.sourceId = config_.sourceId;
+    report.sequence = ++r.sequence;
+    report.intervalMs = static_cast<uint32_t>(elapsedMs);
+    report.packetsReceived = static_cast<uint32_t>(r.packets);
+    report.fragmentsLost = static_cast<uint32_t>(fragmentsLost - r.fragmentsLostBefore + r.framesMissing);
+    report.framesDropped = static_cast<uint32_t>(dropped - r.droppedBefore + r.framesMissing);
+    report.receiveRateKbps = static_cast<uint32_t>(r.bytes * 8 / static_cast<uint64_t>(elapsedMs));
+
+    // Delay trend: mean one-way delay vs the previous interval (clock offset cancels out)
+    if (r.delayCount > 0) {
+        int64_t mean = r.delaySumUs / static_cast<int64_t>(r.delayCount);
+        if (r.havePreviousDelay) {
+            report.delayGradientUs = static_cast<int32_t>(mean - r.previousMeanDelayUs);
+        }
+        r.previousMeanDelayUs = mean;
+        r.havePreviousDelay = true;
+    }
+
+    uint8_t packet[RECEIVER_REPORT_SIZE];
+    size_t size = Protocol::serializeReceiverReport(report, packet);
+#ifdef _WIN32
+    int sent = sendto(socket_, reinterpret_cast<const char*>(packet), static_cast<int>(size), 0,
+                      reinterpret_cast<struct sockaddr*>(&r.source), sizeof(r.source));
+#else
+    ssize_t sent = sendto(socket_, packet, size, MSG_DONTWAIT,
+                          reinterpret_cast<struct sockaddr*>(&r.source), sizeof(r.source));
+#endif
+    if (sent > 0) {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        stats_.reportsSent++;
+    }
+
+    r.lastSent = now;
+    r.packets = 0;
+    r.bytes = 0;
+    r.framesMissing = 0;
+    r.delaySumUs = 0;
+    r.delayCount = 0;
+    r.droppedBefore = dropped;
+    r.fragmentsLostBefore = fragmentsLost;
+}
+
+bool NetworkReceiver::sendTo(const std::string& host, uint16_t port,
+                             const uint8_t* data, size_t size) {
+    if (!listening_ || socket_ == INVALID_SOCKET_VAL) {
+        return false;
+    }
+
+    struct sockaddr_in destAddr{};
+    destAddr.sin_family = AF_INET;
+    destAddr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &destAddr.sin_addr) <= 0) {
+        Logger::instance().errorf("Invalid address: %s", host.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    int sent = sendto(socket_, reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+                      reinterpret_cast<struct sockaddr*>(&destAddr), sizeof(destAddr));
+#else
+    ssize_t sent = sendto(socket_, data, size, MSG_DONTWAIT,
+                          reinterpret_cast<struct sockaddr*>(&destAddr), sizeof(destAddr));
+#endif
+    if (sent < 0) {
+        int err = platform_socket_errno();
+        Logger::instance().debugf("sendTo %s:%u failed: %s", host.c_str(), port,
+                                  platform_socket_strerror(err));
+        return false;
+    }
+    return true;
+}
+
 NetworkReceiverStats NetworkReceiver::getStats() const {
     std::lock_guard<std::mutex> lock(statsMutex_);
     return stats_;
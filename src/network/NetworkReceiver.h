@@ -5,6 +5,17 @@
  *
  * Receives video and audio packets over UDP and reassembles fragmented frames.
  * Compatible with macOS Swift NetworkSender and Node.js sender.
+ * Optionally joins an IPv4 multicast group (source-specific when a source
+ * address is given and the platform supports it).
+ *
+ * With reportIntervalMs set, periodically sends a ReceiverReport (loss,
+ * receive rate, delay trend) back to the address the stream comes from.
+ *
+ * A simulcast host sends several renditions (sourceId) to the same port;
+ * only the configured one is reassembled.
+ *
+ * With partialFrames set, a video frame that loses fragments is still
+ * delivered (isPartial) with the slices that arrived whole.
  */
 
 #include <cstdint>
@@ -14,7 +25,9 @@
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <chrono>
 
+#include "common/Platform.h"
 #include "common/Protocol.h"
 
 namespace ndi_bridge {
@@ -25,6 +38,20 @@ namespace ndi_bridge {
 struct NetworkReceiverConfig {
     uint16_t port = 5990;
     size_t recvBufferSize = 8 * 1024 * 1024;  // 8MB receive buffer
+
+    // Multicast (empty group = unicast)
+    std::string multicastGroup;         // e.g. 239.1.1.1
+    std::string multicastSource;        // Non-empty = source-specific (SSM) join
+    std::string multicastInterface;     // Local IPv4 of the interface to join on (empty = any)
+
+    // Receiver reports to the stream source (0 = off)
+    int reportIntervalMs = 0;
+
+    // Simulcast: video rendition to reassemble (others are dropped on arrival)
+    uint8_t sourceId = 0;
+
+    // Deliver the complete slices of H.264 / HEVC frames that lost fragments
+    bool partialFrames = false;
 };
 
 /**
@@ -36,10 +63,13 @@ struct NetworkReceiverStats {
     uint64_t videoFramesReceived = 0;
     uint64_t audioFramesReceived = 0;
     uint64_t framesDropped = 0;
+    uint64_t videoFramesPartial = 0; // Dropped frames delivered with their complete slices
     uint64_t invalidPackets = 0;
+    uint64_t filteredPackets = 0;   // Video of other simulcast renditions
     // One-way latency estimate (send timestamp based)
     int64_t  latencySumMs = 0;
     uint64_t latencyCount = 0;
+    uint64_t reportsSent = 0;
 };
 
 /**
@@ -50,6 +80,11 @@ struct ReceivedVideoFrame {
     uint64_t timestamp;
     bool isKeyframe;
     uint32_t sequenceNumber;
+    bool isSlice = false;           // One slice of an access unit (FLAG_SLICE)
+    bool endOfAccessUnit = true;    // Last slice of the access unit
+    bool isRepeat = false;          // Repeat marker (FLAG_REPEAT): no picture, data is not video
+    uint8_t codec = 0;              // VideoCodec from the header (byte 35)
+    bool isPartial = false;         // Fragments were lost: only the complete slices are present
 };
 
 /**
@@ -108,6 +143,14 @@ public:
      */
     bool isListening() const { return listening_; }
 
+    /**
+     * Send a datagram from the listening socket (same local port)
+     * Used for rendezvous registration: the relay learns the NAT mapping
+     * of this socket and forwards the stream back through it.
+     * @return true if sent successfully
+     */
+    bool sendTo(const std::string& host, uint16_t port, const uint8_t* data, size_t size);
+
     /**
      * Get current statistics
      */
@@ -142,8 +185,11 @@ public:
     const NetworkReceiverConfig& getConfig() const { return config_; }
 
 private:
+    bool joinMulticastGroup();
     void receiveLoop();
     void processPacket(const uint8_t* data, size_t size, uint64_t recvTimestampNs);
+    void deliverFrame(FrameReassembler::Frame& frame);
+    void sendReport(std::chrono::steady_clock::time_point now);
 
     NetworkReceiverConfig config_;
     socket_t socket_ = INVALID_SOCKET_VAL;
@@ -159,6 +205,26 @@ private:
     mutable std::mutex statsMutex_;
     NetworkReceiverStats stats_;
 
+    // Receiver report accounting (receive thread only)
+    struct ReportState {
+        struct sockaddr_in source{};            // Where the stream comes from
+        bool haveSource = false;
+        std::chrono::steady_clock::time_point lastSent;
+        uint32_t sequence = 0;
+        uint64_t packets = 0;                   // Current interval
+        uint64_t bytes = 0;
+        uint64_t framesMissing = 0;             // Sequence numbers never seen
+        uint32_t highestSequence = 0;
+        bool haveSequence = false;
+        int64_t delaySumUs = 0;                 // One-way delay samples (clock offset included)
+        uint64_t delayCount = 0;
+        int64_t previousMeanDelayUs = 0;
+        bool havePreviousDelay = false;
+        uint64_t droppedBefore = 0;             // Reassembler counters at the last report
+        uint64_t fragmentsLostBefore = 0;
+    };
+    ReportState report_;
+
     // Callbacks
     OnVideoFrame onVideoFrame_;
     OnAudioFrame onAudioFrame_;
@@ -2,6 +2,7 @@
 #include "common/Protocol.h"
 #include "common/Logger.h"
 
+#include <algorithm>
 #include <cstring>
 #include <thread>
 #include <chrono>
@@ -20,18 +21,41 @@ NetworkSender::~NetworkSender() {
 }
 
 bool NetworkSender::connect() {
-    return connect(config_.host, config_.port);
-}
-
-bool NetworkSender::connect(const std::string& host, uint16_t port) {
     if (connected_) {
         disconnect();
     }
 
-    config_.host = host;
-    config_.port = port;
+    // Resolve destinations: explicit target list, or the single host/port
+    std::vector<NetworkTarget> targets = config_.targets;
+    if (targets.empty()) {
+        targets.push_back(NetworkTarget{config_.host, config_.port, -1});
+    }
+
+    targets_.clear();
+    for (const auto& t : targets) {
+        Target target;
+        target.addr.sin_family = AF_INET;
+        target.addr.sin_port = htons(t.port);
+        if (inet_pton(AF_INET, t.host.c_str(), &target.addr.sin_addr) <= 0) {
+            Logger::instance().errorf("Invalid address: %s", t.host.c_str());
+            targets_.clear();
+            if (onError_) {
+                onError_("Invalid address: " + t.host);
+            }
+            return false;
+        }
+        target.pacingDelayUs = t.pacingDelayUs >= 0 ? t.pacingDelayUs : config_.pacingDelayUs;
+        target.stats.endpoint = t.host + ":" + std::to_string(t.port);
+        target.stats.pacingDelayUs = target.pacingDelayUs;
+        targets_.push_back(std::move(target));
+    }
+    multiTarget_ = targets_.size() > 1;
 
-    Logger::instance().infof("Connecting to %s:%u...", host.c_str(), port);
+    if (multiTarget_) {
+        Logger::instance().infof("Connecting to %zu targets...", targets_.size());
+    } else {
+        Logger::instance().infof("Connecting to %s...", targets_[0].stats.endpoint.c_str());
+    }
 
     // Create UDP socket
     socket_ = socket(AF_INET, SOCK_DGRAM, 0);
@@ -50,27 +74,21 @@ bool NetworkSender::connect(const std::string& host, uint16_t port) {
                reinterpret_cast<const char*>(&optval), sizeof(optval));
 
     // Increase send buffer size — match Mac's aggressive non-blocking pattern
-    int sendbuf = 4 * 1024 * 1024;  // 4MB
+    // (scaled with the number of targets: each frame is queued once per target)
+    int sendbuf = 4 * 1024 * 1024 * static_cast<int>(std::min<size_t>(targets_.size(), 4));
     setsockopt(socket_, SOL_SOCKET, SO_SNDBUF,
                reinterpret_cast<const char*>(&sendbuf), sizeof(sendbuf));
 
-    // Setup destination address
-    struct sockaddr_in destAddr{};
-    destAddr.sin_family = AF_INET;
-    destAddr.sin_port = htons(port);
-
-    if (inet_pton(AF_INET, host.c_str(), &destAddr.sin_addr) <= 0) {
-        Logger::instance().errorf("Invalid address: %s", host.c_str());
+    if (!configureMulticast()) {
         platform_close_socket(socket_);
         socket_ = INVALID_SOCKET_VAL;
-        if (onError_) {
-            onError_("Invalid address: " + host);
-        }
         return false;
     }
 
-    // Connect UDP socket (sets default destination)
-    if (::connect(socket_, reinterpret_cast<struct sockaddr*>(&destAddr), sizeof(destAddr)) < 0) {
+    // Connect UDP socket (sets default destination) — single target only
+    if (!multiTarget_ &&
+        ::connect(socket_, reinterpret_cast<struct sockaddr*>(&targets_[0].addr),
+                  sizeof(targets_[0].addr)) < 0) {
         int err = platform_socket_errno();
         Logger::instance().errorf("Failed to connect: %s", platform_socket_strerror(err));
         platform_close_socket(socket_);
@@ -85,16 +103,72 @@ bool NetworkSender::connect(const std::string& host, uint16_t port) {
     platform_set_nonblocking(socket_);
 
     connected_ = true;
-    Logger::instance().successf("Connected to %s:%u (non-blocking, pacing: %dus)",
-        host.c_str(), port, config_.pacingDelayUs);
+    for (const auto& target : targets_) {
+        Logger::instance().successf("Connected to %s (non-blocking, pacing: %dus)",
+            target.stats.endpoint.c_str(), target.pacingDelayUs);
+        if (onConnected_) {
+            onConnected_(target.stats.endpoint);
+        }
+    }
+
+    return true;
+}
 
-    if (onConnected_) {
-        onConnected_(host + ":" + std::to_string(port));
+bool NetworkSender::configureMulticast() {
+    bool anyMulticast = false;
+    for (const auto& target : targets_) {
+        if (IN_MULTICAST(ntohl(target.addr.sin_addr.s_addr))) {
+            anyMulticast = true;
+        }
+    }
+    if (!anyMulticast) {
+        return true;
     }
 
+    platform_mcast_opt_t ttl = static_cast<platform_mcast_opt_t>(config_.multicastTtl);
+    if (setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_TTL,
+                   reinterpret_cast<const char*>(&ttl), sizeof(ttl)) < 0) {
+        int err = platform_socket_errno();
+        Logger::instance().errorf("Failed to set multicast TTL %d: %s",
+                                  config_.multicastTtl, platform_socket_strerror(err));
+        return false;
+    }
+
+    platform_mcast_opt_t loop = config_.multicastLoopback ? 1 : 0;
+    setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_LOOP,
+               reinterpret_cast<const char*>(&loop), sizeof(loop));
+
+    if (!config_.multicastInterface.empty()) {
+        struct in_addr iface{};
+        if (inet_pton(AF_INET, config_.multicastInterface.c_str(), &iface) <= 0) {
+            Logger::instance().errorf("Invalid multicast interface: %s",
+                                      config_.multicastInterface.c_str());
+            return false;
+        }
+        if (setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_IF,
+                       reinterpret_cast<const char*>(&iface), sizeof(iface)) < 0) {
+            int err = platform_socket_errno();
+            Logger::instance().errorf("Failed to set multicast interface %s: %s",
+                                      config_.multicastInterface.c_str(),
+                                      platform_socket_strerror(err));
+            return false;
+        }
+    }
+
+    Logger::instance().successf("Multicast: TTL %d, interface %s, loopback %s",
+        config_.multicastTtl,
+        config_.multicastInterface.empty() ? "default" : config_.multicastInterface.c_str(),
+        config_.multicastLoopback ? "on" : "off");
     return true;
 }
 
+bool NetworkSender::connect(const std::string& host, uint16_t port) {
+    config_.host = host;
+    config_.port = port;
+    config_.targets.clear();
+    return connect();
+}
+
 void NetworkSender::disconnect() {
     if (socket_ != INVALID_SOCKET_VAL) {
         platform_close_socket(socket_);
@@ -107,171 +181,337 @@ void NetworkSender::disconnect() {
                                 stats.bytesSent, stats.packetsSent, stats.framesSent);
 }
 
-bool NetworkSender::sendVideo(const uint8_t* data, size_t size, bool isKeyframe, uint64_t timestamp) {
+bool NetworkSender::sendVideo(const uint8_t* data, size_t size, bool isKeyframe, uint64_t timestamp,
+                              uint8_t sliceFlags, uint8_t sourceId) {
     if (!connected_) {
         LOG_ERROR("Cannot send video - not connected");
         return false;
     }
+    if (sourceId >= MAX_SOURCE_IDS) {
+        Logger::instance().errorf("Invalid video source id: %u", sourceId);
+        return false;
+    }
+
+    // Fragment fields are filled in per fragment by sendFrame()
+    PacketHeader header = Protocol::createVideoHeader(
+        0, timestamp, static_cast<uint32_t>(size), 0, 0, 0, isKeyframe);
+    header.flags |= sliceFlags & (FLAG_SLICE | FLAG_END_OF_AU);
+    header.sourceId = sourceId;
+    header.codec = static_cast<uint8_t>(config_.videoCodec);
+    return sendFrame(data, size, header);
+}
+
+bool NetworkSender::sendRepeat(uint64_t timestamp, uint8_t sourceId) {
+    if (!connected_ || sourceId >= MAX_SOURCE_IDS) {
+        return false;
+    }
+
+    static const uint8_t payload[REPEAT_PAYLOAD_SIZE] = {0};
+    PacketHeader header = Protocol::createVideoHeader(
+        0, timestamp, static_cast<uint32_t>(REPEAT_PAYLOAD_SIZE), 0, 0, 0, false);
+    header.flags |= FLAG_REPEAT;
+    header.sourceId = sourceId;
+    header.codec = static_cast<uint8_t>(config_.videoCodec);
+    return sendFrame(payload, sizeof(payload), header);
+}
+
+bool NetworkSender::sendAudio(const uint8_t* data, size_t size, uint64_t timestamp,
+                              uint32_t sampleRate, uint8_t channels) {
+    if (!connected_) {
+        LOG_ERROR("Cannot send audio - not connected");
+        return false;
+    }
 
-    // Use consistent payload size for fragmentation
-    const size_t maxPayload = MAX_UDP_PAYLOAD;
-    const uint16_t fragmentCount = Protocol::calculateFragmentCount(static_cast<uint32_t>(size));
-    const uint32_t seqNum = ++sequenceNumber_;
+    PacketHeader header = Protocol::createAudioHeader(
+        0, timestamp, static_cast<uint32_t>(size), 0, 0, 0, sampleRate, channels);
+    return sendFrame(data, size, header);
+}
 
-    std::vector<uint8_t> packet(MAX_PACKET_SIZE);
+bool NetworkSender::sendFrame(const uint8_t* data, size_t size, PacketHeader header) {
+    // Use consistent payload size for fragmentation (derived from --mtu)
+    const size_t maxPayload = Protocol::payloadSizeForMtu(config_.mtu);
+    const uint16_t fragmentCount = Protocol::calculateFragmentCount(static_cast<uint32_t>(size), maxPayload);
 
+    // Serialize every fragment header once, shared by all targets
+    std::vector<uint8_t> headers(static_cast<size_t>(fragmentCount) * HEADER_SIZE);
+    header.sequenceNumber = ++sequenceNumbers_[header.sourceId];
+    header.fragmentCount = fragmentCount;
+    header.sendTimestamp = Protocol::wallClockNs();
     for (uint16_t i = 0; i < fragmentCount; i++) {
         size_t offset = i * maxPayload;
-        size_t payloadSize = std::min(maxPayload, size - offset);
+        header.fragmentIndex = i;
+        header.payloadSize = static_cast<uint16_t>(std::min(maxPayload, size - offset));
+        Protocol::serializeInto(header, headers.data() + static_cast<size_t>(i) * HEADER_SIZE);
+    }
 
-        // Create header
-        PacketHeader header = Protocol::createVideoHeader(
-            seqNum,
-            timestamp,
-            static_cast<uint32_t>(size),
-            i,
-            fragmentCount,
-            static_cast<uint16_t>(payloadSize),
-            isKeyframe
-        );
-        header.sendTimestamp = Protocol::wallClockNs();
-
-        // Serialize header
-        Protocol::serializeInto(header, packet.data());
-
-        // Copy payload
-        std::memcpy(packet.data() + HEADER_SIZE, data + offset, payloadSize);
+    // Earliest send time of each fragment (adaptive pacing of this source)
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::chrono::steady_clock::time_point> release(fragmentCount, start);
+    if (header.isVideo()) {
+        reserveFragments(header.sourceId, size, maxPayload, fragmentCount, start, release);
+    }
 
-        // Send packet
-        if (!sendPacket(packet.data(), HEADER_SIZE + payloadSize)) {
-            return false;
+    // Every target sends each fragment once the bucket has released it and,
+    // for paced targets, its own fragment spacing has elapsed. Targets are
+    // interleaved so none waits for another's paced frame to finish; an
+    // unpaced target sends all released fragments in one batch.
+    struct Cursor {
+        Target* target;
+        uint16_t next;
+        std::chrono::steady_clock::time_point due;
+    };
+    std::vector<Cursor> cursors;
+    for (auto& target : targets_) {
+        cursors.push_back(Cursor{&target, 0, start});
+    }
+    bool ok = true;
+    while (!cursors.empty()) {
+        auto now = std::chrono::steady_clock::now();
+        auto nextDue = std::chrono::steady_clock::time_point::max();
+        for (auto it = cursors.begin(); it != cursors.end();) {
+            const int delayUs = it->target->pacingDelayUs;
+            uint16_t count = 0;
+            if (it->due <= now) {
+                const uint16_t limit = delayUs > 0 ? 1 : fragmentCount - it->next;
+                while (count < limit && release[it->next + count] <= now) count++;
+            }
+            if (count > 0) {
+                if (!sendFragments(*it->target, headers.data(), data, size, maxPayload,
+                                   it->next, count)) {
+                    ok = false;
+                    it = cursors.erase(it);
+                    continue;
+                }
+                // Pace fragments to avoid overwhelming the network tunnel
+                it->next += count;
+                it->due = now + std::chrono::microseconds(std::max(delayUs, 0));
+            }
+            if (it->next >= fragmentCount) {
+                it = cursors.erase(it);
+                continue;
+            }
+            nextDue = std::min(nextDue, std::max(it->due, release[it->next]));
+            ++it;
         }
-
-        // Pace fragments to avoid overwhelming the network tunnel
-        if (config_.pacingDelayUs > 0 && i + 1 < fragmentCount) {
-            std::this_thread::sleep_for(std::chrono::microseconds(config_.pacingDelayUs));
+        if (!cursors.empty()) {
+            std::this_thread::sleep_until(nextDue);
         }
     }
 
     {
         std::lock_guard<std::mutex> lock(statsMutex_);
-        stats_.framesSent++;
+        framesSent_++;
     }
 
-    return true;
+    return ok;
 }
 
-bool NetworkSender::sendAudio(const uint8_t* data, size_t size, uint64_t timestamp,
-                              uint32_t sampleRate, uint8_t channels) {
-    if (!connected_) {
-        LOG_ERROR("Cannot send audio - not connected");
-        return false;
-    }
-
-    // Use consistent payload size for fragmentation
-    const size_t maxPayload = MAX_UDP_PAYLOAD;
-    const uint16_t fragmentCount = Protocol::calculateFragmentCount(static_cast<uint32_t>(size));
-    const uint32_t seqNum = ++sequenceNumber_;
-
-    std::vector<uint8_t> packet(MAX_PACKET_SIZE);
+bool NetworkSender::sendFragments(Target& target, const uint8_t* headers, const uint8_t* data,
+                                  size_t size, size_t maxPayload, uint16_t first, uint16_t count) {
+#ifdef __linux__
+    // Scatter-gather: [shared header][payload slice of the encoded frame], no copy
+    constexpr size_t BATCH = 64;
+    struct mmsghdr msgs[BATCH];
+    struct iovec iovs[BATCH][2];
+
+    for (size_t base = first; base < static_cast<size_t>(first) + count; base += BATCH) {
+        size_t n = std::min(BATCH, static_cast<size_t>(first) + count - base);
+        std::memset(msgs, 0, sizeof(struct mmsghdr) * n);
+        for (size_t j = 0; j < n; j++) {
+            size_t i = base + j;
+            size_t offset = i * maxPayload;
+            iovs[j][0].iov_base = const_cast<uint8_t*>(headers + i * HEADER_SIZE);
+            iovs[j][0].iov_len = HEADER_SIZE;
+            iovs[j][1].iov_base = const_cast<uint8_t*>(data + offset);
+            iovs[j][1].iov_len = std::min(maxPayload, size - offset);
+            msgs[j].msg_hdr.msg_iov = iovs[j];
+            msgs[j].msg_hdr.msg_iovlen = 2;
+            if (multiTarget_) {
+                msgs[j].msg_hdr.msg_name = &target.addr;
+                msgs[j].msg_hdr.msg_namelen = sizeof(target.addr);
+            }
+        }
 
-    for (uint16_t i = 0; i < fragmentCount; i++) {
+        size_t done = 0;
+        while (done < n) {
+            int sent = sendmmsg(socket_, msgs + done, static_cast<unsigned int>(n - done),
+                                MSG_DONTWAIT);
+            if (sent < 0) {
+                int err = errno;
+                recordSendError(target, err);
+                if (err != EAGAIN && err != EWOULDBLOCK) {
+                    return false;
+                }
+                // Non-blocking socket: kernel buffer full — drop this packet, keep going
+                done++;
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(statsMutex_);
+            for (int k = 0; k < sent; k++) {
+                target.stats.bytesSent += msgs[done + k].msg_len;
+                target.stats.packetsSent++;
+            }
+            done += static_cast<size_t>(sent);
+        }
+    }
+    return true;
+#else
+    std::vector<uint8_t> packet(HEADER_SIZE + maxPayload);
+    for (size_t i = first; i < static_cast<size_t>(first) + count; i++) {
         size_t offset = i * maxPayload;
         size_t payloadSize = std::min(maxPayload, size - offset);
 
-        // Create header
-        PacketHeader header = Protocol::createAudioHeader(
-            seqNum,
-            timestamp,
-            static_cast<uint32_t>(size),
-            i,
-            fragmentCount,
-            static_cast<uint16_t>(payloadSize),
-            sampleRate,
-            channels
-        );
-        header.sendTimestamp = Protocol::wallClockNs();
-
-        // Serialize header
-        Protocol::serializeInto(header, packet.data());
-
-        // Copy payload
+        // Copy header + payload
+        std::memcpy(packet.data(), headers + i * HEADER_SIZE, HEADER_SIZE);
         std::memcpy(packet.data() + HEADER_SIZE, data + offset, payloadSize);
 
         // Send packet
-        if (!sendPacket(packet.data(), HEADER_SIZE + payloadSize)) {
+        if (!sendPacket(target, packet.data(), HEADER_SIZE + payloadSize)) {
             return false;
         }
+    }
+    return true;
+#endif
+}
 
-        // Pace fragments to avoid overwhelming the network tunnel
-        if (config_.pacingDelayUs > 0 && i + 1 < fragmentCount) {
-            std::this_thread::sleep_for(std::chrono::microseconds(config_.pacingDelayUs));
-        }
+bool NetworkSender::sendRaw(const uint8_t* data, size_t size) {
+    bool ok = true;
+    for (auto& target : targets_) {
+        ok &= sendPacket(target, data, size);
     }
+    return ok;
+}
 
-    {
-        std::lock_guard<std::mutex> lock(statsMutex_);
-        stats_.framesSent++;
+size_t NetworkSender::receive(uint8_t* buffer, size_t size) {
+    if (!connected_) {
+        return 0;
     }
+#ifdef _WIN32
+    int received = recv(socket_, reinterpret_cast<char*>(buffer), static_cast<int>(size), 0);
+#else
+    ssize_t received = recv(socket_, buffer, size, MSG_DONTWAIT);
+#endif
+    return received > 0 ? static_cast<size_t>(received) : 0;
+}
 
-    return true;
+void NetworkSender::setPacingRate(uint64_t bitsPerSecond, size_t burstBytes, uint8_t sourceId) {
+    if (sourceId >= MAX_SOURCE_IDS) return;
+    const size_t packetBytes = Protocol::payloadSizeForMtu(config_.mtu) + HEADER_SIZE;
+    std::lock_guard<std::mutex> lock(pacingMutex_);
+    PacingBucket& bucket = pacing_[sourceId];
+    if (bucket.rateBps == 0) {
+        // Newly paced: start with a full bucket
+        bucket.tokens = static_cast<double>(std::max(burstBytes, packetBytes));
+        bucket.refilled = std::chrono::steady_clock::now();
+    }
+    bucket.rateBps = bitsPerSecond;
+    bucket.burstBytes = static_cast<double>(std::max(burstBytes, packetBytes));
+    bucket.tokens = std::min(bucket.tokens, bucket.burstBytes);
 }
 
-bool NetworkSender::sendRaw(const uint8_t* data, size_t size) {
-    return sendPacket(data, size);
+void NetworkSender::reserveFragments(uint8_t sourceId, size_t size, size_t maxPayload,
+                                     uint16_t fragmentCount,
+                                     std::chrono::steady_clock::time_point now,
+                                     std::vector<std::chrono::steady_clock::time_point>& release) {
+    std::lock_guard<std::mutex> lock(pacingMutex_);
+    PacingBucket& bucket = pacing_[sourceId];
+    if (bucket.rateBps == 0) return;
+
+    const double bytesPerUs = static_cast<double>(bucket.rateBps) / 8.0 / 1e6;
+    const double elapsedUs = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - bucket.refilled).count());
+    bucket.tokens = std::min(bucket.burstBytes, bucket.tokens + elapsedUs * bytesPerUs);
+    bucket.refilled = now;
+
+    // Whole frame reserved up front: fragments past the burst wait for
+    // their share of the rate (the debt carries over to the next frame)
+    for (uint16_t i = 0; i < fragmentCount; i++) {
+        const size_t offset = static_cast<size_t>(i) * maxPayload;
+        bucket.tokens -= static_cast<double>(std::min(maxPayload, size - offset) + HEADER_SIZE);
+        if (bucket.tokens < 0.0) {
+            release[i] = now + std::chrono::microseconds(static_cast<int64_t>(-bucket.tokens / bytesPerUs));
+        }
+    }
 }
 
-bool NetworkSender::sendPacket(const uint8_t* data, size_t size) {
+bool NetworkSender::sendPacket(Target& target, const uint8_t* data, size_t size) {
+    const struct sockaddr* to = multiTarget_
+        ? reinterpret_cast<const struct sockaddr*>(&target.addr) : nullptr;
+    socklen_t toLen = multiTarget_ ? sizeof(target.addr) : 0;
 #ifdef _WIN32
-    int sent = send(socket_, reinterpret_cast<const char*>(data),
-                    static_cast<int>(size), 0);
+    int sent = sendto(socket_, reinterpret_cast<const char*>(data),
+                      static_cast<int>(size), 0, to, toLen);
 #else
-    ssize_t sent = send(socket_, data, size, MSG_DONTWAIT);
+    ssize_t sent = sendto(socket_, data, size, MSG_DONTWAIT, to, toLen);
 #endif
 
     if (sent < 0) {
         int err = platform_socket_errno();
-        if (err == PLATFORM_EAGAIN || err == PLATFORM_EWOULDBLOCK) {
-            // Non-blocking socket: kernel buffer full — drop packet (real-time behavior)
-            // This matches Mac's .idempotent send completion (fire-and-forget)
-            {
-                std::lock_guard<std::mutex> lock(statsMutex_);
-                stats_.packetsDroppedEagain++;
-            }
-            return true;
-        }
-        {
-            std::lock_guard<std::mutex> lock(statsMutex_);
-            stats_.sendErrors++;
-            // Rate-limit error logging: only log once per second
-            static auto lastErrorLog = std::chrono::steady_clock::time_point{};
-            auto now = std::chrono::steady_clock::now();
-            if (now - lastErrorLog >= std::chrono::seconds(1)) {
-                lastErrorLog = now;
-                Logger::instance().errorf("Send error: %s (total: %lu)",
-                                          platform_socket_strerror(err), stats_.sendErrors);
-            }
-        }
-        return false;
+        recordSendError(target, err);
+        // Non-blocking socket: kernel buffer full — drop packet (real-time behavior)
+        // This matches Mac's .idempotent send completion (fire-and-forget)
+        return err == PLATFORM_EAGAIN || err == PLATFORM_EWOULDBLOCK;
     }
 
     {
         std::lock_guard<std::mutex> lock(statsMutex_);
-        stats_.bytesSent += sent;
-        stats_.packetsSent++;
+        target.stats.bytesSent += sent;
+        target.stats.packetsSent++;
     }
 
     return true;
 }
 
+void NetworkSender::recordSendError(Target& target, int err) {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    if (err == PLATFORM_EAGAIN || err == PLATFORM_EWOULDBLOCK) {
+        target.stats.packetsDroppedEagain++;
+        return;
+    }
+    target.stats.sendErrors++;
+    // Rate-limit error logging: only log once per second
+    static auto lastErrorLog = std::chrono::steady_clock::time_point{};
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastErrorLog >= std::chrono::seconds(1)) {
+        lastErrorLog = now;
+        Logger::instance().errorf("Send error to %s: %s (total: %lu)",
+                                  target.stats.endpoint.c_str(),
+                                  platform_socket_strerror(err), target.stats.sendErrors);
+    }
+}
+
 NetworkSenderStats NetworkSender::getStats() const {
     std::lock_guard<std::mutex> lock(statsMutex_);
-    return stats_;
+    NetworkSenderStats stats;
+    stats.framesSent = framesSent_;
+    for (const auto& target : targets_) {
+        stats.bytesSent += target.stats.bytesSent;
+        stats.packetsSent += target.stats.packetsSent;
+        stats.sendErrors += target.stats.sendErrors;
+        stats.packetsDroppedEagain += target.stats.packetsDroppedEagain;
+    }
+    return stats;
+}
+
+std::vector<NetworkTargetStats> NetworkSender::getTargetStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    std::vector<NetworkTargetStats> result;
+    result.reserve(targets_.size());
+    for (const auto& target : targets_) {
+        result.push_back(target.stats);
+    }
+    return result;
 }
 
 void NetworkSender::resetStats() {
     std::lock_guard<std::mutex> lock(statsMutex_);
-    stats_ = NetworkSenderStats{};
+    framesSent_ = 0;
+    for (auto& target : targets_) {
+        target.stats.bytesSent = 0;
+        target.stats.packetsSent = 0;
+        target.stats.sendErrors = 0;
+        target.stats.packetsDroppedEagain = 0;
+    }
 }
 
 } // namespace ndi_bridge
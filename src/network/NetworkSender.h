@@ -5,8 +5,21 @@
  *
  * Sends video and audio frames over UDP with automatic fragmentation.
  * Compatible with macOS Swift NetworkSender and Node.js receiver.
+ *
+ * Multi-target: one encoded stream can go to several destinations. Each
+ * frame is fragmented and its headers serialized once, then sent to every
+ * target (sendmmsg batch on Linux) with per-target pacing and statistics.
+ *
+ * Adaptive bitrate caps one video source with a token bucket: a burst up to
+ * the bucket size (about one keyframe) leaves at once, then fragments are
+ * released at the pacing rate. Other sources and audio are not metered.
+ *
+ * Multicast: a target in 224.0.0.0/4 reaches every receiver that joined the
+ * group, with one send per packet (TTL / interface / loopback configurable).
  */
 
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -14,17 +27,34 @@
 #include <atomic>
 #include <mutex>
 #include "../common/Platform.h"
+#include "../common/Protocol.h"
 
 namespace ndi_bridge {
 
+/**
+ * One destination of a NetworkSender
+ */
+struct NetworkTarget {
+    std::string host = "127.0.0.1";
+    uint16_t port = 5990;
+    int pacingDelayUs = -1;  // Delay between fragments, -1 = NetworkSenderConfig::pacingDelayUs
+};
+
 /**
  * Configuration for NetworkSender
  */
 struct NetworkSenderConfig {
     std::string host = "127.0.0.1";
     uint16_t port = 5990;
+    std::vector<NetworkTarget> targets;  // Non-empty = replaces host/port (multi-target)
     size_t mtu = 1400;  // Match Mac bridge MTU
     int pacingDelayUs = 0;  // No pacing — fire-and-forget like Mac (non-blocking UDP)
+    VideoCodec videoCodec = VideoCodec::H264;  // Signalled in every video header
+
+    // Multicast (applies when a target is a 224.0.0.0/4 group)
+    int multicastTtl = 1;               // 1 = stay on the local segment
+    std::string multicastInterface;     // Local IPv4 of the outgoing interface (empty = routing table)
+    bool multicastLoopback = true;      // Deliver to receivers on this host too
 };
 
 /**
@@ -38,6 +68,18 @@ struct NetworkSenderStats {
     uint64_t packetsDroppedEagain = 0;
 };
 
+/**
+ * Per-target statistics (multi-target)
+ */
+struct NetworkTargetStats {
+    std::string endpoint;           // "host:port"
+    int pacingDelayUs = 0;
+    uint64_t bytesSent = 0;
+    uint64_t packetsSent = 0;
+    uint64_t sendErrors = 0;
+    uint64_t packetsDroppedEagain = 0;
+};
+
 /**
  * Callback types
  */
@@ -61,14 +103,16 @@ public:
     NetworkSender& operator=(const NetworkSender&) = delete;
 
     /**
-     * Connect to target endpoint
-     * For UDP this just sets up the socket and destination address.
-     * @return true if socket created successfully
+     * Connect to target endpoint(s)
+     * For UDP this just sets up the socket and destination address(es).
+     * A single target uses a connected socket; several share one
+     * unconnected socket.
+     * @return true if socket created and every target address is valid
      */
     bool connect();
 
     /**
-     * Connect to specific host and port
+     * Connect to specific host and port (single target)
      */
     bool connect(const std::string& host, uint16_t port);
 
@@ -84,13 +128,24 @@ public:
 
     /**
      * Send video frame
-     * @param data H.264 Annex-B encoded video data
+     * @param data Encoded video access unit (config videoCodec bitstream)
      * @param size Size in bytes
      * @param isKeyframe True if this is a keyframe
      * @param timestamp PTS in 10M ticks/sec
+     * @param sliceFlags FLAG_SLICE / FLAG_END_OF_AU for slice units (0 = whole access unit)
+     * @param sourceId Simulcast rendition (own sequence numbers, < MAX_SOURCE_IDS)
      * @return true if sent successfully
      */
-    bool sendVideo(const uint8_t* data, size_t size, bool isKeyframe, uint64_t timestamp);
+    bool sendVideo(const uint8_t* data, size_t size, bool isKeyframe, uint64_t timestamp,
+                   uint8_t sliceFlags = 0, uint8_t sourceId = 0);
+
+    /**
+     * Send a repeat marker: the picture did not change, joins show the
+     * previous frame again (one packet, FLAG_REPEAT)
+     * @param timestamp PTS in 10M ticks/sec of the skipped frame
+     * @param sourceId Simulcast rendition
+     */
+    bool sendRepeat(uint64_t timestamp, uint8_t sourceId = 0);
 
     /**
      * Send audio frame
@@ -105,15 +160,37 @@ public:
                    uint32_t sampleRate, uint8_t channels);
 
     /**
-     * Send raw packet (no fragmentation)
+     * Send raw packet (no fragmentation) to every target
      */
     bool sendRaw(const uint8_t* data, size_t size);
 
     /**
-     * Get current statistics
+     * Read one datagram sent back to this socket, without blocking
+     * (receiver reports from joins, directly or via the relay)
+     * @return Bytes read, 0 if nothing is pending
+     */
+    size_t receive(uint8_t* buffer, size_t size);
+
+    /**
+     * Cap the video send rate of one source (adaptive bitrate)
+     * Token bucket: up to burstBytes go out back to back, the rest at this
+     * rate. Per-target pacing delays still apply. Safe to call while sending.
+     * @param bitsPerSecond Pacing rate, 0 = unpaced
+     * @param burstBytes Bucket size (at least one fragment)
+     * @param sourceId Video source to pace (renditions are paced separately)
+     */
+    void setPacingRate(uint64_t bitsPerSecond, size_t burstBytes = 0, uint8_t sourceId = 0);
+
+    /**
+     * Get current statistics (summed over targets)
      */
     NetworkSenderStats getStats() const;
 
+    /**
+     * Get per-target statistics, in target order
+     */
+    std::vector<NetworkTargetStats> getTargetStats() const;
+
     /**
      * Reset statistics
      */
@@ -132,18 +209,47 @@ public:
     const NetworkSenderConfig& getConfig() const { return config_; }
 
 private:
-    bool sendPacket(const uint8_t* data, size_t size);
+    struct Target {
+        struct sockaddr_in addr{};
+        int pacingDelayUs = 0;
+        NetworkTargetStats stats;   // Guarded by statsMutex_
+    };
+
+    // Token bucket of one video source (bytes; negative = sent ahead of the rate)
+    struct PacingBucket {
+        uint64_t rateBps = 0;       // 0 = unpaced
+        double burstBytes = 0.0;
+        double tokens = 0.0;
+        std::chrono::steady_clock::time_point refilled;
+    };
+
+    bool sendFrame(const uint8_t* data, size_t size, PacketHeader header);
+    void reserveFragments(uint8_t sourceId, size_t size, size_t maxPayload, uint16_t fragmentCount,
+                          std::chrono::steady_clock::time_point now,
+                          std::vector<std::chrono::steady_clock::time_point>& release);
+    bool sendFragments(Target& target, const uint8_t* headers, const uint8_t* data,
+                       size_t size, size_t maxPayload, uint16_t first, uint16_t count);
+    bool sendPacket(Target& target, const uint8_t* data, size_t size);
+    bool configureMulticast();
+    void recordSendError(Target& target, int err);
 
     NetworkSenderConfig config_;
     socket_t socket_ = INVALID_SOCKET_VAL;
     std::atomic<bool> connected_{false};
+    std::vector<Target> targets_;
+    bool multiTarget_ = false;      // Unconnected socket, explicit destinations
+
+    // Adaptive pacing, one bucket per sourceId (setPacingRate)
+    std::mutex pacingMutex_;
+    std::array<PacingBucket, MAX_SOURCE_IDS> pacing_{};
 
-    // Sequence number for frames (incremented per frame, not per packet)
-    std::atomic<uint32_t> sequenceNumber_{0};
+    // Sequence number for frames (incremented per frame, not per packet),
+    // one counter per sourceId; audio shares rendition 0's
+    std::array<std::atomic<uint32_t>, MAX_SOURCE_IDS> sequenceNumbers_{};
 
     // Statistics
     mutable std::mutex statsMutex_;
-    NetworkSenderStats stats_;
+    uint64_t framesSent_ = 0;
 
     // Callbacks
     OnSenderConnected onConnected_;
@@ -0,0 +1,1057 @@
+/**
+ * RelayMode.cpp - NDI Bridge Rendezvous Relay Implementation
+ *
+ * Learns host/join addresses from registration packets and forwards
+ * protocol packets between paired peers (or, in frame-level mode,
+ * reassembled and re-fragmented frames; in fan-out mode, to every
+ * subscriber of the session).
+ */
+
+#include "RelayMode.h"
+#include "../common/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+namespace ndi_bridge {
+
+RelayMode::RelayMode(const RelayModeConfig& config)
+    : config_(config)
+    , rendition_(config.rendition >= 0 || !(config.frameLevel || config.fanout) ? config.rendition : 0)
+{
+    LOG_DEBUG("RelayMode created");
+}
+
+RelayMode::~RelayMode() {
+    stop();
+    LOG_DEBUG("RelayMode destroyed");
+}
+
+int RelayMode::start(std::atomic<bool>& running) {
+    if (running_) {
+        LOG_ERROR("Relay mode is already running");
+        return 1;
+    }
+
+    auto& log = Logger::instance();
+
+    log.info("═══════════════════════════════════════════════════════");
+    log.info("Starting RELAY MODE (Rendezvous)");
+    log.successf("Listen port: %u", config_.listenPort);
+    log.successf("Peer timeout: %d ms, max sessions: %zu",
+                 config_.peerTimeoutMs, config_.maxSessions);
+    if (config_.frameLevel) {
+        log.successf("Frame-level: re-fragment at MTU %zu (%zu bytes payload)",
+                     config_.outputMtu, Protocol::payloadSizeForMtu(config_.outputMtu));
+    }
+    if (config_.fanout) {
+        log.successf("Fan-out: up to %zu joins per session, queue %zu packets, GOP cache %.1f MB",
+                     config_.maxSubscribers, config_.subscriberQueuePackets,
+                     config_.gopCacheBytes / (1024.0 * 1024.0));
+    }
+    if (rendition_ >= 0) {
+        log.successf("Simulcast: relaying video rendition %d only", rendition_);
+    }
+    log.info("═══════════════════════════════════════════════════════");
+
+    if (!openSocket()) {
+        return 1;
+    }
+
+    recvSlots_.resize(BATCH_SIZE);
+    sendSlots_.reserve(BATCH_SIZE);
+
+    running_ = true;
+    startTime_ = std::chrono::steady_clock::now();
+    ioThread_ = std::thread(&RelayMode::ioLoop, this);
+
+    log.success("═══════════════════════════════════════════════════════");
+    log.success("RELAY MODE STARTED");
+    log.successf("Waiting for host/join registrations on port %u...", config_.listenPort);
+    log.success("═══════════════════════════════════════════════════════");
+    log.info("Press Ctrl+C to stop...");
+
+    // Main loop - periodic stats, I/O runs on its own thread
+    auto lastStats = std::chrono::steady_clock::now();
+    uint64_t lastBytes = 0;
+    while (running && running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        auto now = std::chrono::steady_clock::now();
+        double sinceLast = std::chrono::duration<double>(now - lastStats).count();
+        if (sinceLast >= 5.0) {
+            auto stats = getStats();
+            double rateMbps = (stats.bytesForwarded - lastBytes) * 8.0 / sinceLast / 1e6;
+            lastBytes = stats.bytesForwarded;
+            lastStats = now;
+            log.infof("[RELAY] sessions=%lu pkts=%lu fwd=%lu bytes=%.1fMB rate=%.1fMbps unrouted=%lu eagain=%lu invalid=%lu filtered=%lu time=%.0fs",
+                      stats.activeSessions, stats.packetsReceived, stats.packetsForwarded,
+                      stats.bytesForwarded / (1024.0 * 1024.0), rateMbps,
+                      stats.packetsUnrouted, stats.packetsDroppedEagain,
+                      stats.invalidPackets, stats.packetsFiltered, stats.runTimeSeconds);
+            if (config_.frameLevel) {
+                log.infof("[RELAY] frames=%lu keyframes=%.1f%% dropped=%lu latency=%.1fms (max %.1fms)",
+                          stats.framesRelayed,
+                          stats.framesRelayed > 0 ? 100.0 * stats.keyframesRelayed / stats.framesRelayed : 0.0,
+                          stats.framesDropped, stats.avgLatencyMs, stats.maxLatencyMs);
+            }
+            if (config_.fanout) {
+                log.infof("[RELAY] subscribers=%lu cached_starts=%lu drops=%lu resyncs=%lu",
+                          stats.subscribers, stats.cachedStarts,
+                          stats.subscriberDrops, stats.subscriberResyncs);
+            }
+        }
+    }
+
+    auto finalStats = getStats();
+
+    // Cleanup
+    stop();
+
+    log.success("═══════════════════════════════════════════════════════");
+    log.success("RELAY MODE STOPPED");
+    log.successf("Duration: %.1f seconds", finalStats.runTimeSeconds);
+    log.successf("Packets: %lu received, %lu forwarded (%.2f MB), %lu unrouted, %lu invalid",
+                 finalStats.packetsReceived, finalStats.packetsForwarded,
+                 finalStats.bytesForwarded / (1024.0 * 1024.0),
+                 finalStats.packetsUnrouted, finalStats.invalidPackets);
+    log.successf("Registrations: %lu (%lu sessions at exit)",
+                 finalStats.registrations, finalStats.activeSessions);
+    if (config_.frameLevel) {
+        log.successf("Frames: %lu relayed (%lu keyframes), %lu dropped incomplete, latency avg %.1fms",
+                     finalStats.framesRelayed, finalStats.keyframesRelayed,
+                     finalStats.framesDropped, finalStats.avgLatencyMs);
+    }
+    if (config_.fanout) {
+        log.successf("Fan-out: %lu cached starts, %lu packets dropped, %lu resyncs",
+                     finalStats.cachedStarts, finalStats.subscriberDrops,
+                     finalStats.subscriberResyncs);
+    }
+    log.success("═══════════════════════════════════════════════════════");
+
+    return 0;
+}
+
+void RelayMode::stop() {
+    // Atomic CAS: only ONE thread enters the stop logic (prevents double-join crash)
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false)) return;
+
+    LOG_INFO("Stopping Relay Mode...");
+
+    if (ioThread_.joinable()) {
+        ioThread_.join();
+    }
+
+#ifdef __linux__
+    if (epollFd_ >= 0) {
+        close(epollFd_);
+        epollFd_ = -1;
+    }
+#endif
+
+    if (socket_ != INVALID_SOCKET_VAL) {
+        platform_close_socket(socket_);
+        socket_ = INVALID_SOCKET_VAL;
+    }
+}
+
+RelayMode::Stats RelayMode::getStats() const {
+    Stats stats;
+    stats.packetsReceived = packetsReceived_;
+    stats.packetsForwarded = packetsForwarded_;
+    stats.bytesForwarded = bytesForwarded_;
+    stats.packetsUnrouted = packetsUnrouted_;
+    stats.packetsDroppedEagain = packetsDroppedEagain_;
+    stats.invalidPackets = invalidPackets_;
+    stats.packetsFiltered = packetsFiltered_;
+    stats.registrations = registrations_;
+    stats.activeSessions = activeSessions_;
+    stats.framesRelayed = framesRelayed_;
+    stats.keyframesRelayed = keyframesRelayed_;
+    stats.framesDropped = framesDropped_;
+    uint64_t samples = latencySamples_;
+    if (samples > 0) {
+        stats.avgLatencyMs = latencySumUs_ / 1000.0 / samples;
+    }
+    stats.maxLatencyMs = maxLatencyUs_ / 1000.0;
+    stats.subscribers = subscribers_;
+    stats.subscriberDrops = subscriberDrops_;
+    stats.subscriberResyncs = subscriberResyncs_;
+    stats.cachedStarts = cachedStarts_;
+
+    if (running_) {
+        auto now = std::chrono::steady_clock::now();
+        stats.runTimeSeconds = std::chrono::duration<double>(now - startTime_).count();
+    }
+
+    return stats;
+}
+
+// ============================================================================
+// Socket / I/O loop
+// ============================================================================
+
+bool RelayMode::openSocket() {
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ == INVALID_SOCKET_VAL) {
+        int err = platform_socket_errno();
+        Logger::instance().errorf("Failed to create socket: %s", platform_socket_strerror(err));
+        return false;
+    }
+
+    int optval = 1;
+    setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<const char*>(&optval), sizeof(optval));
+
+    int bufSize = static_cast<int>(config_.socketBufferSize);
+    setsockopt(socket_, SOL_SOCKET, SO_RCVBUF,
+               reinterpret_cast<const char*>(&bufSize), sizeof(bufSize));
+    setsockopt(socket_, SOL_SOCKET, SO_SNDBUF,
+               reinterpret_cast<const char*>(&bufSize), sizeof(bufSize));
+
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config_.listenPort);
+    addr.sin_addr.s_addr = INADDR_ANY;
+
+    if (bind(socket_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        int err = platform_socket_errno();
+        Logger::instance().errorf("Failed to bind to port %u: %s",
+                                  config_.listenPort, platform_socket_strerror(err));
+        platform_close_socket(socket_);
+        socket_ = INVALID_SOCKET_VAL;
+        return false;
+    }
+
+    platform_set_nonblocking(socket_);
+
+#ifdef __linux__
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        Logger::instance().errorf("Failed to create epoll: %s", strerror(errno));
+        platform_close_socket(socket_);
+        socket_ = INVALID_SOCKET_VAL;
+        return false;
+    }
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = socket_;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, socket_, &ev);
+#endif
+
+    Logger::instance().successf("Relay listening on UDP port %u", config_.listenPort);
+    return true;
+}
+
+void RelayMode::ioLoop() {
+    LOG_DEBUG("Relay I/O thread started");
+
+    auto lastHousekeeping = Clock::now();
+    auto lastSessionLog = lastHousekeeping;
+
+    while (running_) {
+        // Wait for readability (100ms timeout for housekeeping + shutdown,
+        // 1ms while subscriber queues still hold packets)
+        int timeoutMs = queuedPackets_ > 0 ? 1 : 100;
+#ifdef __linux__
+        struct epoll_event events[1];
+        int ret = epoll_wait(epollFd_, events, 1, timeoutMs);
+#else
+#ifdef _WIN32
+        WSAPOLLFD pfd;
+#else
+        struct pollfd pfd;
+#endif
+        pfd.fd = socket_;
+        pfd.events = POLLIN;
+        int ret = platform_poll(&pfd, 1, timeoutMs);
+#endif
+        if (ret < 0) {
+            int err = platform_socket_errno();
+            if (err == PLATFORM_EINTR) continue;
+            Logger::instance().errorf("Relay wait error: %s", platform_socket_strerror(err));
+            break;
+        }
+
+        // Drain the socket batch by batch until it would block
+        while (ret > 0 && running_) {
+            size_t count = receiveBatch();
+            if (count == 0) break;
+
+            auto now = Clock::now();
+            for (size_t i = 0; i < count; i++) {
+                handleDatagram(recvSlots_[i], now);
+            }
+            flushSends();
+            flushSubscribers();
+
+            if (count < BATCH_SIZE) break;
+        }
+        flushSubscribers();
+
+        auto now = Clock::now();
+        if (now - lastHousekeeping >= std::chrono::seconds(1)) {
+            lastHousekeeping = now;
+            expirePeers(now);
+        }
+        if (Logger::instance().isVerbose() && now - lastSessionLog >= std::chrono::seconds(5)) {
+            lastSessionLog = now;
+            logSessions();
+        }
+    }
+
+    LOG_DEBUG("Relay I/O thread stopped");
+}
+
+size_t RelayMode::receiveBatch() {
+#ifdef __linux__
+    struct mmsghdr msgs[BATCH_SIZE];
+    struct iovec iovs[BATCH_SIZE];
+    std::memset(msgs, 0, sizeof(msgs));
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        iovs[i].iov_base = recvSlots_[i].data;
+        iovs[i].iov_len = MAX_DATAGRAM_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &recvSlots_[i].from;
+        msgs[i].msg_hdr.msg_namelen = sizeof(recvSlots_[i].from);
+    }
+
+    int n = recvmmsg(socket_, msgs, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (n < 0) {
+        int err = errno;
+        if (err != EAGAIN && err != EWOULDBLOCK && err != EINTR) {
+            Logger::instance().errorf("Relay receive error: %s", strerror(err));
+        }
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        recvSlots_[i].size = msgs[i].msg_len;
+    }
+    return static_cast<size_t>(n);
+#else
+    size_t count = 0;
+    while (count < BATCH_SIZE) {
+        RecvSlot& slot = recvSlots_[count];
+        socklen_t fromLen = sizeof(slot.from);
+#ifdef _WIN32
+        int received = recvfrom(socket_, reinterpret_cast<char*>(slot.data),
+                                static_cast<int>(MAX_DATAGRAM_SIZE), 0,
+                                reinterpret_cast<struct sockaddr*>(&slot.from), &fromLen);
+#else
+        ssize_t received = recvfrom(socket_, slot.data, MAX_DATAGRAM_SIZE, MSG_DONTWAIT,
+                                    reinterpret_cast<struct sockaddr*>(&slot.from), &fromLen);
+#endif
+        if (received < 0) break;
+        slot.size = static_cast<size_t>(received);
+        count++;
+    }
+    return count;
+#endif
+}
+
+void RelayMode::flushSends() {
+    if (sendSlots_.empty()) return;
+
+#ifdef __linux__
+    struct mmsghdr msgs[BATCH_SIZE];
+    struct iovec iovs[BATCH_SIZE];
+    std::memset(msgs, 0, sizeof(msgs));
+    size_t total = sendSlots_.size();
+    for (size_t i = 0; i < total; i++) {
+        iovs[i].iov_base = const_cast<uint8_t*>(sendSlots_[i].data);
+        iovs[i].iov_len = sendSlots_[i].size;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &sendSlots_[i].to;
+        msgs[i].msg_hdr.msg_namelen = sizeof(sendSlots_[i].to);
+    }
+
+    size_t offset = 0;
+    while (offset < total) {
+        int n = sendmmsg(socket_, msgs + offset, static_cast<unsigned int>(total - offset),
+                         MSG_DONTWAIT);
+        if (n < 0) {
+            // Head datagram failed (EAGAIN or unreachable peer) — drop it, keep going
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                packetsDroppedEagain_++;
+            }
+            offset++;
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            packetsForwarded_++;
+            bytesForwarded_ += msgs[offset + i].msg_len;
+        }
+        offset += static_cast<size_t>(n);
+    }
+#else
+    for (const auto& slot : sendSlots_) {
+#ifdef _WIN32
+        int sent = sendto(socket_, reinterpret_cast<const char*>(slot.data),
+                          static_cast<int>(slot.size), 0,
+                          reinterpret_cast<const struct sockaddr*>(&slot.to), sizeof(slot.to));
+#else
+        ssize_t sent = sendto(socket_, slot.data, slot.size, MSG_DONTWAIT,
+                              reinterpret_cast<const struct sockaddr*>(&slot.to), sizeof(slot.to));
+#endif
+        if (sent < 0) {
+            int err = platform_socket_errno();
+            if (err == PLATFORM_EAGAIN || err == PLATFORM_EWOULDBLOCK) {
+                packetsDroppedEagain_++;
+            }
+            continue;
+        }
+        packetsForwarded_++;
+        bytesForwarded_ += static_cast<uint64_t>(sent);
+    }
+#endif
+
+    sendSlots_.clear();
+}
+
+// ============================================================================
+// Routing
+// ============================================================================
+
+void RelayMode::handleDatagram(const RecvSlot& slot, Clock::time_point now) {
+    packetsReceived_++;
+
+    uint32_t magic = Protocol::peekMagic(slot.data, slot.size);
+
+    if (magic == RENDEZVOUS_MAGIC) {
+        auto packet = Protocol::deserializeRendezvous(slot.data, slot.size);
+        if (!packet) {
+            invalidPackets_++;
+            return;
+        }
+        registerPeer(*packet, slot.from, now);
+        return;
+    }
+
+    const bool receiverReport = magic == RECEIVER_REPORT_MAGIC;
+    if (!receiverReport && (magic != PROTOCOL_MAGIC || slot.size < LEGACY_HEADER_SIZE)) {
+        invalidPackets_++;
+        return;
+    }
+
+    auto it = flows_.find(flowKey(slot.from));
+    if (it == flows_.end()) {
+        packetsUnrouted_++;
+        return;
+    }
+
+    const Flow& flow = it->second;
+    Session* session = flow.session;
+    Peer& src = flow.subscriber ? flow.subscriber->peer
+                                : session->peers[static_cast<size_t>(flow.role)];
+    Peer& dst = session->peers[1 - static_cast<size_t>(flow.role)];
+    src.lastSeen = now;
+    src.packets++;
+    src.bytes += slot.size;
+
+    if (receiverReport) {
+        // Reports only travel upstream (join → host), in every relay mode
+        if (flow.role != RendezvousRole::Join || !dst.known) {
+            packetsUnrouted_++;
+            return;
+        }
+        sendSlots_.push_back(SendSlot{slot.data, slot.size, dst.addr});
+        return;
+    }
+
+    // Simulcast: keep one rendition (header bytes 5/6: media type, sourceId)
+    if (rendition_ >= 0 && flow.role == RendezvousRole::Host &&
+        slot.data[5] == static_cast<uint8_t>(MediaType::Video) && slot.data[6] != rendition_) {
+        packetsFiltered_++;
+        return;
+    }
+
+    if (config_.frameLevel && flow.role == RendezvousRole::Host) {
+        handleFrameLevel(*session, slot, dst, now);
+        return;
+    }
+
+    if (config_.fanout && flow.role == RendezvousRole::Host) {
+        auto headerOpt = Protocol::deserialize(slot.data, slot.size);
+        if (!headerOpt) {
+            invalidPackets_++;
+            return;
+        }
+        // One copy per ingest packet, shared by reference by every subscriber
+        auto dgram = std::make_shared<Datagram>();
+        dgram->size = slot.size;
+        std::memcpy(dgram->data, slot.data, slot.size);
+        fanOutPacket(*session, dgram, *headerOpt);
+        return;
+    }
+
+    if (!dst.known) {
+        packetsUnrouted_++;
+        return;
+    }
+
+    // Forward as-is (sendTimestamp preserved → join measures end-to-end latency)
+    sendSlots_.push_back(SendSlot{slot.data, slot.size, dst.addr});
+}
+
+void RelayMode::handleFrameLevel(Session& session, const RecvSlot& slot, const Peer& dst,
+                                 Clock::time_point now) {
+    auto headerOpt = Protocol::deserialize(slot.data, slot.size);
+    if (!headerOpt || !Protocol::isValid(*headerOpt) || slot.size < HEADER_SIZE) {
+        invalidPackets_++;
+        return;
+    }
+    const PacketHeader& header = *headerOpt;
+
+    FrameReassembler& reassembler = header.isVideo() ? session.videoReassembler
+                                                     : session.audioReassembler;
+    uint64_t droppedBefore = reassembler.getStats().framesDropped;
+    auto frameOpt = reassembler.addPacket(header, slot.data + HEADER_SIZE,
+                                          slot.size - HEADER_SIZE);
+    framesDropped_ += reassembler.getStats().framesDropped - droppedBefore;
+    if (!frameOpt) return;
+
+    auto& frame = *frameOpt;
+    if (frame.type == MediaType::Video) {
+        updateFrameStats(session.frameStats, frame, now);
+    }
+
+    if (config_.fanout) {
+        fanOutFrame(session, frame);
+    } else if (dst.known) {
+        sendFrame(frame, dst.addr);
+    } else {
+        packetsUnrouted_++;
+    }
+
+    // Buffer goes back to the reassembler for the next frame
+    reassembler.recycle(std::move(frame.data));
+}
+
+void RelayMode::sendFrame(const FrameReassembler::Frame& frame, const struct sockaddr_in& to) {
+    const size_t maxPayload = Protocol::payloadSizeForMtu(config_.outputMtu);
+    const uint32_t totalSize = static_cast<uint32_t>(frame.data.size());
+    const uint16_t fragmentCount = Protocol::calculateFragmentCount(totalSize, maxPayload);
+    if (fragmentCount == 0) return;
+
+    // Headers are rebuilt per fragment; sequence number, flags and the
+    // original sendTimestamp are kept so the join still measures
+    // end-to-end latency.
+    if (fragHeaders_.size() < fragmentCount) {
+        fragHeaders_.resize(fragmentCount);
+    }
+    for (uint16_t i = 0; i < fragmentCount; i++) {
+        Protocol::serializeInto(fragmentHeader(frame, i, fragmentCount, maxPayload),
+                                fragHeaders_[i].data());
+    }
+
+#ifdef __linux__
+    // Scatter-gather: [header][payload slice of the reassembled buffer]
+    struct mmsghdr msgs[BATCH_SIZE];
+    struct iovec iovs[BATCH_SIZE][2];
+    uint8_t* payload = const_cast<uint8_t*>(frame.data.data());
+
+    for (size_t base = 0; base < fragmentCount; base += BATCH_SIZE) {
+        size_t count = std::min(BATCH_SIZE, static_cast<size_t>(fragmentCount) - base);
+        std::memset(msgs, 0, sizeof(struct mmsghdr) * count);
+        for (size_t j = 0; j < count; j++) {
+            size_t i = base + j;
+            size_t offset = i * maxPayload;
+            iovs[j][0].iov_base = fragHeaders_[i].data();
+            iovs[j][0].iov_len = HEADER_SIZE;
+            iovs[j][1].iov_base = payload + offset;
+            iovs[j][1].iov_len = std::min(maxPayload, static_cast<size_t>(totalSize) - offset);
+            msgs[j].msg_hdr.msg_iov = iovs[j];
+            msgs[j].msg_hdr.msg_iovlen = 2;
+            msgs[j].msg_hdr.msg_name = const_cast<struct sockaddr_in*>(&to);
+            msgs[j].msg_hdr.msg_namelen = sizeof(to);
+        }
+
+        size_t sent = 0;
+        while (sent < count) {
+            int n = sendmmsg(socket_, msgs + sent, static_cast<unsigned int>(count - sent),
+                             MSG_DONTWAIT);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    packetsDroppedEagain_++;
+                }
+                sent++;
+                continue;
+            }
+            for (int k = 0; k < n; k++) {
+                packetsForwarded_++;
+                bytesForwarded_ += msgs[sent + k].msg_len;
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+#else
+    // No sendmmsg/iovec here: assemble each datagram in a scratch buffer
+    uint8_t packet[MAX_DATAGRAM_SIZE];
+    for (uint16_t i = 0; i < fragmentCount; i++) {
+        size_t offset = static_cast<size_t>(i) * maxPayload;
+        size_t payloadSize = std::min(maxPayload, static_cast<size_t>(totalSize) - offset);
+        std::memcpy(packet, fragHeaders_[i].data(), HEADER_SIZE);
+        std::memcpy(packet + HEADER_SIZE, frame.data.data() + offset, payloadSize);
+#ifdef _WIN32
+        int sent = sendto(socket_, reinterpret_cast<const char*>(packet),
+                          static_cast<int>(HEADER_SIZE + payloadSize), 0,
+                          reinterpret_cast<const struct sockaddr*>(&to), sizeof(to));
+#else
+        ssize_t sent = sendto(socket_, packet, HEADER_SIZE + payloadSize, MSG_DONTWAIT,
+                              reinterpret_cast<const struct sockaddr*>(&to), sizeof(to));
+#endif
+        if (sent < 0) {
+            int err = platform_socket_errno();
+            if (err == PLATFORM_EAGAIN || err == PLATFORM_EWOULDBLOCK) {
+                packetsDroppedEagain_++;
+            }
+            continue;
+        }
+        packetsForwarded_++;
+        bytesForwarded_ += static_cast<uint64_t>(sent);
+    }
+#endif
+}
+
+PacketHeader RelayMode::fragmentHeader(const FrameReassembler::Frame& frame, uint16_t index,
+                                      uint16_t fragmentCount, size_t maxPayload) const {
+    const uint32_t totalSize = static_cast<uint32_t>(frame.data.size());
+    size_t offset = static_cast<size_t>(index) * maxPayload;
+    uint16_t payloadSize = static_cast<uint16_t>(std::min(maxPayload, totalSize - offset));
+    PacketHeader header = frame.type == MediaType::Video
+        ? Protocol::createVideoHeader(frame.sequenceNumber, frame.timestamp, totalSize,
+                                      index, fragmentCount, payloadSize, frame.isKeyframe)
+        : Protocol::createAudioHeader(frame.sequenceNumber, frame.timestamp, totalSize,
+                                      index, fragmentCount, payloadSize,
+                                      frame.sampleRate, frame.channels);
+    header.sourceId = frame.sourceId;
+    header.flags = frame.flags;
+    header.codec = frame.codec;
+    header.sendTimestamp = frame.sendTimestamp;
+    return header;
+}
+
+void RelayMode::updateFrameStats(FrameStats& fs, const FrameReassembler::Frame& frame,
+                                 Clock::time_point now) {
+    fs.frames++;
+    framesRelayed_++;
+    if (frame.isKeyframe) {
+        fs.keyframes++;
+        keyframesRelayed_++;
+    }
+
+    // One-way latency host → relay (needs synchronized clocks, like the join's)
+    if (frame.sendTimestamp > 0) {
+        uint64_t nowNs = Protocol::wallClockNs();
+        if (nowNs > frame.sendTimestamp) {
+            uint64_t latencyUs = (nowNs - frame.sendTimestamp) / 1000;
+            fs.lastLatencyMs = latencyUs / 1000.0;
+            fs.latencySumMs += fs.lastLatencyMs;
+            fs.latencySamples++;
+            fs.maxLatencyMs = std::max(fs.maxLatencyMs, fs.lastLatencyMs);
+            latencySumUs_ += latencyUs;
+            latencySamples_++;
+            if (latencyUs > maxLatencyUs_) maxLatencyUs_ = latencyUs;
+        }
+    }
+
+    // Instantaneous bitrate, refreshed about once per second
+    if (fs.windowBytes == 0 && fs.windowStart == Clock::time_point{}) {
+        fs.windowStart = now;
+    }
+    fs.windowBytes += frame.data.size();
+    double elapsed = std::chrono::duration<double>(now - fs.windowStart).count();
+    if (elapsed >= 1.0) {
+        fs.bitrateMbps = fs.windowBytes * 8.0 / elapsed / 1e6;
+        fs.windowBytes = 0;
+        fs.windowStart = now;
+    }
+}
+
+// ============================================================================
+// Fan-out (SFU)
+// ============================================================================
+
+void RelayMode::fanOutFrame(Session& session, const FrameReassembler::Frame& frame) {
+    const size_t maxPayload = Protocol::payloadSizeForMtu(config_.outputMtu);
+    const uint16_t fragmentCount = Protocol::calculateFragmentCount(
+        static_cast<uint32_t>(frame.data.size()), maxPayload);
+
+    // Subscriber queues outlive the frame buffer: build standalone datagrams
+    for (uint16_t i = 0; i < fragmentCount; i++) {
+        PacketHeader header = fragmentHeader(frame, i, fragmentCount, maxPayload);
+        auto dgram = std::make_shared<Datagram>();
+        Protocol::serializeInto(header, dgram->data);
+        std::memcpy(dgram->data + HEADER_SIZE,
+                    frame.data.data() + static_cast<size_t>(i) * maxPayload, header.payloadSize);
+        dgram->size = HEADER_SIZE + header.payloadSize;
+        fanOutPacket(session, dgram, header);
+    }
+}
+
+void RelayMode::fanOutPacket(Session& session, const SharedDatagram& dgram,
+                             const PacketHeader& header) {
+    const bool video = header.isVideo();
+    const bool keyframeStart = video && header.isKeyframe() && header.fragmentIndex == 0;
+
+    // GOP cache: restarts on every new keyframe (which carries SPS/PPS),
+    // abandoned until the next one if the GOP outgrows its budget
+    if (video) {
+        if (header.isKeyframe() && header.sequenceNumber != session.gopCacheSeq) {
+            session.gopCache.clear();
+            session.gopCacheBytes = 0;
+            session.gopCacheSeq = header.sequenceNumber;
+            session.gopCacheValid = true;
+        }
+        if (session.gopCacheValid) {
+            session.gopCache.push_back(dgram);
+            session.gopCacheBytes += dgram->size;
+            if (session.gopCacheBytes > config_.gopCacheBytes) {
+                session.gopCache.clear();
+                session.gopCacheBytes = 0;
+                session.gopCacheValid = false;
+            }
+        }
+    }
+
+    if (session.subscribers.empty()) {
+        packetsUnrouted_++;
+        return;
+    }
+
+    for (auto& sub : session.subscribers) {
+        // Video is gated until the subscriber can decode it; audio always flows
+        if (video && sub->waitingForKeyframe) {
+            if (!keyframeStart) continue;
+            sub->waitingForKeyframe = false;
+        }
+        enqueue(*sub, dgram);
+    }
+}
+
+void RelayMode::enqueue(Subscriber& sub, const SharedDatagram& dgram) {
+    if (sub.queue.size() >= config_.subscriberQueuePackets) {
+        // Too far behind: drop its backlog and resync it alone on the next keyframe
+        Logger::instance().debugf("[RELAY] Subscriber %s overflowed (%zu packets), resyncing",
+                                  describeAddr(sub.peer.addr).c_str(), sub.queue.size());
+        subscriberDrops_ += sub.queue.size() + 1;
+        subscriberResyncs_++;
+        queuedPackets_ -= sub.queue.size();
+        sub.queue.clear();
+        sub.waitingForKeyframe = true;
+        return;
+    }
+    sub.queue.push_back(dgram);
+    queuedPackets_++;
+}
+
+void RelayMode::flushSubscribers() {
+    if (queuedPackets_ == 0) return;
+
+    readySubscribers_.clear();
+    for (auto& entry : sessions_) {
+        for (auto& sub : entry.second->subscribers) {
+            if (!sub->queue.empty()) readySubscribers_.push_back(sub.get());
+        }
+    }
+
+    // Round-robin: at most FANOUT_QUANTUM packets per subscriber per round,
+    // so a large backlog (e.g. a GOP replay) cannot delay live packets of others
+    auto popSent = [this](Subscriber* sub, size_t size, bool forwarded) {
+        sub->queue.pop_front();
+        queuedPackets_--;
+        if (forwarded) {
+            packetsForwarded_++;
+            bytesForwarded_ += size;
+        }
+    };
+
+#ifdef __linux__
+    struct mmsghdr msgs[BATCH_SIZE];
+    struct iovec iovs[BATCH_SIZE];
+    Subscriber* owners[BATCH_SIZE];
+
+    while (!readySubscribers_.empty()) {
+        size_t count = 0;
+        size_t visited = 0;
+        std::memset(msgs, 0, sizeof(msgs));
+        for (Subscriber* sub : readySubscribers_) {
+            if (count == BATCH_SIZE) break;
+            size_t take = std::min({FANOUT_QUANTUM, sub->queue.size(), BATCH_SIZE - count});
+            for (size_t k = 0; k < take; k++) {
+                const Datagram& d = *sub->queue[k];
+                iovs[count].iov_base = const_cast<uint8_t*>(d.data);
+                iovs[count].iov_len = d.size;
+                msgs[count].msg_hdr.msg_iov = &iovs[count];
+                msgs[count].msg_hdr.msg_iovlen = 1;
+                msgs[count].msg_hdr.msg_name = &sub->peer.addr;
+                msgs[count].msg_hdr.msg_namelen = sizeof(sub->peer.addr);
+                owners[count] = sub;
+                count++;
+            }
+            visited++;
+        }
+
+        int n = sendmmsg(socket_, msgs, static_cast<unsigned int>(count), MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;  // Socket buffer full: queues keep their backlog for the next pass
+            }
+            // Head datagram rejected (e.g. unreachable peer) — drop it, keep going
+            popSent(owners[0], 0, false);
+        } else {
+            for (int i = 0; i < n; i++) {
+                popSent(owners[i], msgs[i].msg_len, true);
+            }
+        }
+
+        // Next round starts with the subscribers this one did not reach
+        std::rotate(readySubscribers_.begin(), readySubscribers_.begin() + visited,
+                    readySubscribers_.end());
+        readySubscribers_.erase(
+            std::remove_if(readySubscribers_.begin(), readySubscribers_.end(),
+                           [](Subscriber* sub) { return sub->queue.empty(); }),
+            readySubscribers_.end());
+    }
+#else
+    bool socketFull = false;
+    while (!readySubscribers_.empty() && !socketFull) {
+        for (Subscriber* sub : readySubscribers_) {
+            size_t take = std::min(FANOUT_QUANTUM, sub->queue.size());
+            for (size_t k = 0; k < take; k++) {
+                const Datagram& d = *sub->queue.front();
+#ifdef _WIN32
+                int sent = sendto(socket_, reinterpret_cast<const char*>(d.data),
+                                  static_cast<int>(d.size), 0,
+                                  reinterpret_cast<const struct sockaddr*>(&sub->peer.addr),
+                                  sizeof(sub->peer.addr));
+#else
+                ssize_t sent = sendto(socket_, d.data, d.size, MSG_DONTWAIT,
+                                      reinterpret_cast<const struct sockaddr*>(&sub->peer.addr),
+                                      sizeof(sub->peer.addr));
+#endif
+                if (sent < 0) {
+                    int err = platform_socket_errno();
+                    if (err == PLATFORM_EAGAIN || err == PLATFORM_EWOULDBLOCK) {
+                        socketFull = true;
+                        break;
+                    }
+                    popSent(sub, 0, false);
+                    continue;
+                }
+                popSent(sub, static_cast<size_t>(sent), true);
+            }
+            if (socketFull) break;
+        }
+        readySubscribers_.erase(
+            std::remove_if(readySubscribers_.begin(), readySubscribers_.end(),
+                           [](Subscriber* sub) { return sub->queue.empty(); }),
+            readySubscribers_.end());
+    }
+#endif
+}
+
+void RelayMode::addSubscriber(Session& session, const struct sockaddr_in& from,
+                              Clock::time_point now) {
+    auto sub = std::make_unique<Subscriber>();
+    sub->peer.addr = from;
+    sub->peer.known = true;
+    sub->peer.lastSeen = now;
+
+    // Instant start: replay the cached GOP (IDR + SPS/PPS onwards) by reference
+    bool cached = session.gopCacheValid && !session.gopCache.empty() &&
+                  session.gopCache.size() < config_.subscriberQueuePackets;
+    if (cached) {
+        for (const auto& dgram : session.gopCache) {
+            enqueue(*sub, dgram);
+        }
+        sub->waitingForKeyframe = false;
+        cachedStarts_++;
+    }
+
+    flows_[flowKey(from)] = Flow{&session, RendezvousRole::Join, sub.get()};
+    session.subscribers.push_back(std::move(sub));
+    subscribers_++;
+
+    Logger::instance().successf("[RELAY] Session '%s': subscriber %zu registered from %s (%s)",
+                                session.key.c_str(), session.subscribers.size(),
+                                describeAddr(from).c_str(),
+                                cached ? "started from cached GOP" : "waiting for keyframe");
+}
+
+void RelayMode::removeSubscriber(Session& session, Subscriber* sub) {
+    queuedPackets_ -= sub->queue.size();
+    flows_.erase(flowKey(sub->peer.addr));
+    auto it = std::find_if(session.subscribers.begin(), session.subscribers.end(),
+                           [sub](const std::unique_ptr<Subscriber>& s) { return s.get() == sub; });
+    if (it != session.subscribers.end()) {
+        session.subscribers.erase(it);
+        subscribers_--;
+    }
+}
+
+// ============================================================================
+// Registration
+// ============================================================================
+
+void RelayMode::registerPeer(const RendezvousPacket& packet, const struct sockaddr_in& from,
+                             Clock::time_point now) {
+    uint64_t key = flowKey(from);
+    size_t roleIdx = static_cast<size_t>(packet.role);
+
+    // Fast path: keepalive from an already-registered flow
+    auto flowIt = flows_.find(key);
+    if (flowIt != flows_.end()) {
+        const Flow& flow = flowIt->second;
+        if (flow.session->key == packet.sessionKey && flow.role == packet.role) {
+            Peer& peer = flow.subscriber ? flow.subscriber->peer : flow.session->peers[roleIdx];
+            peer.lastSeen = now;
+            return;
+        }
+        // Address re-used for another session/role — detach it first
+        Session* old = flow.session;
+        if (flow.subscriber) {
+            removeSubscriber(*old, flow.subscriber);
+        } else {
+            old->peers[static_cast<size_t>(flow.role)].known = false;
+            flows_.erase(flowIt);
+        }
+    }
+
+    auto sessionIt = sessions_.find(packet.sessionKey);
+    if (sessionIt == sessions_.end()) {
+        if (sessions_.size() >= config_.maxSessions) {
+            Logger::instance().errorf("[RELAY] Session limit reached (%zu), refusing '%s' from %s",
+                                      config_.maxSessions, packet.sessionKey.c_str(),
+                                      describeAddr(from).c_str());
+            return;
+        }
+        auto session = std::make_unique<Session>();
+        session->key = packet.sessionKey;
+        sessionIt = sessions_.emplace(packet.sessionKey, std::move(session)).first;
+        activeSessions_ = sessions_.size();
+    }
+
+    Session* session = sessionIt->second.get();
+
+    // Fan-out: every join address is its own subscriber
+    if (config_.fanout && packet.role == RendezvousRole::Join) {
+        if (session->subscribers.size() >= config_.maxSubscribers) {
+            Logger::instance().errorf("[RELAY] Session '%s': subscriber limit reached (%zu), refusing %s",
+                                      session->key.c_str(), config_.maxSubscribers,
+                                      describeAddr(from).c_str());
+            return;
+        }
+        addSubscriber(*session, from, now);
+        registrations_++;
+        return;
+    }
+
+    Peer& peer = session->peers[roleIdx];
+
+    // NAT rebinding: same role re-registers from a new address
+    if (peer.known) {
+        Logger::instance().infof("[RELAY] Session '%s': %s moved %s -> %s",
+                                 session->key.c_str(),
+                                 packet.role == RendezvousRole::Host ? "host" : "join",
+                                 describeAddr(peer.addr).c_str(), describeAddr(from).c_str());
+        flows_.erase(flowKey(peer.addr));
+    }
+
+    peer.addr = from;
+    peer.known = true;
+    peer.lastSeen = now;
+    flows_[key] = Flow{session, packet.role};
+    registrations_++;
+
+    bool paired = session->peers[0].known &&
+                  (session->peers[1].known || !session->subscribers.empty());
+    Logger::instance().successf("[RELAY] Session '%s': %s registered from %s%s",
+                                session->key.c_str(),
+                                packet.role == RendezvousRole::Host ? "host" : "join",
+                                describeAddr(from).c_str(),
+                                paired ? " (paired)" : "");
+}
+
+void RelayMode::expirePeers(Clock::time_point now) {
+    auto timeout = std::chrono::milliseconds(config_.peerTimeoutMs);
+
+    for (auto it = sessions_.begin(); it != sessions_.end();) {
+        Session* session = it->second.get();
+        for (size_t role = 0; role < 2; role++) {
+            Peer& peer = session->peers[role];
+            if (peer.known && now - peer.lastSeen > timeout) {
+                Logger::instance().infof("[RELAY] Session '%s': %s %s timed out",
+                                         session->key.c_str(), role == 0 ? "host" : "join",
+                                         describeAddr(peer.addr).c_str());
+                flows_.erase(flowKey(peer.addr));
+                peer = Peer{};
+            }
+        }
+
+        auto& subs = session->subscribers;
+        for (size_t i = 0; i < subs.size();) {
+            if (now - subs[i]->peer.lastSeen > timeout) {
+                Logger::instance().infof("[RELAY] Session '%s': subscriber %s timed out",
+                                         session->key.c_str(),
+                                         describeAddr(subs[i]->peer.addr).c_str());
+                removeSubscriber(*session, subs[i].get());
+            } else {
+                i++;
+            }
+        }
+
+        if (!session->peers[0].known && !session->peers[1].known && subs.empty()) {
+            it = sessions_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    activeSessions_ = sessions_.size();
+}
+
+void RelayMode::logSessions() {
+    for (const auto& entry : sessions_) {
+        const Session& s = *entry.second;
+        Logger::instance().debugf("[RELAY] '%s': host=%s (%lu pkts, %.1fMB) join=%s (%lu pkts)",
+                                  s.key.c_str(),
+                                  s.peers[0].known ? describeAddr(s.peers[0].addr).c_str() : "-",
+                                  s.peers[0].packets, s.peers[0].bytes / (1024.0 * 1024.0),
+                                  s.peers[1].known ? describeAddr(s.peers[1].addr).c_str() : "-",
+                                  s.peers[1].packets);
+        if (config_.frameLevel && s.frameStats.frames > 0) {
+            const FrameStats& fs = s.frameStats;
+            Logger::instance().debugf("[RELAY] '%s': frames=%lu keyframes=%.1f%% latency=%.1fms (avg %.1f, max %.1f) bitrate=%.2fMbps",
+                                      s.key.c_str(), fs.frames, 100.0 * fs.keyframes / fs.frames,
+                                      fs.lastLatencyMs,
+                                      fs.latencySamples > 0 ? fs.latencySumMs / fs.latencySamples : 0.0,
+                                      fs.maxLatencyMs, fs.bitrateMbps);
+        }
+        for (const auto& sub : s.subscribers) {
+            Logger::instance().debugf("[RELAY] '%s': subscriber %s queue=%zu%s",
+                                      s.key.c_str(), describeAddr(sub->peer.addr).c_str(),
+                                      sub->queue.size(),
+                                      sub->waitingForKeyframe ? " (waiting for keyframe)" : "");
+        }
+    }
+}
+
+uint64_t RelayMode::flowKey(const struct sockaddr_in& addr) {
+    return (static_cast<uint64_t>(addr.sin_addr.s_addr) << 16) | addr.sin_port;
+}
+
+std::string RelayMode::describeAddr(const struct sockaddr_in& addr) {
+    char ip[INET_ADDRSTRLEN] = {0};
+    inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(addr.sin_port));
+}
+
+} // namespace ndi_bridge
@@ -0,0 +1,284 @@
+#pragma once
+
+/**
+ * RelayMode.h - NDI Bridge Rendezvous Relay
+ *
+ * Host and join both dial out to the relay and register with a session key.
+ * The relay learns their public addresses from recvfrom(), pairs them by key,
+ * and forwards protocol packets both ways without touching the payload.
+ * No FFmpeg, no NDI SDK: a single UDP socket serves every session.
+ *
+ * Frame-level mode (phase 3) reassembles host media into whole frames,
+ * re-fragments them for a different outbound MTU and tracks per-frame
+ * latency / keyframe ratio / bitrate.
+ *
+ * Fan-out mode (SFU) lets any number of joins subscribe to one host under
+ * the same session key, each with its own send queue.
+ *
+ * Receiver reports (adaptive bitrate) from joins are forwarded upstream to
+ * the session's host in every mode.
+ *
+ * Simulcast hosts send several renditions (video sourceId). Packet
+ * forwarding passes them all and lets each join pick; frame-level and
+ * fan-out relays carry a single rendition.
+ *
+ * See Docs/RELAY_MODE.md (phases 2 and 3).
+ */
+
+#include <array>
+#include <deque>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+
+#include "../common/Protocol.h"
+
+namespace ndi_bridge {
+
+/**
+ * Relay mode configuration
+ */
+struct RelayModeConfig {
+    uint16_t listenPort = 5990;
+    int peerTimeoutMs = 15000;              // Forget a peer after this much silence
+    size_t maxSessions = 1024;              // Refuse new session keys beyond this
+    size_t socketBufferSize = 16 * 1024 * 1024;  // SO_RCVBUF / SO_SNDBUF
+    bool frameLevel = false;                // Reassemble + re-fragment host media
+    size_t outputMtu = DEFAULT_MTU;         // Outbound MTU in frame-level mode
+    bool fanout = false;                    // One host → N joins per session (SFU)
+    size_t maxSubscribers = 32;             // Per session, fan-out mode
+    size_t subscriberQueuePackets = 4096;   // Per-subscriber backlog before resync
+    size_t gopCacheBytes = 8 * 1024 * 1024; // Last IDR..now, replayed to new joins
+    int rendition = -1;                     // Simulcast video sourceId to forward (-1 = all;
+                                            // frame-level / fan-out reassemble one, default 0)
+};
+
+/**
+ * RelayMode - Rendezvous relay orchestrator
+ *
+ * Pipeline (per session):
+ *   host ──UDP──→ relay ──UDP──→ join   (media)
+ *   join ──UDP──→ relay ──UDP──→ host   (feedback, if any)
+ *
+ * Frame-level: host fragments → FrameReassembler → re-fragment at
+ * outputMtu → join. The reassembled buffer is sent by scatter-gather
+ * (header iovec + payload slice), then handed back to the reassembler.
+ *
+ * Fan-out: each host datagram is copied once into a ref-counted buffer and
+ * queued by reference on every subscriber. New subscribers start from the
+ * cached GOP (last IDR + SPS/PPS onwards) or wait for the next keyframe.
+ * Queues drain round-robin, so a subscriber with a backlog cannot starve
+ * the others; one that overflows its queue is resynced on its own.
+ *
+ * One I/O thread: epoll + recvmmsg/sendmmsg batches on Linux,
+ * poll + recvfrom/sendto elsewhere. Flow lookup is a hash of the
+ * source address (O(1) per packet).
+ */
+class RelayMode {
+public:
+    explicit RelayMode(const RelayModeConfig& config = RelayModeConfig());
+    ~RelayMode();
+
+    // Non-copyable
+    RelayMode(const RelayMode&) = delete;
+    RelayMode& operator=(const RelayMode&) = delete;
+
+    /**
+     * Start relay mode
+     * @param running Reference to running flag for graceful shutdown
+     * @return 0 on success, error code otherwise
+     */
+    int start(std::atomic<bool>& running);
+
+    /**
+     * Stop relay mode
+     */
+    void stop();
+
+    /**
+     * Check if running
+     */
+    bool isRunning() const { return running_; }
+
+    /**
+     * Get statistics
+     */
+    struct Stats {
+        uint64_t packetsReceived = 0;
+        uint64_t packetsForwarded = 0;
+        uint64_t bytesForwarded = 0;
+        uint64_t packetsUnrouted = 0;       // Valid media with no paired peer yet
+        uint64_t packetsDroppedEagain = 0;  // Kernel send buffer full
+        uint64_t invalidPackets = 0;
+        uint64_t packetsFiltered = 0;       // Video of renditions not relayed
+        uint64_t registrations = 0;
+        uint64_t activeSessions = 0;
+        // Frame-level mode only
+        uint64_t framesRelayed = 0;
+        uint64_t keyframesRelayed = 0;
+        uint64_t framesDropped = 0;         // Incomplete at reassembly
+        double avgLatencyMs = 0.0;          // Host send → relay reassembled
+        double maxLatencyMs = 0.0;
+        // Fan-out mode only
+        uint64_t subscribers = 0;
+        uint64_t subscriberDrops = 0;       // Packets dropped on queue overflow
+        uint64_t subscriberResyncs = 0;     // Overflows that forced a keyframe wait
+        uint64_t cachedStarts = 0;          // Subscribers started from the GOP cache
+        double runTimeSeconds = 0.0;
+    };
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t BATCH_SIZE = 64;            // Datagrams per recvmmsg/sendmmsg
+    static constexpr size_t MAX_DATAGRAM_SIZE = 2048;   // > any MTU we use
+    static constexpr size_t FANOUT_QUANTUM = 16;        // Packets per subscriber per round
+
+    struct Peer {
+        struct sockaddr_in addr{};
+        bool known = false;
+        Clock::time_point lastSeen;
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+    };
+
+    // Per-session frame statistics (frame-level mode)
+    struct FrameStats {
+        uint64_t frames = 0;
+        uint64_t keyframes = 0;
+        double lastLatencyMs = 0.0;
+        double maxLatencyMs = 0.0;
+        double latencySumMs = 0.0;
+        uint64_t latencySamples = 0;
+        // Instantaneous bitrate over a ~1 s window
+        Clock::time_point windowStart;
+        uint64_t windowBytes = 0;
+        double bitrateMbps = 0.0;
+    };
+
+    // Ref-counted datagram shared by every subscriber queue (fan-out)
+    struct Datagram {
+        size_t size = 0;
+        uint8_t data[MAX_DATAGRAM_SIZE];
+    };
+    using SharedDatagram = std::shared_ptr<const Datagram>;
+
+    struct Subscriber {
+        Peer peer;
+        std::deque<SharedDatagram> queue;
+        bool waitingForKeyframe = true;
+    };
+
+    struct Session {
+        std::string key;
+        Peer peers[2];      // Indexed by RendezvousRole (peers[Join] unused in fan-out)
+        // Fan-out mode: subscribers + GOP cache (video since the last keyframe)
+        std::vector<std::unique_ptr<Subscriber>> subscribers;
+        std::vector<SharedDatagram> gopCache;
+        size_t gopCacheBytes = 0;
+        uint32_t gopCacheSeq = 0;
+        bool gopCacheValid = false;
+        // Frame-level mode: host → join media
+        FrameReassembler videoReassembler;
+        FrameReassembler audioReassembler;
+        FrameStats frameStats;
+    };
+
+    struct Flow {
+        Session* session;
+        RendezvousRole role;
+        Subscriber* subscriber = nullptr;   // Fan-out joins only
+    };
+
+    // One received datagram inside the current batch
+    struct RecvSlot {
+        uint8_t data[MAX_DATAGRAM_SIZE];
+        size_t size = 0;
+        struct sockaddr_in from{};
+    };
+
+    // One pending forward (points into a RecvSlot — no copy)
+    struct SendSlot {
+        const uint8_t* data;
+        size_t size;
+        struct sockaddr_in to;
+    };
+
+    bool openSocket();
+    void ioLoop();
+    size_t receiveBatch();
+    void flushSends();
+    void handleDatagram(const RecvSlot& slot, Clock::time_point now);
+    void handleFrameLevel(Session& session, const RecvSlot& slot, const Peer& dst,
+                          Clock::time_point now);
+    void sendFrame(const FrameReassembler::Frame& frame, const struct sockaddr_in& to);
+    void fanOutFrame(Session& session, const FrameReassembler::Frame& frame);
+    void fanOutPacket(Session& session, const SharedDatagram& dgram, const PacketHeader& header);
+    void enqueue(Subscriber& sub, const SharedDatagram& dgram);
+    void flushSubscribers();
+    void addSubscriber(Session& session, const struct sockaddr_in& from, Clock::time_point now);
+    void removeSubscriber(Session& session, Subscriber* sub);
+    PacketHeader fragmentHeader(const FrameReassembler::Frame& frame, uint16_t index,
+                                uint16_t fragmentCount, size_t maxPayload) const;
+    void updateFrameStats(FrameStats& fs, const FrameReassembler::Frame& frame,
+                          Clock::time_point now);
+    void registerPeer(const RendezvousPacket& packet, const struct sockaddr_in& from,
+                      Clock::time_point now);
+    void expirePeers(Clock::time_point now);
+    void logSessions();
+
+    static uint64_t flowKey(const struct sockaddr_in& addr);
+    static std::string describeAddr(const struct sockaddr_in& addr);
+
+    // Configuration
+    RelayModeConfig config_;
+    int rendition_ = -1;        // Effective config_.rendition
+
+    // Socket + I/O thread
+    socket_t socket_ = INVALID_SOCKET_VAL;
+    std::atomic<bool> running_{false};
+    std::thread ioThread_;
+#ifdef __linux__
+    int epollFd_ = -1;
+#endif
+
+    // Batches (owned by the I/O thread)
+    std::vector<RecvSlot> recvSlots_;
+    std::vector<SendSlot> sendSlots_;
+    std::vector<std::array<uint8_t, HEADER_SIZE>> fragHeaders_;  // Frame-level re-fragmentation
+    std::vector<Subscriber*> readySubscribers_;                  // Fan-out flush scratch
+    size_t queuedPackets_ = 0;                                   // Across all subscriber queues
+
+    // Session + flow tables (owned by the I/O thread)
+    std::unordered_map<std::string, std::unique_ptr<Session>> sessions_;
+    std::unordered_map<uint64_t, Flow> flows_;
+
+    // Statistics
+    std::chrono::steady_clock::time_point startTime_;
+    std::atomic<uint64_t> packetsReceived_{0};
+    std::atomic<uint64_t> packetsForwarded_{0};
+    std::atomic<uint64_t> bytesForwarded_{0};
+    std::atomic<uint64_t> packetsUnrouted_{0};
+    std::atomic<uint64_t> packetsDroppedEagain_{0};
+    std::atomic<uint64_t> invalidPackets_{0};
+    std::atomic<uint64_t> packetsFiltered_{0};
+    std::atomic<uint64_t> registrations_{0};
+    std::atomic<uint64_t> activeSessions_{0};
+    std::atomic<uint64_t> framesRelayed_{0};
+    std::atomic<uint64_t> keyframesRelayed_{0};
+    std::atomic<uint64_t> framesDropped_{0};
+    std::atomic<uint64_t> latencySumUs_{0};
+    std::atomic<uint64_t> latencySamples_{0};
+    std::atomic<uint64_t> maxLatencyUs_{0};
+    std::atomic<uint64_t> subscribers_{0};
+    std::atomic<uint64_t> subscriberDrops_{0};
+    std::atomic<uint64_t> subscriberResyncs_{0};
+    std::atomic<uint64_t> cachedStarts_{0};
+};
+
+} // namespace ndi_bridge
@@ -0,0 +1,795 @@
+/**
+ * convert_test.cpp - Test and benchmark for PixelConverter
+ *
+ * Checks every available kernel (scalar / SSE4.1 / AVX2 / NEON) against
+ * the scalar reference bit for bit, the scalar reference against plain
+ * reference implementations (floating-point BT.709 for BGRA), slice
+ * threading against a single thread, (with FFmpeg) the output against
+ * sws_scale, the simulcast resize against a plain area average, the
+ * lossless UYVY codec roundtrip and the static-content block hash.
+ *
+ * Usage: convert-test           run the correctness tests
+ *        convert-test --bench   also measure throughput at 1080p and 2160p
+ *                               (and 1080p → 720p / 360p resize, lossless
+ *                               encode / decode, change detection)
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/Logger.h"
+#include "video/PixelConverter.h"
+#include "video/LosslessCodec.h"
+#include "video/FrameChangeDetector.h"
+
+#ifdef HAVE_FFMPEG
+extern "C" {
+#include <libswscale/swscale.h>
+#include <libavutil/pixfmt.h>
+}
+#endif
+
+using namespace ndi_bridge;
+
+namespace {
+
+const ConvertKernel ALL_KERNELS[] = {
+    ConvertKernel::Scalar, ConvertKernel::SSE41, ConvertKernel::AVX2, ConvertKernel::NEON
+};
+
+const char* formatName(PixelFormat fmt) {
+    switch (fmt) {
+        case PixelFormat::BGRA: return "BGRA";
+        case PixelFormat::UYVY: return "UYVY";
+        case PixelFormat::NV12: return "NV12";
+        case PixelFormat::I420: return "I420";
+        case PixelFormat::I422: return "I422";
+    }
+    return "?";
+}
+
+/**
+ * Frame in any PixelFormat, planes padded past the visible width
+ */
+struct Image {
+    PixelFormat format;
+    int width;
+    int height;
+    int planes = 1;
+    std::vector<uint8_t> plane[3];
+    int stride[3] = {0, 0, 0};
+    int rowBytes[3] = {0, 0, 0};
+    int rows[3] = {0, 0, 0};
+    uint8_t* ptr[3] = {nullptr, nullptr, nullptr};
+
+    Image(PixelFormat fmt, int w, int h, int pad = 32)
+        : format(fmt), width(w), height(h) {
+        const int cw = (w + 1) / 2;
+        const int ch = (h + 1) / 2;
+        switch (fmt) {
+            case PixelFormat::BGRA: setPlane(0, w * 4, h); break;
+            case PixelFormat::UYVY: setPlane(0, w * 2, h); break;
+            case PixelFormat::NV12: setPlane(0, w, h); setPlane(1, cw * 2, ch); break;
+            case PixelFormat::I420: setPlane(0, w, h); setPlane(1, cw, ch); setPlane(2, cw, ch); break;
+            case PixelFormat::I422: setPlane(0, w, h); setPlane(1, cw, h); setPlane(2, cw, h); break;
+        }
+        for (int i = 0; i < planes; i++) {
+            stride[i] = rowBytes[i] + pad;
+            plane[i].assign(static_cast<size_t>(stride[i]) * rows[i], 0xCD);
+            ptr[i] = plane[i].data();
+        }
+    }
+
+    void setPlane(int i, int bytes, int r) {
+        rowBytes[i] = bytes;
+        rows[i] = r;
+        planes = std::max(planes, i + 1);
+    }
+
+    uint8_t* at(int p, int x, int y) { return ptr[p] + static_cast<size_t>(y) * stride[p] + x; }
+    uint8_t at(int p, int x, int y) const { return plane[p][static_cast<size_t>(y) * stride[p] + x]; }
+
+    void fillNoise(uint32_t seed) {
+        std::mt19937 rng(seed);
+        for (int i = 0; i < planes; i++) {
+            for (auto& b : plane[i]) b = static_cast<uint8_t>(rng());
+        }
+    }
+};
+
+struct Diff {
+    int maxPrimary = 0;     // Plane 0 (luma, or the packed plane)
+    int maxChroma = 0;      // Remaining planes
+};
+
+Diff compare(const Image& a, const Image& b) {
+    Diff d;
+    for (int p = 0; p < a.planes; p++) {
+        int& worst = p == 0 ? d.maxPrimary : d.maxChroma;
+        for (int y = 0; y < a.rows[p]; y++) {
+            for (int x = 0; x < a.rowBytes[p]; x++) {
+                worst = std::max(worst, std::abs(a.at(p, x, y) - b.at(p, x, y)));
+            }
+        }
+    }
+    return d;
+}
+
+std::string describe(const Diff& d) {
+    return "max diff P=" + std::to_string(d.maxPrimary) + " C=" + std::to_string(d.maxChroma);
+}
+
+bool runConvert(PixelConverter& conv, const Image& src, Image& dst) {
+    const uint8_t* const planes[3] = {src.ptr[0], src.ptr[1], src.ptr[2]};
+    return conv.convert(src.format, planes, src.stride, dst.format, dst.ptr, dst.stride,
+                        src.width, src.height);
+}
+
+/**
+ * Independent floating-point reference (BT.709, 2x2 box chroma)
+ */
+Image bgraReference(const Image& s, PixelFormat dst, bool fullRange) {
+    Image out(dst, s.width, s.height);
+    const double kr = 0.2126, kb = 0.0722, kg = 1.0 - kr - kb;
+    const double ys = fullRange ? 1.0 : 219.0 / 255.0;
+    const double cs = fullRange ? 1.0 : 224.0 / 255.0;
+    const double yo = fullRange ? 0.0 : 16.0;
+    auto px = [&](int x, int y, int c) {
+        return static_cast<double>(s.at(0, std::min(x, s.width - 1) * 4 + c, std::min(y, s.height - 1)));
+    };
+    auto clamp8 = [](double v) {
+        return static_cast<uint8_t>(std::min(255.0, std::max(0.0, std::floor(v + 0.5))));
+    };
+    for (int y = 0; y < s.height; y++) {
+        for (int x = 0; x < s.width; x++) {
+            *out.at(0, x, y) = clamp8(yo + ys * (kr * px(x, y, 2) + kg * px(x, y, 1) + kb * px(x, y, 0)));
+        }
+    }
+    for (int y = 0; y < out.rows[1]; y++) {
+        for (int x = 0; x < out.rowBytes[1]; x++) {
+            double r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    b += px(x * 2 + dx, y * 2 + dy, 0) / 4.0;
+                    g += px(x * 2 + dx, y * 2 + dy, 1) / 4.0;
+                    r += px(x * 2 + dx, y * 2 + dy, 2) / 4.0;
+                }
+            }
+            double yy = kr * r + kg * g + kb * b;
+            *out.at(1, x, y) = clamp8(128.0 + cs * (b - yy) / (2.0 * (1.0 - kb)));
+            *out.at(2, x, y) = clamp8(128.0 + cs * (r - yy) / (2.0 * (1.0 - kr)));
+        }
+    }
+    return out;
+}
+
+// UYVY reference: luma copied, 4:2:0 chroma = rounded average of each row pair
+Image uyvyReference(const Image& s, PixelFormat dst) {
+    Image out(dst, s.width, s.height);
+    for (int y = 0; y < s.height; y++) {
+        for (int x = 0; x < s.width; x++) {
+            *out.at(0, x, y) = s.at(0, x * 2 + 1, y);
+        }
+    }
+    for (int y = 0; y < out.rows[1]; y++) {
+        const int r0 = dst == PixelFormat::I422 ? y : y * 2;
+        const int r1 = dst == PixelFormat::I422 ? y : std::min(y * 2 + 1, s.height - 1);
+        for (int x = 0; x < s.width / 2; x++) {
+            uint8_t u = static_cast<uint8_t>((s.at(0, x * 4, r0) + s.at(0, x * 4, r1) + 1) >> 1);
+            uint8_t v = static_cast<uint8_t>((s.at(0, x * 4 + 2, r0) + s.at(0, x * 4 + 2, r1) + 1) >> 1);
+            if (dst == PixelFormat::NV12) {
+                *out.at(1, x * 2, y) = u;
+                *out.at(1, x * 2 + 1, y) = v;
+            } else {
+                *out.at(1, x, y) = u;
+                *out.at(2, x, y) = v;
+            }
+        }
+    }
+    return out;
+}
+
+// 4:2:0 → UYVY reference: each chroma row serves both luma rows of its pair
+Image yuv420Reference(const Image& s) {
+    Image out(PixelFormat::UYVY, s.width, s.height);
+    for (int y = 0; y < s.height; y++) {
+        for (int x = 0; x < s.width / 2; x++) {
+            uint8_t* p = out.at(0, x * 4, y);
+            if (s.format == PixelFormat::NV12) {
+                p[0] = s.at(1, x * 2, y / 2);
+                p[2] = s.at(1, x * 2 + 1, y / 2);
+            } else {
+                p[0] = s.at(1, x, y / 2);
+                p[2] = s.at(2, x, y / 2);
+            }
+            p[1] = s.at(0, x * 2, y);
+            p[3] = s.at(0, x * 2 + 1, y);
+        }
+    }
+    return out;
+}
+
+struct Conversion {
+    PixelFormat src;
+    PixelFormat dst;
+};
+
+const Conversion CONVERSIONS[] = {
+    {PixelFormat::UYVY, PixelFormat::I420},
+    {PixelFormat::UYVY, PixelFormat::NV12},
+    {PixelFormat::BGRA, PixelFormat::I420},
+    {PixelFormat::UYVY, PixelFormat::I422},
+    {PixelFormat::I422, PixelFormat::UYVY},
+    {PixelFormat::I420, PixelFormat::UYVY},
+    {PixelFormat::NV12, PixelFormat::UYVY},
+};
+
+std::string name(const Conversion& c) {
+    return std::string(formatName(c.src)) + "->" + formatName(c.dst);
+}
+
+bool check(bool ok, const std::string& what) {
+    if (ok) {
+        Logger::instance().successf("  %s", what.c_str());
+    } else {
+        Logger::instance().errorf("  %s", what.c_str());
+    }
+    return ok;
+}
+
+// Test 1: scalar reference vs independent implementations
+bool testReference() {
+    LOG_INFO("Test 1: scalar kernels vs reference implementations");
+    bool ok = true;
+    for (bool full : {true, false}) {
+        PixelConverterConfig cfg;
+        cfg.threads = 1;
+        cfg.fullRange = full;
+        PixelConverter conv(cfg);
+        conv.setKernel(ConvertKernel::Scalar);
+
+        for (const auto& c : CONVERSIONS) {
+            if (c.src == PixelFormat::I422) continue;   // Round trip below
+            if (!full && c.src != PixelFormat::BGRA) continue;
+            Image s(c.src, 638, 359);
+            s.fillNoise(42);
+            Image out(c.dst, s.width, s.height);
+            ok &= check(runConvert(conv, s, out), "convert() accepted frame");
+            Image ref = c.src == PixelFormat::BGRA ? bgraReference(s, c.dst, full)
+                        : c.src == PixelFormat::UYVY ? uyvyReference(s, c.dst)
+                                                     : yuv420Reference(s);
+            Diff d = compare(out, ref);
+            const int tolerance = c.src == PixelFormat::BGRA ? 1 : 0;
+            ok &= check(d.maxPrimary <= tolerance && d.maxChroma <= tolerance,
+                        name(c) + (full ? " full: " : " limited: ") + describe(d));
+        }
+    }
+
+    // 4:2:2 is lossless both ways: UYVY → I422 → UYVY must round-trip
+    PixelConverter conv;
+    conv.setKernel(ConvertKernel::Scalar);
+    Image s(PixelFormat::UYVY, 638, 359);
+    s.fillNoise(43);
+    Image planar(PixelFormat::I422, s.width, s.height);
+    Image back(PixelFormat::UYVY, s.width, s.height);
+    runConvert(conv, s, planar);
+    ok &= check(runConvert(conv, planar, back), "convert() accepted I422 frame");
+    ok &= check(compare(s, back).maxPrimary == 0, "UYVY->I422->UYVY round trip is exact");
+    return ok;
+}
+
+// Test 2: every SIMD kernel is bit-exact with scalar (including tails)
+bool testKernels() {
+    LOG_INFO("Test 2: SIMD kernels vs scalar (bit-exact)");
+    bool ok = true;
+    const int sizes[][2] = {{1920, 1080}, {1918, 7}, {66, 5}, {34, 2}, {2, 1}, {17, 3}};
+    for (ConvertKernel k : ALL_KERNELS) {
+        if (k == ConvertKernel::Scalar || !PixelConverter::kernelAvailable(k)) continue;
+        bool kernelOk = true;
+        for (bool full : {true, false}) {
+            PixelConverterConfig cfg;
+            cfg.threads = 1;
+            cfg.fullRange = full;
+            PixelConverter ref(cfg);
+            PixelConverter simd(cfg);
+            ref.setKernel(ConvertKernel::Scalar);
+            simd.setKernel(k);
+
+            for (const auto& c : CONVERSIONS) {
+                for (const auto& sz : sizes) {
+                    if (c.src != PixelFormat::BGRA && (sz[0] & 1)) continue;
+                    Image s(c.src, sz[0], sz[1]);
+                    s.fillNoise(7u + sz[0]);
+                    Image a(c.dst, sz[0], sz[1]);
+                    Image b(c.dst, sz[0], sz[1]);
+                    runConvert(ref, s, a);
+                    runConvert(simd, s, b);
+                    Diff d = compare(a, b);
+                    if (d.maxPrimary != 0 || d.maxChroma != 0) {
+                        kernelOk = check(false, std::string(PixelConverter::kernelName(k)) + " " +
+                                         name(c) + " " + std::to_string(sz[0]) + "x" +
+                                         std::to_string(sz[1]) + ": " + describe(d));
+                    }
+                }
+            }
+        }
+        ok &= check(kernelOk, std::string(PixelConverter::kernelName(k)) + " matches scalar");
+    }
+    return ok;
+}
+
+// Test 3: slice threads produce the same frame as one thread
+bool testThreads() {
+    LOG_INFO("Test 3: slice threads vs single thread");
+    bool ok = true;
+    PixelConverterConfig one;
+    one.threads = 1;
+    PixelConverterConfig many;
+    many.threads = 4;
+    PixelConverter single(one);
+    PixelConverter sliced(many);
+    for (const auto& c : CONVERSIONS) {
+        for (int height : {1080, 5, 1}) {
+            Image s(c.src, 1280, height);
+            s.fillNoise(99);
+            Image a(c.dst, s.width, s.height);
+            Image b(c.dst, s.width, s.height);
+            runConvert(single, s, a);
+            runConvert(sliced, s, b);
+            Diff d = compare(a, b);
+            ok &= check(d.maxPrimary == 0 && d.maxChroma == 0,
+                        name(c) + " 1280x" + std::to_string(height) + " with 4 slices");
+        }
+    }
+    return ok;
+}
+
+#ifdef HAVE_FFMPEG
+AVPixelFormat toAV(PixelFormat fmt) {
+    switch (fmt) {
+        case PixelFormat::BGRA: return AV_PIX_FMT_BGRA;
+        case PixelFormat::UYVY: return AV_PIX_FMT_UYVY422;
+        case PixelFormat::NV12: return AV_PIX_FMT_NV12;
+        case PixelFormat::I420: return AV_PIX_FMT_YUV420P;
+        case PixelFormat::I422: return AV_PIX_FMT_YUV422P;
+    }
+    return AV_PIX_FMT_NONE;
+}
+
+SwsContext* makeSws(PixelFormat src, PixelFormat dst, int w, int h) {
+    SwsContext* ctx = sws_getContext(w, h, toAV(src), w, h, toAV(dst),
+                                     SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    if (ctx) {
+        // Same matrix/range the encoder advertises (BT.709, full range)
+        const int* coeffs = sws_getCoefficients(SWS_CS_ITU709);
+        sws_setColorspaceDetails(ctx, coeffs, 1, coeffs, 1, 0, 1 << 16, 1 << 16);
+    }
+    return ctx;
+}
+
+bool runSws(SwsContext* ctx, const Image& s, Image& out) {
+    const uint8_t* src[4] = {s.ptr[0], s.ptr[1], s.ptr[2], nullptr};
+    int srcStride[4] = {s.stride[0], s.stride[1], s.stride[2], 0};
+    uint8_t* dst[4] = {out.ptr[0], out.ptr[1], out.ptr[2], nullptr};
+    int dstStride[4] = {out.stride[0], out.stride[1], out.stride[2], 0};
+    return sws_scale(ctx, src, srcStride, 0, s.height, dst, dstStride) == s.height;
+}
+
+// Smooth content: any sane 4:2:0 filter agrees on it within a level or two
+Image makeGradient(PixelFormat fmt, int width, int height) {
+    Image bgra(PixelFormat::BGRA, width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t* p = bgra.at(0, x * 4, y);
+            p[0] = static_cast<uint8_t>(255 - (x + y) * 255 / (width + height - 2));
+            p[1] = static_cast<uint8_t>(y * 255 / (height - 1));
+            p[2] = static_cast<uint8_t>(x * 255 / (width - 1));
+            p[3] = 255;
+        }
+    }
+    if (fmt == PixelFormat::BGRA) return bgra;
+
+    // YUV sources: the gradient's channels reinterpreted as Y/U/V
+    Image uyvy(PixelFormat::UYVY, width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const uint8_t* p = bgra.at(0, x * 4, y);
+            uint8_t* q = uyvy.at(0, x * 2, y);
+            q[1] = p[2];
+            q[0] = (x & 1) ? p[0] : p[1];
+        }
+    }
+    if (fmt == PixelFormat::UYVY) return uyvy;
+
+    Image planar(fmt, width, height);
+    PixelConverter conv;
+    runConvert(conv, uyvy, planar);
+    return planar;
+}
+
+// Test 4: output vs sws_scale on smooth content
+bool testSwscale() {
+    LOG_INFO("Test 4: PixelConverter vs sws_scale (BT.709 full range)");
+    bool ok = true;
+    PixelConverter conv;
+    for (const auto& c : CONVERSIONS) {
+        Image s = makeGradient(c.src, 1920, 1080);
+        SwsContext* ctx = makeSws(c.src, c.dst, s.width, s.height);
+        if (!ctx) {
+            ok = check(false, "sws_getContext failed");
+            continue;
+        }
+        Image ours(c.dst, s.width, s.height);
+        Image theirs(c.dst, s.width, s.height);
+        runConvert(conv, s, ours);
+        ok &= check(runSws(ctx, s, theirs), "sws_scale converted frame");
+        sws_freeContext(ctx);
+
+        Diff d = compare(ours, theirs);
+        ok &= check(d.maxPrimary <= 1 && d.maxChroma <= 2, name(c) + " vs swscale: " + describe(d));
+    }
+    return ok;
+}
+#endif
+
+bool runScale(PixelConverter& conv, const Image& src, Image& dst) {
+    const uint8_t* const planes[3] = {src.ptr[0], src.ptr[1], src.ptr[2]};
+    return conv.scale(src.format, planes, src.stride, src.width, src.height,
+                      dst.ptr, dst.stride, dst.width, dst.height);
+}
+
+// Plain area average: every source sample belongs to exactly one output pixel
+Image areaReference(const Image& s, int width, int height) {
+    Image out(s.format, width, height);
+    for (int p = 0; p < s.planes; p++) {
+        const int channels = s.format == PixelFormat::NV12 && p == 1 ? 2 : 1;
+        const int sw = s.rowBytes[p] / channels;
+        const int dw = out.rowBytes[p] / channels;
+        for (int oy = 0; oy < out.rows[p]; oy++) {
+            const int y0 = oy * s.rows[p] / out.rows[p];
+            const int y1 = (oy + 1) * s.rows[p] / out.rows[p];
+            for (int ox = 0; ox < dw; ox++) {
+                const int x0 = ox * sw / dw;
+                const int x1 = (ox + 1) * sw / dw;
+                for (int c = 0; c < channels; c++) {
+                    int sum = 0;
+                    for (int y = y0; y < y1; y++) {
+                        for (int x = x0; x < x1; x++) sum += s.at(p, x * channels + c, y);
+                    }
+                    const int n = (y1 - y0) * (x1 - x0);
+                    *out.at(p, ox * channels + c, oy) = static_cast<uint8_t>((sum + n / 2) / n);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// Test 5: resize for simulcast renditions
+bool testScale() {
+    LOG_INFO("Test 5: resize (simulcast renditions)");
+    bool ok = true;
+    PixelConverterConfig one;
+    one.threads = 1;
+    PixelConverterConfig many;
+    many.threads = 4;
+    PixelConverter single(one);
+    PixelConverter sliced(many);
+
+    for (PixelFormat fmt : {PixelFormat::I420, PixelFormat::I422, PixelFormat::NV12}) {
+        const std::string f = formatName(fmt);
+
+        Image s(fmt, 1920, 1080);
+        s.fillNoise(5);
+        Image same(fmt, s.width, s.height);
+        ok &= check(runScale(single, s, same) && compare(s, same).maxPrimary == 0 &&
+                    compare(s, same).maxChroma == 0, f + " same size is a copy");
+
+        Image small(fmt, 640, 360);
+        runScale(single, s, small);
+        Diff d = compare(small, areaReference(s, 640, 360));
+        ok &= check(d.maxPrimary == 0 && d.maxChroma == 0, f + " 1920x1080->640x360 area: " + describe(d));
+
+        // Bilinear keeps a flat picture flat
+        Image flat(fmt, 1920, 1080);
+        for (int p = 0; p < flat.planes; p++) std::fill(flat.plane[p].begin(), flat.plane[p].end(), 77);
+        Image mid(fmt, 1280, 720);
+        runScale(single, flat, mid);
+        Image midRef(fmt, 1280, 720);
+        for (int p = 0; p < midRef.planes; p++) {
+            for (int y = 0; y < midRef.rows[p]; y++) std::memset(midRef.at(p, 0, y), 77, midRef.rowBytes[p]);
+        }
+        d = compare(mid, midRef);
+        ok &= check(d.maxPrimary == 0 && d.maxChroma == 0, f + " 1920x1080->1280x720 bilinear flat");
+
+        for (const auto& sz : {std::array<int, 2>{1280, 720}, std::array<int, 2>{640, 360},
+                               std::array<int, 2>{426, 241}}) {
+            Image a(fmt, sz[0], sz[1]);
+            Image b(fmt, sz[0], sz[1]);
+            runScale(single, s, a);
+            runScale(sliced, s, b);
+            d = compare(a, b);
+            ok &= check(d.maxPrimary == 0 && d.maxChroma == 0,
+                        f + " " + std::to_string(sz[0]) + "x" + std::to_string(sz[1]) + " with 4 slices");
+        }
+    }
+
+    Image bgra(PixelFormat::BGRA, 64, 64);
+    Image out(PixelFormat::BGRA, 32, 32);
+    ok &= check(!runScale(single, bgra, out), "packed formats rejected");
+    return ok;
+}
+
+// Camera-like UYVY: smooth gradients, a hard edge and a little sensor noise
+void fillPicture(Image& img, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> noise(-2, 2);
+    for (int y = 0; y < img.height; y++) {
+        uint8_t* row = img.at(0, 0, y);
+        for (int x = 0; x < img.rowBytes[0]; x++) {
+            const int px = x / 2;
+            int v = (x & 1) ? 40 + (px + y) * 160 / (img.width + img.height)
+                            : 128 + static_cast<int>(40 * std::sin((px + 2 * y) * 0.01));
+            if ((x & 1) && px > img.width / 2 && y < img.height / 3) v = 235;
+            row[x] = static_cast<uint8_t>(std::clamp(v + noise(rng), 0, 255));
+        }
+    }
+}
+
+// Test 6: lossless UYVY codec (LAN raw transport)
+bool testLossless() {
+    LOG_INFO("Test 6: lossless codec");
+    bool ok = true;
+    LosslessCodecConfig one;
+    one.threads = 1;
+    LosslessCodecConfig many;
+    many.threads = 4;
+    many.slices = 6;    // More slices than threads
+    LosslessCodec single(one);
+    LosslessCodec sliced(many);
+
+    struct Case { int width; int height; bool noise; };
+    for (const Case& c : {Case{1920, 1080, false}, Case{1920, 1080, true}, Case{1280, 5, false},
+                          Case{2, 1, false}, Case{722, 3, true}}) {
+        Image s(PixelFormat::UYVY, c.width, c.height);
+        if (c.noise) s.fillNoise(6); else fillPicture(s, 6);
+        const std::string what = std::to_string(c.width) + "x" + std::to_string(c.height) +
+                                 (c.noise ? " noise" : "");
+
+        for (LosslessCodec* codec : {&single, &sliced}) {
+            std::vector<uint8_t> coded;
+            Image out(PixelFormat::UYVY, c.width, c.height);
+            bool done = codec->encode(s.ptr[0], s.stride[0], c.width, c.height, coded) &&
+                        codec->decode(coded.data(), coded.size(), out.ptr[0], out.stride[0]);
+            auto info = LosslessCodec::parseHeader(coded.data(), coded.size());
+            char ratio[32];
+            std::snprintf(ratio, sizeof(ratio), "%.2f:1",
+                          static_cast<double>(c.width) * 2 * c.height / std::max<size_t>(coded.size(), 1));
+            ok &= check(done && info && info->width == c.width && info->height == c.height &&
+                        compare(s, out).maxPrimary == 0,
+                        what + " " + std::to_string(codec->threadCount()) + "T roundtrip, " + ratio);
+        }
+    }
+
+    // Damaged frames are rejected, never read out of bounds
+    Image s(PixelFormat::UYVY, 640, 360);
+    fillPicture(s, 7);
+    Image out(PixelFormat::UYVY, 640, 360);
+    std::vector<uint8_t> coded;
+    single.encode(s.ptr[0], s.stride[0], 640, 360, coded);
+    ok &= check(!single.decode(coded.data(), coded.size() / 2, out.ptr[0], out.stride[0]),
+                "truncated frame rejected");
+    coded[LOSSLESS_HEADER_SIZE + 1] ^= 0x40;     // Slice 0 size now past the end
+    ok &= check(!single.decode(coded.data(), coded.size(), out.ptr[0], out.stride[0]),
+                "corrupt slice table rejected");
+    ok &= check(!single.encode(s.ptr[0], s.stride[0], 639, 360, coded), "odd width rejected");
+    return ok;
+}
+
+// Test 7: static-content detection (host skipStatic)
+bool testChangeDetector() {
+    Logger::instance().infof("Test 7: frame change detector (%s)", FrameChangeDetector::hashName());
+    bool ok = true;
+    FrameChangeDetector detector;   // 64x16 blocks
+
+    Image s(PixelFormat::UYVY, 1920, 1080);
+    fillPicture(s, 9);
+    const int blocks = 30 * 68;     // 1080 / 16 rounded up
+    FrameChange first = detector.compare(s.ptr[0], s.stride[0], 1920, 1080, 2);
+    ok &= check(first.dirtyBlocks == blocks && first.width == 1920 && first.height == 1080,
+                "first frame entirely dirty");
+    FrameChange same = detector.compare(s.ptr[0], s.stride[0], 1920, 1080, 2);
+    ok &= check(!same.changed() && same.totalBlocks == blocks, "identical frame static");
+
+    // Stride padding is not part of the picture
+    s.at(0, s.rowBytes[0], 100)[0] ^= 0xFF;
+    ok &= check(!detector.compare(s.ptr[0], s.stride[0], 1920, 1080, 2).changed(),
+                "padding ignored");
+
+    // One sample: one block, bounding box on the block grid
+    s.at(0, 700 * 2 + 1, 500)[0] ^= 0x01;
+    FrameChange one = detector.compare(s.ptr[0], s.stride[0], 1920, 1080, 2);
+    ok &= check(one.dirtyBlocks == 1 && one.x == 640 && one.y == 496 &&
+                one.width == 64 && one.height == 16, "single changed sample");
+
+    // Two distant changes: bounding box covers both, partial edge blocks clipped
+    s.at(0, 0, 0)[0] ^= 0x01;
+    s.at(0, 1919 * 2, 1079)[0] ^= 0x01;
+    FrameChange two = detector.compare(s.ptr[0], s.stride[0], 1920, 1080, 2);
+    ok &= check(two.dirtyBlocks == 2 && two.x == 0 && two.y == 0 &&
+                two.width == 1920 && two.height == 1080, "two corners, clipped bounding box");
+
+    // Geometry change and reset() start over
+    ok &= check(detector.compare(s.ptr[0], s.stride[0], 1280, 720, 2).dirtyBlocks == 20 * 45,
+                "geometry change entirely dirty");
+    detector.reset();
+    ok &= check(detector.compare(s.ptr[0], s.stride[0], 1280, 720, 2).dirtyBlocks == 20 * 45,
+                "reset entirely dirty");
+
+    // Odd sizes (BGRA, width not a multiple of the block)
+    Image b(PixelFormat::BGRA, 100, 17);
+    b.fillNoise(9);
+    FrameChangeDetector small;
+    small.compare(b.ptr[0], b.stride[0], 100, 17, 4);
+    b.at(0, 99 * 4 + 3, 16)[0] ^= 0x80;
+    FrameChange edge = small.compare(b.ptr[0], b.stride[0], 100, 17, 4);
+    ok &= check(edge.dirtyBlocks == 1 && edge.x == 64 && edge.y == 16 &&
+                edge.width == 36 && edge.height == 1, "BGRA edge block");
+    return ok;
+}
+
+// Throughput benchmark (not pass/fail)
+void benchmark() {
+    LOG_INFO("Benchmark: ms/frame (Mpixel/s)");
+    const int sizes[][2] = {{1920, 1080}, {3840, 2160}};
+    const int autoThreads = PixelConverter().threadCount();
+
+    for (const auto& c : CONVERSIONS) {
+        for (const auto& sz : sizes) {
+            Image s(c.src, sz[0], sz[1], 0);
+            s.fillNoise(1);
+            Image out(c.dst, sz[0], sz[1], 0);
+            const int frames = sz[0] > 1920 ? 30 : 120;
+            const double mpix = static_cast<double>(sz[0]) * sz[1] / 1e6;
+
+            auto measure = [&](const std::function<void()>& fn) {
+                fn();   // Warm-up
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < frames; i++) fn();
+                auto end = std::chrono::steady_clock::now();
+                return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+            };
+
+            std::string line = name(c) + " " + std::to_string(sz[0]) + "x" +
+                               std::to_string(sz[1]) + ":";
+            char buf[96];
+
+#ifdef HAVE_FFMPEG
+            if (SwsContext* ctx = makeSws(c.src, c.dst, sz[0], sz[1])) {
+                double ms = measure([&] { runSws(ctx, s, out); });
+                std::snprintf(buf, sizeof(buf), "  swscale %.2f (%.0f)", ms, mpix / ms * 1000.0);
+                line += buf;
+                sws_freeContext(ctx);
+            }
+#endif
+            for (ConvertKernel k : ALL_KERNELS) {
+                if (!PixelConverter::kernelAvailable(k)) continue;
+                for (int threads : {1, autoThreads}) {
+                    PixelConverterConfig cfg;
+                    cfg.threads = threads;
+                    PixelConverter conv(cfg);
+                    conv.setKernel(k);
+                    double ms = measure([&] { runConvert(conv, s, out); });
+                    std::snprintf(buf, sizeof(buf), "  %s/%dT %.2f (%.0f)",
+                                  PixelConverter::kernelName(k), threads, ms, mpix / ms * 1000.0);
+                    line += buf;
+                    if (autoThreads == 1) break;
+                }
+            }
+            LOG_INFO(line);
+        }
+    }
+
+    const int autoScale = autoThreads;
+    Image full(PixelFormat::I420, 1920, 1080, 0);
+    full.fillNoise(2);
+    for (const auto& sz : {std::array<int, 2>{1280, 720}, std::array<int, 2>{640, 360}}) {
+        Image out(PixelFormat::I420, sz[0], sz[1], 0);
+        std::string line = "I420 resize 1920x1080->" + std::to_string(sz[0]) + "x" +
+                           std::to_string(sz[1]) + ":";
+        char buf[96];
+        for (int threads : {1, autoScale}) {
+            PixelConverterConfig cfg;
+            cfg.threads = threads;
+            PixelConverter conv(cfg);
+            runScale(conv, full, out);   // Warm-up
+            const int frames = 120;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames; i++) runScale(conv, full, out);
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count() / frames;
+            std::snprintf(buf, sizeof(buf), "  %dT %.2f ms", threads, ms);
+            line += buf;
+            if (autoScale == 1) break;
+        }
+        LOG_INFO(line);
+    }
+
+    Image picture(PixelFormat::UYVY, 1920, 1080, 0);
+    fillPicture(picture, 8);
+    Image decoded(PixelFormat::UYVY, 1920, 1080, 0);
+    for (int threads : {1, autoThreads}) {
+        LosslessCodecConfig cfg;
+        cfg.threads = threads;
+        LosslessCodec codec(cfg);
+        std::vector<uint8_t> coded;
+        const int frames = 60;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) codec.encode(picture.ptr[0], picture.stride[0], 1920, 1080, coded);
+        auto mid = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) codec.decode(coded.data(), coded.size(), decoded.ptr[0], decoded.stride[0]);
+        auto end = std::chrono::steady_clock::now();
+        Logger::instance().infof("Lossless UYVY 1920x1080 %dT: encode %.2f ms, decode %.2f ms, %.2f:1",
+                                 threads,
+                                 std::chrono::duration<double, std::milli>(mid - start).count() / frames,
+                                 std::chrono::duration<double, std::milli>(end - mid).count() / frames,
+                                 1920.0 * 2 * 1080 / coded.size());
+        if (autoThreads == 1) break;
+    }
+
+    FrameChangeDetector detector;
+    const int frames = 240;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) detector.compare(picture.ptr[0], picture.stride[0], 1920, 1080, 2);
+    Logger::instance().infof("Change detection UYVY 1920x1080 (%s): %.3f ms",
+                             FrameChangeDetector::hashName(),
+                             std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start).count() / frames);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool bench = argc > 1 && std::string(argv[1]) == "--bench";
+
+    LOG_INFO("═══════════════════════════════════════");
+    LOG_INFO("  PixelConverter Test");
+    LOG_INFO("═══════════════════════════════════════");
+    Logger::instance().infof("Best kernel: %s, slice threads: %d",
+                             PixelConverter::kernelName(PixelConverter::bestKernel()),
+                             PixelConverter().threadCount());
+
+    bool ok = true;
+    ok &= testReference();
+    ok &= testKernels();
+    ok &= testThreads();
+#ifdef HAVE_FFMPEG
+    ok &= testSwscale();
+#else
+    LOG_INFO("Test 4 skipped (built without FFmpeg)");
+#endif
+    ok &= testScale();
+    ok &= testLossless();
+    ok &= testChangeDetector();
+
+    if (bench) {
+        benchmark();
+    }
+
+    if (ok) {
+        LOG_SUCCESS("═══ ALL TESTS PASSED ═══");
+        return 0;
+    }
+    LOG_ERROR("═══ TESTS FAILED ═══");
+    return 1;
+}
@@ -9,12 +9,18 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 
 #include "common/Logger.h"
+#include "common/LatencyHistogram.h"
 #include "common/Protocol.h"
 #include "network/NetworkSender.h"
 #include "network/NetworkReceiver.h"
+#include "network/CongestionController.h"
+#include "join/DecodeQueue.h"
+#include "relay/RelayMode.h"
 
 using namespace ndi_bridge;
 
@@ -120,6 +126,16 @@ int main() {
             return 1;
         }
 
+        // Slice boundary flags survive serialization alongside the keyframe bit
+        header.flags |= FLAG_SLICE | FLAG_END_OF_AU;
+        serialized = Protocol::serialize(header);
+        deserialized = Protocol::deserialize(serialized.data(), serialized.size());
+        if (!deserialized || !deserialized->isSlice() || !deserialized->isKeyframe() ||
+            !(deserialized->flags & FLAG_END_OF_AU)) {
+            LOG_ERROR("Slice flags mismatch");
+            return 1;
+        }
+
         LOG_SUCCESS("Protocol serialization OK");
     }
 
@@ -240,6 +256,709 @@ int main() {
 
     std::cout << "\n";
 
+    // Test 3: Rendezvous relay (host and join both dial out to the relay)
+    LOG_INFO("Test 3: Rendezvous relay loopback");
+    {
+        const uint16_t relayPort = 15991;
+        const uint16_t joinPort = 15992;
+        const std::string sessionKey = "network-test";
+
+        // Rendezvous packet roundtrip
+        uint8_t regPacket[RENDEZVOUS_PACKET_SIZE];
+        size_t regSize = Protocol::serializeRendezvous(RendezvousRole::Join, sessionKey, regPacket);
+        auto parsed = Protocol::deserializeRendezvous(regPacket, regSize);
+        if (!parsed || parsed->role != RendezvousRole::Join || parsed->sessionKey != sessionKey) {
+            LOG_ERROR("Rendezvous packet roundtrip failed");
+            testPassed = false;
+        }
+
+        RelayModeConfig relayConfig;
+        relayConfig.listenPort = relayPort;
+        RelayMode relay(relayConfig);
+        std::atomic<bool> relayRunning{true};
+        std::thread relayThread([&]() { relay.start(relayRunning); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        // Join: listen locally, register from the same socket
+        NetworkReceiverConfig joinConfig;
+        joinConfig.port = joinPort;
+        NetworkReceiver join(joinConfig);
+        int relayedBefore = videoFramesReceived;
+        join.setOnVideoFrame(onVideoFrame);
+        if (!join.startListening()) {
+            LOG_ERROR("Failed to start join receiver");
+            testPassed = false;
+        }
+        join.sendTo("127.0.0.1", relayPort, regPacket, regSize);
+
+        // Host: connected sender to the relay, register then stream
+        NetworkSenderConfig hostConfig;
+        hostConfig.port = relayPort;
+        NetworkSender host(hostConfig);
+        if (!host.connect()) {
+            LOG_ERROR("Failed to connect host sender to relay");
+            testPassed = false;
+        }
+        regSize = Protocol::serializeRendezvous(RendezvousRole::Host, sessionKey, regPacket);
+        host.sendRaw(regPacket, regSize);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        host.sendVideo(expectedVideoData.data(), expectedVideoData.size(), true, videoTimestamp);
+
+        for (int i = 0; i < 20 && videoFramesReceived == relayedBefore; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        auto relayStats = relay.getStats();
+        Logger::instance().infof("Relay: %lu received, %lu forwarded, %lu registrations, %lu sessions",
+                                 relayStats.packetsReceived, relayStats.packetsForwarded,
+                                 relayStats.registrations, relayStats.activeSessions);
+
+        if (videoFramesReceived == relayedBefore) {
+            LOG_ERROR("No video frame received through relay!");
+            testPassed = false;
+        } else if (relayStats.registrations != 2 || relayStats.activeSessions != 1) {
+            LOG_ERROR("Relay did not pair host and join into one session");
+            testPassed = false;
+        } else {
+            LOG_SUCCESS("Rendezvous relay OK");
+        }
+
+        host.disconnect();
+        join.stop();
+        relayRunning = false;
+        relayThread.join();
+    }
+
+    // Test 4: Frame-level relay (reassemble at 1400, re-fragment at 1200)
+    LOG_INFO("Test 4: Frame-level relay with MTU re-fragmentation");
+    {
+        const uint16_t relayPort = 15993;
+        const uint16_t joinPort = 15994;
+        const std::string sessionKey = "network-test-frames";
+        const size_t outMtu = 1200;
+        const int framesToSend = 3;
+
+        RelayModeConfig relayConfig;
+        relayConfig.listenPort = relayPort;
+        relayConfig.frameLevel = true;
+        relayConfig.outputMtu = outMtu;
+        RelayMode relay(relayConfig);
+        std::atomic<bool> relayRunning{true};
+        std::thread relayThread([&]() { relay.start(relayRunning); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        NetworkReceiverConfig joinConfig;
+        joinConfig.port = joinPort;
+        NetworkReceiver join(joinConfig);
+        int relayedBefore = videoFramesReceived;
+        join.setOnVideoFrame(onVideoFrame);
+        if (!join.startListening()) {
+            LOG_ERROR("Failed to start join receiver");
+            testPassed = false;
+        }
+        uint8_t regPacket[RENDEZVOUS_PACKET_SIZE];
+        size_t regSize = Protocol::serializeRendezvous(RendezvousRole::Join, sessionKey, regPacket);
+        join.sendTo("127.0.0.1", relayPort, regPacket, regSize);
+
+        NetworkSenderConfig hostConfig;
+        hostConfig.port = relayPort;
+        NetworkSender host(hostConfig);
+        if (!host.connect()) {
+            LOG_ERROR("Failed to connect host sender to relay");
+            testPassed = false;
+        }
+        regSize = Protocol::serializeRendezvous(RendezvousRole::Host, sessionKey, regPacket);
+        host.sendRaw(regPacket, regSize);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        for (int f = 0; f < framesToSend; f++) {
+            host.sendVideo(expectedVideoData.data(), expectedVideoData.size(), true,
+                           videoTimestamp + f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        for (int i = 0; i < 20 && videoFramesReceived < relayedBefore + framesToSend; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        auto relayStats = relay.getStats();
+        uint16_t expectedFragments = Protocol::calculateFragmentCount(
+            static_cast<uint32_t>(expectedVideoData.size()), Protocol::payloadSizeForMtu(outMtu));
+        Logger::instance().infof("Relay: %lu frames (%lu keyframes), %lu packets forwarded, latency %.2fms",
+                                 relayStats.framesRelayed, relayStats.keyframesRelayed,
+                                 relayStats.packetsForwarded, relayStats.avgLatencyMs);
+
+        if (videoFramesReceived != relayedBefore + framesToSend) {
+            Logger::instance().errorf("Expected %d frames through frame-level relay, got %d",
+                                      framesToSend, videoFramesReceived - relayedBefore);
+            testPassed = false;
+        } else if (relayStats.framesRelayed != static_cast<uint64_t>(framesToSend) ||
+                   relayStats.keyframesRelayed != static_cast<uint64_t>(framesToSend)) {
+            LOG_ERROR("Relay frame statistics mismatch");
+            testPassed = false;
+        } else if (relayStats.packetsForwarded !=
+                   static_cast<uint64_t>(framesToSend) * expectedFragments) {
+            Logger::instance().errorf("Expected %u fragments per frame at MTU %zu",
+                                      expectedFragments, outMtu);
+            testPassed = false;
+        } else {
+            LOG_SUCCESS("Frame-level relay OK");
+        }
+
+        host.disconnect();
+        join.stop();
+        relayRunning = false;
+        relayThread.join();
+    }
+
+    // Test 5: Fan-out relay (one host, several joins, keyframe gating + GOP cache)
+    LOG_INFO("Test 5: Fan-out relay with keyframe-gated subscribers");
+    {
+        const uint16_t relayPort = 15995;
+        const uint16_t earlyPort = 15996;
+        const uint16_t latePort = 15997;
+        const std::string sessionKey = "network-test-fanout";
+
+        RelayModeConfig relayConfig;
+        relayConfig.listenPort = relayPort;
+        relayConfig.fanout = true;
+        RelayMode relay(relayConfig);
+        std::atomic<bool> relayRunning{true};
+        std::thread relayThread([&]() { relay.start(relayRunning); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        // Each join counts intact frames and records whether its first was a keyframe
+        struct JoinProbe {
+            std::atomic<int> frames{0};
+            std::atomic<bool> firstWasKeyframe{false};
+        };
+        JoinProbe early, late;
+        auto probe = [](JoinProbe& p) {
+            return [&p](const ReceivedVideoFrame& frame) {
+                if (frame.data != expectedVideoData) {
+                    LOG_ERROR("Fan-out video data mismatch!");
+                    testPassed = false;
+                }
+                if (p.frames++ == 0) p.firstWasKeyframe = frame.isKeyframe;
+            };
+        };
+
+        uint8_t regPacket[RENDEZVOUS_PACKET_SIZE];
+        size_t regSize = Protocol::serializeRendezvous(RendezvousRole::Join, sessionKey, regPacket);
+
+        NetworkReceiverConfig earlyConfig;
+        earlyConfig.port = earlyPort;
+        NetworkReceiver earlyJoin(earlyConfig);
+        earlyJoin.setOnVideoFrame(probe(early));
+        earlyJoin.startListening();
+        earlyJoin.sendTo("127.0.0.1", relayPort, regPacket, regSize);
+
+        NetworkSenderConfig hostConfig;
+        hostConfig.port = relayPort;
+        NetworkSender host(hostConfig);
+        host.connect();
+        size_t hostRegSize = Protocol::serializeRendezvous(RendezvousRole::Host, sessionKey, regPacket);
+        host.sendRaw(regPacket, hostRegSize);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        // P-frame first: the early join must not see it (gated until keyframe)
+        host.sendVideo(expectedVideoData.data(), expectedVideoData.size(), false, videoTimestamp);
+        host.sendVideo(expectedVideoData.data(), expectedVideoData.size(), true, videoTimestamp + 1);
+        host.sendVideo(expectedVideoData.data(), expectedVideoData.size(), false, videoTimestamp + 2);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        // Late join: starts instantly from the cached GOP (keyframe + P-frame)
+        NetworkReceiverConfig lateConfig;
+        lateConfig.port = latePort;
+        NetworkReceiver lateJoin(lateConfig);
+        lateJoin.setOnVideoFrame(probe(late));
+        lateJoin.startListening();
+        regSize = Protocol::serializeRendezvous(RendezvousRole::Join, sessionKey, regPacket);
+        lateJoin.sendTo("127.0.0.1", relayPort, regPacket, regSize);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        host.sendVideo(expectedVideoData.data(), expectedVideoData.size(), false, videoTimestamp + 3);
+
+        for (int i = 0; i < 20 && (early.frames < 3 || late.frames < 3); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        auto relayStats = relay.getStats();
+        Logger::instance().infof("Fan-out: early=%d late=%d frames, %lu subscribers, %lu cached starts",
+                                 early.frames.load(), late.frames.load(),
+                                 relayStats.subscribers, relayStats.cachedStarts);
+
+        if (early.frames != 3 || late.frames != 3) {
+            LOG_ERROR("Expected 3 frames on each subscriber (keyframe onwards)");
+            testPassed = false;
+        } else if (!early.firstWasKeyframe || !late.firstWasKeyframe) {
+            LOG_ERROR("A subscriber started on a non-keyframe");
+            testPassed = false;
+        } else if (relayStats.subscribers != 2 || relayStats.cachedStarts != 1) {
+            LOG_ERROR("Fan-out subscriber statistics mismatch");
+            testPassed = false;
+        } else {
+            LOG_SUCCESS("Fan-out relay OK");
+        }
+
+        host.disconnect();
+        earlyJoin.stop();
+        lateJoin.stop();
+        relayRunning = false;
+        relayThread.join();
+    }
+
+    // Test 6: Multi-target sender (one encode, several destinations)
+    LOG_INFO("Test 6: Multi-target sender with per-target pacing");
+    {
+        const uint16_t portA = 15998;
+        const uint16_t portB = 15999;
+
+        NetworkReceiverConfig configA;
+        configA.port = portA;
+        NetworkReceiver receiverA(configA);
+        NetworkReceiverConfig configB;
+        configB.port = portB;
+        NetworkReceiver receiverB(configB);
+
+        std::atomic<int> framesA{0};
+        std::atomic<int> framesB{0};
+        receiverA.setOnVideoFrame([&](const ReceivedVideoFrame& frame) {
+            onVideoFrame(frame);
+            framesA++;
+        });
+        receiverB.setOnVideoFrame([&](const ReceivedVideoFrame& frame) {
+            onVideoFrame(frame);
+            framesB++;
+        });
+        receiverA.startListening();
+        receiverB.startListening();
+
+        NetworkSenderConfig multiConfig;
+        multiConfig.targets.push_back(NetworkTarget{"127.0.0.1", portA, -1});
+        multiConfig.targets.push_back(NetworkTarget{"127.0.0.1", portB, 100});
+        NetworkSender multi(multiConfig);
+        if (!multi.connect()) {
+            LOG_ERROR("Failed to connect multi-target sender");
+            testPassed = false;
+        }
+
+        multi.sendVideo(expectedVideoData.data(), expectedVideoData.size(), true, videoTimestamp);
+
+        for (int i = 0; i < 20 && (framesA == 0 || framesB == 0); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        auto targetStats = multi.getTargetStats();
+        uint16_t fragments = Protocol::calculateFragmentCount(
+            static_cast<uint32_t>(expectedVideoData.size()));
+        if (framesA != 1 || framesB != 1) {
+            Logger::instance().errorf("Expected one frame per target, got %d / %d",
+                                      framesA.load(), framesB.load());
+            testPassed = false;
+        } else if (targetStats.size() != 2 ||
+                   targetStats[0].packetsSent != fragments ||
+                   targetStats[1].packetsSent != fragments ||
+                   targetStats[1].pacingDelayUs != 100) {
+            LOG_ERROR("Per-target statistics mismatch");
+            testPassed = false;
+        } else if (multi.getStats().framesSent != 1) {
+            LOG_ERROR("Frame should be counted once across targets");
+            testPassed = false;
+        } else {
+            LOG_SUCCESS("Multi-target sender OK");
+        }
+
+        // Adaptive pacing: token bucket on source 0 only (burst out at once,
+        // the rest at the rate); another rendition is not held back.
+        // Own receiver: the 200 KB frame would fail the 5000-byte validator on portA.
+        const uint16_t pacedPort = 16001;
+        NetworkReceiverConfig pacedRecvConfig;
+        pacedRecvConfig.port = pacedPort;
+        NetworkReceiver pacedReceiver(pacedRecvConfig);
+        pacedReceiver.setOnVideoFrame([](const ReceivedVideoFrame&) {});
+        pacedReceiver.startListening();
+
+        NetworkSenderConfig pacedConfig;
+        pacedConfig.port = pacedPort;
+        NetworkSender paced(pacedConfig);
+        paced.connect();
+        paced.setPacingRate(8000000, 50000, 0);     // 1 MB/s, 50 KB burst
+        std::vector<uint8_t> large(200000, 0x5A);
+        auto elapsedMs = [&](uint8_t sourceId) {
+            auto t0 = std::chrono::steady_clock::now();
+            paced.sendVideo(large.data(), large.size(), true, videoTimestamp, 0, sourceId);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        };
+        double renditionMs = elapsedMs(1);
+        double pacedMs = elapsedMs(0);
+        // (200 KB - 50 KB burst) at 1 MB/s. Sleeps only run long, so the floor is
+        // tight and the ceiling loose; an unpaced send never reaches the floor.
+        const double expectedMs = 150.0;
+        const double minMs = expectedMs * 0.8;
+        if (renditionMs >= minMs || pacedMs < minMs || pacedMs > expectedMs * 10.0) {
+            Logger::instance().errorf("Pacing mismatch: rendition %.1f ms, paced %.1f ms (expected ~%.0f)",
+                                      renditionMs, pacedMs, expectedMs);
+            testPassed = false;
+        } else {
+            Logger::instance().successf("Per-source pacing token bucket OK (rendition %.1f ms, paced %.1f ms)",
+                                        renditionMs, pacedMs);
+        }
+        paced.disconnect();
+        pacedReceiver.stop();
+
+        multi.disconnect();
+        receiverA.stop();
+        receiverB.stop();
+    }
+
+    // Test 7: Multicast over loopback (any-source + source-specific receivers)
+    LOG_INFO("Test 7: Multicast loopback send/receive");
+    {
+        const uint16_t mcastPort = 16000;
+        const std::string group = "239.255.77.1";
+
+        NetworkReceiverConfig asmConfig;
+        asmConfig.port = mcastPort;
+        asmConfig.multicastGroup = group;
+        asmConfig.multicastInterface = "127.0.0.1";
+        NetworkReceiver asmReceiver(asmConfig);
+
+        NetworkReceiverConfig ssmConfig = asmConfig;
+        ssmConfig.multicastSource = "127.0.0.1";
+        NetworkReceiver ssmReceiver(ssmConfig);
+
+        std::atomic<int> framesAsm{0};
+        std::atomic<int> framesSsm{0};
+        asmReceiver.setOnVideoFrame([&](const ReceivedVideoFrame& frame) {
+            onVideoFrame(frame);
+            framesAsm++;
+        });
+        ssmReceiver.setOnVideoFrame([&](const ReceivedVideoFrame& frame) {
+            onVideoFrame(frame);
+            framesSsm++;
+        });
+
+        if (!asmReceiver.startListening() || !ssmReceiver.startListening()) {
+            LOG_ERROR("Failed to join multicast group on loopback");
+            testPassed = false;
+        } else {
+            NetworkSenderConfig mcastConfig;
+            mcastConfig.host = group;
+            mcastConfig.port = mcastPort;
+            mcastConfig.multicastInterface = "127.0.0.1";
+            mcastConfig.multicastLoopback = true;
+            NetworkSender sender(mcastConfig);
+            if (!sender.connect()) {
+                LOG_ERROR("Failed to connect multicast sender");
+                testPassed = false;
+            }
+
+            sender.sendVideo(expectedVideoData.data(), expectedVideoData.size(), true, videoTimestamp);
+
+            for (int i = 0; i < 20 && (framesAsm == 0 || framesSsm == 0); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+
+            if (framesAsm != 1 || framesSsm != 1) {
+                Logger::instance().errorf("Expected one multicast frame per receiver, got %d / %d",
+                                          framesAsm.load(), framesSsm.load());
+                testPassed = false;
+            } else {
+                LOG_SUCCESS("Multicast loopback OK");
+            }
+            sender.disconnect();
+        }
+
+        asmReceiver.stop();
+        ssmReceiver.stop();
+    }
+
+    std::cout << "\n";
+
+    // Test 8: Receiver reports back to the sender + congestion controller
+    LOG_INFO("Test 8: Receiver reports and adaptive bitrate");
+    {
+        ReceiverReport sent;
+        sent.sequence = 7;
+        sent.intervalMs = 500;
+        sent.packetsReceived = 900;
+        sent.fragmentsLost = 100;
+        sent.framesDropped = 2;
+        sent.receiveRateKbps = 6000;
+        sent.delayGradientUs = -1500;
+        uint8_t bytes[RECEIVER_REPORT_SIZE];
+        size_t written = Protocol::serializeReceiverReport(sent, bytes);
+        auto parsed = Protocol::deserializeReceiverReport(bytes, written);
+        if (written != RECEIVER_REPORT_SIZE || !parsed || parsed->sequence != 7 ||
+            parsed->fragmentsLost != 100 || parsed->delayGradientUs != -1500 ||
+            parsed->lossFraction() < 0.099 || parsed->lossFraction() > 0.101) {
+            LOG_ERROR("Receiver report serialization mismatch");
+            testPassed = false;
+        }
+
+        // Live loop: the receiver reports to whoever sent it media
+        const uint16_t reportPort = 16090;
+        NetworkReceiverConfig recvConfig;
+        recvConfig.port = reportPort;
+        recvConfig.reportIntervalMs = 100;
+        NetworkReceiver receiver(recvConfig);
+        receiver.setOnVideoFrame([](const ReceivedVideoFrame&) {});
+
+        NetworkSenderConfig sendConfig;
+        sendConfig.host = "127.0.0.1";
+        sendConfig.port = reportPort;
+        NetworkSender sender(sendConfig);
+
+        if (!receiver.startListening() || !sender.connect()) {
+            LOG_ERROR("Failed to set up report loop");
+            testPassed = false;
+        } else {
+            std::vector<uint8_t> frame(4000, 0x42);
+            std::optional<ReceiverReport> report;
+            uint8_t buffer[256];
+            for (int i = 0; i < 30 && !report; i++) {
+                sender.sendVideo(frame.data(), frame.size(), i == 0, 1000000ULL * i);
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                size_t size;
+                while (!report && (size = sender.receive(buffer, sizeof(buffer))) > 0) {
+                    report = Protocol::deserializeReceiverReport(buffer, size);
+                }
+            }
+            if (!report || report->packetsReceived == 0 || report->fragmentsLost != 0) {
+                LOG_ERROR("No receiver report came back to the sender");
+                testPassed = false;
+            } else {
+                Logger::instance().successf("Report #%u: %u packets, %u kbps",
+                                            report->sequence, report->packetsReceived,
+                                            report->receiveRateKbps);
+            }
+            sender.disconnect();
+        }
+        receiver.stop();
+
+        // Controller: heavy loss backs off, queue growth backs off to the receive rate,
+        // a clean path probes back up, all within bounds
+        CongestionControllerConfig ccConfig;
+        ccConfig.minBitrate = 1000000;
+        ccConfig.maxBitrate = 10000000;
+        ccConfig.startBitrate = 8000000;
+        CongestionController cc(ccConfig);
+
+        ReceiverReport lossy;
+        lossy.intervalMs = 500;
+        lossy.packetsReceived = 700;
+        lossy.fragmentsLost = 300;
+        lossy.receiveRateKbps = 5600;
+        bool lossChanged = cc.onReport(lossy);
+        int afterLoss = cc.targetBitrate();
+
+        cc.reset(8000000);
+        ReceiverReport queued;
+        queued.intervalMs = 500;
+        queued.packetsReceived = 1000;
+        queued.receiveRateKbps = 6000;
+        queued.delayGradientUs = 10000;
+        cc.onReport(queued);
+        int afterDelay = cc.targetBitrate();
+
+        ReceiverReport clean;
+        clean.intervalMs = 500;
+        clean.packetsReceived = 1000;
+        clean.receiveRateKbps = 5100;
+        for (int i = 0; i < 200; i++) cc.onReport(clean);
+        int afterProbe = cc.targetBitrate();
+
+        if (!lossChanged || afterLoss >= 8000000 || afterLoss < 6000000 ||
+            std::abs(afterDelay - 5100000) > 1 || std::abs(afterProbe - 7650000) > 1 ||
+            cc.pacingRate() <= static_cast<uint64_t>(afterProbe)) {
+            Logger::instance().errorf("Controller mismatch: loss=%d delay=%d probe=%d",
+                                      afterLoss, afterDelay, afterProbe);
+            testPassed = false;
+        } else {
+            LOG_SUCCESS("Receiver reports / adaptive bitrate OK");
+        }
+    }
+
+    std::cout << "\n";
+
+    // Test 9: Timing histogram (join decode-time percentiles)
+    LOG_INFO("Test 9: Latency histogram percentiles");
+    {
+        LatencyHistogram histogram;
+        bool emptyOk = histogram.percentileMs(0.99) == 0.0;
+        for (uint64_t us = 1; us <= 1000; us++) histogram.record(us * 10);    // 0.01-10 ms
+        histogram.record(500000);                                           // Past the last bucket
+        double p50 = histogram.percentileMs(0.50);
+        double p99 = histogram.percentileMs(0.99);
+        double p100 = histogram.percentileMs(1.0);
+        if (!emptyOk || histogram.count() != 1001 || std::abs(p50 - 5.1) > 1e-9 ||
+            std::abs(p99 - 10.0) > 1e-9 || std::abs(p100 - 100.0) > 1e-9) {
+            Logger::instance().errorf("Histogram mismatch: p50=%.2f p99=%.2f p100=%.2f",
+                                      p50, p99, p100);
+            testPassed = false;
+        } else {
+            LOG_SUCCESS("Latency histogram OK");
+        }
+    }
+
+    std::cout << "\n";
+
+    // Test 10: Partial frame salvage (complete slices of a frame that lost a fragment)
+    LOG_INFO("Test 10: Partial frame salvage");
+    {
+        // SPS + three slices, 4-byte start code first; payload bytes never 0 or 1
+        std::vector<uint8_t> au = {0, 0, 0, 1, 0x67};
+        au.resize(24, 0x42);
+        const size_t sliceStart[3] = {24, 328, 632};
+        for (size_t s = 0; s < 3; s++) {
+            au.insert(au.end(), {0, 0, 1, 0x41});
+            for (int i = 0; i < 300; i++) au.push_back(static_cast<uint8_t>(2 + (i + s) % 250));
+        }
+        std::vector<uint8_t> expected(au.begin() + 1, au.begin() + sliceStart[1]);   // SPS + slice 0
+        expected.insert(expected.end(), au.begin() + sliceStart[2], au.end());      // Slice 2
+
+        const uint16_t fragSize = 200;
+        const uint16_t fragCount = static_cast<uint16_t>((au.size() + fragSize - 1) / fragSize);
+        auto feed = [&](FrameReassembler& reassembler, bool lose) {
+            for (uint16_t i = 0; i < fragCount; i++) {
+                if (lose && i == 2) continue;       // Bytes 400-599: middle of slice 1
+                size_t offset = static_cast<size_t>(i) * fragSize;
+                uint16_t size = static_cast<uint16_t>(std::min<size_t>(fragSize, au.size() - offset));
+                PacketHeader header = Protocol::createVideoHeader(7, 1000, static_cast<uint32_t>(au.size()),
+                                                                  i, fragCount, size);
+                reassembler.addPacket(header, au.data() + offset, size);
+            }
+            // Next frame abandons the incomplete one
+            uint8_t next[8] = {0, 0, 0, 1, 0x41, 9, 9, 9};
+            PacketHeader header = Protocol::createVideoHeader(8, 2000, sizeof(next), 0, 1, sizeof(next));
+            return reassembler.addPacket(header, next, sizeof(next));
+        };
+
+        FrameReassembler salvaging;
+        salvaging.setPartialFrames(true);
+        auto next = feed(salvaging, true);
+        auto partial = salvaging.takePartial();
+
+        FrameReassembler dropping;
+        feed(dropping, true);
+
+        FrameReassembler complete;
+        complete.setPartialFrames(true);
+        feed(complete, false);
+
+        if (!next || next->partial || !partial || !partial->partial ||
+            partial->sequenceNumber != 7 || partial->data != expected ||
+            salvaging.takePartial() || salvaging.getStats().framesSalvaged != 1 ||
+            salvaging.getStats().framesDropped != 1 ||
+            dropping.takePartial() || complete.takePartial() ||
+            complete.getStats().framesCompleted != 2) {
+            Logger::instance().errorf("Salvage mismatch: partial=%d size=%zu (expected %zu)",
+                                      partial.has_value() ? 1 : 0,
+                                      partial ? partial->data.size() : 0, expected.size());
+            testPassed = false;
+        } else {
+            LOG_SUCCESS("Partial frame salvage OK");
+        }
+    }
+
+    std::cout << "\n";
+
+    // Test 11: Join decode queue overload policy (cuts only between dependency chains)
+    LOG_INFO("Test 11: Decode queue overload policy");
+    {
+        // Whole picture, or one slice of it (first / last flags as the host sets them)
+        auto unit = [](uint32_t seq, bool keyframe, bool slice = false, bool end = true) {
+            ReceivedVideoFrame frame;
+            frame.timestamp = seq;
+            frame.isKeyframe = keyframe;
+            frame.sequenceNumber = seq;
+            frame.isSlice = slice;
+            frame.endOfAccessUnit = end;
+            return frame;
+        };
+        auto contents = [](const DecodeQueue& queue) {
+            std::vector<uint32_t> seqs;
+            for (size_t i = 0; i < queue.size(); i++) seqs.push_back(queue[i].sequenceNumber);
+            return seqs;
+        };
+        bool ok = true;
+        auto expect = [&](bool condition, const char* what) {
+            if (!condition) {
+                Logger::instance().errorf("Decode queue: %s", what);
+                ok = false;
+            }
+        };
+
+        // Incoming keyframe replaces everything queued
+        {
+            DecodeQueue queue(4);
+            for (uint32_t i = 1; i <= 4; i++) queue.push(unit(i, false));
+            expect(queue.push(unit(5, true)), "incoming keyframe refused");
+            expect(contents(queue) == std::vector<uint32_t>{5}, "incoming keyframe: queue not cleared");
+            expect(queue.getStats().skippedResync == 4, "incoming keyframe: skip count");
+        }
+
+        // Queued keyframe: skip ahead to the newest one
+        {
+            DecodeQueue queue(4);
+            queue.push(unit(1, false));
+            queue.push(unit(2, true));
+            queue.push(unit(3, false));
+            queue.push(unit(4, true));
+            expect(queue.push(unit(5, false)), "queued keyframe: delta refused");
+            expect(contents(queue) == (std::vector<uint32_t>{4, 5}), "queued keyframe: wrong cut");
+            expect(queue.getStats().skippedResync == 3 && !queue.awaitingKeyframe(),
+                   "queued keyframe: counters");
+        }
+
+        // No keyframe: drop, refuse the dependants, resume at the next keyframe
+        {
+            DecodeQueue queue(4);
+            for (uint32_t i = 1; i <= 4; i++) queue.push(unit(i, false));
+            expect(!queue.push(unit(5, false)) && queue.awaitingKeyframe(), "no keyframe: delta admitted");
+            expect(!queue.push(unit(6, false)) && !queue.push(unit(7, false)), "no keyframe: dependant admitted");
+            expect(contents(queue) == (std::vector<uint32_t>{1, 2, 3, 4}), "no keyframe: queued pictures lost");
+            queue.pop();
+            expect(queue.push(unit(8, true)) && !queue.awaitingKeyframe(), "no keyframe: keyframe refused");
+            expect(queue.push(unit(9, false)), "no keyframe: delta after keyframe refused");
+            expect(contents(queue) == (std::vector<uint32_t>{8, 9}), "no keyframe: wrong resume");
+            auto stats = queue.getStats();
+            expect(stats.droppedOverload == 1 && stats.skippedResync == 5, "no keyframe: counters");
+        }
+
+        // Slice units: a picture is kept or dropped whole
+        {
+            DecodeQueue queue(4);
+            queue.push(unit(1, false));
+            queue.push(unit(2, false, true, false));    // Picture 2, slices a-c queued
+            queue.push(unit(2, false, true, false));
+            queue.push(unit(2, false, true, false));
+            expect(!queue.push(unit(2, false, true, true)), "slices: last slice admitted");
+            expect(contents(queue) == std::vector<uint32_t>{1}, "slices: partial picture left queued");
+            expect(!queue.push(unit(3, false, true, false)) && !queue.push(unit(3, false, true, true)),
+                   "slices: dependant slice admitted");
+            // IDR in slices: only the first carries the keyframe flag
+            expect(queue.push(unit(4, true, true, false)) && queue.push(unit(4, false, true, false)) &&
+                   queue.push(unit(4, false, true, true)), "slices: IDR slices refused");
+            expect(contents(queue) == (std::vector<uint32_t>{1, 4, 4, 4}), "slices: wrong queue after IDR");
+
+            // Full again: skipping to the queued IDR starts at its first slice
+            expect(queue.push(unit(5, false, true, false)), "slices: delta slice refused");
+            expect(contents(queue) == (std::vector<uint32_t>{4, 4, 4, 5}) && queue[0].isKeyframe,
+                   "slices: cut inside an access unit");
+        }
+
+        if (ok) {
+            LOG_SUCCESS("Decode queue overload policy OK");
+        } else {
+            testPassed = false;
+        }
+    }
+
+    std::cout << "\n";
+
     if (testPassed) {
         LOG_SUCCESS("=== ALL TESTS PASSED ===");
         return 0;
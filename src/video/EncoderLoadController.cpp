@@ -0,0 +1,93 @@
+/**
+ * EncoderLoadController.cpp - Encoder preset adaptation from measured headroom
+ */
+
+#include "video/EncoderLoadController.h"
+#include "common/Logger.h"
+
+#include <algorithm>
+
+namespace ndi_bridge {
+
+static const char* const PRESETS[] = {
+    "ultrafast", "superfast", "veryfast", "faster", "fast", "medium", "slow"
+};
+
+bool EncoderLoadController::isPreset(const std::string& preset) {
+    return std::find(std::begin(PRESETS), std::end(PRESETS), preset) != std::end(PRESETS);
+}
+
+EncoderLoadController::EncoderLoadController(const EncoderLoadControllerConfig& config) {
+    if (config.allowHalfFrameRate) {
+        ladder_.push_back(OperatingPoint{PRESETS[0], 2});
+    }
+    for (const char* preset : PRESETS) {
+        ladder_.push_back(OperatingPoint{preset, 1});
+        if (config.maxPreset == preset) break;
+    }
+
+    for (size_t i = 0; i < ladder_.size(); i++) {
+        if (ladder_[i].decimation == 1 && config.startPreset == ladder_[i].preset) {
+            level_ = i;
+        }
+    }
+}
+
+void EncoderLoadController::setFrameRate(int fps) {
+    fps_ = std::max(fps, 1);
+}
+
+bool EncoderLoadController::onFrame(double encodeMs, uint64_t droppedTotal) {
+    if (!droppedBaseline_) {
+        windowDropped_ = droppedTotal;
+        droppedBaseline_ = true;
+    }
+
+    windowMs_ += encodeMs;
+    // One window per second of source time, whatever the decimation
+    if (++windowFrames_ < std::max(fps_ / frameDecimation(), 1)) {
+        return false;
+    }
+
+    const double budgetMs = 1000.0 * frameDecimation() / fps_;
+    const double load = windowMs_ / windowFrames_ / budgetMs;
+    const bool dropped = droppedTotal > windowDropped_;
+    windowFrames_ = 0;
+    windowMs_ = 0.0;
+    windowDropped_ = droppedTotal;
+    lastLoad_ = load;
+
+    if (barredWindows_ > 0 && --barredWindows_ == 0) {
+        barredLevel_ = 0;
+    }
+    if (settleWindows_ > 0) {
+        settleWindows_--;
+        return false;
+    }
+
+    const size_t previous = level_;
+    if (load > HIGH_LOAD || dropped) {
+        lowWindows_ = 0;
+        if (level_ == 0) return false;
+        barredLevel_ = level_;
+        barredWindows_ = BAR_WINDOWS;
+        level_--;
+    } else if (load < LOW_LOAD) {
+        if (++lowWindows_ < UPGRADE_WINDOWS) return false;
+        lowWindows_ = 0;
+        if (level_ + 1 >= ladder_.size() || level_ + 1 == barredLevel_) return false;
+        level_++;
+    } else {
+        lowWindows_ = 0;
+        return false;
+    }
+
+    settleWindows_ = 1;
+    Logger::instance().infof("Encoder load %.0f%%%s: %s%s -> %s%s",
+                             load * 100.0, dropped ? " (frames dropped)" : "",
+                             ladder_[previous].preset, ladder_[previous].decimation > 1 ? " @ half rate" : "",
+                             preset(), frameDecimation() > 1 ? " @ half rate" : "");
+    return true;
+}
+
+} // namespace ndi_bridge
@@ -0,0 +1,101 @@
+#pragma once
+
+/**
+ * EncoderLoadController.h - Encoder preset adaptation from measured headroom
+ *
+ * Walks an operating-point ladder, fastest first:
+ *
+ *   [ultrafast @ half rate] → ultrafast → superfast → veryfast → faster → fast → medium
+ *
+ * Load is the mean encode time per frame over a one-second window divided
+ * by the frame budget (1/fps, doubled at half rate). Hysteresis:
+ *
+ *   - load > 85% or the pipeline dropped a frame: one step faster at once,
+ *     and the point that overloaded is barred for a minute,
+ *   - load < 50% for three windows in a row: one step slower,
+ *   - the window after a change is ignored (the reopen emits an IDR).
+ *
+ * A slower preset costs roughly 1.5-2x per step, so the 50% threshold keeps
+ * the new point under the 85% one and the controller does not oscillate.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ndi_bridge {
+
+/**
+ * Controller bounds
+ */
+struct EncoderLoadControllerConfig {
+    std::string startPreset = "ultrafast";
+    std::string maxPreset = "medium";       // Slowest (best quality) preset allowed
+    bool allowHalfFrameRate = false;        // Last resort below ultrafast
+};
+
+/**
+ * EncoderLoadController - Turns encode times into preset / frame-rate steps
+ *
+ * Not thread-safe: feed it from the encode thread.
+ */
+class EncoderLoadController {
+public:
+    explicit EncoderLoadController(const EncoderLoadControllerConfig& config = EncoderLoadControllerConfig());
+
+    /**
+     * Set the source frame rate (frame budget and window length)
+     */
+    void setFrameRate(int fps);
+
+    /**
+     * Record one encoded frame
+     * @param encodeMs Time spent encoding it
+     * @param droppedTotal Running count of frames dropped because the encoder was behind
+     * @return true if the operating point changed (apply preset() / frameDecimation())
+     */
+    bool onFrame(double encodeMs, uint64_t droppedTotal);
+
+    /**
+     * Current operating point
+     */
+    const char* preset() const { return ladder_[level_].preset; }
+    int frameDecimation() const { return ladder_[level_].decimation; }  // Encode 1 frame in N
+
+    /**
+     * Load of the last complete window (1.0 = encode time equals the frame budget)
+     */
+    double lastLoad() const { return lastLoad_; }
+
+    /**
+     * Known x264 preset (fastest to slowest order)
+     */
+    static bool isPreset(const std::string& preset);
+
+private:
+    static constexpr double HIGH_LOAD = 0.85;
+    static constexpr double LOW_LOAD = 0.50;
+    static constexpr int UPGRADE_WINDOWS = 3;
+    static constexpr int BAR_WINDOWS = 60;      // One minute at one window per second
+
+    struct OperatingPoint {
+        const char* preset;
+        int decimation;
+    };
+
+    std::vector<OperatingPoint> ladder_;
+    size_t level_ = 0;
+
+    int fps_ = 60;
+    int windowFrames_ = 0;
+    double windowMs_ = 0.0;
+    uint64_t windowDropped_ = 0;    // droppedTotal at window start
+    bool droppedBaseline_ = false;
+    int lowWindows_ = 0;
+    int settleWindows_ = 0;
+    size_t barredLevel_ = 0;        // Level that overloaded (0 = none)
+    int barredWindows_ = 0;
+    double lastLoad_ = 0.0;
+};
+
+} // namespace ndi_bridge
@@ -0,0 +1,189 @@
+#include "video/FrameChangeDetector.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FRAMECHANGE_X86 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define FRAMECHANGE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define FRAMECHANGE_TARGET(isa)
+#endif
+#elif defined(__ARM_FEATURE_CRC32)
+#define FRAMECHANGE_ARM_CRC 1
+#include <arm_acle.h>
+#endif
+
+namespace ndi_bridge {
+
+namespace {
+
+// Hash `size` bytes, continuing from `seed` (one row segment of a block)
+using SegmentHash = uint32_t (*)(uint32_t seed, const uint8_t* data, size_t size);
+
+uint32_t hashScalar(uint32_t seed, const uint8_t* data, size_t size) {
+    constexpr uint64_t MULTIPLIER = 0xff51afd7ed558ccdULL;
+    uint64_t h = seed ^ 0x9E3779B97F4A7C15ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * MULTIPLIER;
+        h ^= h >> 32;
+    }
+    for (; i < size; i++) {
+        h = (h ^ data[i]) * MULTIPLIER;
+    }
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+#ifdef FRAMECHANGE_X86
+FRAMECHANGE_TARGET("sse4.2")
+uint32_t hashSSE42(uint32_t seed, const uint8_t* data, size_t size) {
+    uint64_t crc = seed;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        crc = _mm_crc32_u64(crc, word);
+    }
+    uint32_t crc32 = static_cast<uint32_t>(crc);
+    for (; i < size; i++) {
+        crc32 = _mm_crc32_u8(crc32, data[i]);
+    }
+    return crc32;
+}
+
+bool cpuHasSSE42() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return false;
+#endif
+}
+#endif // FRAMECHANGE_X86
+
+#ifdef FRAMECHANGE_ARM_CRC
+uint32_t hashArmCrc(uint32_t seed, const uint8_t* data, size_t size) {
+    uint32_t crc = seed;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        crc = __crc32cd(crc, word);
+    }
+    for (; i < size; i++) {
+        crc = __crc32cb(crc, data[i]);
+    }
+    return crc;
+}
+#endif
+
+struct HashImpl {
+    SegmentHash fn;
+    const char* name;
+};
+
+const HashImpl& hashImpl() {
+    static const HashImpl impl = [] {
+#ifdef FRAMECHANGE_X86
+        if (cpuHasSSE42()) return HashImpl{hashSSE42, "crc32c-sse4.2"};
+#endif
+#ifdef FRAMECHANGE_ARM_CRC
+        return HashImpl{hashArmCrc, "crc32c-arm"};
+#endif
+        return HashImpl{hashScalar, "scalar"};
+    }();
+    return impl;
+}
+
+} // namespace
+
+FrameChangeDetector::FrameChangeDetector(const FrameChangeDetectorConfig& config)
+    : config_(config) {
+    config_.blockWidth = std::max(config_.blockWidth, 1);
+    config_.blockHeight = std::max(config_.blockHeight, 1);
+}
+
+const char* FrameChangeDetector::hashName() {
+    return hashImpl().name;
+}
+
+void FrameChangeDetector::reset() {
+    hashes_.clear();
+    width_ = height_ = bytesPerPixel_ = 0;
+}
+
+FrameChange FrameChangeDetector::compare(const uint8_t* data, int stride, int width, int height,
+                                         int bytesPerPixel) {
+    FrameChange change;
+    if (!data || width <= 0 || height <= 0 || bytesPerPixel <= 0) {
+        return change;
+    }
+
+    const int bw = config_.blockWidth;
+    const int bh = config_.blockHeight;
+    const int cols = (width + bw - 1) / bw;
+    const int rows = (height + bh - 1) / bh;
+    const size_t rowBytes = static_cast<size_t>(width) * bytesPerPixel;
+    const size_t segmentBytes = static_cast<size_t>(bw) * bytesPerPixel;
+
+    const bool fresh = width != width_ || height != height_ || bytesPerPixel != bytesPerPixel_ ||
+                       hashes_.size() != static_cast<size_t>(cols) * rows;
+    if (fresh) {
+        hashes_.assign(static_cast<size_t>(cols) * rows, 0);
+        width_ = width;
+        height_ = height;
+        bytesPerPixel_ = bytesPerPixel;
+    }
+    band_.resize(cols);
+
+    const SegmentHash hash = hashImpl().fn;
+    int minCol = cols, maxCol = -1, minRow = rows, maxRow = -1;
+
+    for (int br = 0; br < rows; br++) {
+        std::fill(band_.begin(), band_.end(), 0u);
+
+        // Row-major walk: each row feeds one segment into every block of the band
+        const int y1 = std::min(height, (br + 1) * bh);
+        for (int y = br * bh; y < y1; y++) {
+            const uint8_t* row = data + static_cast<size_t>(y) * stride;
+            for (int c = 0; c < cols; c++) {
+                const size_t offset = c * segmentBytes;
+                band_[c] = hash(band_[c], row + offset, std::min(segmentBytes, rowBytes - offset));
+            }
+        }
+
+        uint32_t* previous = hashes_.data() + static_cast<size_t>(br) * cols;
+        for (int c = 0; c < cols; c++) {
+            if (!fresh && band_[c] == previous[c]) continue;
+            previous[c] = band_[c];
+            change.dirtyBlocks++;
+            minCol = std::min(minCol, c);
+            maxCol = std::max(maxCol, c);
+            minRow = std::min(minRow, br);
+            maxRow = br;
+        }
+    }
+
+    change.totalBlocks = cols * rows;
+    if (change.dirtyBlocks > 0) {
+        change.x = minCol * bw;
+        change.y = minRow * bh;
+        change.width = std::min(width, (maxCol + 1) * bw) - change.x;
+        change.height = std::min(height, (maxRow + 1) * bh) - change.y;
+    }
+    return change;
+}
+
+} // namespace ndi_bridge
@@ -0,0 +1,82 @@
+#pragma once
+
+/**
+ * FrameChangeDetector.h - Block-hash comparison of consecutive frames
+ *
+ * Detects static content (slides, dashboards, graphics) before any
+ * conversion or encode work is spent on it. The frame is cut into blocks
+ * (64x16 pixels by default); each block is hashed with CRC32C (SSE4.2 or
+ * ARMv8 CRC instructions, picked at runtime on x86; a multiplicative hash
+ * otherwise) and compared with the previous frame's hash for that block.
+ * Only one hash per block is kept, not the previous frame.
+ *
+ * Works on packed frames (UYVY / BGRA). No FFmpeg dependency.
+ */
+
+#include <cstdint>
+#include <vector>
+
+namespace ndi_bridge {
+
+/**
+ * Detector configuration
+ */
+struct FrameChangeDetectorConfig {
+    int blockWidth = 64;        // Pixels per block (horizontal)
+    int blockHeight = 16;       // Rows per block
+};
+
+/**
+ * Result of one comparison
+ */
+struct FrameChange {
+    int dirtyBlocks = 0;        // Blocks whose hash differs from the previous frame
+    int totalBlocks = 0;
+    // Bounding box of the dirty blocks in pixels (all zero when static)
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool changed() const { return dirtyBlocks > 0; }
+    double dirtyFraction() const { return totalBlocks ? static_cast<double>(dirtyBlocks) / totalBlocks : 0.0; }
+};
+
+/**
+ * FrameChangeDetector - Dirty-block detection between consecutive frames
+ *
+ * compare() is not reentrant: one caller at a time (the convert thread).
+ */
+class FrameChangeDetector {
+public:
+    explicit FrameChangeDetector(const FrameChangeDetectorConfig& config = FrameChangeDetectorConfig());
+
+    /**
+     * Hash a frame and compare it with the previous one
+     *
+     * The first frame, and any frame after a geometry change or reset(),
+     * is entirely dirty.
+     * @param bytesPerPixel 2 for UYVY, 4 for BGRA
+     */
+    FrameChange compare(const uint8_t* data, int stride, int width, int height, int bytesPerPixel);
+
+    /**
+     * Forget the previous frame (next compare() reports everything dirty)
+     */
+    void reset();
+
+    /**
+     * Hash implementation in use ("crc32c-sse4.2", "crc32c-arm", "scalar")
+     */
+    static const char* hashName();
+
+private:
+    FrameChangeDetectorConfig config_;
+    std::vector<uint32_t> hashes_;      // Previous frame, one per block (row-major)
+    std::vector<uint32_t> band_;        // Hashes of the block row being compared
+    int width_ = 0;
+    int height_ = 0;
+    int bytesPerPixel_ = 0;
+};
+
+} // namespace ndi_bridge
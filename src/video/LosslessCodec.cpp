@@ -0,0 +1,499 @@
+#include "video/LosslessCodec.h"
+#include "common/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ndi_bridge {
+
+namespace {
+
+constexpr int MAX_AUTO_THREADS = 8;
+constexpr uint32_t STORED_FLAG = 0x80000000u;
+
+// Rice code: q = u >> k zeros, a one, then the k low bits of u. A prefix of
+// RICE_ESCAPE zeros instead carries the residual as a plain byte, so no
+// sample costs more than RICE_ESCAPE + 9 bits.
+constexpr int RICE_ESCAPE = 12;
+constexpr int MAX_SAMPLE_BITS = RICE_ESCAPE + 1 + 8;
+
+// UYVY byte order within a macropixel: U Y0 V Y1
+enum Component { Luma = 0, Cb = 1, Cr = 2 };
+
+inline int countLeadingZeros(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    return _BitScanReverse64(&index, value) ? 63 - static_cast<int>(index) : 64;
+#else
+    return value ? __builtin_clzll(value) : 64;
+#endif
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    return (static_cast<uint64_t>(p[0]) << 56) | (static_cast<uint64_t>(p[1]) << 48) |
+           (static_cast<uint64_t>(p[2]) << 40) | (static_cast<uint64_t>(p[3]) << 32) |
+           (static_cast<uint64_t>(p[4]) << 24) | (static_cast<uint64_t>(p[5]) << 16) |
+           (static_cast<uint64_t>(p[6]) << 8) | p[7];
+}
+
+inline int countLeadingZeros32(uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    return _BitScanReverse(&index, value) ? 31 - static_cast<int>(index) : 32;
+#else
+    return value ? __builtin_clz(value) : 32;
+#endif
+}
+
+struct RiceContext {
+    // Running mean of the zigzagged residual, x16 (decays over ~16 samples,
+    // so k follows the local residual magnitude)
+    uint32_t mean = 64;
+
+    // Smallest k with 2^k >= mean residual
+    int k() const {
+        const uint32_t avg = mean >> 4;
+        return avg ? std::min(32 - countLeadingZeros32(avg), 7) : 0;
+    }
+
+    void update(uint32_t u) { mean += u - (mean >> 4); }
+};
+
+// LOCO-I median edge detector: median(left, above, left + above - aboveLeft),
+// written as a clamp the compiler turns into conditional moves
+inline int medianPredict(int left, int above, int aboveLeft) {
+    const int lo = left < above ? left : above;
+    const int hi = left < above ? above : left;
+    const int gradient = left + above - aboveLeft;
+    return gradient < lo ? lo : (gradient > hi ? hi : gradient);
+}
+
+/**
+ * Visit one row in coding order with each sample's prediction
+ *
+ * Neighbours are the previous sample of the same component: 2 bytes back
+ * for luma, 4 for chroma. The first row of a slice (above == nullptr) uses
+ * the left neighbour only, the first macropixel of a row the one above.
+ * The decoder passes its output row, so predictions read reconstructed
+ * samples exactly as the encoder saw them.
+ */
+template <typename Row, typename Sample>
+inline bool codeRow(Row* row, const uint8_t* above, int rowBytes, RiceContext* ctx, Sample&& sample) {
+    static constexpr Component COMPONENT[4] = {Cb, Luma, Cr, Luma};
+
+    for (int i = 0; i < 4; i++) {
+        if (!sample(ctx[COMPONENT[i]], above ? above[i] : (i == 3 ? row[1] : 128), row[i])) return false;
+    }
+
+    if (!above) {
+        for (int i = 4; i < rowBytes; i += 4) {
+            if (!sample(ctx[Cb], row[i - 4], row[i])) return false;
+            if (!sample(ctx[Luma], row[i - 1], row[i + 1])) return false;
+            if (!sample(ctx[Cr], row[i - 2], row[i + 2])) return false;
+            if (!sample(ctx[Luma], row[i + 1], row[i + 3])) return false;
+        }
+        return true;
+    }
+
+    for (int i = 4; i < rowBytes; i += 4) {
+        if (!sample(ctx[Cb], medianPredict(row[i - 4], above[i], above[i - 4]), row[i])) return false;
+        if (!sample(ctx[Luma], medianPredict(row[i - 1], above[i + 1], above[i - 1]), row[i + 1])) return false;
+        if (!sample(ctx[Cr], medianPredict(row[i - 2], above[i + 2], above[i - 2]), row[i + 2])) return false;
+        if (!sample(ctx[Luma], medianPredict(row[i + 1], above[i + 3], above[i + 1]), row[i + 3])) return false;
+    }
+    return true;
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t* out) : begin_(out), out_(out) {}
+
+    void put(uint32_t value, int bits) {
+        acc_ = (acc_ << bits) | value;
+        bits_ += bits;
+        if (bits_ >= 32) {
+            bits_ -= 32;
+            const uint32_t word = static_cast<uint32_t>(acc_ >> bits_);
+            out_[0] = static_cast<uint8_t>(word >> 24);
+            out_[1] = static_cast<uint8_t>(word >> 16);
+            out_[2] = static_cast<uint8_t>(word >> 8);
+            out_[3] = static_cast<uint8_t>(word);
+            out_ += 4;
+        }
+    }
+
+    void flush() {
+        while (bits_ >= 8) {
+            bits_ -= 8;
+            *out_++ = static_cast<uint8_t>(acc_ >> bits_);
+        }
+        if (bits_ > 0) {
+            *out_++ = static_cast<uint8_t>(acc_ << (8 - bits_));
+            bits_ = 0;
+        }
+    }
+
+    // Bytes written so far, including the bits still buffered
+    size_t size() const { return static_cast<size_t>(out_ - begin_) + (bits_ + 7) / 8; }
+
+private:
+    uint8_t* begin_;
+    uint8_t* out_;
+    uint64_t acc_ = 0;
+    int bits_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    // At least 56 bits buffered (zeros past the end of the slice)
+    void refill() {
+        if (pos_ + 8 <= size_) {
+            // Whole bytes that fit; the partial one is re-read at the same bit position
+            window_ |= load64(data_ + pos_) >> bits_;
+            const int bytes = (63 - bits_) >> 3;
+            pos_ += bytes;
+            bits_ += bytes * 8;
+            return;
+        }
+        while (bits_ <= 56) {
+            uint64_t byte = pos_ < size_ ? data_[pos_] : 0;
+            pos_++;
+            window_ |= byte << (56 - bits_);
+            bits_ += 8;
+        }
+    }
+
+    int leadingZeros() const { return countLeadingZeros(window_); }
+
+    uint32_t take(int bits) {
+        if (bits == 0) return 0;
+        uint32_t value = static_cast<uint32_t>(window_ >> (64 - bits));
+        skip(bits);
+        return value;
+    }
+
+    void skip(int bits) {
+        window_ <<= bits;
+        bits_ -= bits;
+    }
+
+    // Consumed more than the slice holds
+    bool overrun() const { return pos_ * 8 - static_cast<size_t>(bits_) > size_ * 8; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    uint64_t window_ = 0;
+    int bits_ = 0;
+};
+
+inline uint32_t zigzag(int residual) {
+    return (static_cast<uint32_t>(residual) << 1) ^ static_cast<uint32_t>(residual >> 31);
+}
+
+inline int unzigzag(uint32_t u) {
+    return static_cast<int>(u >> 1) ^ -static_cast<int>(u & 1);
+}
+
+/**
+ * Code rows [y0, y1) into out (capacity raw size + one worst-case row)
+ * @return coded size, or the raw size | STORED_FLAG when coding does not pay
+ */
+uint32_t encodeSlice(const uint8_t* src, int stride, int rowBytes, int y0, int y1, uint8_t* out) {
+    const size_t rawSize = static_cast<size_t>(rowBytes) * (y1 - y0);
+    RiceContext ctx[3];
+    BitWriter writer(out);
+
+    auto sample = [&](RiceContext& c, int pred, uint8_t x) {
+        const uint32_t u = zigzag(static_cast<int8_t>(static_cast<uint8_t>(x - pred)));
+        const int k = c.k();
+        const uint32_t q = u >> k;
+        if (q < RICE_ESCAPE) {
+            writer.put((1u << k) | (u & ((1u << k) - 1)), static_cast<int>(q) + 1 + k);
+        } else {
+            writer.put(0x100u | u, RICE_ESCAPE + 1 + 8);
+        }
+        c.update(u);
+        return true;
+    };
+
+    bool stored = false;
+    for (int y = y0; y < y1; y++) {
+        const uint8_t* row = src + static_cast<size_t>(y) * stride;
+        const uint8_t* above = y > y0 ? row - stride : nullptr;
+        codeRow(row, above, rowBytes, ctx, sample);
+        if (writer.size() > rawSize) {
+            stored = true;
+            break;
+        }
+    }
+    writer.flush();
+
+    if (stored || writer.size() >= rawSize) {
+        for (int y = y0; y < y1; y++) {
+            std::memcpy(out + static_cast<size_t>(y - y0) * rowBytes,
+                        src + static_cast<size_t>(y) * stride, rowBytes);
+        }
+        return static_cast<uint32_t>(rawSize) | STORED_FLAG;
+    }
+    return static_cast<uint32_t>(writer.size());
+}
+
+bool decodeSlice(const uint8_t* data, size_t size, uint8_t* dst, int stride, int rowBytes, int y0, int y1) {
+    RiceContext ctx[3];
+    BitReader reader(data, size);
+
+    auto sample = [&](RiceContext& c, int pred, uint8_t& x) {
+        reader.refill();
+        const int zeros = reader.leadingZeros();
+        uint32_t u;
+        if (zeros < RICE_ESCAPE) {
+            const int k = c.k();
+            reader.skip(zeros + 1);
+            u = (static_cast<uint32_t>(zeros) << k) | reader.take(k);
+        } else if (zeros == RICE_ESCAPE) {
+            reader.skip(RICE_ESCAPE + 1);
+            u = reader.take(8);
+        } else {
+            return false;
+        }
+        x = static_cast<uint8_t>(pred + unzigzag(u));
+        c.update(u);
+        return true;
+    };
+
+    for (int y = y0; y < y1; y++) {
+        uint8_t* row = dst + static_cast<size_t>(y) * stride;
+        const uint8_t* above = y > y0 ? row - stride : nullptr;
+        if (!codeRow(row, above, rowBytes, ctx, sample) || reader.overrun()) return false;
+    }
+    return true;
+}
+
+inline void put16(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 8);
+    p[1] = static_cast<uint8_t>(v);
+}
+
+inline void put32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+inline uint32_t get16(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 8) | p[1];
+}
+
+inline uint32_t get32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline int sliceRow(int height, int slice, int count) {
+    return static_cast<int>(static_cast<int64_t>(height) * slice / count);
+}
+
+} // namespace
+
+// ============================================================================
+// LosslessCodec
+// ============================================================================
+
+LosslessCodec::LosslessCodec(const LosslessCodecConfig& config)
+    : config_(config) {
+    int threads = config_.threads;
+    if (threads <= 0) {
+        threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()),
+                             1, MAX_AUTO_THREADS);
+    }
+
+    threads_ = threads;
+    for (int i = 1; i < threads; i++) {
+        workers_.emplace_back(&LosslessCodec::workerLoop, this, i);
+    }
+
+    Logger::instance().debugf("LosslessCodec: %d slice thread(s)", threadCount());
+}
+
+LosslessCodec::~LosslessCodec() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+std::optional<LosslessCodec::FrameInfo> LosslessCodec::parseHeader(const uint8_t* data, size_t size) {
+    if (!data || size < LOSSLESS_HEADER_SIZE || data[0] != LOSSLESS_VERSION) {
+        return std::nullopt;
+    }
+
+    FrameInfo info;
+    info.slices = data[1];
+    info.width = static_cast<int>(get16(data + 2));
+    info.height = static_cast<int>(get16(data + 4));
+    if (info.slices < 1 || info.slices > LOSSLESS_MAX_SLICES || info.slices > info.height ||
+        info.width <= 0 || (info.width & 1) ||
+        size < LOSSLESS_HEADER_SIZE + 4 * static_cast<size_t>(info.slices)) {
+        return std::nullopt;
+    }
+    // Every sample costs at least one bit: bounds what a header can make us allocate
+    if (size * 8 < static_cast<size_t>(info.width) * 2 * info.height) {
+        return std::nullopt;
+    }
+    return info;
+}
+
+bool LosslessCodec::encode(const uint8_t* src, int srcStride, int width, int height,
+                           std::vector<uint8_t>& out) {
+    if (!src || width <= 0 || height <= 0 || (width & 1) || width > 0xFFFF || height > 0xFFFF ||
+        srcStride < width * 2) {
+        return false;
+    }
+
+    const int rowBytes = width * 2;
+    const int slices = std::clamp(config_.slices > 0 ? config_.slices : threadCount(),
+                                  1, std::min(LOSSLESS_MAX_SLICES, height));
+
+    // Worst case: a slice that turns out incompressible, plus the row that revealed it
+    if (static_cast<int>(sliceBuffers_.size()) < slices) {
+        sliceBuffers_.resize(slices);
+    }
+    uint32_t sliceSizes[LOSSLESS_MAX_SLICES];
+
+    const std::function<void(int)> job = [&](int slice) {
+        const int y0 = sliceRow(height, slice, slices);
+        const int y1 = sliceRow(height, slice + 1, slices);
+        auto& buffer = sliceBuffers_[slice];
+        const size_t capacity = static_cast<size_t>(rowBytes) * (y1 - y0 + 1) +
+                                static_cast<size_t>(rowBytes) * MAX_SAMPLE_BITS / 8 + 8;
+        if (buffer.size() < capacity) buffer.resize(capacity);
+        sliceSizes[slice] = encodeSlice(src, srcStride, rowBytes, y0, y1, buffer.data());
+    };
+    runSlices(slices, job);
+
+    size_t total = LOSSLESS_HEADER_SIZE + 4 * static_cast<size_t>(slices);
+    for (int i = 0; i < slices; i++) {
+        total += sliceSizes[i] & ~STORED_FLAG;
+    }
+
+    out.resize(total);
+    uint8_t* p = out.data();
+    p[0] = LOSSLESS_VERSION;
+    p[1] = static_cast<uint8_t>(slices);
+    put16(p + 2, static_cast<uint32_t>(width));
+    put16(p + 4, static_cast<uint32_t>(height));
+    put16(p + 6, 0);
+    p += LOSSLESS_HEADER_SIZE;
+    for (int i = 0; i < slices; i++, p += 4) {
+        put32(p, sliceSizes[i]);
+    }
+    for (int i = 0; i < slices; i++) {
+        const size_t bytes = sliceSizes[i] & ~STORED_FLAG;
+        std::memcpy(p, sliceBuffers_[i].data(), bytes);
+        p += bytes;
+    }
+    return true;
+}
+
+bool LosslessCodec::decode(const uint8_t* data, size_t size, uint8_t* dst, int dstStride) {
+    auto info = parseHeader(data, size);
+    if (!info || !dst || dstStride < info->width * 2) {
+        return false;
+    }
+
+    const int slices = info->slices;
+    const int rowBytes = info->width * 2;
+    const int height = info->height;
+
+    // Slice table → payload offsets
+    size_t offsets[LOSSLESS_MAX_SLICES + 1];
+    uint32_t sliceSizes[LOSSLESS_MAX_SLICES];
+    offsets[0] = LOSSLESS_HEADER_SIZE + 4 * static_cast<size_t>(slices);
+    for (int i = 0; i < slices; i++) {
+        sliceSizes[i] = get32(data + LOSSLESS_HEADER_SIZE + 4 * i);
+        offsets[i + 1] = offsets[i] + (sliceSizes[i] & ~STORED_FLAG);
+    }
+    if (offsets[slices] > size) {
+        return false;
+    }
+
+    bool sliceOk[LOSSLESS_MAX_SLICES];
+    const std::function<void(int)> job = [&](int slice) {
+        const int y0 = sliceRow(height, slice, slices);
+        const int y1 = sliceRow(height, slice + 1, slices);
+        const uint8_t* payload = data + offsets[slice];
+        const size_t bytes = offsets[slice + 1] - offsets[slice];
+
+        if (sliceSizes[slice] & STORED_FLAG) {
+            sliceOk[slice] = bytes == static_cast<size_t>(rowBytes) * (y1 - y0);
+            if (!sliceOk[slice]) return;
+            for (int y = y0; y < y1; y++) {
+                std::memcpy(dst + static_cast<size_t>(y) * dstStride,
+                            payload + static_cast<size_t>(y - y0) * rowBytes, rowBytes);
+            }
+            return;
+        }
+        sliceOk[slice] = decodeSlice(payload, bytes, dst, dstStride, rowBytes, y0, y1);
+    };
+    runSlices(slices, job);
+
+    return std::all_of(sliceOk, sliceOk + slices, [](bool ok) { return ok; });
+}
+
+void LosslessCodec::runSlices(int count, const std::function<void(int)>& job) {
+    const int stride = threads_;
+    if (count <= 1 || workers_.empty()) {
+        for (int i = 0; i < count; i++) job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        sliceCount_ = count;
+        pending_ = std::min(count, stride) - 1;
+        generation_++;
+    }
+    workCv_.notify_all();
+
+    // More slices than threads: each thread takes every stride-th slice
+    for (int i = 0; i < count; i += stride) job(i);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [this] { return pending_ == 0; });
+    job_ = nullptr;
+}
+
+void LosslessCodec::workerLoop(int index) {
+    const int stride = threads_;
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        workCv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+        if (stopping_) return;
+        seen = generation_;
+        if (index >= sliceCount_) continue;
+
+        const std::function<void(int)>* job = job_;
+        const int count = sliceCount_;
+        lock.unlock();
+        for (int i = index; i < count; i += stride) (*job)(i);
+        lock.lock();
+        if (--pending_ == 0) doneCv_.notify_one();
+    }
+}
+
+} // namespace ndi_bridge
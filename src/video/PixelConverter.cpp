@@ -0,0 +1,1106 @@
+#include "video/PixelConverter.h"
+#include "common/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PIXCONV_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+// GCC/Clang: compile individual kernels for a newer ISA than the baseline,
+// selected at runtime. MSVC accepts the intrinsics without a target flag.
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXCONV_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PIXCONV_TARGET(isa)
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define PIXCONV_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace ndi_bridge {
+
+namespace {
+
+constexpr int MAX_AUTO_THREADS = 8;
+
+// ============================================================================
+// BT.709 RGB → YCbCr coefficients
+//
+// Fixed point, chosen so that every kernel computes exactly the same thing:
+//   term = (value * 128 * coef + 0x4000) >> 15      (pmulhrsw / vqrdmulh)
+//   out  = clamp((sat16(sum(terms) + bias)) >> 7, 0, 255)
+// value is a pixel (luma) or the sum of a 2x2 block / 4 (chroma, computed
+// exactly as sum << 5).
+// ============================================================================
+
+struct Coefficients {
+    int16_t yR, yG, yB;
+    int16_t uR, uG, uB;
+    int16_t vR, vG, vB;
+    int16_t yBias;          // (offset << 7) + rounding
+    int16_t cBias;          // (128 << 7) + rounding
+};
+
+int16_t q15(double v) {
+    return static_cast<int16_t>(std::lround(v * 32768.0));
+}
+
+Coefficients makeCoefficients(bool fullRange) {
+    const double kr = 0.2126, kb = 0.0722, kg = 1.0 - kr - kb;
+    const double ys = fullRange ? 1.0 : 219.0 / 255.0;
+    const double cs = fullRange ? 1.0 : 224.0 / 255.0;
+
+    Coefficients c;
+    c.yR = q15(kr * ys);
+    c.yG = q15(kg * ys);
+    c.yB = q15(kb * ys);
+    c.uR = q15(-kr / (2.0 * (1.0 - kb)) * cs);
+    c.uG = q15(-kg / (2.0 * (1.0 - kb)) * cs);
+    c.uB = q15(0.5 * cs);
+    c.vR = q15(0.5 * cs);
+    c.vG = q15(-kg / (2.0 * (1.0 - kr)) * cs);
+    c.vB = q15(-kb / (2.0 * (1.0 - kr)) * cs);
+    c.yBias = static_cast<int16_t>(((fullRange ? 0 : 16) << 7) + 64);
+    c.cBias = static_cast<int16_t>((128 << 7) + 64);
+    return c;
+}
+
+// Row-pair kernels: two source rows → two luma rows + one chroma row
+using UyvyToI420Fn = void (*)(const uint8_t* s0, const uint8_t* s1,
+                              uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width);
+using UyvyToNV12Fn = void (*)(const uint8_t* s0, const uint8_t* s1,
+                              uint8_t* y0, uint8_t* y1, uint8_t* uv, int width);
+using BgraToI420Fn = void (*)(const uint8_t* s0, const uint8_t* s1,
+                              uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width,
+                              const Coefficients& c);
+
+// Single-row kernels (4:2:2 has one chroma row per luma row)
+using UyvyToI422Fn = void (*)(const uint8_t* s, uint8_t* y, uint8_t* u, uint8_t* v, int width);
+using I422ToUyvyFn = void (*)(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                              uint8_t* d, int width);
+// 4:2:0 → UYVY reuses these per output row, chroma row = luma row / 2
+using NV12ToUyvyFn = void (*)(const uint8_t* y, const uint8_t* uv, uint8_t* d, int width);
+
+struct KernelTable {
+    UyvyToI420Fn uyvyToI420;
+    UyvyToNV12Fn uyvyToNV12;
+    BgraToI420Fn bgraToI420;
+    UyvyToI422Fn uyvyToI422;
+    I422ToUyvyFn i422ToUyvy;
+    NV12ToUyvyFn nv12ToUyvy;
+};
+
+// ============================================================================
+// Scalar reference
+// ============================================================================
+
+inline uint8_t avgRound(uint8_t a, uint8_t b) {
+    return static_cast<uint8_t>((a + b + 1) >> 1);
+}
+
+inline int mulhrs(int a, int b) {
+    return (a * b + 0x4000) >> 15;
+}
+
+inline uint8_t packTerm(int sum, int bias) {
+    int v = std::clamp(sum + bias, -32768, 32767) >> 7;
+    return static_cast<uint8_t>(std::clamp(v, 0, 255));
+}
+
+inline uint8_t lumaScalar(const uint8_t* p, const Coefficients& c) {
+    return packTerm(mulhrs(p[2] << 7, c.yR) + mulhrs(p[1] << 7, c.yG) +
+                    mulhrs(p[0] << 7, c.yB), c.yBias);
+}
+
+void uyvyToI420Scalar(const uint8_t* s0, const uint8_t* s1,
+                      uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width) {
+    for (int x = 0; x + 1 < width; x += 2) {
+        const uint8_t* a = s0 + x * 2;
+        const uint8_t* b = s1 + x * 2;
+        y0[x] = a[1];
+        y0[x + 1] = a[3];
+        y1[x] = b[1];
+        y1[x + 1] = b[3];
+        u[x / 2] = avgRound(a[0], b[0]);
+        v[x / 2] = avgRound(a[2], b[2]);
+    }
+}
+
+void uyvyToNV12Scalar(const uint8_t* s0, const uint8_t* s1,
+                      uint8_t* y0, uint8_t* y1, uint8_t* uv, int width) {
+    for (int x = 0; x + 1 < width; x += 2) {
+        const uint8_t* a = s0 + x * 2;
+        const uint8_t* b = s1 + x * 2;
+        y0[x] = a[1];
+        y0[x + 1] = a[3];
+        y1[x] = b[1];
+        y1[x + 1] = b[3];
+        uv[x] = avgRound(a[0], b[0]);
+        uv[x + 1] = avgRound(a[2], b[2]);
+    }
+}
+
+void bgraToI420Scalar(const uint8_t* s0, const uint8_t* s1,
+                      uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width,
+                      const Coefficients& c) {
+    for (int x = 0; x < width; x += 2) {
+        const bool pair = x + 1 < width;
+        const uint8_t* p00 = s0 + x * 4;
+        const uint8_t* p10 = s1 + x * 4;
+        const uint8_t* p01 = pair ? p00 + 4 : p00;   // Odd width: repeat last column
+        const uint8_t* p11 = pair ? p10 + 4 : p10;
+
+        y0[x] = lumaScalar(p00, c);
+        y1[x] = lumaScalar(p10, c);
+        if (pair) {
+            y0[x + 1] = lumaScalar(p01, c);
+            y1[x + 1] = lumaScalar(p11, c);
+        }
+
+        const int b = (p00[0] + p01[0] + p10[0] + p11[0]) << 5;
+        const int g = (p00[1] + p01[1] + p10[1] + p11[1]) << 5;
+        const int r = (p00[2] + p01[2] + p10[2] + p11[2]) << 5;
+        u[x / 2] = packTerm(mulhrs(r, c.uR) + mulhrs(g, c.uG) + mulhrs(b, c.uB), c.cBias);
+        v[x / 2] = packTerm(mulhrs(r, c.vR) + mulhrs(g, c.vG) + mulhrs(b, c.vB), c.cBias);
+    }
+}
+
+void uyvyToI422Scalar(const uint8_t* s, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    for (int x = 0; x + 1 < width; x += 2) {
+        const uint8_t* p = s + x * 2;
+        y[x] = p[1];
+        y[x + 1] = p[3];
+        u[x / 2] = p[0];
+        v[x / 2] = p[2];
+    }
+}
+
+void i422ToUyvyScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                      uint8_t* d, int width) {
+    for (int x = 0; x + 1 < width; x += 2) {
+        uint8_t* p = d + x * 2;
+        p[0] = u[x / 2];
+        p[1] = y[x];
+        p[2] = v[x / 2];
+        p[3] = y[x + 1];
+    }
+}
+
+void nv12ToUyvyScalar(const uint8_t* y, const uint8_t* uv, uint8_t* d, int width) {
+    for (int x = 0; x + 1 < width; x += 2) {
+        uint8_t* p = d + x * 2;
+        p[0] = uv[x];
+        p[1] = y[x];
+        p[2] = uv[x + 1];
+        p[3] = y[x + 1];
+    }
+}
+
+#ifdef PIXCONV_X86
+
+// ============================================================================
+// SSE4.1 (16 UYVY / 8 BGRA pixels per iteration)
+// ============================================================================
+
+PIXCONV_TARGET("sse4.1")
+void uyvyToI420SSE41(const uint8_t* s0, const uint8_t* s1,
+                     uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width) {
+    const __m128i lo = _mm_set1_epi16(0x00FF);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s0 + x * 2));
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s0 + x * 2 + 16));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + x * 2));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + x * 2 + 16));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + x),
+                         _mm_packus_epi16(_mm_srli_epi16(a0, 8), _mm_srli_epi16(b0, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + x),
+                         _mm_packus_epi16(_mm_srli_epi16(a1, 8), _mm_srli_epi16(b1, 8)));
+
+        // U0 V0 U1 V1 ... averaged over the row pair
+        __m128i uv = _mm_packus_epi16(_mm_and_si128(_mm_avg_epu8(a0, a1), lo),
+                                      _mm_and_si128(_mm_avg_epu8(b0, b1), lo));
+        __m128i planar = _mm_packus_epi16(_mm_and_si128(uv, lo), _mm_srli_epi16(uv, 8));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2), planar);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2), _mm_srli_si128(planar, 8));
+    }
+    uyvyToI420Scalar(s0 + x * 2, s1 + x * 2, y0 + x, y1 + x, u + x / 2, v + x / 2, width - x);
+}
+
+PIXCONV_TARGET("sse4.1")
+void uyvyToNV12SSE41(const uint8_t* s0, const uint8_t* s1,
+                     uint8_t* y0, uint8_t* y1, uint8_t* uv, int width) {
+    const __m128i lo = _mm_set1_epi16(0x00FF);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s0 + x * 2));
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s0 + x * 2 + 16));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + x * 2));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + x * 2 + 16));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + x),
+                         _mm_packus_epi16(_mm_srli_epi16(a0, 8), _mm_srli_epi16(b0, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + x),
+                         _mm_packus_epi16(_mm_srli_epi16(a1, 8), _mm_srli_epi16(b1, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(uv + x),
+                         _mm_packus_epi16(_mm_and_si128(_mm_avg_epu8(a0, a1), lo),
+                                          _mm_and_si128(_mm_avg_epu8(b0, b1), lo)));
+    }
+    uyvyToNV12Scalar(s0 + x * 2, s1 + x * 2, y0 + x, y1 + x, uv + x, width - x);
+}
+
+PIXCONV_TARGET("sse4.1")
+void uyvyToI422SSE41(const uint8_t* s, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    const __m128i lo = _mm_set1_epi16(0x00FF);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x * 2));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + x * 2 + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y + x),
+                         _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+        __m128i uv = _mm_packus_epi16(_mm_and_si128(a, lo), _mm_and_si128(b, lo));
+        __m128i planar = _mm_packus_epi16(_mm_and_si128(uv, lo), _mm_srli_epi16(uv, 8));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2), planar);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2), _mm_srli_si128(planar, 8));
+    }
+    uyvyToI422Scalar(s + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+}
+
+PIXCONV_TARGET("sse4.1")
+void i422ToUyvySSE41(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                     uint8_t* d, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        __m128i uv = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2)),
+                                       _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x * 2), _mm_unpacklo_epi8(uv, l));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x * 2 + 16), _mm_unpackhi_epi8(uv, l));
+    }
+    i422ToUyvyScalar(y + x, u + x / 2, v + x / 2, d + x * 2, width - x);
+}
+
+PIXCONV_TARGET("sse4.1")
+void nv12ToUyvySSE41(const uint8_t* y, const uint8_t* uv, uint8_t* d, int width) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x * 2), _mm_unpacklo_epi8(c, l));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x * 2 + 16), _mm_unpackhi_epi8(c, l));
+    }
+    nv12ToUyvyScalar(y + x, uv + x, d + x * 2, width - x);
+}
+
+// 8 BGRA pixels → B, G, R as 8 x int16
+PIXCONV_TARGET("sse4.1")
+inline void loadBgr8(const uint8_t* p, __m128i& b, __m128i& g, __m128i& r) {
+    const __m128i shuf = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    __m128i t0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), shuf);
+    __m128i t1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), shuf);
+    __m128i bg = _mm_unpacklo_epi32(t0, t1);    // B0-3 B4-7 G0-3 G4-7
+    __m128i ra = _mm_unpackhi_epi32(t0, t1);    // R0-3 R4-7 A0-3 A4-7
+    b = _mm_cvtepu8_epi16(bg);
+    g = _mm_cvtepu8_epi16(_mm_srli_si128(bg, 8));
+    r = _mm_cvtepu8_epi16(ra);
+}
+
+// Weighted sum of (value << 7) planes + bias, >> 7 (8 x int16)
+PIXCONV_TARGET("sse4.1")
+inline __m128i weigh8(__m128i r, __m128i g, __m128i b,
+                      int16_t cr, int16_t cg, int16_t cb, int16_t bias) {
+    __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_mulhrs_epi16(r, _mm_set1_epi16(cr)),
+                                              _mm_mulhrs_epi16(g, _mm_set1_epi16(cg))),
+                                _mm_mulhrs_epi16(b, _mm_set1_epi16(cb)));
+    return _mm_srai_epi16(_mm_adds_epi16(sum, _mm_set1_epi16(bias)), 7);
+}
+
+PIXCONV_TARGET("sse4.1")
+void bgraToI420SSE41(const uint8_t* s0, const uint8_t* s1,
+                     uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width,
+                     const Coefficients& c) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m128i b0, g0, r0, b1, g1, r1;
+        loadBgr8(s0 + x * 4, b0, g0, r0);
+        loadBgr8(s1 + x * 4, b1, g1, r1);
+
+        __m128i l0 = weigh8(_mm_slli_epi16(r0, 7), _mm_slli_epi16(g0, 7), _mm_slli_epi16(b0, 7),
+                            c.yR, c.yG, c.yB, c.yBias);
+        __m128i l1 = weigh8(_mm_slli_epi16(r1, 7), _mm_slli_epi16(g1, 7), _mm_slli_epi16(b1, 7),
+                            c.yR, c.yG, c.yB, c.yBias);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(y0 + x), _mm_packus_epi16(l0, l0));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(y1 + x), _mm_packus_epi16(l1, l1));
+
+        // 2x2 block sums: rows added, then horizontal pairs (lanes 0-3 valid)
+        __m128i sb = _mm_add_epi16(b0, b1);
+        __m128i sg = _mm_add_epi16(g0, g1);
+        __m128i sr = _mm_add_epi16(r0, r1);
+        sb = _mm_slli_epi16(_mm_hadd_epi16(sb, sb), 5);
+        sg = _mm_slli_epi16(_mm_hadd_epi16(sg, sg), 5);
+        sr = _mm_slli_epi16(_mm_hadd_epi16(sr, sr), 5);
+
+        __m128i cu = weigh8(sr, sg, sb, c.uR, c.uG, c.uB, c.cBias);
+        __m128i cv = weigh8(sr, sg, sb, c.vR, c.vG, c.vB, c.cBias);
+        __m128i packed = _mm_packus_epi16(cu, cv);  // U0-3 (dup) V0-3 (dup)
+        int32_t u4 = _mm_cvtsi128_si32(packed);
+        int32_t v4 = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+        std::memcpy(u + x / 2, &u4, 4);
+        std::memcpy(v + x / 2, &v4, 4);
+    }
+    bgraToI420Scalar(s0 + x * 4, s1 + x * 4, y0 + x, y1 + x, u + x / 2, v + x / 2, width - x, c);
+}
+
+// ============================================================================
+// AVX2 (32 UYVY / 16 BGRA pixels per iteration)
+//
+// 256-bit pack instructions work per 128-bit lane; permute4x64(0xD8) puts
+// the quadwords back in order.
+// ============================================================================
+
+PIXCONV_TARGET("avx2")
+void uyvyToI420AVX2(const uint8_t* s0, const uint8_t* s1,
+                    uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width) {
+    const __m256i lo = _mm256_set1_epi16(0x00FF);
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s0 + x * 2));
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s0 + x * 2 + 32));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1 + x * 2));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1 + x * 2 + 32));
+
+        __m256i l0 = _mm256_packus_epi16(_mm256_srli_epi16(a0, 8), _mm256_srli_epi16(b0, 8));
+        __m256i l1 = _mm256_packus_epi16(_mm256_srli_epi16(a1, 8), _mm256_srli_epi16(b1, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y0 + x), _mm256_permute4x64_epi64(l0, 0xD8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y1 + x), _mm256_permute4x64_epi64(l1, 0xD8));
+
+        __m256i uv = _mm256_packus_epi16(_mm256_and_si256(_mm256_avg_epu8(a0, a1), lo),
+                                         _mm256_and_si256(_mm256_avg_epu8(b0, b1), lo));
+        uv = _mm256_permute4x64_epi64(uv, 0xD8);
+        __m256i planar = _mm256_packus_epi16(_mm256_and_si256(uv, lo), _mm256_srli_epi16(uv, 8));
+        planar = _mm256_permute4x64_epi64(planar, 0xD8);    // U0-15 | V0-15
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(u + x / 2), _mm256_castsi256_si128(planar));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(v + x / 2), _mm256_extracti128_si256(planar, 1));
+    }
+    uyvyToI420SSE41(s0 + x * 2, s1 + x * 2, y0 + x, y1 + x, u + x / 2, v + x / 2, width - x);
+}
+
+PIXCONV_TARGET("avx2")
+void uyvyToNV12AVX2(const uint8_t* s0, const uint8_t* s1,
+                    uint8_t* y0, uint8_t* y1, uint8_t* uv, int width) {
+    const __m256i lo = _mm256_set1_epi16(0x00FF);
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s0 + x * 2));
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s0 + x * 2 + 32));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1 + x * 2));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1 + x * 2 + 32));
+
+        __m256i l0 = _mm256_packus_epi16(_mm256_srli_epi16(a0, 8), _mm256_srli_epi16(b0, 8));
+        __m256i l1 = _mm256_packus_epi16(_mm256_srli_epi16(a1, 8), _mm256_srli_epi16(b1, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y0 + x), _mm256_permute4x64_epi64(l0, 0xD8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y1 + x), _mm256_permute4x64_epi64(l1, 0xD8));
+
+        __m256i c = _mm256_packus_epi16(_mm256_and_si256(_mm256_avg_epu8(a0, a1), lo),
+                                        _mm256_and_si256(_mm256_avg_epu8(b0, b1), lo));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(uv + x), _mm256_permute4x64_epi64(c, 0xD8));
+    }
+    uyvyToNV12SSE41(s0 + x * 2, s1 + x * 2, y0 + x, y1 + x, uv + x, width - x);
+}
+
+PIXCONV_TARGET("avx2")
+void uyvyToI422AVX2(const uint8_t* s, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    const __m256i lo = _mm256_set1_epi16(0x00FF);
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + x * 2));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + x * 2 + 32));
+        __m256i l = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y + x), _mm256_permute4x64_epi64(l, 0xD8));
+
+        __m256i uv = _mm256_packus_epi16(_mm256_and_si256(a, lo), _mm256_and_si256(b, lo));
+        uv = _mm256_permute4x64_epi64(uv, 0xD8);
+        __m256i planar = _mm256_packus_epi16(_mm256_and_si256(uv, lo), _mm256_srli_epi16(uv, 8));
+        planar = _mm256_permute4x64_epi64(planar, 0xD8);    // U0-15 | V0-15
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(u + x / 2), _mm256_castsi256_si128(planar));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(v + x / 2), _mm256_extracti128_si256(planar, 1));
+    }
+    uyvyToI422SSE41(s + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+}
+
+PIXCONV_TARGET("avx2")
+void i422ToUyvyAVX2(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                    uint8_t* d, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + x));
+        __m128i u16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x / 2));
+        __m128i v16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + x / 2));
+        // Chroma for pixels 0-15 | 16-31, matching the luma lanes
+        __m256i uv = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi8(u16, v16)),
+                                             _mm_unpackhi_epi8(u16, v16), 1);
+        __m256i o0 = _mm256_unpacklo_epi8(uv, l);      // px 0-7  | px 16-23
+        __m256i o1 = _mm256_unpackhi_epi8(uv, l);      // px 8-15 | px 24-31
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x * 2),
+                            _mm256_permute2x128_si256(o0, o1, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x * 2 + 32),
+                            _mm256_permute2x128_si256(o0, o1, 0x31));
+    }
+    i422ToUyvySSE41(y + x, u + x / 2, v + x / 2, d + x * 2, width - x);
+}
+
+PIXCONV_TARGET("avx2")
+void nv12ToUyvyAVX2(const uint8_t* y, const uint8_t* uv, uint8_t* d, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        // UV pairs and luma share lanes (pixels 0-15 | 16-31), no cross-lane fixup on load
+        __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + x));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv + x));
+        __m256i o0 = _mm256_unpacklo_epi8(c, l);       // px 0-7  | px 16-23
+        __m256i o1 = _mm256_unpackhi_epi8(c, l);       // px 8-15 | px 24-31
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x * 2),
+                            _mm256_permute2x128_si256(o0, o1, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + x * 2 + 32),
+                            _mm256_permute2x128_si256(o0, o1, 0x31));
+    }
+    nv12ToUyvySSE41(y + x, uv + x, d + x * 2, width - x);
+}
+
+// 16 BGRA pixels → B, G, R as 16 x int16
+PIXCONV_TARGET("avx2")
+inline void loadBgr16(const uint8_t* p, __m256i& b, __m256i& g, __m256i& r) {
+    const __m256i shuf = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                                          0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    __m256i t0 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), shuf);
+    __m256i t1 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), shuf);
+    t0 = _mm256_permutevar8x32_epi32(t0, perm);     // B0-7 G0-7 R0-7 A0-7
+    t1 = _mm256_permutevar8x32_epi32(t1, perm);     // B8-15 G8-15 R8-15 A8-15
+    __m256i br = _mm256_unpacklo_epi64(t0, t1);     // B0-15 | R0-15
+    __m256i ga = _mm256_unpackhi_epi64(t0, t1);     // G0-15 | A0-15
+    b = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(br));
+    r = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(br, 1));
+    g = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(ga));
+}
+
+PIXCONV_TARGET("avx2")
+inline __m256i weigh16(__m256i r, __m256i g, __m256i b,
+                       int16_t cr, int16_t cg, int16_t cb, int16_t bias) {
+    __m256i sum = _mm256_add_epi16(_mm256_add_epi16(_mm256_mulhrs_epi16(r, _mm256_set1_epi16(cr)),
+                                                    _mm256_mulhrs_epi16(g, _mm256_set1_epi16(cg))),
+                                   _mm256_mulhrs_epi16(b, _mm256_set1_epi16(cb)));
+    return _mm256_srai_epi16(_mm256_adds_epi16(sum, _mm256_set1_epi16(bias)), 7);
+}
+
+PIXCONV_TARGET("avx2")
+void bgraToI420AVX2(const uint8_t* s0, const uint8_t* s1,
+                    uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width,
+                    const Coefficients& c) {
+    const __m256i chromaPerm = _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7);
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m256i b0, g0, r0, b1, g1, r1;
+        loadBgr16(s0 + x * 4, b0, g0, r0);
+        loadBgr16(s1 + x * 4, b1, g1, r1);
+
+        __m256i l0 = weigh16(_mm256_slli_epi16(r0, 7), _mm256_slli_epi16(g0, 7),
+                             _mm256_slli_epi16(b0, 7), c.yR, c.yG, c.yB, c.yBias);
+        __m256i l1 = weigh16(_mm256_slli_epi16(r1, 7), _mm256_slli_epi16(g1, 7),
+                             _mm256_slli_epi16(b1, 7), c.yR, c.yG, c.yB, c.yBias);
+        l0 = _mm256_permute4x64_epi64(_mm256_packus_epi16(l0, l0), 0xD8);
+        l1 = _mm256_permute4x64_epi64(_mm256_packus_epi16(l1, l1), 0xD8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + x), _mm256_castsi256_si128(l0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + x), _mm256_castsi256_si128(l1));
+
+        // 2x2 block sums: elements 0-3 of each lane are valid
+        __m256i sb = _mm256_add_epi16(b0, b1);
+        __m256i sg = _mm256_add_epi16(g0, g1);
+        __m256i sr = _mm256_add_epi16(r0, r1);
+        sb = _mm256_slli_epi16(_mm256_hadd_epi16(sb, sb), 5);
+        sg = _mm256_slli_epi16(_mm256_hadd_epi16(sg, sg), 5);
+        sr = _mm256_slli_epi16(_mm256_hadd_epi16(sr, sr), 5);
+
+        __m256i cu = weigh16(sr, sg, sb, c.uR, c.uG, c.uB, c.cBias);
+        __m256i cv = weigh16(sr, sg, sb, c.vR, c.vG, c.vB, c.cBias);
+        __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(cu, cv), chromaPerm);
+        __m128i uv = _mm256_castsi256_si128(packed);   // U0-7 | V0-7
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2), uv);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2), _mm_srli_si128(uv, 8));
+    }
+    bgraToI420SSE41(s0 + x * 4, s1 + x * 4, y0 + x, y1 + x, u + x / 2, v + x / 2, width - x, c);
+}
+
+bool cpuSupports(ConvertKernel kernel) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (kernel == ConvertKernel::SSE41) return __builtin_cpu_supports("sse4.1");
+    if (kernel == ConvertKernel::AVX2) return __builtin_cpu_supports("avx2");
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (kernel == ConvertKernel::SSE41) return sse41;
+    if (kernel != ConvertKernel::AVX2 || !osxsave || !avx) return false;
+    if ((_xgetbv(0) & 6) != 6) return false;   // OS saves YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    (void)kernel;
+    return false;
+#endif
+}
+
+#endif // PIXCONV_X86
+
+#ifdef PIXCONV_NEON
+
+// ============================================================================
+// NEON (32 UYVY / 16 BGRA pixels per iteration)
+//
+// vld4 de-interleaves UYVY/BGRA for free; vqrdmulh is the pmulhrsw
+// equivalent, so results match the scalar reference bit for bit.
+// ============================================================================
+
+void uyvyToI420NEON(const uint8_t* s0, const uint8_t* s1,
+                    uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        uint8x16x4_t a = vld4q_u8(s0 + x * 2);     // U, Y even, V, Y odd
+        uint8x16x4_t b = vld4q_u8(s1 + x * 2);
+        uint8x16x2_t l0 = {{a.val[1], a.val[3]}};
+        uint8x16x2_t l1 = {{b.val[1], b.val[3]}};
+        vst2q_u8(y0 + x, l0);
+        vst2q_u8(y1 + x, l1);
+        vst1q_u8(u + x / 2, vrhaddq_u8(a.val[0], b.val[0]));
+        vst1q_u8(v + x / 2, vrhaddq_u8(a.val[2], b.val[2]));
+    }
+    uyvyToI420Scalar(s0 + x * 2, s1 + x * 2, y0 + x, y1 + x, u + x / 2, v + x / 2, width - x);
+}
+
+void uyvyToNV12NEON(const uint8_t* s0, const uint8_t* s1,
+                    uint8_t* y0, uint8_t* y1, uint8_t* uv, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        uint8x16x4_t a = vld4q_u8(s0 + x * 2);
+        uint8x16x4_t b = vld4q_u8(s1 + x * 2);
+        uint8x16x2_t l0 = {{a.val[1], a.val[3]}};
+        uint8x16x2_t l1 = {{b.val[1], b.val[3]}};
+        uint8x16x2_t c = {{vrhaddq_u8(a.val[0], b.val[0]), vrhaddq_u8(a.val[2], b.val[2])}};
+        vst2q_u8(y0 + x, l0);
+        vst2q_u8(y1 + x, l1);
+        vst2q_u8(uv + x, c);
+    }
+    uyvyToNV12Scalar(s0 + x * 2, s1 + x * 2, y0 + x, y1 + x, uv + x, width - x);
+}
+
+void uyvyToI422NEON(const uint8_t* s, uint8_t* y, uint8_t* u, uint8_t* v, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        uint8x16x4_t p = vld4q_u8(s + x * 2);
+        uint8x16x2_t l = {{p.val[1], p.val[3]}};
+        vst2q_u8(y + x, l);
+        vst1q_u8(u + x / 2, p.val[0]);
+        vst1q_u8(v + x / 2, p.val[2]);
+    }
+    uyvyToI422Scalar(s + x * 2, y + x, u + x / 2, v + x / 2, width - x);
+}
+
+void i422ToUyvyNEON(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                    uint8_t* d, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        uint8x16x2_t l = vld2q_u8(y + x);          // Y even, Y odd
+        uint8x16x4_t p = {{vld1q_u8(u + x / 2), l.val[0], vld1q_u8(v + x / 2), l.val[1]}};
+        vst4q_u8(d + x * 2, p);
+    }
+    i422ToUyvyScalar(y + x, u + x / 2, v + x / 2, d + x * 2, width - x);
+}
+
+void nv12ToUyvyNEON(const uint8_t* y, const uint8_t* uv, uint8_t* d, int width) {
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        uint8x16x2_t l = vld2q_u8(y + x);          // Y even, Y odd
+        uint8x16x2_t c = vld2q_u8(uv + x);         // U, V
+        uint8x16x4_t p = {{c.val[0], l.val[0], c.val[1], l.val[1]}};
+        vst4q_u8(d + x * 2, p);
+    }
+    nv12ToUyvyScalar(y + x, uv + x, d + x * 2, width - x);
+}
+
+inline int16x8_t weigh8(int16x8_t r, int16x8_t g, int16x8_t b,
+                        int16_t cr, int16_t cg, int16_t cb, int16_t bias) {
+    int16x8_t sum = vaddq_s16(vaddq_s16(vqrdmulhq_n_s16(r, cr), vqrdmulhq_n_s16(g, cg)),
+                              vqrdmulhq_n_s16(b, cb));
+    return vshrq_n_s16(vqaddq_s16(sum, vdupq_n_s16(bias)), 7);
+}
+
+inline uint8x8_t luma8(uint8x8_t r, uint8x8_t g, uint8x8_t b, const Coefficients& c) {
+    int16x8_t y = weigh8(vreinterpretq_s16_u16(vshll_n_u8(r, 7)),
+                         vreinterpretq_s16_u16(vshll_n_u8(g, 7)),
+                         vreinterpretq_s16_u16(vshll_n_u8(b, 7)),
+                         c.yR, c.yG, c.yB, c.yBias);
+    return vqmovun_s16(y);
+}
+
+void bgraToI420NEON(const uint8_t* s0, const uint8_t* s1,
+                    uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width,
+                    const Coefficients& c) {
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t p0 = vld4q_u8(s0 + x * 4);    // B, G, R, A
+        uint8x16x4_t p1 = vld4q_u8(s1 + x * 4);
+
+        vst1q_u8(y0 + x, vcombine_u8(
+            luma8(vget_low_u8(p0.val[2]), vget_low_u8(p0.val[1]), vget_low_u8(p0.val[0]), c),
+            luma8(vget_high_u8(p0.val[2]), vget_high_u8(p0.val[1]), vget_high_u8(p0.val[0]), c)));
+        vst1q_u8(y1 + x, vcombine_u8(
+            luma8(vget_low_u8(p1.val[2]), vget_low_u8(p1.val[1]), vget_low_u8(p1.val[0]), c),
+            luma8(vget_high_u8(p1.val[2]), vget_high_u8(p1.val[1]), vget_high_u8(p1.val[0]), c)));
+
+        // 2x2 block sums (pairwise add row 0, accumulate pairwise row 1)
+        int16x8_t sb = vreinterpretq_s16_u16(vshlq_n_u16(
+            vpadalq_u8(vpaddlq_u8(p0.val[0]), p1.val[0]), 5));
+        int16x8_t sg = vreinterpretq_s16_u16(vshlq_n_u16(
+            vpadalq_u8(vpaddlq_u8(p0.val[1]), p1.val[1]), 5));
+        int16x8_t sr = vreinterpretq_s16_u16(vshlq_n_u16(
+            vpadalq_u8(vpaddlq_u8(p0.val[2]), p1.val[2]), 5));
+        vst1_u8(u + x / 2, vqmovun_s16(weigh8(sr, sg, sb, c.uR, c.uG, c.uB, c.cBias)));
+        vst1_u8(v + x / 2, vqmovun_s16(weigh8(sr, sg, sb, c.vR, c.vG, c.vB, c.cBias)));
+    }
+    bgraToI420Scalar(s0 + x * 4, s1 + x * 4, y0 + x, y1 + x, u + x / 2, v + x / 2, width - x, c);
+}
+
+#endif // PIXCONV_NEON
+
+KernelTable kernelTable(ConvertKernel kernel) {
+    switch (kernel) {
+#ifdef PIXCONV_X86
+        case ConvertKernel::SSE41:
+            return {uyvyToI420SSE41, uyvyToNV12SSE41, bgraToI420SSE41,
+                    uyvyToI422SSE41, i422ToUyvySSE41, nv12ToUyvySSE41};
+        case ConvertKernel::AVX2:
+            return {uyvyToI420AVX2, uyvyToNV12AVX2, bgraToI420AVX2,
+                    uyvyToI422AVX2, i422ToUyvyAVX2, nv12ToUyvyAVX2};
+#endif
+#ifdef PIXCONV_NEON
+        case ConvertKernel::NEON:
+            return {uyvyToI420NEON, uyvyToNV12NEON, bgraToI420NEON,
+                    uyvyToI422NEON, i422ToUyvyNEON, nv12ToUyvyNEON};
+#endif
+        default:
+            return {uyvyToI420Scalar, uyvyToNV12Scalar, bgraToI420Scalar,
+                    uyvyToI422Scalar, i422ToUyvyScalar, nv12ToUyvyScalar};
+    }
+}
+
+// ============================================================================
+// Resize (simulcast renditions)
+//
+// Plain C++, left to the auto-vectoriser: the cost is a fraction of the
+// colour conversion because only the smaller output is written. Each plane
+// is resized on its own; NV12 chroma is two interleaved channels.
+// ============================================================================
+
+// Per output sample along one axis
+struct ScaleAxis {
+    std::vector<int> first;     // Area: first source sample; bilinear: near tap
+    std::vector<int> last;      // Area: one past the last sample; bilinear: far tap
+    std::vector<int> weight;    // Bilinear: weight of the far tap (0..256)
+};
+
+// Every source sample [i * src / dst, (i + 1) * src / dst) belongs to output i
+ScaleAxis areaAxis(int src, int dst) {
+    ScaleAxis a;
+    a.first.resize(dst);
+    a.last.resize(dst);
+    for (int i = 0; i < dst; i++) {
+        a.first[i] = static_cast<int>(static_cast<int64_t>(i) * src / dst);
+        a.last[i] = std::max(a.first[i] + 1,
+                             static_cast<int>(static_cast<int64_t>(i + 1) * src / dst));
+    }
+    return a;
+}
+
+// Sample centres aligned: position = (i + 0.5) * src / dst - 0.5, in 1/256
+ScaleAxis bilinearAxis(int src, int dst) {
+    ScaleAxis a;
+    a.first.resize(dst);
+    a.last.resize(dst);
+    a.weight.resize(dst);
+    const int64_t maxPos = static_cast<int64_t>(src - 1) * 256;
+    for (int i = 0; i < dst; i++) {
+        int64_t pos = (static_cast<int64_t>(2 * i + 1) * src * 256) / (2 * static_cast<int64_t>(dst)) - 128;
+        pos = std::clamp<int64_t>(pos, 0, maxPos);
+        a.first[i] = static_cast<int>(pos >> 8);
+        a.weight[i] = static_cast<int>(pos & 255);
+        a.last[i] = std::min(a.first[i] + 1, src - 1);
+    }
+    return a;
+}
+
+struct ScalePlane {
+    const uint8_t* src;
+    int srcStride;
+    uint8_t* dst;
+    int dstStride;
+    int srcWidth, srcHeight;    // In samples (NV12 chroma: UV pairs)
+    int dstWidth, dstHeight;
+    int channels;               // 1, or 2 for interleaved UV
+    bool area;
+    ScaleAxis x, y;
+};
+
+// Vertical pass into a row of column sums (contiguous, vectorises), then the
+// horizontal pass reads that row. Same integer result as a 2D loop.
+template <int Channels>
+void scaleRowsArea(const ScalePlane& p, int firstRow, int lastRow) {
+    const int rowSamples = p.srcWidth * Channels;
+    std::vector<uint16_t> columns(static_cast<size_t>(rowSamples));  // <= 257 rows of 255
+    for (int oy = firstRow; oy < lastRow; oy++) {
+        const int top = p.y.first[oy];
+        const int bottom = p.y.last[oy];
+        std::fill(columns.begin(), columns.end(), 0);
+        for (int sy = top; sy < bottom; sy++) {
+            const uint8_t* row = p.src + static_cast<ptrdiff_t>(sy) * p.srcStride;
+            for (int i = 0; i < rowSamples; i++) columns[i] += row[i];
+        }
+
+        uint8_t* out = p.dst + static_cast<ptrdiff_t>(oy) * p.dstStride;
+        for (int ox = 0; ox < p.dstWidth; ox++) {
+            const int left = p.x.first[ox] * Channels;
+            const int right = p.x.last[ox] * Channels;
+            const int count = (bottom - top) * (p.x.last[ox] - p.x.first[ox]);
+            for (int c = 0; c < Channels; c++) {
+                int sum = 0;
+                for (int sx = left + c; sx < right; sx += Channels) sum += columns[sx];
+                out[ox * Channels + c] = static_cast<uint8_t>((sum + count / 2) / count);
+            }
+        }
+    }
+}
+
+template <int Channels>
+void scaleRowsBilinear(const ScalePlane& p, int firstRow, int lastRow) {
+    const int rowSamples = p.srcWidth * Channels;
+    std::vector<uint16_t> blended(static_cast<size_t>(rowSamples));   // Row * 256
+    for (int oy = firstRow; oy < lastRow; oy++) {
+        const uint8_t* r0 = p.src + static_cast<ptrdiff_t>(p.y.first[oy]) * p.srcStride;
+        const uint8_t* r1 = p.src + static_cast<ptrdiff_t>(p.y.last[oy]) * p.srcStride;
+        const int wy = p.y.weight[oy];
+        for (int i = 0; i < rowSamples; i++) {
+            blended[i] = static_cast<uint16_t>(r0[i] * (256 - wy) + r1[i] * wy);
+        }
+
+        uint8_t* out = p.dst + static_cast<ptrdiff_t>(oy) * p.dstStride;
+        for (int ox = 0; ox < p.dstWidth; ox++) {
+            const int left = p.x.first[ox] * Channels;
+            const int right = p.x.last[ox] * Channels;
+            const int wx = p.x.weight[ox];
+            for (int c = 0; c < Channels; c++) {
+                out[ox * Channels + c] = static_cast<uint8_t>(
+                    (blended[left + c] * (256 - wx) + blended[right + c] * wx + 32768) >> 16);
+            }
+        }
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// PixelConverter
+// ============================================================================
+
+PixelConverter::PixelConverter(const PixelConverterConfig& config)
+    : config_(config)
+    , kernel_(bestKernel()) {
+    int threads = config_.threads;
+    if (threads <= 0) {
+        threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()),
+                             1, MAX_AUTO_THREADS);
+    }
+
+    for (int i = 1; i < threads; i++) {
+        workers_.emplace_back(&PixelConverter::workerLoop, this, i);
+    }
+
+    Logger::instance().debugf("PixelConverter: %s kernels, %d slice thread(s), %s range",
+                              kernelName(kernel_), threadCount(),
+                              config_.fullRange ? "full" : "limited");
+}
+
+PixelConverter::~PixelConverter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+bool PixelConverter::supports(PixelFormat srcFormat, PixelFormat dstFormat) {
+    if (srcFormat == PixelFormat::UYVY) {
+        return dstFormat == PixelFormat::I420 || dstFormat == PixelFormat::NV12 ||
+               dstFormat == PixelFormat::I422;
+    }
+    if (srcFormat == PixelFormat::BGRA) {
+        return dstFormat == PixelFormat::I420;
+    }
+    if (srcFormat == PixelFormat::I422 || srcFormat == PixelFormat::I420 ||
+        srcFormat == PixelFormat::NV12) {
+        return dstFormat == PixelFormat::UYVY;
+    }
+    return false;
+}
+
+bool PixelConverter::kernelAvailable(ConvertKernel kernel) {
+    switch (kernel) {
+        case ConvertKernel::Scalar:
+            return true;
+#ifdef PIXCONV_X86
+        case ConvertKernel::SSE41:
+        case ConvertKernel::AVX2:
+            return cpuSupports(kernel);
+#endif
+#ifdef PIXCONV_NEON
+        case ConvertKernel::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+ConvertKernel PixelConverter::bestKernel() {
+    static const ConvertKernel best = [] {
+        for (ConvertKernel k : {ConvertKernel::AVX2, ConvertKernel::NEON, ConvertKernel::SSE41}) {
+            if (kernelAvailable(k)) return k;
+        }
+        return ConvertKernel::Scalar;
+    }();
+    return best;
+}
+
+bool PixelConverter::setKernel(ConvertKernel kernel) {
+    if (!kernelAvailable(kernel)) return false;
+    kernel_ = kernel;
+    return true;
+}
+
+const char* PixelConverter::kernelName(ConvertKernel kernel) {
+    switch (kernel) {
+        case ConvertKernel::Scalar: return "scalar";
+        case ConvertKernel::SSE41: return "SSE4.1";
+        case ConvertKernel::AVX2: return "AVX2";
+        case ConvertKernel::NEON: return "NEON";
+    }
+    return "unknown";
+}
+
+bool PixelConverter::convert(PixelFormat srcFormat, const uint8_t* src, int srcStride,
+                             PixelFormat dstFormat, uint8_t* const dst[], const int dstStride[],
+                             int width, int height) {
+    const uint8_t* const planes[3] = {src, nullptr, nullptr};
+    const int strides[3] = {srcStride, 0, 0};
+    return convert(srcFormat, planes, strides, dstFormat, dst, dstStride, width, height);
+}
+
+bool PixelConverter::convert(PixelFormat srcFormat, const uint8_t* const src[], const int srcStride[],
+                             PixelFormat dstFormat, uint8_t* const dst[], const int dstStride[],
+                             int width, int height) {
+    if (!supports(srcFormat, dstFormat) || !src || !src[0] || !dst || width <= 0 || height <= 0) {
+        return false;
+    }
+    if (srcFormat != PixelFormat::BGRA && (width & 1)) {
+        return false;   // 4:2:2: two pixels per chroma sample
+    }
+    if (srcFormat != PixelFormat::UYVY && srcFormat != PixelFormat::BGRA &&
+        (!src[1] || (srcFormat != PixelFormat::NV12 && !src[2]))) {
+        return false;
+    }
+
+    const KernelTable table = kernelTable(kernel_);
+    const Coefficients coeffs = makeCoefficients(config_.fullRange);
+    const int pairs = (height + 1) / 2;
+    const int slices = std::min(threadCount(), pairs);
+
+    auto row = [](const uint8_t* base, int stride, int y) {
+        return base + static_cast<ptrdiff_t>(y) * stride;
+    };
+    auto rowOut = [](uint8_t* base, int stride, int y) {
+        return base + static_cast<ptrdiff_t>(y) * stride;
+    };
+
+    const std::function<void(int)> job = [&](int slice) {
+        const int first = pairs * slice / slices;
+        const int last = pairs * (slice + 1) / slices;
+        for (int pair = first; pair < last; pair++) {
+            const int row0 = pair * 2;
+            const int row1 = std::min(row0 + 1, height - 1);   // Odd height: repeat last row
+
+            // 4:2:2 ⇄ packed: one chroma row per luma row
+            if (dstFormat == PixelFormat::I422) {
+                for (int y = row0; y <= row1; y++) {
+                    table.uyvyToI422(row(src[0], srcStride[0], y), rowOut(dst[0], dstStride[0], y),
+                                     rowOut(dst[1], dstStride[1], y), rowOut(dst[2], dstStride[2], y),
+                                     width);
+                }
+                continue;
+            }
+            if (srcFormat == PixelFormat::I422) {
+                for (int y = row0; y <= row1; y++) {
+                    table.i422ToUyvy(row(src[0], srcStride[0], y), row(src[1], srcStride[1], y),
+                                     row(src[2], srcStride[2], y), rowOut(dst[0], dstStride[0], y),
+                                     width);
+                }
+                continue;
+            }
+            // 4:2:0 → packed: both rows of the pair share the chroma row
+            if (srcFormat == PixelFormat::I420) {
+                for (int y = row0; y <= row1; y++) {
+                    table.i422ToUyvy(row(src[0], srcStride[0], y), row(src[1], srcStride[1], pair),
+                                     row(src[2], srcStride[2], pair), rowOut(dst[0], dstStride[0], y),
+                                     width);
+                }
+                continue;
+            }
+            if (srcFormat == PixelFormat::NV12) {
+                for (int y = row0; y <= row1; y++) {
+                    table.nv12ToUyvy(row(src[0], srcStride[0], y), row(src[1], srcStride[1], pair),
+                                     rowOut(dst[0], dstStride[0], y), width);
+                }
+                continue;
+            }
+
+            const uint8_t* s0 = row(src[0], srcStride[0], row0);
+            const uint8_t* s1 = row(src[0], srcStride[0], row1);
+            uint8_t* y0 = rowOut(dst[0], dstStride[0], row0);
+            uint8_t* y1 = rowOut(dst[0], dstStride[0], row1);
+            uint8_t* c1 = rowOut(dst[1], dstStride[1], pair);
+
+            if (dstFormat == PixelFormat::NV12) {
+                table.uyvyToNV12(s0, s1, y0, y1, c1, width);
+                continue;
+            }
+
+            uint8_t* c2 = rowOut(dst[2], dstStride[2], pair);
+            if (srcFormat == PixelFormat::UYVY) {
+                table.uyvyToI420(s0, s1, y0, y1, c1, c2, width);
+            } else {
+                table.bgraToI420(s0, s1, y0, y1, c1, c2, width, coeffs);
+            }
+        }
+    };
+
+    runSlices(slices, job);
+    return true;
+}
+
+bool PixelConverter::supportsScale(PixelFormat format) {
+    return format == PixelFormat::I420 || format == PixelFormat::I422 ||
+           format == PixelFormat::NV12;
+}
+
+bool PixelConverter::scale(PixelFormat format, const uint8_t* const src[], const int srcStride[],
+                           int srcWidth, int srcHeight, uint8_t* const dst[], const int dstStride[],
+                           int dstWidth, int dstHeight) {
+    if (!supportsScale(format) || !src || !dst || srcWidth <= 0 || srcHeight <= 0 ||
+        dstWidth <= 0 || dstHeight <= 0) {
+        return false;
+    }
+
+    const int planeCount = format == PixelFormat::NV12 ? 2 : 3;
+    for (int i = 0; i < planeCount; i++) {
+        if (!src[i] || !dst[i]) return false;
+    }
+
+    ScalePlane planes[3];
+    for (int i = 0; i < planeCount; i++) {
+        ScalePlane& p = planes[i];
+        const bool chroma = i > 0;
+        const bool halfHeight = chroma && format != PixelFormat::I422;
+        p.src = src[i];
+        p.srcStride = srcStride[i];
+        p.dst = dst[i];
+        p.dstStride = dstStride[i];
+        p.srcWidth = chroma ? (srcWidth + 1) / 2 : srcWidth;
+        p.srcHeight = halfHeight ? (srcHeight + 1) / 2 : srcHeight;
+        p.dstWidth = chroma ? (dstWidth + 1) / 2 : dstWidth;
+        p.dstHeight = halfHeight ? (dstHeight + 1) / 2 : dstHeight;
+        p.channels = chroma && format == PixelFormat::NV12 ? 2 : 1;
+        p.area = p.srcWidth >= 2 * p.dstWidth && p.srcHeight >= 2 * p.dstHeight;
+        p.x = p.area ? areaAxis(p.srcWidth, p.dstWidth) : bilinearAxis(p.srcWidth, p.dstWidth);
+        p.y = p.area ? areaAxis(p.srcHeight, p.dstHeight) : bilinearAxis(p.srcHeight, p.dstHeight);
+    }
+
+    const int slices = std::min(threadCount(), dstHeight);
+    const std::function<void(int)> job = [&](int slice) {
+        for (int i = 0; i < planeCount; i++) {
+            const ScalePlane& p = planes[i];
+            const int first = p.dstHeight * slice / slices;
+            const int last = p.dstHeight * (slice + 1) / slices;
+            if (p.area) {
+                p.channels == 2 ? scaleRowsArea<2>(p, first, last) : scaleRowsArea<1>(p, first, last);
+            } else {
+                p.channels == 2 ? scaleRowsBilinear<2>(p, first, last)
+                                : scaleRowsBilinear<1>(p, first, last);
+            }
+        }
+    };
+
+    runSlices(slices, job);
+    return true;
+}
+
+void PixelConverter::runSlices(int count, const std::function<void(int)>& job) {
+    if (count <= 1 || workers_.empty()) {
+        for (int i = 0; i < count; i++) job(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        sliceCount_ = count;
+        pending_ = count - 1;
+        generation_++;
+    }
+    workCv_.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [this] { return pending_ == 0; });
+    job_ = nullptr;
+}
+
+void PixelConverter::workerLoop(int index) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        workCv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+        if (stopping_) return;
+        seen = generation_;
+        if (index >= sliceCount_) continue;
+
+        const std::function<void(int)>* job = job_;
+        lock.unlock();
+        (*job)(index);
+        lock.lock();
+        if (--pending_ == 0) doneCv_.notify_one();
+    }
+}
+
+} // namespace ndi_bridge
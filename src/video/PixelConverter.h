@@ -0,0 +1,141 @@
+#pragma once
+
+/**
+ * PixelConverter.h - SIMD colour conversion for the encode/decode paths
+ *
+ * Replaces sws_scale for the conversions we run on every frame:
+ *   UYVY → I420 / NV12   4:2:2 → 4:2:0, chroma = rounded average of a row pair
+ *   BGRA → I420          BT.709, full range (x264 fullrange=on) or limited
+ *   UYVY ⇄ I422          4:2:2 deinterleave / interleave (native 4:2:2 mode)
+ *   I420 / NV12 → UYVY   decoder output for NDI, chroma row repeated for the pair
+ *
+ * It also resizes planar YUV frames (simulcast renditions): area average
+ * when shrinking by 2x or more, bilinear otherwise.
+ *
+ * Kernels: scalar reference, SSE4.1 and AVX2 (x86, picked at runtime from
+ * CPUID) and NEON (ARM). Every SIMD kernel is bit-exact with the scalar one.
+ * Rows are split into slices (row pairs) and converted on a small worker
+ * pool owned by the converter. No FFmpeg dependency.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#include "PixelFormat.h"
+
+namespace ndi_bridge {
+
+/**
+ * Kernel implementations
+ */
+enum class ConvertKernel {
+    Scalar,
+    SSE41,
+    AVX2,
+    NEON
+};
+
+/**
+ * Converter configuration
+ */
+struct PixelConverterConfig {
+    int threads = 0;            // Slice threads (0 = hardware concurrency, max 8)
+    bool fullRange = true;      // BGRA → YUV range, must match the encoder VUI
+};
+
+/**
+ * PixelConverter - Multi-threaded SIMD pixel format conversion
+ *
+ * Destination planes follow the FFmpeg layout: dst[0] = Y, dst[1] = U
+ * (or interleaved UV for NV12), dst[2] = V. Odd heights repeat the last
+ * row for chroma; odd widths are allowed for BGRA only.
+ *
+ * convert() is not reentrant: one caller at a time (the encoder thread).
+ */
+class PixelConverter {
+public:
+    explicit PixelConverter(const PixelConverterConfig& config = PixelConverterConfig());
+    ~PixelConverter();
+
+    // Non-copyable
+    PixelConverter(const PixelConverter&) = delete;
+    PixelConverter& operator=(const PixelConverter&) = delete;
+
+    /**
+     * Check whether a conversion has a native kernel
+     */
+    static bool supports(PixelFormat srcFormat, PixelFormat dstFormat);
+
+    /**
+     * Convert one frame (planar source: src[0..2] as for dst)
+     * @return false if the conversion is unsupported or the geometry invalid
+     */
+    bool convert(PixelFormat srcFormat, const uint8_t* const src[], const int srcStride[],
+                 PixelFormat dstFormat, uint8_t* const dst[], const int dstStride[],
+                 int width, int height);
+
+    /**
+     * Convert one frame from a packed source (UYVY / BGRA)
+     */
+    bool convert(PixelFormat srcFormat, const uint8_t* src, int srcStride,
+                 PixelFormat dstFormat, uint8_t* const dst[], const int dstStride[],
+                 int width, int height);
+
+    /**
+     * Check whether scale() handles a format (I420 / I422 / NV12)
+     */
+    static bool supportsScale(PixelFormat format);
+
+    /**
+     * Resize one planar frame, same format on both sides
+     *
+     * Shrinking by 2x or more on both axes averages every source sample an
+     * output pixel covers; any other ratio interpolates bilinearly. Output
+     * rows are split across the slice threads (same one-caller rule as
+     * convert()).
+     * @return false if the format is unsupported or a geometry is invalid
+     */
+    bool scale(PixelFormat format, const uint8_t* const src[], const int srcStride[],
+               int srcWidth, int srcHeight, uint8_t* const dst[], const int dstStride[],
+               int dstWidth, int dstHeight);
+
+    /**
+     * Kernel selection (defaults to the best one this CPU supports)
+     */
+    ConvertKernel kernel() const { return kernel_; }
+    bool setKernel(ConvertKernel kernel);
+    static ConvertKernel bestKernel();
+    static bool kernelAvailable(ConvertKernel kernel);
+    static const char* kernelName(ConvertKernel kernel);
+
+    /**
+     * Number of slices a frame is split into (workers + calling thread)
+     */
+    int threadCount() const { return static_cast<int>(workers_.size()) + 1; }
+
+    const PixelConverterConfig& getConfig() const { return config_; }
+
+private:
+    void runSlices(int count, const std::function<void(int)>& job);
+    void workerLoop(int index);
+
+    PixelConverterConfig config_;
+    ConvertKernel kernel_;
+
+    // Slice worker pool (slice 0 runs on the calling thread)
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable doneCv_;
+    const std::function<void(int)>* job_ = nullptr;
+    int sliceCount_ = 0;
+    int pending_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace ndi_bridge
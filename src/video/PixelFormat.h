@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * PixelFormat.h - Raw video pixel formats
+ *
+ * Shared by VideoEncoder (FFmpeg) and PixelConverter (no FFmpeg).
+ */
+
+namespace ndi_bridge {
+
+/**
+ * Supported input pixel formats
+ */
+enum class PixelFormat {
+    BGRA,       // 32-bit BGRA (NDI default on some platforms)
+    UYVY,       // 16-bit packed YUV 4:2:2 (NDI native)
+    NV12,       // Planar YUV 4:2:0 (encoder native)
+    I420,       // Planar YUV 4:2:0 (alias YUV420P)
+    I422        // Planar YUV 4:2:2 (alias YUV422P, x264 High 4:2:2)
+};
+
+} // namespace ndi_bridge
@@ -1,6 +1,20 @@
 #include "video/VideoDecoder.h"
 #include "common/Logger.h"
 #include "common/Protocol.h"
+#include "video/PixelConverter.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define DECODER_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define DECODER_NEON 1
+#include <arm_neon.h>
+#endif
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -24,6 +38,58 @@ static AVPixelFormat toAVPixelFormat(OutputPixelFormat fmt) {
     return AV_PIX_FMT_NONE;
 }
 
+// Reassembled frames carry their padding as spare capacity (no realloc here)
+static_assert(FRAME_TAIL_PADDING >= AV_INPUT_BUFFER_PADDING_SIZE,
+              "FRAME_TAIL_PADDING must cover the decoder input padding");
+
+// av_buffer_create() free callback: the packet owned the frame's vector
+static void releaseOwnedBuffer(void* opaque, uint8_t* /*data*/) {
+    delete static_cast<std::vector<uint8_t>*>(opaque);
+}
+
+/**
+ * First Annex-B start code (00 00 01) at or after p, end if none.
+ * SIMD: 16 positions per step where bytes i and i + 1 are both zero;
+ * only those candidates are checked for the 01.
+ */
+static const uint8_t* findStartCode(const uint8_t* p, const uint8_t* end) {
+#if defined(DECODER_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 18) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, zero), _mm_cmpeq_epi8(b, zero))));
+        while (mask) {
+#ifdef _MSC_VER
+            unsigned long i;
+            _BitScanForward(&i, mask);
+#else
+            const int i = __builtin_ctz(mask);
+#endif
+            if (p[i + 2] == 0x01) return p + i;
+            mask &= mask - 1;
+        }
+        p += 16;
+    }
+#elif defined(DECODER_NEON)
+    const uint8x16_t zero = vdupq_n_u8(0);
+    while (end - p >= 18) {
+        const uint8x16_t pairs = vandq_u8(vceqq_u8(vld1q_u8(p), zero), vceqq_u8(vld1q_u8(p + 1), zero));
+        if (vmaxvq_u8(pairs) != 0) {
+            for (int i = 0; i < 16; i++) {
+                if (p[i] == 0 && p[i + 1] == 0 && p[i + 2] == 0x01) return p + i;
+            }
+        }
+        p += 16;
+    }
+#endif
+    for (; end - p >= 3; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 0x01) return p;
+    }
+    return end;
+}
+
 static const char* outputFormatName(OutputPixelFormat fmt) {
     switch (fmt) {
         case OutputPixelFormat::BGRA: return "BGRA";
@@ -48,7 +114,8 @@ bool VideoDecoder::configure(const VideoDecoderConfig& config) {
     cleanup();
     config_ = config;
 
-    Logger::instance().infof("Configuring decoder, output format=%s",
+    Logger::instance().infof("Configuring %s decoder, output format=%s",
+                             Protocol::codecName(config.codec),
                              outputFormatName(config.outputFormat));
 
     if (!initDecoder()) {
@@ -75,14 +142,39 @@ static enum AVPixelFormat getHwFormat(AVCodecContext* /*ctx*/,
 }
 #endif
 
+// FFmpeg decoder for a codec (nullptr if the build lacks it)
+static const AVCodec* findDecoder(VideoCodec codec) {
+    const AVCodec* found = nullptr;
+    switch (codec) {
+        case VideoCodec::H264:
+            found = avcodec_find_decoder(AV_CODEC_ID_H264);
+            break;
+        case VideoCodec::HEVC:
+            found = avcodec_find_decoder(AV_CODEC_ID_HEVC);
+            break;
+        case VideoCodec::AV1:
+            // dav1d: FFmpeg's native AV1 decoder is hwaccel-only on most builds
+            found = avcodec_find_decoder_by_name("libdav1d");
+            if (!found) found = avcodec_find_decoder(AV_CODEC_ID_AV1);
+            break;
+        case VideoCodec::Lossless:
+            break;  // Not an FFmpeg codec: JoinMode decodes it with LosslessCodec
+    }
+    return found;
+}
+
+bool VideoDecoder::isAvailable(VideoCodec codec) {
+    return findDecoder(codec) != nullptr;
+}
+
 bool VideoDecoder::initDecoder() {
-    // Find H.264 decoder
-    const AVCodec* codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+    const AVCodec* codec = findDecoder(config_.codec);
     if (!codec) {
-        LOG_ERROR("H.264 decoder not found");
-        if (onError_) onError_("H.264 decoder not found");
+        Logger::instance().errorf("%s decoder not found", Protocol::codecName(config_.codec));
+        if (onError_) onError_(std::string(Protocol::codecName(config_.codec)) + " decoder not found");
         return false;
     }
+    const bool dav1d = std::string(codec->name) == "libdav1d";
 
     // Allocate codec context
     codecCtx_ = avcodec_alloc_context3(codec);
@@ -93,7 +185,7 @@ bool VideoDecoder::initDecoder() {
 
     // Try VideoToolbox hardware acceleration on macOS
 #ifdef __APPLE__
-    if (config_.useHardwareAccel) {
+    if (config_.useHardwareAccel && config_.codec != VideoCodec::AV1) {
         int ret = av_hwdevice_ctx_create(&hwDeviceCtx_, AV_HWDEVICE_TYPE_VIDEOTOOLBOX,
                                           nullptr, nullptr, 0);
         if (ret >= 0) {
@@ -110,19 +202,38 @@ bool VideoDecoder::initDecoder() {
     }
 #endif
 
+    AVDictionary* opts = nullptr;
     if (hwAccelActive_) {
         // With hwaccel, GPU handles decoding — no need for CPU thread constraints
         codecCtx_->flags2 |= AV_CODEC_FLAG2_FAST;
+    } else if (dav1d) {
+        // dav1d threads over tiles / rows; one frame in flight keeps it zero-delay
+        codecCtx_->thread_count = 0;
+        av_dict_set(&opts, "max_frame_delay", "1", 0);
+        Logger::instance().infof("Using decoder: %s", codec->name);
     } else {
-        // Software decoding: single-thread for zero frame buffering (lowest latency)
-        codecCtx_->thread_count = 1;
+        // Software decoding: slice threads only. Frame threads would hold one
+        // frame per thread; slices of the same picture decode in parallel
+        // with zero added delay (the host's x264 zerolatency sliced threads
+        // emit one slice per encoder thread).
+        codecCtx_->thread_count = std::max(config_.threads, 0);    // 0 = FFmpeg picks (cores)
+        codecCtx_->thread_type = FF_THREAD_SLICE;
         codecCtx_->flags |= AV_CODEC_FLAG_LOW_DELAY;
         codecCtx_->flags2 |= AV_CODEC_FLAG2_FAST;
-        Logger::instance().infof("Using decoder: %s", codec->name);
     }
 
+    // Joining an intra refresh stream: hold pictures back until the wave that
+    // started at the recovery point has covered the whole frame
+    codecCtx_->flags &= ~AV_CODEC_FLAG_OUTPUT_CORRUPT;
+
+    // Pictures with lost slices (partial frames from the receiver) still come
+    // out: the missing macroblocks are predicted from the previous picture,
+    // so a loss shows as a local artifact and the reference chain goes on
+    codecCtx_->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK | FF_EC_FAVOR_INTER;
+
     // Open codec
-    int ret = avcodec_open2(codecCtx_, codec, nullptr);
+    int ret = avcodec_open2(codecCtx_, codec, &opts);
+    av_dict_free(&opts);
     if (ret < 0) {
         char errbuf[256];
         av_strerror(ret, errbuf, sizeof(errbuf));
@@ -131,6 +242,13 @@ bool VideoDecoder::initDecoder() {
         return false;
     }
 
+    // Resolved by avcodec_open2 (auto thread count, slice threads unsupported)
+    threads_ = std::max(codecCtx_->thread_count, 1);
+    if (!hwAccelActive_ && !dav1d) {
+        Logger::instance().infof("Using decoder: %s (%d slice thread%s)", codec->name,
+                                 threads_, threads_ > 1 ? "s" : "");
+    }
+
     // Allocate frame for decoded output
     frame_ = av_frame_alloc();
     if (!frame_) {
@@ -163,23 +281,48 @@ bool VideoDecoder::initScaler(int width, int height, int srcPixelFormat) {
         sws_freeContext(swsCtx_);
         swsCtx_ = nullptr;
     }
-    if (convertedFrame_) {
-        av_frame_free(&convertedFrame_);
-        convertedFrame_ = nullptr;
-    }
+    converter_.reset();
+    passthrough_ = false;
 
     AVPixelFormat srcFormat = static_cast<AVPixelFormat>(srcPixelFormat);
-    AVPixelFormat dstFormat = toAVPixelFormat(config_.outputFormat);
+    scalerSrcFormat_ = srcPixelFormat;
+
+    const bool planar422 = srcFormat == AV_PIX_FMT_YUV422P || srcFormat == AV_PIX_FMT_YUVJ422P;
+    const bool planar420 = srcFormat == AV_PIX_FMT_YUV420P || srcFormat == AV_PIX_FMT_YUVJ420P;
+    const bool semiPlanar420 = srcFormat == AV_PIX_FMT_NV12;
 
-    // If formats match, no conversion needed
-    if (srcFormat == dstFormat) {
-        LOG_DEBUG("No pixel format conversion needed");
+    // 4:2:0 output would throw away half of a 4:2:2 stream's chroma
+    outputFormat_ = config_.outputFormat;
+    if (planar422 && (outputFormat_ == OutputPixelFormat::NV12 ||
+                      outputFormat_ == OutputPixelFormat::I420)) {
+        outputFormat_ = OutputPixelFormat::UYVY;
+    }
+    AVPixelFormat dstFormat = toAVPixelFormat(outputFormat_);
+
+    // Decoder planes already in the output layout: copied as they are
+    if (srcFormat == dstFormat || (planar420 && outputFormat_ == OutputPixelFormat::I420)) {
+        passthrough_ = true;
+        Logger::instance().infof("Pixel conversion: none (%s passed through)",
+                                 av_get_pix_fmt_name(srcFormat));
+        return true;
+    }
+
+    // YUV → UYVY: re-interleave only (4:2:0 chroma rows serve two luma rows)
+    if (outputFormat_ == OutputPixelFormat::UYVY && (width % 2) == 0 &&
+        (planar422 || planar420 || semiPlanar420)) {
+        converterSrc_ = planar422 ? PixelFormat::I422
+                      : planar420 ? PixelFormat::I420 : PixelFormat::NV12;
+        converter_ = std::make_unique<PixelConverter>();
+        Logger::instance().infof("Pixel conversion: %s -> UYVY (%s, %d slice threads)",
+                                 av_get_pix_fmt_name(srcFormat),
+                                 PixelConverter::kernelName(converter_->kernel()),
+                                 converter_->threadCount());
         return true;
     }
 
     Logger::instance().debugf("Creating scaler: %s -> %s",
                               av_get_pix_fmt_name(srcFormat),
-                              outputFormatName(config_.outputFormat));
+                              outputFormatName(outputFormat_));
 
     swsCtx_ = sws_getContext(
         width, height, srcFormat,
@@ -201,30 +344,6 @@ bool VideoDecoder::initScaler(int width, int height, int srcPixelFormat) {
     int brightness = 0, contrast = 1 << 16, saturation = 1 << 16;
     sws_setColorspaceDetails(swsCtx_, inv_table, srcRange, table, dstRange,
                              brightness, contrast, saturation);
-
-    // Allocate converted frame with FFmpeg-managed aligned buffer
-    convertedFrame_ = av_frame_alloc();
-    if (!convertedFrame_) {
-        LOG_ERROR("Failed to allocate converted frame");
-        return false;
-    }
-
-    convertedFrame_->format = dstFormat;
-    convertedFrame_->width = width;
-    convertedFrame_->height = height;
-
-    int ret = av_frame_get_buffer(convertedFrame_, 32); // 32-byte alignment
-    if (ret < 0) {
-        char errbuf[256];
-        av_strerror(ret, errbuf, sizeof(errbuf));
-        Logger::instance().errorf("Failed to allocate converted frame buffer: %s", errbuf);
-        av_frame_free(&convertedFrame_);
-        return false;
-    }
-
-    Logger::instance().debugf("Scaler output: %dx%d linesize=%d (av_frame_get_buffer, aligned)",
-        width, height, convertedFrame_->linesize[0]);
-
     return true;
 }
 
@@ -249,11 +368,6 @@ void VideoDecoder::cleanup() {
         swFrame_ = nullptr;
     }
 
-    if (convertedFrame_) {
-        av_frame_free(&convertedFrame_);
-        convertedFrame_ = nullptr;
-    }
-
     if (packet_) {
         av_packet_free(&packet_);
         packet_ = nullptr;
@@ -263,10 +377,14 @@ void VideoDecoder::cleanup() {
         sws_freeContext(swsCtx_);
         swsCtx_ = nullptr;
     }
+    converter_.reset();
+    scalerSrcFormat_ = -1;
 
     configured_ = false;
     decoderReady_ = false;
+    chunkedInput_ = false;
     hwAccelActive_ = false;
+    threads_ = 1;
     width_ = 0;
     height_ = 0;
     sps_.clear();
@@ -276,112 +394,212 @@ void VideoDecoder::cleanup() {
     stats_ = Stats{};
 }
 
-std::vector<VideoDecoder::NALUnit> VideoDecoder::parseNALUnits(const uint8_t* data, size_t size) {
-    std::vector<NALUnit> nalUnits;
+void VideoDecoder::parseNALUnits(const uint8_t* data, size_t size) {
+    nalUnits_.clear();
 
-    if (size < 4) return nalUnits;
+    const bool hevc = config_.codec == VideoCodec::HEVC;
+    const uint8_t* end = data + size;
+    const uint8_t* start = findStartCode(data, end);
+    while (start != end) {
+        const uint8_t* nalStart = start + 3;
+        if (nalStart >= end) break;
 
-    size_t i = 0;
-    size_t nalStart = 0;
-    bool foundFirst = false;
+        NALUnit nal;
+        nal.data = nalStart;
+        nal.type = hevc ? (nalStart[0] >> 1) & 0x3F : nalStart[0] & 0x1F;
 
-    while (i < size - 3) {
-        // Check for start code (0x00 0x00 0x01 or 0x00 0x00 0x00 0x01)
-        if (data[i] == 0x00 && data[i + 1] == 0x00) {
-            int startCodeLen = 0;
+        // Parameter sets and SEI precede the first slice: the slice data
+        // (nearly all of the access unit) is never scanned
+        const bool vcl = hevc ? nal.type < HEVC_NAL_VCL_END
+                              : nal.type >= NAL_TYPE_NON_IDR && nal.type <= NAL_TYPE_IDR;
+        start = vcl ? end : findStartCode(nalStart, end);
 
-            if (data[i + 2] == 0x01) {
-                startCodeLen = 3;
-            } else if (i + 3 < size && data[i + 2] == 0x00 && data[i + 3] == 0x01) {
-                startCodeLen = 4;
-            }
+        // A 4-byte start code's leading zero is not part of this NAL
+        const uint8_t* nalEnd = start;
+        if (nalEnd != end && nalEnd > nalStart && nalEnd[-1] == 0x00) nalEnd--;
+        nal.size = static_cast<size_t>(nalEnd - nalStart);
+        nalUnits_.push_back(nal);
+    }
+}
 
-            if (startCodeLen > 0) {
-                // Save previous NAL unit (if any)
-                if (foundFirst && nalStart < i) {
-                    NALUnit nal;
-                    nal.data = data + nalStart;
-                    nal.size = i - nalStart;
-                    nal.type = data[nalStart] & 0x1F;
-                    nalUnits.push_back(nal);
-                }
-
-                // Move past start code
-                i += startCodeLen;
-                nalStart = i;
-                foundFirst = true;
-                continue;
+bool VideoDecoder::findSequenceHeader(const uint8_t* data, size_t size,
+                                      const uint8_t*& header, size_t& headerSize) {
+    // Low-overhead OBU stream: header byte, optional extension byte, leb128 size
+    size_t pos = 0;
+    while (pos < size) {
+        const uint8_t obuHeader = data[pos];
+        const uint8_t type = (obuHeader >> 3) & 0x0F;
+        size_t offset = pos + 1 + ((obuHeader >> 2) & 1);
+        uint64_t obuSize = 0;
+        if (obuHeader & 0x02) {
+            for (int i = 0; i < 8 && offset < size; i++) {
+                const uint8_t byte = data[offset++];
+                obuSize |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+                if (!(byte & 0x80)) break;
             }
+        } else {
+            obuSize = size - std::min(offset, size);     // Last OBU runs to the end
         }
-        i++;
+        if (offset > size || obuSize > size - offset) return false;
+
+        if (type == AV1_OBU_SEQUENCE_HEADER) {
+            header = data + pos;
+            headerSize = offset + obuSize - pos;
+            return true;
+        }
+        pos = offset + obuSize;
     }
+    return false;
+}
 
-    // Add last NAL unit
-    if (foundFirst && nalStart < size) {
-        NALUnit nal;
-        nal.data = data + nalStart;
-        nal.size = size - nalStart;
-        nal.type = data[nalStart] & 0x1F;
-        nalUnits.push_back(nal);
+bool VideoDecoder::hasRecoveryPoint(const NALUnit& nal) {
+    // SEI RBSP without emulation prevention bytes (00 00 03)
+    std::vector<uint8_t> rbsp;
+    rbsp.reserve(nal.size);
+    int zeros = 0;
+    for (size_t i = 1; i < nal.size; i++) {     // Skip the NAL header byte
+        if (zeros >= 2 && nal.data[i] == 0x03) {
+            zeros = 0;
+            continue;
+        }
+        zeros = nal.data[i] == 0x00 ? zeros + 1 : 0;
+        rbsp.push_back(nal.data[i]);
     }
 
-    return nalUnits;
+    // sei_message(): ff-coded payload type and size, then the payload
+    size_t pos = 0;
+    while (pos < rbsp.size() && rbsp[pos] != 0x80) {    // 0x80 = rbsp_trailing_bits
+        int type = 0;
+        while (pos < rbsp.size() && rbsp[pos] == 0xFF) { type += 255; pos++; }
+        if (pos >= rbsp.size()) break;
+        type += rbsp[pos++];
+
+        size_t payloadSize = 0;
+        while (pos < rbsp.size() && rbsp[pos] == 0xFF) { payloadSize += 255; pos++; }
+        if (pos >= rbsp.size()) break;
+        payloadSize += rbsp[pos++];
+
+        if (type == SEI_RECOVERY_POINT) return true;
+        pos += payloadSize;
+    }
+    return false;
 }
 
 bool VideoDecoder::decode(const uint8_t* data, size_t size, uint64_t timestamp) {
+    // Not ref-counted: avcodec_send_packet() copies it into a padded buffer
+    return decodeAccessUnit(data, size, timestamp, nullptr);
+}
+
+bool VideoDecoder::decode(std::vector<uint8_t>&& data, uint64_t timestamp) {
+    const size_t size = data.size();
+    data.resize(size + AV_INPUT_BUFFER_PADDING_SIZE, 0);
+
+    // The packet takes the vector: FFmpeg frees it with its last reference
+    auto* owned = new std::vector<uint8_t>(std::move(data));
+    AVBufferRef* buffer = av_buffer_create(owned->data(), owned->size(),
+                                           releaseOwnedBuffer, owned, 0);
+    if (!buffer) {
+        delete owned;
+        return false;
+    }
+    return decodeAccessUnit(owned->data(), size, timestamp, buffer);
+}
+
+bool VideoDecoder::decodeAccessUnit(const uint8_t* data, size_t size, uint64_t timestamp,
+                                    AVBufferRef* buffer) {
     if (!configured_) {
         LOG_ERROR("Decoder not configured");
+        av_buffer_unref(&buffer);
         return false;
     }
 
     // Parse NAL units to extract SPS/PPS and track keyframes
-    auto nalUnits = parseNALUnits(data, size);
     bool hasIDR = false;
+    bool hasSPS = false;
+    bool hasRecovery = false;
+
+    nalUnits_.clear();
+    const bool hevc = config_.codec == VideoCodec::HEVC;
+    const uint8_t spsType = hevc ? HEVC_NAL_SPS : NAL_TYPE_SPS;
+    const uint8_t ppsType = hevc ? HEVC_NAL_PPS : NAL_TYPE_PPS;
+    if (config_.codec == VideoCodec::AV1) {
+        // The encoders repeat the sequence header on every key frame only,
+        // so it marks the random access points
+        const uint8_t* header = nullptr;
+        size_t headerSize = 0;
+        if (findSequenceHeader(data, size, header, headerSize)) {
+            hasSPS = hasIDR = true;
+            if (sps_.size() != headerSize || !std::equal(sps_.begin(), sps_.end(), header)) {
+                Logger::instance().debugf("Received sequence header (%zu bytes)%s",
+                    headerSize, sps_.empty() ? "" : " (changed)");
+                sps_.assign(header, header + headerSize);
+            }
+        }
+    } else {
+        parseNALUnits(data, size);
+    }
 
-    for (const auto& nal : nalUnits) {
-        if (nal.type == NAL_TYPE_SPS) {
+    for (const auto& nal : nalUnits_) {
+        if (nal.type == spsType) {
+            hasSPS = true;
             // Only log when SPS changes or is first received
-            std::vector<uint8_t> newSps(nal.data, nal.data + nal.size);
-            if (newSps != sps_) {
+            if (sps_.size() != nal.size || !std::equal(sps_.begin(), sps_.end(), nal.data)) {
                 Logger::instance().debugf("Received SPS (%zu bytes)%s",
                     nal.size, sps_.empty() ? "" : " (changed)");
-                sps_ = std::move(newSps);
+                sps_.assign(nal.data, nal.data + nal.size);
             }
-        } else if (nal.type == NAL_TYPE_PPS) {
-            std::vector<uint8_t> newPps(nal.data, nal.data + nal.size);
-            if (newPps != pps_) {
+        } else if (nal.type == ppsType) {
+            if (pps_.size() != nal.size || !std::equal(pps_.begin(), pps_.end(), nal.data)) {
                 Logger::instance().debugf("Received PPS (%zu bytes)%s",
                     nal.size, pps_.empty() ? "" : " (changed)");
-                pps_ = std::move(newPps);
+                pps_.assign(nal.data, nal.data + nal.size);
             }
-            if (!decoderReady_ && !sps_.empty()) {
-                decoderReady_ = true;
-                LOG_SUCCESS("Decoder ready (SPS/PPS received)");
-            }
-        } else if (nal.type == NAL_TYPE_IDR) {
+        } else if (hevc ? nal.type >= HEVC_NAL_IRAP_FIRST && nal.type <= HEVC_NAL_IRAP_LAST
+                        : nal.type == NAL_TYPE_IDR) {
             hasIDR = true;
+        } else if (!hevc && nal.type == NAL_TYPE_SEI && hasRecoveryPoint(nal)) {
+            hasRecovery = true;
+            stats_.recoveryPoints++;
+        }
+    }
+
+    // Start at a random access point: an IDR, or the recovery point SEI that
+    // opens an intra refresh wave (the stream then has no periodic IDR)
+    const bool haveParameterSets = !sps_.empty() && (!pps_.empty() || config_.codec == VideoCodec::AV1);
+    if (!decoderReady_ && haveParameterSets && (hasIDR || hasRecovery)) {
+        decoderReady_ = true;
+        if (config_.codec == VideoCodec::AV1) {
+            LOG_SUCCESS("Decoder ready (sequence header + key frame received)");
+        } else {
+            LOG_SUCCESS(hasIDR ? "Decoder ready (SPS/PPS + IDR received)"
+                               : "Decoder ready (SPS/PPS + recovery point received)");
         }
     }
 
     if (!decoderReady_) {
         LOG_DEBUG("Waiting for keyframe (SPS/PPS)");
+        av_buffer_unref(&buffer);
         return true;
     }
 
-    if (hasIDR) {
+    // Slice units: every slice of an IDR has an IDR NAL, only the first has SPS
+    if (hasIDR && (!chunkedInput_ || hasSPS)) {
         stats_.keyframesDecoded++;
     }
 
-    // Send the ENTIRE Annex-B frame as one packet to the decoder.
-    // Previously, each NAL/slice was sent individually, causing the decoder
-    // to output partial frames with concealment errors for missing slices.
+    // Send the ENTIRE Annex-B frame as one packet to the decoder (parameter
+    // sets in band, as sent). Slice units (decodeSlice) are the exception:
+    // chunked input keeps the picture open until its last slice. With a
+    // buffer the packet is ref-counted and the decoder reads it in place.
     av_packet_unref(packet_);
+    packet_->buf = buffer;
     packet_->data = const_cast<uint8_t*>(data);
     packet_->size = static_cast<int>(size);
     packet_->pts = static_cast<int64_t>(timestamp);
     packet_->dts = packet_->pts;
 
     int ret = avcodec_send_packet(codecCtx_, packet_);
+    av_packet_unref(packet_);   // The decoder holds its own reference
     if (ret < 0) {
         if (ret == AVERROR(EAGAIN)) {
             // Decoder full, try to receive frames
@@ -415,131 +633,26 @@ bool VideoDecoder::decode(const uint8_t* data, size_t size, uint64_t timestamp)
     return true;
 }
 
-bool VideoDecoder::processNALUnit(const NALUnit& nal, uint64_t timestamp) {
-    switch (nal.type) {
-        case NAL_TYPE_SPS: {
-            std::vector<uint8_t> newSps(nal.data, nal.data + nal.size);
-            if (newSps != sps_) {
-                Logger::instance().debugf("Received SPS (%zu bytes)%s",
-                    nal.size, sps_.empty() ? "" : " (changed)");
-                sps_ = std::move(newSps);
-            }
-            return true;
-        }
-
-        case NAL_TYPE_PPS: {
-            std::vector<uint8_t> newPps(nal.data, nal.data + nal.size);
-            if (newPps != pps_) {
-                Logger::instance().debugf("Received PPS (%zu bytes)%s",
-                    nal.size, pps_.empty() ? "" : " (changed)");
-                pps_ = std::move(newPps);
-            }
-            if (!decoderReady_ && !sps_.empty()) {
-                decoderReady_ = true;
-                LOG_SUCCESS("Decoder ready (SPS/PPS received)");
-            }
-            return true;
-        }
-
-        case NAL_TYPE_IDR:
-            stats_.keyframesDecoded++;
-            return decodeNALUnit(nal, timestamp);
-
-        case NAL_TYPE_NON_IDR:
-            return decodeNALUnit(nal, timestamp);
-
-        case NAL_TYPE_SEI:
-            // Skip SEI
-            return true;
-
-        default:
-            Logger::instance().debugf("Skipping NAL type %d", nal.type);
-            return true;
-    }
+bool VideoDecoder::decodeSlice(const uint8_t* data, size_t size, uint64_t timestamp) {
+    beginSliceInput();
+    stats_.slicesDecoded++;
+    return decode(data, size, timestamp);
 }
 
-bool VideoDecoder::decodeNALUnit(const NALUnit& nal, uint64_t timestamp) {
-    if (!decoderReady_ && nal.type != NAL_TYPE_IDR) {
-        // Need SPS/PPS first, skip non-IDR frames
-        LOG_DEBUG("Waiting for keyframe (SPS/PPS)");
-        return true;
-    }
-
-    // Build packet with Annex-B start code
-    // FFmpeg H.264 decoder expects Annex-B format
-    std::vector<uint8_t> packetData;
-
-    // For IDR frames, prepend SPS and PPS
-    if (nal.type == NAL_TYPE_IDR && !sps_.empty() && !pps_.empty()) {
-        packetData.reserve(sps_.size() + pps_.size() + nal.size + 12);
-
-        // Add SPS with start code
-        packetData.push_back(0x00);
-        packetData.push_back(0x00);
-        packetData.push_back(0x00);
-        packetData.push_back(0x01);
-        packetData.insert(packetData.end(), sps_.begin(), sps_.end());
-
-        // Add PPS with start code
-        packetData.push_back(0x00);
-        packetData.push_back(0x00);
-        packetData.push_back(0x00);
-        packetData.push_back(0x01);
-        packetData.insert(packetData.end(), pps_.begin(), pps_.end());
-    } else {
-        packetData.reserve(nal.size + 4);
-    }
-
-    // Add start code
-    packetData.push_back(0x00);
-    packetData.push_back(0x00);
-    packetData.push_back(0x00);
-    packetData.push_back(0x01);
-
-    // Add NAL data
-    packetData.insert(packetData.end(), nal.data, nal.data + nal.size);
-
-    // Set packet data
-    av_packet_unref(packet_);
-    packet_->data = packetData.data();
-    packet_->size = static_cast<int>(packetData.size());
-    packet_->pts = static_cast<int64_t>(timestamp);
-    packet_->dts = packet_->pts;
-
-    // Send packet to decoder
-    int ret = avcodec_send_packet(codecCtx_, packet_);
-    if (ret < 0) {
-        if (ret == AVERROR(EAGAIN)) {
-            // Decoder is full, try to receive frames first
-        } else if (ret == AVERROR_EOF) {
-            return true;
-        } else {
-            char errbuf[256];
-            av_strerror(ret, errbuf, sizeof(errbuf));
-            Logger::instance().errorf("Failed to send packet: %s", errbuf);
-            stats_.decodeErrors++;
-            return false;
-        }
-    }
-
-    // Receive decoded frames
-    while (ret >= 0) {
-        ret = avcodec_receive_frame(codecCtx_, frame_);
-        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-            break;
-        } else if (ret < 0) {
-            char errbuf[256];
-            av_strerror(ret, errbuf, sizeof(errbuf));
-            Logger::instance().errorf("Failed to receive frame: %s", errbuf);
-            stats_.decodeErrors++;
-            return false;
-        }
+bool VideoDecoder::decodeSlice(std::vector<uint8_t>&& data, uint64_t timestamp) {
+    beginSliceInput();
+    stats_.slicesDecoded++;
+    return decode(std::move(data), timestamp);
+}
 
-        processDecodedFrame(frame_, timestamp);
-        av_frame_unref(frame_);
-    }
+void VideoDecoder::beginSliceInput() {
+    if (!configured_ || chunkedInput_ || config_.codec != VideoCodec::H264) return;
 
-    return true;
+    // h264dec checks the flag per packet: with it, a packet may end
+    // mid-picture and the picture completes on its last macroblock row
+    codecCtx_->flags2 |= AV_CODEC_FLAG2_CHUNKS;
+    chunkedInput_ = true;
+    LOG_INFO("Decoder: slice input (decoding slices as they arrive)");
 }
 
 void VideoDecoder::processDecodedFrame(AVFrame* frame, uint64_t timestamp) {
@@ -573,11 +686,13 @@ void VideoDecoder::processDecodedFrame(AVFrame* frame, uint64_t timestamp) {
             hwAccelActive_ ? " (hwaccel)" : "");
     }
 
-    // Update dimensions if changed
-    if (width_ != cpuFrame->width || height_ != cpuFrame->height) {
+    // Update dimensions (or chroma format, e.g. a 4:2:2 sender) if changed
+    if (width_ != cpuFrame->width || height_ != cpuFrame->height ||
+        scalerSrcFormat_ != cpuFrame->format) {
         width_ = cpuFrame->width;
         height_ = cpuFrame->height;
-        Logger::instance().infof("Video dimensions: %dx%d", width_, height_);
+        Logger::instance().infof("Video dimensions: %dx%d (%s)", width_, height_,
+                                 av_get_pix_fmt_name(static_cast<AVPixelFormat>(cpuFrame->format)));
 
         // Reinitialize scaler for new dimensions, using actual frame pixel format
         if (!initScaler(width_, height_, cpuFrame->format)) {
@@ -587,55 +702,72 @@ void VideoDecoder::processDecodedFrame(AVFrame* frame, uint64_t timestamp) {
     }
 
     stats_.framesDecoded++;
-
-    // Convert pixel format if needed
-    AVFrame* outputFrame = cpuFrame;
-    if (swsCtx_ && convertedFrame_) {
-        av_frame_make_writable(convertedFrame_);
-        sws_scale(
-            swsCtx_,
-            cpuFrame->data, cpuFrame->linesize,
-            0, cpuFrame->height,
-            convertedFrame_->data, convertedFrame_->linesize
-        );
-        outputFrame = convertedFrame_;
-    }
-
-    // Build output frame (reuse persistent buffer to avoid per-frame malloc/page faults)
-    if (onDecodedFrame_) {
-        outputDecodedFrame_.width = width_;
-        outputDecodedFrame_.height = height_;
-        outputDecodedFrame_.timestamp = timestamp;
-        outputDecodedFrame_.format = config_.outputFormat;
-
-        if (config_.outputFormat == OutputPixelFormat::BGRA ||
-            config_.outputFormat == OutputPixelFormat::UYVY) {
-            outputDecodedFrame_.stride = outputFrame->linesize[0];
-            size_t dataSize = static_cast<size_t>(outputDecodedFrame_.stride) * height_;
-            outputDecodedFrame_.data.resize(dataSize);  // no-op after first frame
-            std::memcpy(outputDecodedFrame_.data.data(), outputFrame->data[0], dataSize);
+    const bool concealed = frame->decode_error_flags != 0 || (frame->flags & AV_FRAME_FLAG_CORRUPT);
+    if (concealed) {
+        stats_.framesConcealed++;
+    }
+    if (!onDecodedFrame_) {
+        return;
+    }
+
+    // Output layout: compact rows, 4:2:0 planes back to back (what NDI takes)
+    const bool planar = outputFormat_ == OutputPixelFormat::NV12 ||
+                        outputFormat_ == OutputPixelFormat::I420;
+    const int stride = planar ? (width_ + 1) & ~1
+                              : width_ * (outputFormat_ == OutputPixelFormat::BGRA ? 4 : 2);
+    const int chromaRows = (height_ + 1) / 2;
+    const size_t lumaSize = static_cast<size_t>(stride) * height_;
+    const size_t size = planar ? lumaSize + static_cast<size_t>(stride) * chromaRows : lumaSize;
+
+    // Render into a ref-counted caller buffer when there is one (no copy afterwards)
+    std::shared_ptr<uint8_t> buffer = acquireOutput_ ? acquireOutput_(size) : nullptr;
+    uint8_t* out = buffer.get();
+    if (!out) {
+        outputDecodedFrame_.data.resize(size);  // no-op after first frame
+        out = outputDecodedFrame_.data.data();
+    }
+
+    uint8_t* dst[4] = {out, nullptr, nullptr, nullptr};
+    int dstStride[4] = {stride, 0, 0, 0};
+    if (outputFormat_ == OutputPixelFormat::NV12) {
+        dst[1] = out + lumaSize;
+        dstStride[1] = stride;
+    } else if (outputFormat_ == OutputPixelFormat::I420) {
+        dst[1] = out + lumaSize;
+        dst[2] = dst[1] + static_cast<size_t>(stride / 2) * chromaRows;
+        dstStride[1] = dstStride[2] = stride / 2;
+    }
+
+    if (converter_) {
+        converter_->convert(converterSrc_, cpuFrame->data, cpuFrame->linesize,
+                            PixelFormat::UYVY, dst, dstStride, cpuFrame->width, cpuFrame->height);
+    } else if (swsCtx_) {
+        sws_scale(swsCtx_, cpuFrame->data, cpuFrame->linesize, 0, cpuFrame->height,
+                  dst, dstStride);
+    } else if (passthrough_) {
+        if (!planar) {
+            av_image_copy_plane(dst[0], dstStride[0], cpuFrame->data[0], cpuFrame->linesize[0],
+                                stride, height_);
         } else {
-            outputDecodedFrame_.stride = outputFrame->linesize[0];
-
-            if (config_.outputFormat == OutputPixelFormat::NV12) {
-                size_t ySize = static_cast<size_t>(outputFrame->linesize[0]) * height_;
-                size_t uvSize = static_cast<size_t>(outputFrame->linesize[1]) * height_ / 2;
-                outputDecodedFrame_.data.resize(ySize + uvSize);
-                std::memcpy(outputDecodedFrame_.data.data(), outputFrame->data[0], ySize);
-                std::memcpy(outputDecodedFrame_.data.data() + ySize, outputFrame->data[1], uvSize);
-            } else {
-                size_t ySize = static_cast<size_t>(outputFrame->linesize[0]) * height_;
-                size_t uSize = static_cast<size_t>(outputFrame->linesize[1]) * height_ / 2;
-                size_t vSize = static_cast<size_t>(outputFrame->linesize[2]) * height_ / 2;
-                outputDecodedFrame_.data.resize(ySize + uSize + vSize);
-                std::memcpy(outputDecodedFrame_.data.data(), outputFrame->data[0], ySize);
-                std::memcpy(outputDecodedFrame_.data.data() + ySize, outputFrame->data[1], uSize);
-                std::memcpy(outputDecodedFrame_.data.data() + ySize + uSize, outputFrame->data[2], vSize);
+            const int chromaBytes = outputFormat_ == OutputPixelFormat::NV12 ? stride : stride / 2;
+            av_image_copy_plane(dst[0], dstStride[0], cpuFrame->data[0], cpuFrame->linesize[0],
+                                width_, height_);
+            for (int p = 1; p < (outputFormat_ == OutputPixelFormat::NV12 ? 2 : 3); p++) {
+                av_image_copy_plane(dst[p], dstStride[p], cpuFrame->data[p], cpuFrame->linesize[p],
+                                    chromaBytes, chromaRows);
             }
         }
-
-        onDecodedFrame_(outputDecodedFrame_);
     }
+
+    outputDecodedFrame_.width = width_;
+    outputDecodedFrame_.height = height_;
+    outputDecodedFrame_.stride = stride;
+    outputDecodedFrame_.timestamp = timestamp;
+    outputDecodedFrame_.format = outputFormat_;
+    outputDecodedFrame_.concealed = concealed;
+    outputDecodedFrame_.buffer = std::move(buffer);
+    onDecodedFrame_(outputDecodedFrame_);
+    outputDecodedFrame_.buffer.reset();     // The consumer holds its own reference
 }
 
 void VideoDecoder::flush() {
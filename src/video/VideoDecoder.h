@@ -1,10 +1,10 @@
 #pragma once
 
 /**
- * VideoDecoder.h - H.264 video decoder using FFmpeg
+ * VideoDecoder.h - Video decoder using FFmpeg (H.264, HEVC, AV1)
  *
- * Decodes H.264 Annex-B encoded video to raw pixel buffers.
- * Automatically detects SPS/PPS and creates decoder context.
+ * Decodes H.264 / HEVC Annex-B or AV1 OBU streams to raw pixel buffers.
+ * Waits for parameter sets and a random access point before decoding.
  */
 
 #include <cstdint>
@@ -13,6 +13,9 @@
 #include <functional>
 #include <memory>
 
+#include "../common/Protocol.h"
+#include "PixelFormat.h"
+
 // Forward declarations for FFmpeg types
 struct AVCodecContext;
 struct AVBufferRef;
@@ -22,34 +25,45 @@ struct SwsContext;
 
 namespace ndi_bridge {
 
+class PixelConverter;
+
 /**
  * Supported output pixel formats
  */
 enum class OutputPixelFormat {
     BGRA,       // 32-bit BGRA (NDI default on some platforms)
     UYVY,       // 16-bit packed YUV 4:2:2 (NDI native)
-    NV12,       // Planar YUV 4:2:0
-    I420        // Planar YUV 4:2:0 (alias YUV420P)
+    NV12,       // Semi-planar YUV 4:2:0 (NDI native, no conversion from hwaccel output)
+    I420        // Planar YUV 4:2:0 (NDI native, no conversion from software decode)
 };
 
 /**
  * Decoder configuration
  */
 struct VideoDecoderConfig {
-    OutputPixelFormat outputFormat = OutputPixelFormat::BGRA;
+    OutputPixelFormat outputFormat = OutputPixelFormat::BGRA;  // 4:2:2 streams never go to NV12 / I420 (UYVY)
+    VideoCodec codec = VideoCodec::H264;    // HEVC: FFmpeg hevc, AV1: libdav1d (or native)
     bool useHardwareAccel = false;  // Future: VAAPI, VDPAU, etc.
+    int threads = 0;                // Slice threads, software H.264 / HEVC (0 = one per core)
 };
 
 /**
  * Decoded frame data
+ *
+ * NV12 / I420 planes are stored back to back in the layout NDI expects:
+ * chroma follows luma, chroma stride = stride (NV12) or stride / 2 (I420).
  */
 struct DecodedFrame {
-    std::vector<uint8_t> data;      // Raw pixel data
+    std::vector<uint8_t> data;      // Raw pixel data (empty when buffer is set)
+    std::shared_ptr<const uint8_t> buffer;  // Ref-counted output buffer (setOutputBuffer)
     int width;
     int height;
-    int stride;                     // Line stride in bytes
+    int stride;                     // Line stride in bytes (luma for NV12 / I420)
     uint64_t timestamp;             // PTS in 10M ticks/sec
     OutputPixelFormat format;
+    bool concealed = false;         // Slices were missing or broken: filled in from the previous frame
+
+    const uint8_t* pixels() const { return buffer ? buffer.get() : data.data(); }
 };
 
 /**
@@ -59,13 +73,27 @@ using OnDecodedFrame = std::function<void(const DecodedFrame& frame)>;
 using OnDecoderError = std::function<void(const std::string& error)>;
 
 /**
- * VideoDecoder - H.264 decoder using FFmpeg
+ * Output buffer provider: a ref-counted buffer of `size` bytes for the next
+ * frame (e.g. FrameBufferPool::acquire), or nullptr to use DecodedFrame::data
+ */
+using AcquireOutputBuffer = std::function<std::shared_ptr<uint8_t>(size_t size)>;
+
+/**
+ * VideoDecoder - H.264 / HEVC / AV1 decoder using FFmpeg
  *
  * Features:
- * - Software decoding with FFmpeg
- * - Automatic SPS/PPS detection from Annex-B stream
+ * - Software decoding with FFmpeg (libdav1d for AV1)
+ * - Whole access units in one packet (no per-NAL rebuild); an owned
+ *   buffer is handed to FFmpeg without a copy
+ * - SPS/PPS tracking with a SIMD start-code scan that stops at the first
+ *   slice (HEVC: + VPS, AV1: sequence header)
+ * - Slice-threaded software decode (no frame threads: zero added delay)
  * - Automatic pixel format conversion to BGRA
- * - Handles fragmented NAL units
+ * - NV12 / I420 output straight from the decoder planes (no sws_scale)
+ * - YUV → UYVY by SIMD re-interleave only (4:2:2: no chroma resampling,
+ *   4:2:0: each chroma row serves its two luma rows)
+ * - Output rendered into ref-counted caller buffers (setOutputBuffer), kept
+ *   by the consumer for as long as it needs them instead of copied
  */
 class VideoDecoder {
 public:
@@ -76,6 +104,11 @@ public:
     VideoDecoder(const VideoDecoder&) = delete;
     VideoDecoder& operator=(const VideoDecoder&) = delete;
 
+    /**
+     * Whether this FFmpeg build has a decoder for a codec
+     */
+    static bool isAvailable(VideoCodec codec);
+
     /**
      * Configure the decoder
      * @return true if configuration successful
@@ -94,14 +127,38 @@ public:
     int getHeight() const { return height_; }
 
     /**
-     * Decode H.264 Annex-B data
-     * @param data H.264 Annex-B encoded data (with start codes)
+     * Decode threads in use (valid after configure; 1 = single-threaded)
+     */
+    int threadCount() const { return threads_; }
+
+    /**
+     * Decode one access unit
+     * @param data H.264 / HEVC Annex-B (with start codes) or AV1 temporal unit
      * @param size Data size in bytes
      * @param timestamp PTS in 10M ticks/sec (NDI timestamp format)
      * @return true if decoding started (result via callback)
      */
     bool decode(const uint8_t* data, size_t size, uint64_t timestamp);
 
+    /**
+     * Decode one access unit, taking its buffer (no copy)
+     *
+     * The vector is wrapped in the packet (av_buffer_create) and freed by
+     * FFmpeg once the decoder is done with it. Spare capacity of
+     * FRAME_TAIL_PADDING bytes (as the reassembler leaves) avoids a realloc
+     * for the input padding.
+     */
+    bool decode(std::vector<uint8_t>&& data, uint64_t timestamp);
+
+    /**
+     * Decode one slice unit of an access unit (host --slices)
+     *
+     * Switches the decoder to chunked input: each slice is decoded as it
+     * arrives and the picture is output once its last macroblock row is in.
+     */
+    bool decodeSlice(const uint8_t* data, size_t size, uint64_t timestamp);
+    bool decodeSlice(std::vector<uint8_t>&& data, uint64_t timestamp);
+
     /**
      * Flush decoder (get any pending frames)
      */
@@ -121,6 +178,14 @@ public:
      * Set callbacks
      */
     void setOnDecodedFrame(OnDecodedFrame callback) { onDecodedFrame_ = std::move(callback); }
+
+    /**
+     * Render frames into buffers from `acquire` instead of DecodedFrame::data
+     *
+     * The callback may keep the frame's buffer (copy the shared_ptr); the
+     * decoder drops its own reference as soon as the callback returns.
+     */
+    void setOutputBuffer(AcquireOutputBuffer acquire) { acquireOutput_ = std::move(acquire); }
     void setOnError(OnDecoderError callback) { onError_ = std::move(callback); }
 
     /**
@@ -130,17 +195,33 @@ public:
         uint64_t framesDecoded = 0;
         uint64_t keyframesDecoded = 0;
         uint64_t decodeErrors = 0;
+        uint64_t slicesDecoded = 0;     // Slice units fed through decodeSlice()
+        uint64_t recoveryPoints = 0;    // Recovery point SEIs (intra refresh entry points)
+        uint64_t framesConcealed = 0;   // Pictures output with error concealment
     };
     Stats getStats() const { return stats_; }
 
 private:
     // NAL unit types
-    static constexpr uint8_t NAL_TYPE_NON_IDR = 1;
+    static constexpr uint8_t NAL_TYPE_NON_IDR = 1;     // Slice NAL types: 1-5
     static constexpr uint8_t NAL_TYPE_IDR = 5;
     static constexpr uint8_t NAL_TYPE_SEI = 6;
     static constexpr uint8_t NAL_TYPE_SPS = 7;
     static constexpr uint8_t NAL_TYPE_PPS = 8;
 
+    // SEI payload types
+    static constexpr int SEI_RECOVERY_POINT = 6;
+
+    // HEVC NAL unit types ((header >> 1) & 0x3F)
+    static constexpr uint8_t HEVC_NAL_IRAP_FIRST = 16;  // BLA / IDR / CRA: 16-23
+    static constexpr uint8_t HEVC_NAL_IRAP_LAST = 23;
+    static constexpr uint8_t HEVC_NAL_VCL_END = 32;     // Slice NAL types: 0-31
+    static constexpr uint8_t HEVC_NAL_SPS = 33;
+    static constexpr uint8_t HEVC_NAL_PPS = 34;
+
+    // AV1 OBU types
+    static constexpr uint8_t AV1_OBU_SEQUENCE_HEADER = 1;
+
     struct NALUnit {
         const uint8_t* data;
         size_t size;
@@ -150,29 +231,40 @@ private:
     bool initDecoder();
     bool initScaler(int width, int height, int srcPixelFormat);
     void cleanup();
-    std::vector<NALUnit> parseNALUnits(const uint8_t* data, size_t size);
-    bool processNALUnit(const NALUnit& nal, uint64_t timestamp);
-    bool decodeNALUnit(const NALUnit& nal, uint64_t timestamp);
+    bool decodeAccessUnit(const uint8_t* data, size_t size, uint64_t timestamp,
+                          AVBufferRef* buffer);
+    void beginSliceInput();
+    void parseNALUnits(const uint8_t* data, size_t size);    // → nalUnits_, up to the first slice
+    static bool findSequenceHeader(const uint8_t* data, size_t size,
+                                   const uint8_t*& header, size_t& headerSize);
+    static bool hasRecoveryPoint(const NALUnit& nal);
     void processDecodedFrame(AVFrame* frame, uint64_t timestamp);
 
     VideoDecoderConfig config_;
     bool configured_ = false;
     bool decoderReady_ = false;
+    bool chunkedInput_ = false;     // AV_CODEC_FLAG2_CHUNKS enabled (slice units)
     int width_ = 0;
     int height_ = 0;
+    int threads_ = 1;
 
-    // Parameter sets
+    // Parameter sets (AV1: sps_ = sequence header OBU, no pps_)
     std::vector<uint8_t> sps_;
     std::vector<uint8_t> pps_;
+    std::vector<NALUnit> nalUnits_;     // Current access unit (capacity reused)
 
     // FFmpeg contexts
     AVCodecContext* codecCtx_ = nullptr;
     AVBufferRef* hwDeviceCtx_ = nullptr;
     AVFrame* frame_ = nullptr;
     AVFrame* swFrame_ = nullptr;        // For GPU→CPU transfer (hwaccel)
-    AVFrame* convertedFrame_ = nullptr;
     AVPacket* packet_ = nullptr;
     SwsContext* swsCtx_ = nullptr;
+    std::unique_ptr<PixelConverter> converter_;    // I422 / I420 / NV12 → UYVY
+    PixelFormat converterSrc_ = PixelFormat::I422;
+    bool passthrough_ = false;                      // Decoder planes already in the output layout
+    OutputPixelFormat outputFormat_ = OutputPixelFormat::BGRA;  // Per stream (4:2:2 → UYVY)
+    int scalerSrcFormat_ = -1;                      // AVPixelFormat the scaler was built for
     bool hwAccelActive_ = false;
 
     // Reusable output frame (avoids per-frame allocation)
@@ -181,6 +273,7 @@ private:
     // Callbacks
     OnDecodedFrame onDecodedFrame_;
     OnDecoderError onError_;
+    AcquireOutputBuffer acquireOutput_;
 
     // Statistics
     Stats stats_;
@@ -1,7 +1,9 @@
 #include "video/VideoEncoder.h"
+#include "video/PixelConverter.h"
 #include "common/Logger.h"
 #include "common/Protocol.h"
 #include <string>
+#include <utility>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -19,20 +21,58 @@ static AVPixelFormat toAVPixelFormat(PixelFormat fmt) {
         case PixelFormat::UYVY: return AV_PIX_FMT_UYVY422;
         case PixelFormat::NV12: return AV_PIX_FMT_NV12;
         case PixelFormat::I420: return AV_PIX_FMT_YUV420P;
+        case PixelFormat::I422: return AV_PIX_FMT_YUV422P;
     }
     return AV_PIX_FMT_NONE;
 }
 
+// SVT-AV1 numeric preset (0 = slowest, 13 = fastest) for an x264 preset name
+static const char* svtAv1Preset(const std::string& x264Preset) {
+    static const char* const names[] = {"ultrafast", "superfast", "veryfast", "faster",
+                                        "fast", "medium", "slow", "slower", "veryslow"};
+    static const char* const presets[] = {"12", "11", "10", "9", "8", "7", "6", "5", "4"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (x264Preset == names[i]) return presets[i];
+    }
+    return "10";
+}
+
+// Software encoder FFmpeg offers for a codec (nullptr if the build lacks it)
+static const AVCodec* findSoftwareEncoder(VideoCodec codec) {
+    const AVCodec* found = nullptr;
+    switch (codec) {
+        case VideoCodec::H264:
+            found = avcodec_find_encoder_by_name("libx264");
+            if (!found) found = avcodec_find_encoder(AV_CODEC_ID_H264);
+            break;
+        case VideoCodec::HEVC:
+            found = avcodec_find_encoder_by_name("libx265");
+            break;
+        case VideoCodec::AV1:
+            found = avcodec_find_encoder_by_name("libsvtav1");
+            if (!found) found = avcodec_find_encoder_by_name("libaom-av1");
+            break;
+        case VideoCodec::Lossless:
+            break;  // Not an FFmpeg codec
+    }
+    return found;
+}
+
 static const char* pixelFormatName(PixelFormat fmt) {
     switch (fmt) {
         case PixelFormat::BGRA: return "BGRA";
         case PixelFormat::UYVY: return "UYVY";
         case PixelFormat::NV12: return "NV12";
         case PixelFormat::I420: return "I420";
+        case PixelFormat::I422: return "I422";
     }
     return "Unknown";
 }
 
+bool VideoEncoder::isAvailable(VideoCodec codec) {
+    return findSoftwareEncoder(codec) != nullptr;
+}
+
 VideoEncoder::VideoEncoder() {
     LOG_DEBUG("VideoEncoder initialized");
 }
@@ -48,7 +88,24 @@ bool VideoEncoder::configure(const VideoEncoderConfig& config) {
 
     config_ = config;
 
-    Logger::instance().infof("Configuring encoder: %dx%d @ %d fps, %d Mbps, input=%s",
+    if (config_.codec == VideoCodec::Lossless) {
+        LOG_ERROR("Lossless transport does not use VideoEncoder (see LosslessCodec)");
+        return false;
+    }
+
+    // Slice units and recovery point entry are built on H.264 NAL syntax
+    if (config_.codec != VideoCodec::H264) {
+        if (config_.sliceOutput || config_.intraRefresh) {
+            Logger::instance().infof("%s: slice streaming / intra refresh are H.264 only, disabled",
+                                     Protocol::codecName(config_.codec));
+        }
+        config_.slices = 0;
+        config_.sliceOutput = false;
+        config_.intraRefresh = false;
+    }
+
+    Logger::instance().infof("Configuring encoder: %s %dx%d @ %d fps, %d Mbps, input=%s",
+                             Protocol::codecName(config_.codec),
                              config.width, config.height, config.fps,
                              config.bitrate / 1000000, pixelFormatName(config.inputFormat));
 
@@ -63,6 +120,25 @@ bool VideoEncoder::configure(const VideoEncoderConfig& config) {
         return false;
     }
 
+    // Input pictures for a pipelined caller (convert and encode on separate threads)
+    for (int i = 0; i < config_.pipelinePictures; i++) {
+        AVFrame* picture = av_frame_alloc();
+        if (!picture) {
+            LOG_ERROR("Failed to allocate pipeline picture");
+            cleanup();
+            return false;
+        }
+        pictures_.push_back(picture);
+        picture->format = codecCtx_->pix_fmt;
+        picture->width = config_.width;
+        picture->height = config_.height;
+        if (av_frame_get_buffer(picture, 0) < 0) {
+            LOG_ERROR("Failed to allocate pipeline picture buffer");
+            cleanup();
+            return false;
+        }
+    }
+
     configured_ = true;
     LOG_SUCCESS("Encoder configured successfully");
     return true;
@@ -72,9 +148,24 @@ bool VideoEncoder::initEncoder() {
     const AVCodec* codec = nullptr;
     hwAccelActive_ = false;
 
+    if (config_.codec != VideoCodec::H264) {
+        return initHevcAv1Encoder();
+    }
+
+#if defined(__APPLE__) || defined(_WIN32)
+    // Hardware encoders only take 4:2:0 (NV12): 4:2:2 is libx264 only,
+    // and so is periodic intra refresh
+    const bool tryHardware = config_.useHardwareAccel && !config_.chroma422 && !config_.intraRefresh;
+    if (config_.useHardwareAccel && config_.chroma422) {
+        LOG_INFO("4:2:2 mode: hardware encoders skipped (libx264 High 4:2:2)");
+    } else if (config_.useHardwareAccel && config_.intraRefresh) {
+        LOG_INFO("Intra refresh: hardware encoders skipped (libx264 only)");
+    }
+#endif
+
 #ifdef __APPLE__
     // Try VideoToolbox hardware encoder first on macOS
-    if (config_.useHardwareAccel) {
+    if (tryHardware) {
         codec = avcodec_find_encoder_by_name("h264_videotoolbox");
         if (codec) {
             Logger::instance().info("Trying hardware encoder: h264_videotoolbox");
@@ -83,7 +174,7 @@ bool VideoEncoder::initEncoder() {
     }
 #elif defined(_WIN32)
     // Try NVIDIA NVENC hardware encoder on Windows
-    if (config_.useHardwareAccel) {
+    if (tryHardware) {
         codec = avcodec_find_encoder_by_name("h264_nvenc");
         if (codec) {
             Logger::instance().info("Trying hardware encoder: h264_nvenc");
@@ -101,10 +192,7 @@ bool VideoEncoder::initEncoder() {
 
     if (!codec) {
         // Fall back to libx264 software encoder
-        codec = avcodec_find_encoder_by_name("libx264");
-        if (!codec) {
-            codec = avcodec_find_encoder(AV_CODEC_ID_H264);
-        }
+        codec = findSoftwareEncoder(VideoCodec::H264);
     }
 
     if (!codec) {
@@ -177,8 +265,7 @@ bool VideoEncoder::initEncoder() {
             avcodec_free_context(&codecCtx_);
             hwAccelActive_ = false;
 
-            codec = avcodec_find_encoder_by_name("libx264");
-            if (!codec) codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+            codec = findSoftwareEncoder(VideoCodec::H264);
             if (!codec) {
                 LOG_ERROR("H.264 encoder not found (fallback)");
                 return false;
@@ -205,22 +292,30 @@ bool VideoEncoder::initEncoder() {
     }
 
     if (!hwAccelActive_) {
-        // libx264 settings
-        codecCtx_->pix_fmt = AV_PIX_FMT_YUV420P;
+        // libx264 settings (4:2:2 requires the High 4:2:2 profile)
+        codecCtx_->pix_fmt = config_.chroma422 ? AV_PIX_FMT_YUV422P : AV_PIX_FMT_YUV420P;
         codecCtx_->rc_max_rate = config_.bitrate * 3 / 2;
         codecCtx_->rc_buffer_size = config_.bitrate / config_.fps;
         codecCtx_->thread_count = 0;
+        if (config_.slices > 0) {
+            codecCtx_->slices = config_.slices;
+        }
 
         opts = nullptr;
         av_dict_set(&opts, "preset", config_.preset.c_str(), 0);
         av_dict_set(&opts, "tune", config_.tune.c_str(), 0);
-        av_dict_set(&opts, "profile", config_.profile.c_str(), 0);
+        av_dict_set(&opts, "profile", config_.chroma422 ? "high422" : config_.profile.c_str(), 0);
         av_dict_set(&opts, "colorprim", "bt709", 0);
         av_dict_set(&opts, "transfer", "bt709", 0);
         av_dict_set(&opts, "colormatrix", "bt709", 0);
         av_dict_set(&opts, "fullrange", "on", 0);
         av_dict_set(&opts, "rc-lookahead", "0", 0);
         av_dict_set(&opts, "sync-lookahead", "0", 0);
+        if (config_.intraRefresh) {
+            // keyint (gop_size) becomes the refresh period; x264 marks the
+            // first frame of each wave as keyframe with a recovery point SEI
+            av_dict_set(&opts, "intra-refresh", "1", 0);
+        }
         // NOTE: Do NOT set sliced-threads=0 here — tune=zerolatency enables
         // sliced-threads=1 which gives multi-thread performance with ZERO added
         // frame latency. Disabling it forces frame-level threading that adds
@@ -268,9 +363,107 @@ bool VideoEncoder::initEncoder() {
     return true;
 }
 
+bool VideoEncoder::initHevcAv1Encoder() {
+    // Software only: the bandwidth win is the point, and the pipeline
+    // pictures must stay in a planar format the resize / convert paths know
+    const bool hevc = config_.codec == VideoCodec::HEVC;
+    const AVCodec* codec = findSoftwareEncoder(config_.codec);
+    if (!codec) {
+        Logger::instance().errorf("%s encoder not found (FFmpeg needs %s)",
+                                  Protocol::codecName(config_.codec), hevc ? "libx265" : "libsvtav1");
+        if (onError_) onError_(std::string(Protocol::codecName(config_.codec)) + " encoder not found");
+        return false;
+    }
+
+    Logger::instance().infof("Using encoder: %s", codec->name);
+
+    codecCtx_ = avcodec_alloc_context3(codec);
+    if (!codecCtx_) {
+        LOG_ERROR("Failed to allocate codec context");
+        return false;
+    }
+
+    // Same timing / colour / rate control as the x264 path. No global header:
+    // each keyframe carries VPS/SPS/PPS or the AV1 sequence header in-band.
+    codecCtx_->width = config_.width;
+    codecCtx_->height = config_.height;
+    codecCtx_->time_base = AVRational{1, static_cast<int>(TIMESTAMP_RESOLUTION)};
+    codecCtx_->framerate = AVRational{config_.fps, 1};
+    codecCtx_->color_range = AVCOL_RANGE_JPEG;
+    codecCtx_->colorspace = AVCOL_SPC_BT709;
+    codecCtx_->color_primaries = AVCOL_PRI_BT709;
+    codecCtx_->color_trc = AVCOL_TRC_BT709;
+    codecCtx_->bit_rate = config_.bitrate;
+    codecCtx_->rc_max_rate = config_.bitrate * 3 / 2;
+    codecCtx_->rc_buffer_size = config_.bitrate / config_.fps;
+    codecCtx_->gop_size = config_.keyframeInterval;
+    codecCtx_->max_b_frames = 0;
+    codecCtx_->thread_count = 0;
+
+    // x265 Main 4:2:2 10 takes 8-bit 4:2:2; AV1 4:2:2 needs the Professional profile
+    if (config_.chroma422 && !hevc) {
+        LOG_INFO("AV1: 4:2:2 not supported by the Main profile, encoding 4:2:0");
+        config_.chroma422 = false;
+    }
+    codecCtx_->pix_fmt = config_.chroma422 ? AV_PIX_FMT_YUV422P : AV_PIX_FMT_YUV420P;
+
+    AVDictionary* opts = nullptr;
+    if (hevc) {
+        // zerolatency: no B-frames, no lookahead, no frame threads
+        av_dict_set(&opts, "preset", config_.preset.c_str(), 0);
+        av_dict_set(&opts, "tune", "zerolatency", 0);
+        av_dict_set(&opts, "forced-idr", "1", 0);     // Forced keyframes are IDRs, not CRAs
+        av_dict_set(&opts, "x265-params",
+                    "repeat-headers=1:annexb=1:rc-lookahead=0:bframes=0:range=full:"
+                    "colorprim=bt709:transfer=bt709:colormatrix=bt709:log-level=error", 0);
+    } else if (std::string(codec->name) == "libsvtav1") {
+        // Low-delay prediction structure (no reordering), CBR
+        av_dict_set(&opts, "preset", svtAv1Preset(config_.preset), 0);
+        av_dict_set(&opts, "svtav1-params", "pred-struct=1:rc=2", 0);
+    } else {
+        av_dict_set(&opts, "usage", "realtime", 0);
+        av_dict_set(&opts, "cpu-used", "8", 0);
+        av_dict_set(&opts, "lag-in-frames", "0", 0);
+        av_dict_set(&opts, "row-mt", "1", 0);
+    }
+
+    int ret = avcodec_open2(codecCtx_, codec, &opts);
+    av_dict_free(&opts);
+    if (ret < 0) {
+        char errbuf[256];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        Logger::instance().errorf("Failed to open encoder: %s", errbuf);
+        if (onError_) onError_(std::string("Failed to open encoder: ") + errbuf);
+        return false;
+    }
+
+    Logger::instance().successf("Encoder opened: %s (software)", codec->name);
+
+    frame_ = av_frame_alloc();
+    if (!frame_) {
+        LOG_ERROR("Failed to allocate frame");
+        return false;
+    }
+    frame_->format = codecCtx_->pix_fmt;
+    frame_->width = codecCtx_->width;
+    frame_->height = codecCtx_->height;
+    if (av_frame_get_buffer(frame_, 0) < 0) {
+        LOG_ERROR("Failed to allocate frame buffer");
+        return false;
+    }
+
+    packet_ = av_packet_alloc();
+    if (!packet_) {
+        LOG_ERROR("Failed to allocate packet");
+        return false;
+    }
+
+    return true;
+}
+
 bool VideoEncoder::initScaler() {
     AVPixelFormat srcFormat = toAVPixelFormat(config_.inputFormat);
-    AVPixelFormat dstFormat = codecCtx_->pix_fmt;  // NV12 for VideoToolbox, YUV420P for x264
+    AVPixelFormat dstFormat = codecCtx_->pix_fmt;  // NV12 for VideoToolbox, YUV420P/422P for x264
 
     // If input matches encoder format, no scaling needed
     if (srcFormat == dstFormat) {
@@ -278,19 +471,46 @@ bool VideoEncoder::initScaler() {
         return true;
     }
 
-    Logger::instance().debugf("Creating scaler: %s -> %s",
-                              pixelFormatName(config_.inputFormat),
-                              av_get_pix_fmt_name(dstFormat));
+    const bool fullRange = codecCtx_->color_range == AVCOL_RANGE_JPEG;
+    switch (dstFormat) {
+        case AV_PIX_FMT_NV12:    converterOutput_ = PixelFormat::NV12; break;
+        case AV_PIX_FMT_YUV422P: converterOutput_ = PixelFormat::I422; break;
+        default:                 converterOutput_ = PixelFormat::I420; break;
+    }
 
-    swsCtx_ = sws_getContext(
-        config_.width, config_.height, srcFormat,
-        config_.width, config_.height, dstFormat,
-        SWS_FAST_BILINEAR, nullptr, nullptr, nullptr
-    );
+    if ((dstFormat == AV_PIX_FMT_NV12 || dstFormat == AV_PIX_FMT_YUV420P ||
+         dstFormat == AV_PIX_FMT_YUV422P) &&
+        PixelConverter::supports(config_.inputFormat, converterOutput_)) {
+        PixelConverterConfig convConfig;
+        convConfig.threads = config_.convertThreads;
+        convConfig.fullRange = fullRange;
+        converter_ = std::make_unique<PixelConverter>(convConfig);
+
+        Logger::instance().infof("Pixel conversion: %s -> %s (%s, %d slice threads)",
+                                 pixelFormatName(config_.inputFormat),
+                                 av_get_pix_fmt_name(dstFormat),
+                                 PixelConverter::kernelName(converter_->kernel()),
+                                 converter_->threadCount());
+    } else {
+        Logger::instance().debugf("Creating scaler: %s -> %s",
+                                  pixelFormatName(config_.inputFormat),
+                                  av_get_pix_fmt_name(dstFormat));
+
+        swsCtx_ = sws_getContext(
+            config_.width, config_.height, srcFormat,
+            config_.width, config_.height, dstFormat,
+            SWS_FAST_BILINEAR, nullptr, nullptr, nullptr
+        );
+
+        if (!swsCtx_) {
+            LOG_ERROR("Failed to create pixel format converter");
+            return false;
+        }
 
-    if (!swsCtx_) {
-        LOG_ERROR("Failed to create pixel format converter");
-        return false;
+        // Same matrix/range as the VUI we signal (BT.709, full range)
+        const int* coeffs = sws_getCoefficients(SWS_CS_ITU709);
+        sws_setColorspaceDetails(swsCtx_, coeffs, fullRange ? 1 : 0, coeffs, fullRange ? 1 : 0,
+                                 0, 1 << 16, 1 << 16);
     }
 
     // Allocate converted frame
@@ -329,6 +549,11 @@ void VideoEncoder::cleanup() {
         convertedFrame_ = nullptr;
     }
 
+    for (auto& picture : pictures_) {
+        av_frame_free(&picture);
+    }
+    pictures_.clear();
+
     if (packet_) {
         av_packet_free(&packet_);
         packet_ = nullptr;
@@ -339,6 +564,8 @@ void VideoEncoder::cleanup() {
         swsCtx_ = nullptr;
     }
 
+    converter_.reset();
+
     configured_ = false;
     hwAccelActive_ = false;
     frameNumber_ = 0;
@@ -358,6 +585,7 @@ bool VideoEncoder::encode(const uint8_t* data, size_t size, uint64_t timestamp)
             break;
         case PixelFormat::NV12:
         case PixelFormat::I420:
+        case PixelFormat::I422:
             stride = config_.width;
             break;
         default:
@@ -373,39 +601,60 @@ bool VideoEncoder::encodeWithStride(const uint8_t* data, int stride, uint64_t ti
         return false;
     }
 
-    // Convert pixel format if necessary
-    AVFrame* frameToEncode = frame_;
+    // Convert pixel format if necessary (direct copy for YUV420P input)
+    AVFrame* frameToEncode = (converter_ || swsCtx_) ? convertedFrame_ : frame_;
+    if (!convertInto(data, stride, frameToEncode)) {
+        LOG_ERROR("Pixel format conversion failed");
+        return false;
+    }
 
-    if (swsCtx_) {
-        if (!convertPixelFormat(data, stride)) {
-            LOG_ERROR("Pixel format conversion failed");
-            return false;
-        }
-        frameToEncode = convertedFrame_;
-    } else {
-        // Direct copy for YUV420P input
-        int ret = av_frame_make_writable(frame_);
-        if (ret < 0) {
-            LOG_ERROR("Failed to make frame writable");
-            return false;
-        }
+    return encodeFrame(frameToEncode, timestamp);
+}
 
-        // Copy data to frame
-        const uint8_t* srcSlice[4] = {data, nullptr, nullptr, nullptr};
-        int srcStride[4] = {stride, 0, 0, 0};
+bool VideoEncoder::convertToPicture(const uint8_t* data, int stride, int picture) {
+    if (!configured_ || picture < 0 || picture >= pictureCount()) {
+        return false;
+    }
+    return convertInto(data, stride, pictures_[picture]);
+}
 
-        av_image_copy(frame_->data, frame_->linesize,
-                      srcSlice, srcStride,
-                      static_cast<AVPixelFormat>(frame_->format),
-                      frame_->width, frame_->height);
+bool VideoEncoder::encodePicture(int picture, uint64_t timestamp) {
+    if (!configured_ || picture < 0 || picture >= pictureCount()) {
+        return false;
     }
+    return encodeFrame(pictures_[picture], timestamp);
+}
 
+bool VideoEncoder::picturePlanes(int picture, uint8_t* data[3], int stride[3]) {
+    if (!configured_ || picture < 0 || picture >= pictureCount()) {
+        return false;
+    }
+    AVFrame* frame = pictures_[picture];
+    if (av_frame_make_writable(frame) < 0) {
+        LOG_ERROR("Failed to make frame writable");
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        data[i] = frame->data[i];
+        stride[i] = frame->linesize[i];
+    }
+    return true;
+}
+
+PixelFormat VideoEncoder::pictureFormat() const {
+    if (codecCtx_ && codecCtx_->pix_fmt == AV_PIX_FMT_NV12) return PixelFormat::NV12;
+    if (codecCtx_ && codecCtx_->pix_fmt == AV_PIX_FMT_YUV422P) return PixelFormat::I422;
+    return PixelFormat::I420;
+}
+
+bool VideoEncoder::encodeFrame(AVFrame* frameToEncode, uint64_t timestamp) {
     // Set timestamp
     frameToEncode->pts = static_cast<int64_t>(timestamp);
 
-    // Force keyframe if requested
+    // Force keyframe if requested (intra refresh: x264 schedules the waves itself)
     if (forceNextKeyframe_ || frameNumber_ == 0 ||
-        (config_.keyframeInterval > 0 && frameNumber_ % config_.keyframeInterval == 0)) {
+        (!config_.intraRefresh && config_.keyframeInterval > 0 &&
+         frameNumber_ % config_.keyframeInterval == 0)) {
         frameToEncode->pict_type = AV_PICTURE_TYPE_I;
         forceNextKeyframe_ = false;
     } else {
@@ -442,12 +691,31 @@ bool VideoEncoder::encodeWithStride(const uint8_t* data, int stride, uint64_t ti
     return true;
 }
 
-bool VideoEncoder::convertPixelFormat(const uint8_t* srcData, int srcStride) {
-    int ret = av_frame_make_writable(convertedFrame_);
+bool VideoEncoder::convertInto(const uint8_t* srcData, int srcStride, AVFrame* dst) {
+    int ret = av_frame_make_writable(dst);
     if (ret < 0) {
+        LOG_ERROR("Failed to make frame writable");
         return false;
     }
 
+    if (converter_) {
+        return converter_->convert(config_.inputFormat, srcData, srcStride,
+                                   converterOutput_, dst->data,
+                                   dst->linesize, config_.width, config_.height);
+    }
+
+    if (!swsCtx_) {
+        // Input already in encoder format: plain copy
+        const uint8_t* srcSlice[4] = {srcData, nullptr, nullptr, nullptr};
+        int srcStrides[4] = {srcStride, 0, 0, 0};
+
+        av_image_copy(dst->data, dst->linesize,
+                      srcSlice, srcStrides,
+                      static_cast<AVPixelFormat>(dst->format),
+                      dst->width, dst->height);
+        return true;
+    }
+
     // Setup source data pointers based on pixel format
     const uint8_t* srcSlice[4] = {nullptr, nullptr, nullptr, nullptr};
     int srcStrides[4] = {0, 0, 0, 0};
@@ -478,6 +746,15 @@ bool VideoEncoder::convertPixelFormat(const uint8_t* srcData, int srcStride) {
             srcStrides[1] = srcStride / 2;
             srcStrides[2] = srcStride / 2;
             break;
+
+        case PixelFormat::I422:
+            srcSlice[0] = srcData;
+            srcSlice[1] = srcData + config_.width * config_.height;
+            srcSlice[2] = srcData + config_.width * config_.height * 3 / 2;
+            srcStrides[0] = srcStride;
+            srcStrides[1] = srcStride / 2;
+            srcStrides[2] = srcStride / 2;
+            break;
     }
 
     // Convert
@@ -485,7 +762,7 @@ bool VideoEncoder::convertPixelFormat(const uint8_t* srcData, int srcStride) {
         swsCtx_,
         srcSlice, srcStrides,
         0, config_.height,
-        convertedFrame_->data, convertedFrame_->linesize
+        dst->data, dst->linesize
     );
 
     return height == config_.height;
@@ -498,8 +775,14 @@ void VideoEncoder::processEncodedPacket(AVPacket* packet) {
     std::vector<uint8_t> annexBData;
     annexBData.reserve(packet->size + 256);  // Extra space for SPS/PPS
 
-    // For keyframes, prepend SPS/PPS from extradata
-    if (isKeyframe && codecCtx_->extradata && codecCtx_->extradata_size > 0) {
+    // AV1 temporal units have no start codes: pass through as-is
+    if (config_.codec == VideoCodec::AV1) {
+        annexBData.assign(packet->data, packet->data + packet->size);
+    }
+
+    // For keyframes, prepend SPS/PPS from extradata (H.264 global header)
+    if (config_.codec == VideoCodec::H264 && isKeyframe &&
+        codecCtx_->extradata && codecCtx_->extradata_size > 0) {
         const uint8_t* extra = codecCtx_->extradata;
         int extraSize = codecCtx_->extradata_size;
 
@@ -558,7 +841,9 @@ void VideoEncoder::processEncodedPacket(AVPacket* packet) {
     bool isAnnexB = (size >= 4 && data[0] == 0 && data[1] == 0 &&
                     (data[2] == 1 || (data[2] == 0 && data[3] == 1)));
 
-    if (isAnnexB) {
+    if (config_.codec == VideoCodec::AV1) {
+        // Copied above
+    } else if (isAnnexB) {
         // Already Annex-B, just append
         annexBData.insert(annexBData.end(), data, data + size);
     } else {
@@ -593,6 +878,12 @@ void VideoEncoder::processEncodedPacket(AVPacket* packet) {
         stats_.keyframesEncoded++;
     }
 
+    if (config_.sliceOutput) {
+        deliverSlices(annexBData, isKeyframe, static_cast<uint64_t>(packet->pts),
+                      static_cast<uint64_t>(packet->duration));
+        return;
+    }
+
     // Call callback
     if (onEncodedFrame_) {
         EncodedFrame frame;
@@ -604,11 +895,155 @@ void VideoEncoder::processEncodedPacket(AVPacket* packet) {
     }
 }
 
+// Offsets of the start codes (3 or 4 bytes) in an Annex-B buffer
+static std::vector<size_t> findStartCodes(const std::vector<uint8_t>& data) {
+    std::vector<size_t> starts;
+    for (size_t i = 0; i + 3 < data.size(); i++) {
+        if (data[i] == 0x00 && data[i + 1] == 0x00 && data[i + 2] == 0x01) {
+            starts.push_back(i > 0 && data[i - 1] == 0x00 ? i - 1 : i);
+            i += 2;
+        }
+    }
+    return starts;
+}
+
+void VideoEncoder::deliverSlices(const std::vector<uint8_t>& annexB, bool isKeyframe,
+                                 uint64_t timestamp, uint64_t duration) {
+    // One unit per slice NAL. Parameter sets / SEI / AUD ride with the slice
+    // that follows them, so the first unit of an IDR is decodable on its own.
+    std::vector<std::pair<size_t, size_t>> units;
+    const auto starts = findStartCodes(annexB);
+    size_t unitStart = 0;
+    for (size_t n = 0; n < starts.size(); n++) {
+        size_t header = starts[n] + (annexB[starts[n] + 2] == 0x01 ? 3 : 4);
+        int nalType = annexB[header] & 0x1F;
+        if (nalType >= 1 && nalType <= 5) {
+            size_t end = n + 1 < starts.size() ? starts[n + 1] : annexB.size();
+            units.emplace_back(unitStart, end);
+            unitStart = end;
+        }
+    }
+    if (unitStart < annexB.size()) {
+        // Trailing non-slice NALs belong to the last unit
+        if (units.empty()) {
+            units.emplace_back(unitStart, annexB.size());
+        } else {
+            units.back().second = annexB.size();
+        }
+    }
+
+    stats_.slicesEncoded += units.size();
+    if (!onEncodedFrame_) return;
+
+    for (size_t i = 0; i < units.size(); i++) {
+        EncodedFrame frame;
+        frame.data.assign(annexB.begin() + units[i].first, annexB.begin() + units[i].second);
+        frame.isKeyframe = isKeyframe && i == 0;    // Receivers resync on the unit with SPS/PPS
+        frame.timestamp = timestamp;
+        frame.duration = duration;
+        frame.isSlice = true;
+        frame.endOfAccessUnit = i + 1 == units.size();
+        onEncodedFrame_(frame);
+    }
+}
+
 void VideoEncoder::forceKeyframe() {
     forceNextKeyframe_ = true;
     LOG_DEBUG("Keyframe forced for next frame");
 }
 
+bool VideoEncoder::reconfigure(int bitrate, int keyframeInterval) {
+    if (!configured_) {
+        LOG_ERROR("Encoder not configured");
+        return false;
+    }
+    if (hwAccelActive_) {
+        LOG_ERROR("Live reconfigure not supported by the hardware encoder");
+        return false;
+    }
+
+    if (bitrate > 0 && bitrate != config_.bitrate && config_.codec != VideoCodec::H264) {
+        // libx265 / SVT-AV1 have no in-flight rate control change in FFmpeg
+        Logger::instance().infof("%s: live bitrate change not supported, keeping %.1f Mbps",
+                                 Protocol::codecName(config_.codec), config_.bitrate / 1e6);
+        bitrate = 0;
+    }
+
+    if (bitrate > 0 && bitrate != config_.bitrate) {
+        // Same rate control as initEncoder: 1.5x peak, one-frame VBV
+        config_.bitrate = bitrate;
+        codecCtx_->bit_rate = bitrate;
+        codecCtx_->rc_max_rate = bitrate * 3 / 2;
+        codecCtx_->rc_buffer_size = bitrate / config_.fps;
+    }
+
+    if (keyframeInterval > 0 && keyframeInterval != config_.keyframeInterval) {
+        if (config_.intraRefresh) {
+            LOG_INFO("Intra refresh: refresh period is fixed until the encoder is reopened");
+        } else {
+            config_.keyframeInterval = keyframeInterval;
+        }
+    }
+
+    Logger::instance().infof("Encoder reconfigured: %.1f Mbps, keyframe every %d frames",
+                              config_.bitrate / 1e6, config_.keyframeInterval);
+    return true;
+}
+
+bool VideoEncoder::setPreset(const std::string& preset) {
+    if (!configured_) {
+        LOG_ERROR("Encoder not configured");
+        return false;
+    }
+    if (hwAccelActive_) {
+        LOG_ERROR("Presets are not supported by the hardware encoder");
+        return false;
+    }
+    if (preset == config_.preset) return true;
+
+    // Deliver whatever the old context still holds (nothing with zerolatency)
+    flush();
+    closeEncoder();
+
+    // Stay in software: the pictures were allocated in its pixel format
+    const std::string previous = config_.preset;
+    const bool useHardwareAccel = config_.useHardwareAccel;
+    config_.useHardwareAccel = false;
+    config_.preset = preset;
+    bool ok = initEncoder();
+    if (!ok) {
+        Logger::instance().errorf("Failed to reopen encoder with preset %s, keeping %s",
+                                  preset.c_str(), previous.c_str());
+        closeEncoder();
+        config_.preset = previous;
+        if (!initEncoder()) {
+            LOG_ERROR("Failed to reopen encoder");
+            closeEncoder();
+            configured_ = false;
+        }
+    }
+    config_.useHardwareAccel = useHardwareAccel;
+
+    // Restart the keyframe schedule from the new IDR
+    frameNumber_ = 0;
+    if (ok) {
+        Logger::instance().infof("Encoder preset: %s -> %s", previous.c_str(), preset.c_str());
+    }
+    return ok;
+}
+
+void VideoEncoder::closeEncoder() {
+    if (codecCtx_) {
+        avcodec_free_context(&codecCtx_);
+    }
+    if (frame_) {
+        av_frame_free(&frame_);
+    }
+    if (packet_) {
+        av_packet_free(&packet_);
+    }
+}
+
 void VideoEncoder::flush() {
     if (!configured_) return;
 
@@ -1,10 +1,10 @@
 #pragma once
 
 /**
- * VideoEncoder.h - H.264 video encoder using FFmpeg/libx264
+ * VideoEncoder.h - Video encoder using FFmpeg (libx264, libx265, SVT-AV1)
  *
- * Encodes raw video frames (BGRA, UYVY, or NV12) to H.264 Annex-B format.
- * Optimized for low-latency streaming with ultrafast preset.
+ * Encodes raw video frames (BGRA, UYVY, or NV12) to H.264 / HEVC Annex-B
+ * or AV1 OBUs. Optimized for low-latency streaming with ultrafast preset.
  */
 
 #include <cstdint>
@@ -13,6 +13,9 @@
 #include <functional>
 #include <memory>
 
+#include "PixelFormat.h"
+#include "../common/Protocol.h"
+
 // Forward declarations for FFmpeg types
 struct AVCodecContext;
 struct AVFrame;
@@ -21,15 +24,7 @@ struct SwsContext;
 
 namespace ndi_bridge {
 
-/**
- * Supported input pixel formats
- */
-enum class PixelFormat {
-    BGRA,       // 32-bit BGRA (NDI default on some platforms)
-    UYVY,       // 16-bit packed YUV 4:2:2 (NDI native)
-    NV12,       // Planar YUV 4:2:0 (encoder native)
-    I420        // Planar YUV 4:2:0 (alias YUV420P)
-};
+class PixelConverter;
 
 /**
  * Encoder configuration
@@ -42,7 +37,13 @@ struct VideoEncoderConfig {
     int keyframeInterval = 60;      // Keyframe every N frames (1 second at 60fps)
     PixelFormat inputFormat = PixelFormat::UYVY;
 
-    // x264 specific (ignored for hardware encoders)
+    // Backend: H.264 = hardware or libx264, HEVC = libx265, AV1 = SVT-AV1
+    // (libaom fallback). HEVC / AV1 are software only and, for now, have no
+    // slice streaming, intra refresh or live bitrate change.
+    VideoCodec codec = VideoCodec::H264;
+
+    // x264 / x265 preset names (SVT-AV1 maps them to its numeric presets),
+    // ignored for hardware encoders
     std::string preset = "ultrafast";
     std::string tune = "zerolatency";
     std::string profile = "high";
@@ -50,6 +51,21 @@ struct VideoEncoderConfig {
     // Hardware acceleration
     bool useHardwareAccel = true;   // Try hardware encoder first (VideoToolbox on macOS)
 
+    // Pixel format conversion
+    int convertThreads = 0;         // Slice threads for UYVY/BGRA conversion (0 = auto)
+    bool chroma422 = false;         // Encode YUV 4:2:2 (x264 High 4:2:2, software only)
+
+    // Periodic intra refresh (x264 only): a rolling intra column refreshes the
+    // picture over keyframeInterval frames instead of a periodic IDR
+    bool intraRefresh = false;
+
+    // Pipelined use (convertToPicture / encodePicture)
+    int pipelinePictures = 0;       // Encoder-format input pictures to allocate
+
+    // Slice streaming
+    int slices = 0;                 // Slices per picture (0 = encoder default)
+    bool sliceOutput = false;       // Deliver each slice as its own EncodedFrame
+
     // Presets
     static VideoEncoderConfig hd1080p60() {
         return VideoEncoderConfig{1920, 1080, 8000000, 60, 60, PixelFormat::UYVY};
@@ -64,25 +80,31 @@ struct VideoEncoderConfig {
  * Encoded frame data
  */
 struct EncodedFrame {
-    std::vector<uint8_t> data;      // H.264 Annex-B data (with start codes)
+    std::vector<uint8_t> data;      // H.264 / HEVC Annex-B (start codes) or AV1 temporal unit
     bool isKeyframe;
     uint64_t timestamp;             // PTS in 10M ticks/sec
     uint64_t duration;              // Duration in 10M ticks/sec
+    bool isSlice = false;           // One slice of an access unit (sliceOutput)
+    bool endOfAccessUnit = true;    // Last unit of the access unit
+    bool isRepeat = false;          // No picture: repeat marker for a static frame (data empty)
 };
 
 /**
  * Callback types
  */
-using OnEncodedFrame = std::function<void(const EncodedFrame& frame)>;
+using OnEncodedFrame = std::function<void(EncodedFrame& frame)>;  // May take frame.data by move
 using OnEncoderError = std::function<void(const std::string& error)>;
 
 /**
- * VideoEncoder - H.264 encoder using FFmpeg/libx264
+ * VideoEncoder - H.264 / HEVC / AV1 encoder using FFmpeg
  *
  * Features:
- * - Software encoding with libx264
- * - Automatic pixel format conversion (BGRA/UYVY → NV12)
- * - H.264 Annex-B output with SPS/PPS on keyframes
+ * - Software encoding with libx264, libx265 (HEVC) or SVT-AV1, hardware
+ *   H.264 where available
+ * - Automatic pixel format conversion (BGRA/UYVY → I420/NV12), SIMD +
+ *   slice threads via PixelConverter, sws_scale for anything else
+ * - Optional native 4:2:2 (UYVY → I422 deinterleave, no chroma decimation)
+ * - Parameter sets (SPS/PPS, VPS, AV1 sequence header) in-band on keyframes
  * - Low-latency optimized (ultrafast + zerolatency)
  */
 class VideoEncoder {
@@ -94,6 +116,12 @@ public:
     VideoEncoder(const VideoEncoder&) = delete;
     VideoEncoder& operator=(const VideoEncoder&) = delete;
 
+    /**
+     * Whether this FFmpeg build has the software encoder for a codec
+     * (libx264 / libx265 / libsvtav1 or libaom)
+     */
+    static bool isAvailable(VideoCodec codec);
+
     /**
      * Configure the encoder
      * @return true if configuration successful
@@ -122,11 +150,59 @@ public:
      */
     bool encodeWithStride(const uint8_t* data, int stride, uint64_t timestamp);
 
+    /**
+     * Pipelined encode: convert into one of the pipelinePictures pictures on
+     * one thread, encode it on another. The two calls may run concurrently
+     * as long as they use different pictures; each is single-caller.
+     * @param picture Index in [0, pictureCount())
+     */
+    int pictureCount() const { return static_cast<int>(pictures_.size()); }
+    bool convertToPicture(const uint8_t* data, int stride, int picture);
+    bool encodePicture(int picture, uint64_t timestamp);
+
+    /**
+     * Encoder-format planes of a pipeline picture (Y, U or UV, V), for a
+     * caller that fills or reads it directly (simulcast resize). Same
+     * threading rule as convertToPicture().
+     * @return false if not configured or the picture index is invalid
+     */
+    bool picturePlanes(int picture, uint8_t* data[3], int stride[3]);
+
+    /**
+     * Pixel format of the pipeline pictures (I420, I422 or NV12)
+     */
+    PixelFormat pictureFormat() const;
+
     /**
      * Force next frame to be a keyframe
      */
     void forceKeyframe();
 
+    /**
+     * Change rate control without reopening the encoder
+     *
+     * libx264 picks the new bitrate/VBV up on the next frame
+     * (x264_encoder_reconfig). The keyframe interval drives our forced
+     * keyframes; x264's own keyint (the interval at configure time) stays
+     * the upper bound. Call from the encoding thread, between frames.
+     * @param bitrate New bitrate in bits/s (0 = keep, x264 only)
+     * @param keyframeInterval Frames between keyframes (0 = keep)
+     * @return false if not configured or the encoder cannot change live
+     */
+    bool reconfigure(int bitrate, int keyframeInterval);
+
+    /**
+     * Switch the x264 / x265 / SVT-AV1 preset
+     *
+     * The encoders cannot change their analysis settings in flight, so this reopens
+     * the codec context (next frame is an IDR). Pipeline pictures and the
+     * pixel converter are kept, so convertToPicture() may run concurrently.
+     * Call from the encoding thread, between frames.
+     * @return false if not configured, hardware encoding, or the reopen
+     *         failed (the previous preset is restored)
+     */
+    bool setPreset(const std::string& preset);
+
     /**
      * Flush encoder (get any pending frames)
      */
@@ -142,6 +218,11 @@ public:
      */
     const VideoEncoderConfig& getConfig() const { return config_; }
 
+    /**
+     * Check if a hardware encoder is in use (presets / live reconfigure n/a)
+     */
+    bool isHardwareAccelerated() const { return hwAccelActive_; }
+
     /**
      * Set callbacks
      */
@@ -155,15 +236,21 @@ public:
         uint64_t framesEncoded = 0;
         uint64_t bytesEncoded = 0;
         uint64_t keyframesEncoded = 0;
+        uint64_t slicesEncoded = 0;     // Slice units delivered (sliceOutput)
     };
     Stats getStats() const { return stats_; }
 
 private:
     bool initEncoder();
+    bool initHevcAv1Encoder();
     bool initScaler();
     void cleanup();
-    bool convertPixelFormat(const uint8_t* srcData, int srcStride);
+    void closeEncoder();
+    bool convertInto(const uint8_t* srcData, int srcStride, AVFrame* dst);
+    bool encodeFrame(AVFrame* frame, uint64_t timestamp);
     void processEncodedPacket(AVPacket* packet);
+    void deliverSlices(const std::vector<uint8_t>& annexB, bool isKeyframe,
+                       uint64_t timestamp, uint64_t duration);
 
     VideoEncoderConfig config_;
     bool configured_ = false;
@@ -177,9 +264,16 @@ private:
     AVPacket* packet_ = nullptr;
     SwsContext* swsCtx_ = nullptr;
 
+    // Native converter (preferred over swsCtx_ when it supports the pair)
+    std::unique_ptr<PixelConverter> converter_;
+    PixelFormat converterOutput_ = PixelFormat::I420;
+
     // Intermediate buffer for pixel format conversion
     AVFrame* convertedFrame_ = nullptr;
 
+    // Pipeline input pictures (config_.pipelinePictures)
+    std::vector<AVFrame*> pictures_;
+
     // Callbacks
     OnEncodedFrame onEncodedFrame_;
     OnEncoderError onError_;
@@ -94,6 +94,21 @@ int BridgeManager::addJoin(const std::string& ndiName, uint16_t port) {
     return id;
 }
 
+bool BridgeManager::reconfigureHost(int id, int bitrateMbps, int keyframeInterval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& h : hosts_) {
+        if (h->id == id) {
+            h->host->reconfigureEncoder(bitrateMbps, keyframeInterval);
+            Logger::instance().infof("Host pipeline #%d reconfigured", id);
+            return true;
+        }
+    }
+
+    Logger::instance().errorf("Host pipeline #%d not found", id);
+    return false;
+}
+
 bool BridgeManager::stopPipeline(int id) {
     std::lock_guard<std::mutex> lock(mutex_);
 
@@ -176,6 +191,10 @@ std::vector<PipelineStatus> BridgeManager::getStatus() {
             ps.videoFramesEncoded = stats.videoFramesEncoded;
             ps.videoFramesDropped = stats.videoFramesDropped;
             ps.bytesSent = stats.bytesSent;
+            ps.bitrateKbps = stats.bitrateKbps;
+            ps.keyframeInterval = stats.keyframeInterval;
+            ps.preset = stats.preset;
+            ps.frameDecimation = stats.frameDecimation;
             ps.runTimeSeconds = stats.runTimeSeconds;
         }
 
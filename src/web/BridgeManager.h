@@ -36,6 +36,10 @@ struct PipelineStatus {
     uint64_t videoFramesEncoded = 0;
     uint64_t videoFramesDropped = 0;  // queue drops
     uint64_t bytesSent = 0;
+    int bitrateKbps = 0;              // Follows the adaptive controller
+    int keyframeInterval = 0;         // Frames (0 = one second)
+    std::string preset;               // x264 preset (operating point)
+    int frameDecimation = 1;          // Encoding 1 frame in N
 
     // Join stats
     uint64_t videoFramesDecoded = 0;
@@ -78,6 +82,14 @@ public:
      */
     int addJoin(const std::string& ndiName, uint16_t port);
 
+    /**
+     * Change a host pipeline's bitrate / keyframe interval without restarting it
+     * @param bitrateMbps New bitrate (0 = keep)
+     * @param keyframeInterval Frames between keyframes (0 = keep)
+     * @return false if no host pipeline has this ID
+     */
+    bool reconfigureHost(int id, int bitrateMbps, int keyframeInterval);
+
     /**
      * Stop and remove a pipeline
      * @return true if found and stopped
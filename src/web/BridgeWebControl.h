@@ -173,6 +173,9 @@ private:
             } else if (strncmp(path, "/api/stop/", 10) == 0) {
                 int id = atoi(path + 10);
                 sendResponse(fd, 200, "application/json", handleStop(id));
+            } else if (strncmp(path, "/api/reconfigure/", 17) == 0) {
+                int id = atoi(path + 17);
+                sendResponse(fd, 200, "application/json", handleReconfigure(id, bodyStr));
             } else {
                 sendResponse(fd, 404, "text/plain", "Not Found");
             }
@@ -270,7 +273,7 @@ private:
                      "{\"id\":%d,\"type\":\"%s\",\"desc\":\"%s\",\"running\":%s,"
                      "\"videoRecv\":%lu,\"videoEnc\":%lu,\"videoDrop\":%lu,"
                      "\"videoDec\":%lu,\"videoOut\":%lu,\"audioOut\":%lu,"
-                     "\"bytesSent\":%lu,\"time\":%.1f}",
+                     "\"bytesSent\":%lu,\"bitrate\":%.1f,\"gop\":%d,\"preset\":\"%s\",\"decimation\":%d,\"time\":%.1f}",
                      p.id, p.type.c_str(), jsonEscape(p.description).c_str(),
                      p.running ? "true" : "false",
                      (unsigned long)p.videoFramesReceived,
@@ -280,6 +283,8 @@ private:
                      (unsigned long)p.videoFramesOutput,
                      (unsigned long)p.audioFramesOutput,
                      (unsigned long)p.bytesSent,
+                     p.bitrateKbps / 1000.0, p.keyframeInterval,
+                     p.preset.c_str(), p.frameDecimation,
                      p.runTimeSeconds);
             json += buf;
         }
@@ -332,6 +337,23 @@ private:
         return buf;
     }
 
+    // bitrate=<Mbps>&gop=<frames>, either may be omitted
+    std::string handleReconfigure(int id, const std::string& body) {
+        std::string bitrateStr = urlParam(body, "bitrate");
+        std::string gopStr = urlParam(body, "gop");
+
+        int bitrate = bitrateStr.empty() ? 0 : atoi(bitrateStr.c_str());
+        int gop = gopStr.empty() ? 0 : atoi(gopStr.c_str());
+        if (bitrate <= 0 && gop <= 0) {
+            return "{\"ok\":false,\"error\":\"bitrate or gop required\"}";
+        }
+
+        if (!manager_->reconfigureHost(id, bitrate, gop)) {
+            return "{\"ok\":false,\"error\":\"host pipeline not found\"}";
+        }
+        return "{\"ok\":true}";
+    }
+
     std::string handleStop(int id) {
         bool ok = manager_->stopPipeline(id);
         if (ok) {
@@ -605,6 +627,19 @@ function stopPipeline(id) {
     .catch(e => alert('Erreur: ' + e));
 }
 
+function setBitrate(id, current) {
+  const v = prompt('Nouveau debit (Mbps)', current);
+  if (!v || isNaN(parseInt(v))) return;
+  fetch('/api/reconfigure/' + id, {
+    method: 'POST',
+    headers: {'Content-Type': 'application/x-www-form-urlencoded'},
+    body: 'bitrate=' + encodeURIComponent(parseInt(v))
+  }).then(r => r.json()).then(d => {
+    if (!d.ok) alert('Erreur: ' + (d.error || 'unknown'));
+    pollPipelines();
+  }).catch(e => alert('Erreur: ' + e));
+}
+
 function fmtBytes(b) {
   if (b < 1024) return b + ' B';
   if (b < 1048576) return (b / 1024).toFixed(1) + ' KB';
@@ -640,7 +675,11 @@ function renderPipelines(pipelines) {
       const fps = fmtFps(p.videoEnc, p.time);
       stats = '<span>video=</span>' + p.videoRecv + ' <span>encoded=</span>' + p.videoEnc
         + ' <span>qdrop=</span>' + p.videoDrop + ' <span>fps=</span>' + fps
-        + '<br><span>sent=</span>' + fmtBytes(p.bytesSent) + ' <span>time=</span>' + fmtTime(p.time);
+        + '<br><span>sent=</span>' + fmtBytes(p.bytesSent) + ' <span>bitrate=</span>'
+        + '<a href="#" onclick="setBitrate(' + p.id + ',' + p.bitrate + ');return false">'
+        + p.bitrate + ' Mbps</a> <span>preset=</span>' + p.preset
+        + (p.decimation > 1 ? ' (1/' + p.decimation + ')' : '')
+        + ' <span>time=</span>' + fmtTime(p.time);
     } else {
       const fps = fmtFps(p.videoOut, p.time);
       stats = '<span>recv=</span>' + p.videoRecv + ' <span>decoded=</span>' + p.videoDec